@@ -0,0 +1,98 @@
+#include <c10/core/DispatchKeySet.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cstdint>
+
+// Per-op cost of the DispatchKeySet operations that run in dispatch loops:
+// walking the keys of a set, and peeling off one key at a time the way a
+// chain of redispatches does.
+
+namespace {
+
+using c10::DispatchKey;
+using c10::DispatchKeySet;
+
+// The keys of a CPU tensor seen by an op with profiling and autograd on
+DispatchKeySet typical_set() {
+  return DispatchKeySet({DispatchKey::CPU, DispatchKey::BackendSelect, DispatchKey::Autograd,
+                         DispatchKey::Profiler, DispatchKey::Tracer});
+}
+
+// The walk the iterator replaces: a has() per possible key
+void BM_IterateWithHas(benchmark::State& state) {
+  DispatchKeySet ks = typical_set();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ks);
+    uint32_t sum = 0;
+    for (uint8_t k = static_cast<uint8_t>(DispatchKey::NumDispatchKeys) - 1; k > 0; k--) {
+      if (ks.has(static_cast<DispatchKey>(k))) {
+        sum += k;
+      }
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_IterateWithIterator(benchmark::State& state) {
+  DispatchKeySet ks = typical_set();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ks);
+    uint32_t sum = 0;
+    for (DispatchKey k : ks) {
+      sum += static_cast<uint8_t>(k);
+    }
+    benchmark::DoNotOptimize(sum);
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+// Dispatch to the highest key, then redispatch to the keys after it, until
+// the set is exhausted
+void BM_RedispatchChain(benchmark::State& state) {
+  DispatchKeySet ks = typical_set();
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ks);
+    DispatchKeySet remaining = ks;
+    DispatchKey k = remaining.highestPriorityTypeId();
+    while (k != DispatchKey::Undefined) {
+      benchmark::DoNotOptimize(k);
+      remaining = remaining & DispatchKeySet(DispatchKeySet::FULL_AFTER, k);
+      k = remaining.highestPriorityTypeId();
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_Has(benchmark::State& state) {
+  DispatchKeySet ks = typical_set();
+  DispatchKey k = DispatchKey::Autograd;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ks);
+    benchmark::DoNotOptimize(k);
+    benchmark::DoNotOptimize(ks.has(k));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_HasUnchecked(benchmark::State& state) {
+  DispatchKeySet ks = typical_set();
+  DispatchKey k = DispatchKey::Autograd;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(ks);
+    benchmark::DoNotOptimize(k);
+    benchmark::DoNotOptimize(ks.has_unchecked(k));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_IterateWithHas);
+BENCHMARK(BM_IterateWithIterator);
+BENCHMARK(BM_RedispatchChain);
+BENCHMARK(BM_Has);
+BENCHMARK(BM_HasUnchecked);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,85 @@
+#include <c10/util/Half.h>
+
+#include <benchmark/benchmark.h>
+
+#include <random>
+#include <vector>
+
+// Throughput of the bulk Half <-> float conversions against the per-element
+// conversions of Half.h, for arrays in L1, in L2 and in memory.
+
+namespace {
+
+using c10::Half;
+
+std::vector<float> random_floats(size_t n) {
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<float> distribution(-1000.f, 1000.f);
+  std::vector<float> values(n);
+  for (auto& value : values) {
+    value = distribution(generator);
+  }
+  return values;
+}
+
+std::vector<Half> random_halfs(size_t n) {
+  const std::vector<float> floats = random_floats(n);
+  return std::vector<Half>(floats.begin(), floats.end());
+}
+
+void set_bytes_processed(benchmark::State& state, size_t bytes_per_item) {
+  state.SetBytesProcessed(state.iterations() * state.range(0) * bytes_per_item);
+}
+
+void BM_HalfToFloat(benchmark::State& state) {
+  const std::vector<Half> src = random_halfs(state.range(0));
+  std::vector<float> dst(src.size());
+  for (auto _ : state) {
+    c10::convert_half_to_float(src.data(), dst.data(), src.size());
+    benchmark::ClobberMemory();
+  }
+  set_bytes_processed(state, sizeof(Half) + sizeof(float));
+}
+
+void BM_HalfToFloatScalar(benchmark::State& state) {
+  const std::vector<Half> src = random_halfs(state.range(0));
+  std::vector<float> dst(src.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < src.size(); i++) {
+      dst[i] = static_cast<float>(src[i]);
+    }
+    benchmark::ClobberMemory();
+  }
+  set_bytes_processed(state, sizeof(Half) + sizeof(float));
+}
+
+void BM_FloatToHalf(benchmark::State& state) {
+  const std::vector<float> src = random_floats(state.range(0));
+  std::vector<Half> dst(src.size());
+  for (auto _ : state) {
+    c10::convert_float_to_half(src.data(), dst.data(), src.size());
+    benchmark::ClobberMemory();
+  }
+  set_bytes_processed(state, sizeof(float) + sizeof(Half));
+}
+
+void BM_FloatToHalfScalar(benchmark::State& state) {
+  const std::vector<float> src = random_floats(state.range(0));
+  std::vector<Half> dst(src.size());
+  for (auto _ : state) {
+    for (size_t i = 0; i < src.size(); i++) {
+      dst[i] = static_cast<Half>(src[i]);
+    }
+    benchmark::ClobberMemory();
+  }
+  set_bytes_processed(state, sizeof(float) + sizeof(Half));
+}
+
+} // namespace
+
+BENCHMARK(BM_HalfToFloat)->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_HalfToFloatScalar)->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_FloatToHalf)->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+BENCHMARK(BM_FloatToHalfScalar)->RangeMultiplier(64)->Range(1 << 10, 1 << 22);
+
+BENCHMARK_MAIN();
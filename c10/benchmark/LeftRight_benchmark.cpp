@@ -0,0 +1,67 @@
+#include <c10/util/LeftRight.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <thread>
+
+// Read throughput of LeftRight and ShardedLeftRight from 1 to (hardware
+// threads) concurrent readers.  Items per second are summed over the reader
+// threads, so with ShardedLeftRight they should grow linearly with the number
+// of cores, while LeftRight's shared counter line caps them.
+
+namespace {
+
+c10::LeftRight<int> left_right(0);
+c10::ShardedLeftRight<int> sharded_left_right(0);
+
+int max_threads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+template <class LR>
+void read(benchmark::State& state, const LR& object) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(object.read([](const int& value) { return value; }));
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+void BM_LeftRightRead(benchmark::State& state) {
+  read(state, left_right);
+}
+
+void BM_ShardedLeftRightRead(benchmark::State& state) {
+  read(state, sharded_left_right);
+}
+
+// One writer thread, the others read
+template <class LR>
+void read_while_writing(benchmark::State& state, LR& object) {
+  if (state.thread_index() == 0) {
+    for (auto _ : state) {
+      object.write([](int& value) { value++; });
+    }
+  } else {
+    read(state, object);
+  }
+}
+
+void BM_LeftRightReadWhileWriting(benchmark::State& state) {
+  read_while_writing(state, left_right);
+}
+
+void BM_ShardedLeftRightReadWhileWriting(benchmark::State& state) {
+  read_while_writing(state, sharded_left_right);
+}
+
+} // namespace
+
+BENCHMARK(BM_LeftRightRead)->ThreadRange(1, max_threads())->UseRealTime();
+BENCHMARK(BM_ShardedLeftRightRead)->ThreadRange(1, max_threads())->UseRealTime();
+BENCHMARK(BM_LeftRightReadWhileWriting)->ThreadRange(2, std::max(2, max_threads()))->UseRealTime();
+BENCHMARK(BM_ShardedLeftRightReadWhileWriting)
+    ->ThreadRange(2, std::max(2, max_threads()))
+    ->UseRealTime();
+
+BENCHMARK_MAIN();
@@ -0,0 +1,84 @@
+#include <c10/util/Gemm.h>
+#include <c10/util/Parallel.h>
+
+#include <benchmark/benchmark.h>
+
+#include <algorithm>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+// Scaling of parallel_for from 1 to (hardware threads) pool threads, on a
+// memory-bound loop (a 256 MB copy, beyond the last level cache) and a
+// compute-bound one (a 1024^3 SGEMM), plus the fixed cost parallel_for pays
+// before the pool wakes up.
+
+namespace {
+
+int max_threads() {
+  return std::max(1u, std::thread::hardware_concurrency());
+}
+
+// Sets the pool size for one benchmark, and restores it
+class NumThreadsGuard {
+ public:
+  explicit NumThreadsGuard(int nthreads) : old_(c10::get_num_threads()) {
+    c10::set_num_threads(nthreads);
+  }
+  ~NumThreadsGuard() {
+    c10::set_num_threads(old_);
+  }
+
+ private:
+  int old_;
+};
+
+void BM_ParallelCopy(benchmark::State& state) {
+  NumThreadsGuard guard(static_cast<int>(state.range(0)));
+  constexpr int64_t kSize = int64_t(1) << 26;
+  const std::vector<float> src(kSize, 1.f);
+  std::vector<float> dst(kSize);
+  for (auto _ : state) {
+    c10::parallel_for(0, kSize, c10::internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      std::memcpy(dst.data() + begin, src.data() + begin, (end - begin) * sizeof(float));
+    });
+    benchmark::ClobberMemory();
+  }
+  state.SetBytesProcessed(state.iterations() * kSize * 2 * sizeof(float));
+}
+
+void BM_ParallelSgemm(benchmark::State& state) {
+  NumThreadsGuard guard(static_cast<int>(state.range(0)));
+  constexpr int64_t kSize = 1024;
+  const std::vector<float> a(kSize * kSize, 1.f);
+  const std::vector<float> b(kSize * kSize, 1.f);
+  std::vector<float> c(kSize * kSize);
+  for (auto _ : state) {
+    c10::gemm(
+        c10::Transpose::NoTrans, c10::Transpose::NoTrans, kSize, kSize, kSize, 1.f, a.data(),
+        kSize, b.data(), kSize, 0.f, c.data(), kSize);
+    benchmark::ClobberMemory();
+  }
+  state.counters["FLOPS"] = benchmark::Counter(
+      static_cast<double>(state.iterations()) * 2 * kSize * kSize * kSize,
+      benchmark::Counter::kIsRate);
+}
+
+// A range just above the grain size with an empty body: what parallel_for
+// costs on top of the work, including the get_num_threads() check.
+void BM_ParallelForOverhead(benchmark::State& state) {
+  NumThreadsGuard guard(static_cast<int>(state.range(0)));
+  for (auto _ : state) {
+    c10::parallel_for(0, 2 * c10::internal::GRAIN_SIZE, c10::internal::GRAIN_SIZE,
+                      [](int64_t begin, int64_t end) { benchmark::DoNotOptimize(begin); });
+  }
+  state.SetItemsProcessed(state.iterations());
+}
+
+} // namespace
+
+BENCHMARK(BM_ParallelCopy)->DenseRange(1, max_threads())->UseRealTime();
+BENCHMARK(BM_ParallelSgemm)->DenseRange(1, max_threads())->UseRealTime();
+BENCHMARK(BM_ParallelForOverhead)->DenseRange(1, max_threads())->UseRealTime();
+
+BENCHMARK_MAIN();
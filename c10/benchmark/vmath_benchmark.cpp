@@ -0,0 +1,81 @@
+#include <c10/util/vmath.h>
+
+#include <benchmark/benchmark.h>
+
+#include <cmath>
+#include <random>
+#include <vector>
+
+// Throughput of the c10::vmath activation functions for float, BFloat16 and
+// Half, against a libm loop over floats.  Arrays hold 64K elements, which
+// stay in L2, so the numbers are those of the math rather than of memory.
+
+namespace {
+
+using c10::BFloat16;
+using c10::Half;
+
+constexpr int64_t kSize = 1 << 16;
+
+template <typename T>
+std::vector<T> random_values(bool positive) {
+  std::mt19937 generator(0);
+  std::uniform_real_distribution<float> distribution(positive ? 0.01f : -8.f, 8.f);
+  std::vector<T> values(kSize);
+  for (auto& value : values) {
+    value = static_cast<T>(distribution(generator));
+  }
+  return values;
+}
+
+template <typename T, void (*fn)(const T*, T*, size_t), bool positive>
+void BM_Vmath(benchmark::State& state) {
+  const std::vector<T> src = random_values<T>(positive);
+  std::vector<T> dst(src.size());
+  for (auto _ : state) {
+    fn(src.data(), dst.data(), src.size());
+    benchmark::ClobberMemory();
+  }
+  state.SetItemsProcessed(state.iterations() * src.size());
+}
+
+float sigmoid(float x) {
+  return 1.f / (1.f + std::exp(-x));
+}
+
+float gelu(float x) {
+  return 0.5f * x * (1.f + std::erf(x * static_cast<float>(M_SQRT1_2)));
+}
+
+#define DEFINE_LIBM_LOOP(name, f)                          \
+  void name(const float* src, float* dst, size_t n) {      \
+    for (size_t i = 0; i < n; i++) {                        \
+      dst[i] = f(src[i]);                                   \
+    }                                                       \
+  }
+DEFINE_LIBM_LOOP(libm_exp, std::exp)
+DEFINE_LIBM_LOOP(libm_log, std::log)
+DEFINE_LIBM_LOOP(libm_tanh, std::tanh)
+DEFINE_LIBM_LOOP(libm_sigmoid, sigmoid)
+DEFINE_LIBM_LOOP(libm_erf, std::erf)
+DEFINE_LIBM_LOOP(libm_gelu, gelu)
+#undef DEFINE_LIBM_LOOP
+
+} // namespace
+
+#define BENCHMARK_VMATH_FN(name, positive)                              \
+  BENCHMARK_TEMPLATE(BM_Vmath, float, &libm_##name, positive);          \
+  BENCHMARK_TEMPLATE(BM_Vmath, float, &c10::vmath::name, positive);     \
+  BENCHMARK_TEMPLATE(BM_Vmath, BFloat16, &c10::vmath::name, positive);  \
+  BENCHMARK_TEMPLATE(BM_Vmath, Half, &c10::vmath::name, positive);
+
+BENCHMARK_VMATH_FN(exp, false)
+BENCHMARK_VMATH_FN(log, true)
+BENCHMARK_VMATH_FN(tanh, false)
+BENCHMARK_VMATH_FN(sigmoid, false)
+BENCHMARK_VMATH_FN(erf, false)
+BENCHMARK_VMATH_FN(gelu, false)
+
+#undef BENCHMARK_VMATH_FN
+
+BENCHMARK_MAIN();
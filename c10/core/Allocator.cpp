@@ -31,7 +31,7 @@ c10::Allocator* GetAllocator(const c10::DeviceType& t){
   return allocator;
 }
 
-void SetAllocator(c10::DeviceType& t, c10::Allocator* allocator, uint8_t priority){
+void SetAllocator(c10::DeviceType t, c10::Allocator* allocator, uint8_t priority){
   // TODO: NOTE: here is a rule, we can only replace original allocator when a new one has a higner priority
   auto DeviceType2Int = static_cast<int>(t);
   if (priority >= allocator_priority[DeviceType2Int]){
@@ -29,6 +29,7 @@ enum class Backend {
   CPU,
   SparseCPU,
   FPGA,
+  Meta,
   Undefined,
   NumOptions
 };
@@ -52,6 +53,8 @@ static inline Backend toDense(Backend b) {
       return Backend::CPU;
     case Backend::FPGA:
       return Backend::FPGA;
+    case Backend::Meta:
+      return Backend::Meta;
     default:
       throw std::runtime_error("Unknown backend");
   }
@@ -64,6 +67,8 @@ static inline Backend dispatchKeyToBackend(DispatchKey t) {
     return Backend::SparseCPU;
   } else if (t == DispatchKey::FPGA) {
     return Backend::FPGA;
+  } else if (t == DispatchKey::Meta) {
+    return Backend::Meta;
   } else if (t == DispatchKey::Undefined) {
     return Backend::Undefined;
   } else {
@@ -79,6 +84,8 @@ static inline DispatchKey backendToDispatchKey(Backend b) {
       return DispatchKey::SparseCPU;
     case Backend::FPGA:
       return DispatchKey::FPGA;
+    case Backend::Meta:
+      return DispatchKey::Meta;
     case Backend::Undefined:
       return DispatchKey::Undefined;
     default:
@@ -94,6 +101,8 @@ static inline DeviceType backendToDeviceType(Backend b) {
       return DeviceType::CPU;
     case Backend::FPGA:
       return DeviceType::FPGA;
+    case Backend::Meta:
+      return DeviceType::Meta;
     case Backend::Undefined:
       AT_ERROR("Undefined backend is not a valid device type");
     default:
@@ -110,6 +119,8 @@ static inline Backend backendToCPU(Backend b) {
     // FIGURE: why convert FPGA backend to CPU backend?
     case Backend::FPGA:
       return Backend::CPU;
+    case Backend::Meta:
+      return Backend::CPU;
     case Backend::Undefined:
       return Backend::Undefined;
     default:
@@ -147,6 +158,8 @@ static inline const char* toString(Backend b) {
       return "SparseCPU";
     case Backend::FPGA:
       return "FPGA";
+    case Backend::Meta:
+      return "Meta";
     default:
       return "UNKNOWN_BACKEND";
   }
@@ -0,0 +1,39 @@
+#include <c10/core/CPUAllocator.h>
+
+#include <cstdlib>
+
+namespace c10 {
+
+static CPUAllocator g_cpu_alloc;
+
+void* alloc_cpu(size_t nbytes) {
+  if (nbytes == 0) {
+    return nullptr;
+  }
+  void* data = nullptr;
+  int err = posix_memalign(&data, gAlignment, nbytes);
+  TORCH_CHECK(err == 0 && data, "DefaultCPUAllocator: not enough memory: you tried to allocate ",
+              nbytes, " bytes.");
+  return data;
+}
+
+void free_cpu(void* data) {
+  free(data);
+}
+
+DataPtr CPUAllocator::allocate(size_t nbytes) const {
+  void* data = alloc_cpu(nbytes);
+  return {data, data, &free_cpu, Device(DeviceType::CPU)};
+}
+
+DeleterFnPtr CPUAllocator::raw_deleter() const {
+  return &free_cpu;
+}
+
+Allocator* GetDefaultCPUAllocator() {
+  return &g_cpu_alloc;
+}
+
+REGISTER_ALLOCATOR(DeviceType::CPU, &g_cpu_alloc)
+
+} // namespace c10
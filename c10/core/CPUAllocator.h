@@ -0,0 +1,24 @@
+#pragma once
+
+#include <c10/core/Allocator.h>
+
+namespace c10 {
+
+// Alignment of CPU allocations: a cache line, which also covers the widest
+// (AVX-512) vector loads in c10/cpu.
+constexpr size_t gAlignment = 64;
+
+// The default allocator of DeviceType::CPU.  Memory comes from the aligned
+// system allocator and is freed by the DataPtr deleter; the data pointer is
+// its own context, so the raw allocate / deallocate interface works too.
+struct C10_API CPUAllocator final : public Allocator {
+  DataPtr allocate(size_t nbytes) const override;
+  DeleterFnPtr raw_deleter() const override;
+};
+
+C10_API void* alloc_cpu(size_t nbytes);
+C10_API void free_cpu(void* data);
+
+C10_API Allocator* GetDefaultCPUAllocator();
+
+} // namespace c10
@@ -0,0 +1,198 @@
+#include <c10/core/ConvOps.h>
+#include <c10/core/MemoryFormatOps.h>
+#include <c10/cpu/ConvKernel.h>
+#include <c10/util/Exception.h>
+
+namespace c10 {
+
+DEFINE_DISPATCH(conv_forward_stub);
+DEFINE_DISPATCH(conv_backward_input_stub);
+DEFINE_DISPATCH(conv_backward_weight_stub);
+
+namespace {
+
+void check_tensor(const char* fn, const char* name, const Tensor& t) {
+  TORCH_CHECK(t.defined(), fn, ": expected a defined ", name);
+  TORCH_CHECK(
+      t.device().type() == DeviceType::CPU, fn, ": expected a CPU ", name, ", got ", t.device());
+  TORCH_CHECK(
+      t.scalar_type() == ScalarType::Float, fn, ": expected a Float ", name, ", got ",
+      t.scalar_type());
+}
+
+// Stores the values of a parameter, one for all spatial dimensions or one
+// per dimension, in the last spatial entries of out
+void expand_param(
+    const char* fn,
+    const char* name,
+    IntArrayRef values,
+    int64_t spatial,
+    int64_t min_value,
+    int64_t* out) {
+  TORCH_CHECK(
+      values.size() == 1 || static_cast<int64_t>(values.size()) == spatial, fn, ": expected ",
+      name, " to have 1 or ", spatial, " values, got ", values.size());
+  for (int64_t d = 0; d < spatial; d++) {
+    const int64_t value = values.size() == 1 ? values[0] : values[d];
+    TORCH_CHECK(
+        value >= min_value, fn, ": ", name, " must be at least ", min_value, ", got ", value);
+    out[3 - spatial + d] = value;
+  }
+}
+
+ConvShape make_shape(
+    const char* fn,
+    IntArrayRef input_sizes,
+    IntArrayRef weight_sizes,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  const int64_t dim = input_sizes.size();
+  TORCH_CHECK(dim == 4 || dim == 5, fn, ": expected a 4-d or 5-d input, got ", dim, " dims");
+  TORCH_CHECK(
+      static_cast<int64_t>(weight_sizes.size()) == dim, fn, ": expected a ", dim,
+      "-d weight, got ", weight_sizes.size(), " dims");
+  for (int64_t d = 0; d < dim; d++) {
+    TORCH_CHECK(
+        input_sizes[d] >= 0, fn, ": input sizes must be non-negative, got ", input_sizes);
+    TORCH_CHECK(
+        d == 0 || weight_sizes[d] > 0, fn, ": weight sizes must be positive, got ", weight_sizes);
+  }
+  TORCH_CHECK(groups > 0, fn, ": groups must be positive, got ", groups);
+  ConvShape s;
+  s.batch = input_sizes[0];
+  s.in_channels = input_sizes[1];
+  s.out_channels = weight_sizes[0];
+  s.groups = groups;
+  TORCH_CHECK(
+      s.out_channels % groups == 0, fn, ": ", s.out_channels,
+      " output channels are not divisible by ", groups, " groups");
+  TORCH_CHECK(
+      weight_sizes[1] * groups == s.in_channels, fn, ": the weight, of sizes ", weight_sizes,
+      ", and ", groups, " groups, expect an input with ", weight_sizes[1] * groups,
+      " channels, got ", s.in_channels);
+  const int64_t spatial = dim - 2;
+  expand_param(fn, "stride", stride, spatial, 1, s.stride);
+  expand_param(fn, "padding", padding, spatial, 0, s.padding);
+  expand_param(fn, "dilation", dilation, spatial, 1, s.dilation);
+  for (int64_t d = 0; d < spatial; d++) {
+    const int64_t i = 3 - spatial + d;
+    s.input[i] = input_sizes[2 + d];
+    s.kernel[i] = weight_sizes[2 + d];
+    const int64_t extent = s.dilation[i] * (s.kernel[i] - 1) + 1;
+    const int64_t padded = s.input[i] + 2 * s.padding[i];
+    TORCH_CHECK(
+        padded >= extent, fn, ": the kernel spans ", extent, " positions of dimension ", 2 + d,
+        ", more than the ", padded, " of the padded input");
+    s.output[i] = (padded - extent) / s.stride[i] + 1;
+  }
+  return s;
+}
+
+MemoryFormat channels_last(int64_t dim) {
+  return dim == 4 ? MemoryFormat::ChannelsLast : MemoryFormat::ChannelsLast3d;
+}
+
+DimVector output_sizes(const ConvShape& s, int64_t dim) {
+  DimVector sizes = {s.batch, s.out_channels};
+  for (int64_t i = 5 - dim; i < 3; i++) {
+    sizes.push_back(s.output[i]);
+  }
+  return sizes;
+}
+
+void check_grad_output(const ConvShape& s, const Tensor& grad_output, int64_t dim) {
+  const DimVector expected = output_sizes(s, dim);
+  TORCH_CHECK(
+      grad_output.sizes() == IntArrayRef(expected), "convolution: expected grad_output of sizes ",
+      IntArrayRef(expected), ", got ", grad_output.sizes());
+}
+
+} // namespace
+
+Tensor convolution(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  check_tensor("convolution", "input", input);
+  check_tensor("convolution", "weight", weight);
+  const ConvShape s =
+      make_shape("convolution", input.sizes(), weight.sizes(), stride, padding, dilation, groups);
+  if (bias.defined()) {
+    check_tensor("convolution", "bias", bias);
+    TORCH_CHECK(
+        bias.dim() == 1 && bias.size(0) == s.out_channels, "convolution: expected a bias of [",
+        s.out_channels, "], got ", bias.sizes());
+  }
+  const MemoryFormat memory_format = channels_last(input.dim());
+  Tensor out = empty(output_sizes(s, input.dim()), ScalarType::Float, memory_format);
+  if (out.numel() == 0) {
+    return out;
+  }
+  const Tensor in = contiguous(input, memory_format);
+  const Tensor w = contiguous(weight, memory_format);
+  const Tensor b = bias.defined() ? contiguous(bias) : Tensor();
+  conv_forward_stub(
+      s, in.data_ptr<float>(), w.data_ptr<float>(), b.defined() ? b.data_ptr<float>() : nullptr,
+      out.data_ptr<float>());
+  return out;
+}
+
+Tensor convolution_backward_input(
+    IntArrayRef input_sizes,
+    const Tensor& grad_output,
+    const Tensor& weight,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  check_tensor("convolution_backward_input", "grad_output", grad_output);
+  check_tensor("convolution_backward_input", "weight", weight);
+  const ConvShape s = make_shape(
+      "convolution_backward_input", input_sizes, weight.sizes(), stride, padding, dilation,
+      groups);
+  check_grad_output(s, grad_output, input_sizes.size());
+  const MemoryFormat memory_format = channels_last(input_sizes.size());
+  Tensor grad_input = empty(input_sizes, ScalarType::Float, memory_format);
+  if (grad_input.numel() == 0) {
+    return grad_input;
+  }
+  const Tensor go = contiguous(grad_output, memory_format);
+  const Tensor w = contiguous(weight, memory_format);
+  conv_backward_input_stub(
+      s, go.data_ptr<float>(), w.data_ptr<float>(), grad_input.data_ptr<float>());
+  return grad_input;
+}
+
+Tensor convolution_backward_weight(
+    IntArrayRef weight_sizes,
+    const Tensor& grad_output,
+    const Tensor& input,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups) {
+  check_tensor("convolution_backward_weight", "grad_output", grad_output);
+  check_tensor("convolution_backward_weight", "input", input);
+  const ConvShape s = make_shape(
+      "convolution_backward_weight", input.sizes(), weight_sizes, stride, padding, dilation,
+      groups);
+  check_grad_output(s, grad_output, input.dim());
+  const MemoryFormat memory_format = channels_last(input.dim());
+  Tensor grad_weight = empty(weight_sizes, ScalarType::Float, memory_format);
+  if (grad_weight.numel() == 0) {
+    return grad_weight;
+  }
+  const Tensor go = contiguous(grad_output, memory_format);
+  const Tensor in = contiguous(input, memory_format);
+  conv_backward_weight_stub(
+      s, go.data_ptr<float>(), in.data_ptr<float>(), grad_weight.data_ptr<float>());
+  return grad_weight;
+}
+
+} // namespace c10
@@ -0,0 +1,69 @@
+#pragma once
+
+#include <c10/core/Tensor.h>
+#include <c10/util/ArrayRef.h>
+
+#include <cstdint>
+
+// 2-d and 3-d convolutions of Float CPU tensors, as in PyTorch:
+//
+//   Tensor y = convolution(x, w, b, /*stride=*/{2}, /*padding=*/{1},
+//                          /*dilation=*/{1}, /*groups=*/1);
+//
+// input is [N, C, H, W] (or [N, C, D, H, W]), weight [OC, C / groups, KH, KW]
+// and bias [OC] or undefined; stride, padding and dilation have one value
+// per spatial dimension, or one for all of them.  Inputs of any strides are
+// accepted, but the kernels work on channels last (NHWC / NDHWC) buffers:
+// other layouts are converted first (see MemoryFormatOps.h), and results
+// are dense in ChannelsLast / ChannelsLast3d.
+//
+// The kernel (c10/cpu/ConvKernel.cpp) picks one of four algorithms from the
+// sizes:
+//  - depthwise (groups == C == OC): per channel, vectorized over the
+//    channels, which are contiguous in NHWC.
+//  - 1 x 1 with stride 1 and no padding: one GEMM (Gemm.h) on the input as
+//    it is, [N * H * W, C] by [C, OC].
+//  - small reductions (KH * KW * C / groups up to 64, e.g. the first layer
+//    of an image model): direct, in register tiles of 4 output positions by
+//    2 vectors of output channels, without copies of the input.
+//  - otherwise im2col + GEMM, a tile of output positions at a time, the
+//    im2col buffers coming from a per-thread Workspace that is kept from one
+//    call to the next.
+// The forward pass runs tiles of output positions of every image on the
+// intra-op thread pool.  The gradients use the same algorithms, except that
+// the direct case goes through im2col + GEMM; their results do not depend on
+// the thread count.
+
+namespace c10 {
+
+C10_API Tensor convolution(
+    const Tensor& input,
+    const Tensor& weight,
+    const Tensor& bias,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups);
+
+// The gradient of the input of a convolution, of sizes input_sizes
+C10_API Tensor convolution_backward_input(
+    IntArrayRef input_sizes,
+    const Tensor& grad_output,
+    const Tensor& weight,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups);
+
+// The gradient of the weight of a convolution, of sizes weight_sizes.  That
+// of the bias is sum(grad_output, {0, 2, 3}) (ReduceOps.h).
+C10_API Tensor convolution_backward_weight(
+    IntArrayRef weight_sizes,
+    const Tensor& grad_output,
+    const Tensor& input,
+    IntArrayRef stride,
+    IntArrayRef padding,
+    IntArrayRef dilation,
+    int64_t groups);
+
+} // namespace c10
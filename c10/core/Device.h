@@ -92,6 +92,11 @@ struct C10_API Device final {
     return type_ == DeviceType::FPGA;
   }
 
+  /// Return true if the device is of Meta type (no data is ever allocated).
+  bool is_meta() const noexcept {
+    return type_ == DeviceType::Meta;
+  }
+
   /// Same string as returned from operator<<.
   std::string str() const;
 
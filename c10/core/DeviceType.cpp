@@ -11,6 +11,8 @@ std::string DeviceTypeName(DeviceType d, bool lower_case) {
       return lower_case ? "cpu" : "CPU";
     case DeviceType::FPGA:
       return lower_case ? "fpga" : "FPGA";
+    case DeviceType::Meta:
+      return lower_case ? "meta" : "META";
     default:
       AT_ERROR(
           "Unknown device: ",
@@ -35,6 +37,7 @@ bool isValidDeviceType(DeviceType d) {
   switch (d) {
     case DeviceType::CPU:
     case DeviceType::FPGA:
+    case DeviceType::Meta:
       return true;
     default:
       return false;
@@ -15,12 +15,14 @@ namespace c10 {
 enum class DeviceType : int16_t {
   CPU = 0,
   FPGA = 1,
-  COMPILE_TIME_MAX_DEVICE_TYPES = 2,
+  Meta = 2, // Storage carries nbytes but no data, see MetaAllocator.h
+  COMPILE_TIME_MAX_DEVICE_TYPES = 3,
   ONLY_FOR_TEST = 11111, // This device type is only for test.
 };
 
 constexpr DeviceType kCPU = DeviceType::CPU;
 constexpr DeviceType kFPGA = DeviceType::FPGA;
+constexpr DeviceType kMeta = DeviceType::Meta;
 
 // define explicit int constant
 constexpr int COMPILE_TIME_MAX_DEVICE_TYPES =
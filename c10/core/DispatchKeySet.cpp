@@ -13,14 +13,12 @@ std::ostream& operator<<(std::ostream& os, DispatchKeySet ts) {
     return os;
   }
   os << "DispatchKeySet(";
-  DispatchKey tid;
   bool first = true;
-  while ((tid = ts.highestPriorityTypeId()) != DispatchKey::Undefined) {
+  for (auto tid : ts) {
     if (!first) {
       os << ", ";
     }
     os << tid;
-    ts = ts.remove(tid);
     first = false;
   }
   os << ")";
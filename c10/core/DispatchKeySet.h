@@ -3,36 +3,61 @@
 #include <c10/core/DispatchKey.h>
 #include <c10/util/Exception.h>
 #include <c10/util/llvmMathExtras.h>
+#include <array>
 #include <iostream>
+#include <iterator>
 #include <string>
+#include <utility>
 
 namespace c10{
 
+namespace detail {
+// kFullAfterMasks[k] is the repr of every key with lower priority than k
+// (the "all keys after k" set used when redispatching).  Entry 0 is the
+// Undefined key, which has nothing after it.
+constexpr uint64_t fullAfterMask(uint8_t k) {
+  return k == 0 ? 0 : (1ULL << (k - 1)) - 1;
+}
+template <size_t... Ks>
+constexpr std::array<uint64_t, sizeof...(Ks)> makeFullAfterMasks(
+    std::index_sequence<Ks...>) {
+  return {{fullAfterMask(static_cast<uint8_t>(Ks))...}};
+}
+constexpr std::array<uint64_t, 64> kFullAfterMasks =
+    makeFullAfterMasks(std::make_index_sequence<64>());
+// FULL_AFTER indexes the table with the key itself, unchecked.
+static_assert(
+    static_cast<size_t>(DispatchKey::NumDispatchKeys) <= kFullAfterMasks.size(),
+    "kFullAfterMasks needs an entry for every DispatchKey");
+} // namespace detail
+
 class DispatchKeySet final{
 private:
   uint64_t repr_ = 0; // a bit represents a Key. Higher bit, higher priority
   // we indeed have a constructor that receive an uint64_t value, but it MUST with RAW
-  DispatchKeySet(uint64_t x):repr_(x) {} // this constructor is use only internal, and the usage applys C++11 features.
+  constexpr DispatchKeySet(uint64_t x):repr_(x) {} // this constructor is use only internal, and the usage applys C++11 features.
 public:
   // TODO: LEARN: use one element's enum to represent different args
   enum Full {FULL};
   enum FullAfter {FULL_AFTER};
   enum Raw {RAW};
-  DispatchKeySet()
+  constexpr DispatchKeySet()
     : repr_(0) {}
-  DispatchKeySet(Full)
+  constexpr DispatchKeySet(Full)
     : repr_(std::numeric_limits<decltype(repr_)>::max()) {}
-  DispatchKeySet(FullAfter, DispatchKey t)
+  constexpr DispatchKeySet(FullAfter, DispatchKey t)
     // LSB after t are OK, but not t itself.
     // TODO: NOTE: take SparseCPU as an example, SparseCPU is actually 2U,
     // 1ULL << (2U -1) = (01)_2 << 1 = (10)_2 = 2  // the -1 in this step means 'After'
     // so repr_ = 2-1 = 1 = CPU
-    : repr_((1ULL << (static_cast<uint8_t>(t) - 1)) - 1) {}
+    // The masks are precomputed in detail::kFullAfterMasks, which also
+    // gives Undefined a well defined (empty) answer.
+    : repr_(detail::kFullAfterMasks[static_cast<uint8_t>(t)]) {}
   // Public version of DispatchKeySet(uint64_t) API; external users
   // must be explicit when they do this!
-  DispatchKeySet(Raw, uint64_t x)
+  constexpr DispatchKeySet(Raw, uint64_t x)
     : repr_(x) {}
-  explicit DispatchKeySet(DispatchKey t)
+  constexpr explicit DispatchKeySet(DispatchKey t)
     : repr_(t == DispatchKey::Undefined
               ? 0
               : 1ULL << (static_cast<uint8_t>(t) - 1)) {}
@@ -48,6 +73,11 @@ public:
     TORCH_INTERNAL_ASSERT(t != DispatchKey::Undefined);
     return static_cast<bool>(repr_ & DispatchKeySet(t).repr_);
   }
+  // Same as has(), minus the Undefined check; for hot dispatch loops where
+  // the key is known to be a real one.  has_unchecked(Undefined) is false.
+  constexpr bool has_unchecked(DispatchKey t) const {
+    return static_cast<bool>(repr_ & DispatchKeySet(t).repr_);
+  }
   // Perform set union
   DispatchKeySet operator|(DispatchKeySet other) const {
     return DispatchKeySet(repr_ | other.repr_);
@@ -79,7 +109,7 @@ public:
   bool empty() const {
     return repr_ == 0;
   }
-  uint64_t raw_repr() { return repr_; }
+  constexpr uint64_t raw_repr() const { return repr_; }
   // Return the type id in this set with the highest priority (i.e.,
   // is the largest in the DispatchKey enum).  Intuitively, this
   // type id is the one that should handle dispatch (assuming there
@@ -91,6 +121,53 @@ public:
     // didn't do it for now.
     return static_cast<DispatchKey>(64 - llvm::countLeadingZeros(repr_));
   }
+
+  // Iterates over the keys in the set from highest to lowest priority, i.e.
+  // in the order dispatch would visit them.  Each step is one
+  // count-leading-zeros plus one bit clear, instead of a has() per possible
+  // DispatchKey.
+  class iterator {
+   public:
+    using value_type = DispatchKey;
+    using difference_type = std::ptrdiff_t;
+    using pointer = const DispatchKey*;
+    using reference = DispatchKey;
+    using iterator_category = std::forward_iterator_tag;
+
+    constexpr explicit iterator(uint64_t remaining) : remaining_(remaining) {}
+
+    DispatchKey operator*() const {
+      return static_cast<DispatchKey>(
+          64 - llvm::countLeadingZeros(remaining_, llvm::ZB_Undefined));
+    }
+    iterator& operator++() {
+      // clear the highest set bit
+      remaining_ &= ~(1ULL << (63 -
+          llvm::countLeadingZeros(remaining_, llvm::ZB_Undefined)));
+      return *this;
+    }
+    iterator operator++(int) {
+      iterator old = *this;
+      ++*this;
+      return old;
+    }
+    constexpr bool operator==(const iterator& other) const {
+      return remaining_ == other.remaining_;
+    }
+    constexpr bool operator!=(const iterator& other) const {
+      return remaining_ != other.remaining_;
+    }
+
+   private:
+    uint64_t remaining_;
+  };
+
+  constexpr iterator begin() const {
+    return iterator(repr_);
+  }
+  constexpr iterator end() const {
+    return iterator(0);
+  }
 };
 // change to ToString for format compatibility
 C10_API std::string toString(DispatchKeySet);
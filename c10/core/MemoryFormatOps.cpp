@@ -0,0 +1,141 @@
+#include <c10/core/MemoryFormatOps.h>
+#include <c10/core/TensorIterator.h>
+#include <c10/cpu/TransposeKernel.h>
+#include <c10/util/Exception.h>
+#include <c10/util/Parallel.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace c10 {
+
+DEFINE_DISPATCH(transpose_stub);
+
+namespace {
+
+// Edge of the square tiles, in elements: a tile of src takes 16 KB at most,
+// so that it and its transpose stay in cache.
+int64_t tile_size(size_t itemsize) {
+  return itemsize <= 4 ? 64 : 32;
+}
+
+// Transposes batch [rows, cols] matrices at src into [cols, rows] ones at dst
+void batched_transpose(
+    const char* fn,
+    const void* src,
+    void* dst,
+    int64_t batch,
+    int64_t rows,
+    int64_t cols,
+    size_t itemsize) {
+  TORCH_CHECK(batch >= 0 && rows >= 0 && cols >= 0, fn, ": sizes must be non-negative");
+  TORCH_CHECK(
+      itemsize >= 1 && itemsize <= 16,
+      fn, ": expected an element size from 1 to 16 bytes, got ", itemsize);
+  const auto* in = static_cast<const char*>(src);
+  auto* out = static_cast<char*>(dst);
+  const int64_t item_bytes = static_cast<int64_t>(itemsize);
+  if (rows == 1 || cols == 1) {
+    // the two layouts are the same
+    parallel_for(0, batch * rows * cols, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+      std::memcpy(out + begin * item_bytes, in + begin * item_bytes, (end - begin) * item_bytes);
+    });
+    return;
+  }
+  const int64_t tile = tile_size(itemsize);
+  const int64_t row_tiles = internal::divup(rows, tile);
+  const int64_t col_tiles = internal::divup(cols, tile);
+  const int64_t matrix_bytes = rows * cols * item_bytes;
+  const int64_t grain_size = internal::divup(internal::GRAIN_SIZE, tile * tile);
+  parallel_for(0, batch * row_tiles * col_tiles, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t t = begin; t < end; t++) {
+      const int64_t j = t % col_tiles * tile;
+      const int64_t i = t / col_tiles % row_tiles * tile;
+      const int64_t b = t / (col_tiles * row_tiles);
+      transpose_stub(
+          in + b * matrix_bytes + (i * cols + j) * item_bytes, cols,
+          out + b * matrix_bytes + (j * rows + i) * item_bytes, rows,
+          std::min(tile, rows - i), std::min(tile, cols - j), itemsize);
+    }
+  });
+}
+
+// Copies self into out, element by element, for any strides
+void copy_strided(const Tensor& self, const Tensor& out) {
+  const size_t itemsize = self.itemsize();
+  TensorIterator iter;
+  iter.add_output(out).add_input(self).build();
+  parallel_for(0, iter.numel(), internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    iter.serial_for_each(
+        [&](char** data, const int64_t* strides, int64_t n) {
+          for (int64_t i = 0; i < n; i++) {
+            std::memcpy(data[0] + i * strides[0], data[1] + i * strides[1], itemsize);
+          }
+        },
+        begin, end);
+  });
+}
+
+} // namespace
+
+void channels_first_to_last(
+    const void* src,
+    void* dst,
+    int64_t batch,
+    int64_t channels,
+    int64_t spatial,
+    size_t itemsize) {
+  batched_transpose("channels_first_to_last", src, dst, batch, channels, spatial, itemsize);
+}
+
+void channels_last_to_first(
+    const void* src,
+    void* dst,
+    int64_t batch,
+    int64_t channels,
+    int64_t spatial,
+    size_t itemsize) {
+  batched_transpose("channels_last_to_first", src, dst, batch, spatial, channels, itemsize);
+}
+
+Tensor contiguous(const Tensor& self, MemoryFormat memory_format) {
+  TORCH_CHECK(self.defined(), "contiguous: expected a defined tensor");
+  TORCH_CHECK(
+      memory_format != MemoryFormat::Preserve,
+      "contiguous: memory format Preserve is not supported");
+  TORCH_CHECK(
+      memory_format != MemoryFormat::ChannelsLast || self.dim() == 4,
+      "contiguous: ChannelsLast needs a 4-d tensor, got ", self.dim(), " dims");
+  TORCH_CHECK(
+      memory_format != MemoryFormat::ChannelsLast3d || self.dim() == 5,
+      "contiguous: ChannelsLast3d needs a 5-d tensor, got ", self.dim(), " dims");
+  if (self.is_contiguous(memory_format)) {
+    return self;
+  }
+  TORCH_CHECK(
+      self.device().type() == DeviceType::CPU,
+      "contiguous: expected a CPU tensor, got ", self.device());
+  Tensor out = empty(self.sizes(), self.scalar_type(), memory_format);
+  const int64_t ndim = self.dim();
+  if ((ndim == 4 || ndim == 5) && out.numel() > 0) {
+    const MemoryFormat channels_last =
+        ndim == 4 ? MemoryFormat::ChannelsLast : MemoryFormat::ChannelsLast3d;
+    const int64_t batch = self.size(0);
+    const int64_t channels = self.size(1);
+    const int64_t spatial = self.numel() / (batch * channels);
+    if (memory_format == channels_last && self.is_contiguous()) {
+      channels_first_to_last(
+          self.data_ptr(), out.data_ptr(), batch, channels, spatial, self.itemsize());
+      return out;
+    }
+    if (memory_format == MemoryFormat::Contiguous && self.is_contiguous(channels_last)) {
+      channels_last_to_first(
+          self.data_ptr(), out.data_ptr(), batch, channels, spatial, self.itemsize());
+      return out;
+    }
+  }
+  copy_strided(self, out);
+  return out;
+}
+
+} // namespace c10
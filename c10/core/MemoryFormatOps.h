@@ -0,0 +1,49 @@
+#pragma once
+
+#include <c10/core/MemoryFormat.h>
+#include <c10/core/Tensor.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// Conversions between the contiguous (NCHW / NCDHW) and the channels last
+// (NHWC / NDHWC) layouts.
+//
+// Per batch, NCHW to NHWC transposes a [channels, spatial] matrix into a
+// [spatial, channels] one, spatial being H * W (or D * H * W).  The matrices
+// are cut into cache-sized tiles that run on the intra-op thread pool
+// (c10/util/Parallel.h), and each tile is transposed in SIMD registers
+// (c10/cpu/TransposeKernel.cpp): 8 x 8 tiles for 1, 2 and 4-byte elements and
+// 4 x 4 tiles for 8-byte ones under AVX2 / AVX-512.  Other element sizes, up
+// to 16 bytes, move as opaque bytes.  A single channel or a single spatial
+// position makes the layouts identical and the conversion a plain copy.
+
+namespace c10 {
+
+// src is [batch, channels, spatial] and dst [batch, spatial, channels], both
+// dense, in elements of itemsize bytes.
+C10_API void channels_first_to_last(
+    const void* src,
+    void* dst,
+    int64_t batch,
+    int64_t channels,
+    int64_t spatial,
+    size_t itemsize);
+
+// The reverse: src is [batch, spatial, channels], dst [batch, channels, spatial].
+C10_API void channels_last_to_first(
+    const void* src,
+    void* dst,
+    int64_t batch,
+    int64_t channels,
+    int64_t spatial,
+    size_t itemsize);
+
+// self if it is already dense in memory_format, else a copy that is.
+// Contiguous <-> ChannelsLast(3d) goes through the kernels above; other
+// strides are copied element by element.
+C10_API Tensor contiguous(
+    const Tensor& self,
+    MemoryFormat memory_format = MemoryFormat::Contiguous);
+
+} // namespace c10
@@ -0,0 +1,60 @@
+#include <c10/core/MetaAllocator.h>
+
+namespace c10 {
+
+static MetaAllocator g_meta_alloc;
+
+// TODO: NOTE: the context is not a real pointer, it is the allocation size.
+// UniqueVoidPtr calls the deleter whenever the context is non-null, which is
+// exactly the case nbytes > 0; zero sized allocations have nothing to return.
+void MetaAllocator::Delete(void* ctx) {
+  auto nbytes = static_cast<int64_t>(reinterpret_cast<uintptr_t>(ctx));
+  g_meta_alloc.allocated_bytes_.fetch_sub(nbytes, std::memory_order_relaxed);
+}
+
+DataPtr MetaAllocator::allocate(size_t nbytes) const {
+  num_allocs_.fetch_add(1, std::memory_order_relaxed);
+  auto now = allocated_bytes_.fetch_add(
+      static_cast<int64_t>(nbytes), std::memory_order_relaxed) +
+      static_cast<int64_t>(nbytes);
+  auto peak = peak_bytes_.load(std::memory_order_relaxed);
+  while (now > peak &&
+         !peak_bytes_.compare_exchange_weak(
+             peak, now, std::memory_order_relaxed)) {
+  }
+  return {nullptr,
+          reinterpret_cast<void*>(static_cast<uintptr_t>(nbytes)),
+          &MetaAllocator::Delete,
+          Device(DeviceType::Meta)};
+}
+
+MetaMemoryStats MetaAllocator::stats() const {
+  MetaMemoryStats s;
+  s.allocated_bytes = allocated_bytes_.load(std::memory_order_relaxed);
+  s.peak_bytes = peak_bytes_.load(std::memory_order_relaxed);
+  s.num_allocs = num_allocs_.load(std::memory_order_relaxed);
+  return s;
+}
+
+void MetaAllocator::reset_peak_stats() {
+  peak_bytes_.store(
+      allocated_bytes_.load(std::memory_order_relaxed),
+      std::memory_order_relaxed);
+  num_allocs_.store(0, std::memory_order_relaxed);
+}
+
+MetaAllocator* GetMetaAllocator() {
+  return &g_meta_alloc;
+}
+
+MetaMemoryStats getMetaMemoryStats() {
+  return g_meta_alloc.stats();
+}
+
+void resetPeakMetaMemoryStats() {
+  g_meta_alloc.reset_peak_stats();
+}
+
+REGISTER_ALLOCATOR(DeviceType::Meta, &g_meta_alloc)
+
+} // namespace c10
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+#include <c10/core/Allocator.h>
+
+namespace c10 {
+
+// The Meta allocator backs storages of DeviceType::Meta.  It never touches
+// memory: allocate(n) hands out a DataPtr whose data is nullptr, and the
+// StorageImpl built on top of it records size_bytes as usual, so shapes,
+// dtypes and nbytes() all behave exactly like they would on CPU.
+//
+// Since nothing is allocated, the allocator is free to keep exact byte
+// accounting instead.  The size of every allocation is stashed in the
+// DataPtr context (the data pointer stays null), and the context deleter
+// gives the bytes back when the storage dies.  A dry run of an op under Meta
+// then looks like:
+//
+//   resetPeakMetaMemoryStats();
+//   ... run op on meta tensors ...
+//   auto stats = getMetaMemoryStats();  // stats.peak_bytes is the op's peak
+//
+// NB: a meta DataPtr with non-zero size converts to true (its context is
+// non-null) even though get() returns nullptr; never dereference it.
+
+struct MetaMemoryStats {
+  // Bytes currently held by live meta storages
+  int64_t allocated_bytes = 0;
+  // High water mark of allocated_bytes since the last reset
+  int64_t peak_bytes = 0;
+  // Number of allocate() calls since the last reset
+  int64_t num_allocs = 0;
+};
+
+struct C10_API MetaAllocator final : public Allocator {
+  DataPtr allocate(size_t nbytes) const override;
+
+  MetaMemoryStats stats() const;
+  // Sets the peak back to the current allocated_bytes and zeroes num_allocs.
+  void reset_peak_stats();
+
+ private:
+  static void Delete(void* ctx);
+
+  mutable std::atomic<int64_t> allocated_bytes_{0};
+  mutable std::atomic<int64_t> peak_bytes_{0};
+  mutable std::atomic<int64_t> num_allocs_{0};
+};
+
+C10_API MetaAllocator* GetMetaAllocator();
+
+// Convenience wrappers around GetMetaAllocator()
+C10_API MetaMemoryStats getMetaMemoryStats();
+C10_API void resetPeakMetaMemoryStats();
+
+} // namespace c10
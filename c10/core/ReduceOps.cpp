@@ -0,0 +1,230 @@
+#include <c10/core/ReduceOps.h>
+#include <c10/cpu/ReduceKernel.h>
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <cmath>
+
+namespace c10 {
+
+DEFINE_DISPATCH(reduce_stub);
+
+namespace {
+
+bool is_supported_dtype(ScalarType dtype) {
+  switch (dtype) {
+#define SUPPORTED_CASE(type, name) \
+    case ScalarType::name:         \
+      return true;
+    AT_FORALL_SCALAR_TYPES_AND2(Half, BFloat16, SUPPORTED_CASE)
+#undef SUPPORTED_CASE
+    default:
+      return false;
+  }
+}
+
+// Which dimensions of self are reduced; none listed means all of them
+std::vector<bool> reduced_dims(const char* fn, const Tensor& self, IntArrayRef dims) {
+  TORCH_CHECK(self.defined(), fn, ": expected a defined tensor");
+  const int64_t ndim = self.dim();
+  std::vector<bool> reduced(static_cast<size_t>(ndim), dims.empty());
+  for (int64_t dim : dims) {
+    const int64_t d = maybe_wrap_dim(dim, ndim);
+    if (ndim == 0) {
+      continue; // a scalar reduces over dim -1 / 0 to itself
+    }
+    TORCH_CHECK(!reduced[d], fn, ": dim ", d, " appears multiple times in the list of dims");
+    reduced[d] = true;
+  }
+  return reduced;
+}
+
+struct Dim {
+  int64_t size;
+  int64_t in_stride;
+  int64_t out_stride;
+};
+
+// Sorts dims from the smallest input stride to the largest (stably, so that
+// ties keep their order) unless in_order, then merges the dimensions that
+// are contiguous with each other, in the output too if with_out.
+void coalesce(
+    std::vector<Dim>& dims,
+    bool in_order,
+    bool with_out,
+    DimVector* sizes,
+    DimVector* in_strides,
+    DimVector* out_strides) {
+  if (!in_order) {
+    std::stable_sort(dims.begin(), dims.end(), [](const Dim& a, const Dim& b) {
+      return a.in_stride < b.in_stride;
+    });
+  }
+  for (const Dim& d : dims) {
+    if (!sizes->empty()) {
+      const size_t last = sizes->size() - 1;
+      const bool in_contiguous = (*sizes)[last] * (*in_strides)[last] == d.in_stride;
+      const bool out_contiguous =
+          !with_out || (*sizes)[last] * (*out_strides)[last] == d.out_stride;
+      if (in_contiguous && out_contiguous) {
+        (*sizes)[last] *= d.size;
+        continue;
+      }
+    }
+    sizes->push_back(d.size);
+    in_strides->push_back(d.in_stride);
+    if (with_out) {
+      out_strides->push_back(d.out_stride);
+    }
+  }
+}
+
+// Runs params.op over the dimensions of self marked in reduced, into a new
+// tensor of out_dtype.  A Sum with divisor 0 is a mean.
+Tensor reduce(
+    const char* fn,
+    const Tensor& self,
+    const std::vector<bool>& reduced,
+    bool keepdim,
+    ScalarType out_dtype,
+    ReduceParams params,
+    bool allow_empty) {
+  TORCH_CHECK(
+      self.device().type() == DeviceType::CPU, fn, ": expected a CPU tensor, got ", self.device());
+  TORCH_CHECK(
+      is_supported_dtype(self.scalar_type()), fn, ": unsupported dtype ", self.scalar_type());
+
+  const int64_t ndim = self.dim();
+  DimVector out_sizes;
+  DimVector keepdim_sizes;
+  int64_t rnumel = 1;
+  for (int64_t d = 0; d < ndim; d++) {
+    if (reduced[d]) {
+      rnumel *= self.size(d);
+      keepdim_sizes.push_back(1);
+      if (keepdim) {
+        out_sizes.push_back(1);
+      }
+    } else {
+      keepdim_sizes.push_back(self.size(d));
+      out_sizes.push_back(self.size(d));
+    }
+  }
+  Tensor out = empty(out_sizes, out_dtype);
+  if (out.numel() == 0) {
+    return out;
+  }
+  TORCH_CHECK(
+      allow_empty || rnumel > 0,
+      fn, ": cannot reduce over zero elements, the reduction has no identity");
+
+  // Output strides of the kept dimensions, as if keepdim
+  DimVector keepdim_strides(static_cast<size_t>(ndim), 1);
+  for (int64_t d = ndim - 2; d >= 0; d--) {
+    keepdim_strides[d] = keepdim_strides[d + 1] * keepdim_sizes[d + 1];
+  }
+
+  std::vector<Dim> kept;
+  std::vector<Dim> reducing;
+  for (int64_t d = 0; d < ndim; d++) {
+    if (self.size(d) == 1) {
+      continue;
+    }
+    const Dim dim{self.size(d), self.stride(d), keepdim_strides[d]};
+    (reduced[d] ? reducing : kept).push_back(dim);
+  }
+  // argmax numbers the reduced elements in row-major order, so it visits
+  // them in that order, last dimension fastest
+  const bool logical_order = params.op == ReduceOp::ArgMax;
+  if (logical_order) {
+    std::reverse(reducing.begin(), reducing.end());
+  }
+
+  ReduceGeometry g;
+  g.in = self.data_ptr();
+  g.in_dtype = self.scalar_type();
+  g.out = out.data_ptr();
+  g.out_dtype = out_dtype;
+  coalesce(kept, false, true, &g.outer_sizes, &g.outer_in_strides, &g.outer_out_strides);
+  coalesce(reducing, logical_order, false, &g.reduce_sizes, &g.reduce_strides, nullptr);
+  if (params.op == ReduceOp::Sum && params.divisor == 0) {
+    params.divisor = static_cast<double>(rnumel); // mean
+  }
+  reduce_stub(g, params);
+  return out;
+}
+
+ScalarType sum_dtype(ScalarType dtype) {
+  return isIntegralType(dtype, /*includeBool=*/true) ? ScalarType::Long : dtype;
+}
+
+void check_floating(const char* fn, const Tensor& self) {
+  TORCH_CHECK(
+      self.defined() && isFloatingType(self.scalar_type()),
+      fn, ": expected a floating point tensor, got ",
+      self.defined() ? toString(self.scalar_type()) : "an undefined tensor");
+}
+
+ReduceParams params_of(ReduceOp op) {
+  ReduceParams params;
+  params.op = op;
+  return params;
+}
+
+} // namespace
+
+Tensor sum(const Tensor& self, IntArrayRef dims, bool keepdim) {
+  const auto reduced = reduced_dims("sum", self, dims);
+  return reduce(
+      "sum", self, reduced, keepdim, sum_dtype(self.scalar_type()), params_of(ReduceOp::Sum), true);
+}
+
+Tensor mean(const Tensor& self, IntArrayRef dims, bool keepdim) {
+  check_floating("mean", self);
+  ReduceParams params = params_of(ReduceOp::Sum);
+  params.divisor = 0; // the number of reduced elements
+  return reduce(
+      "mean", self, reduced_dims("mean", self, dims), keepdim, self.scalar_type(), params, true);
+}
+
+Tensor prod(const Tensor& self, IntArrayRef dims, bool keepdim) {
+  const auto reduced = reduced_dims("prod", self, dims);
+  return reduce(
+      "prod", self, reduced, keepdim, sum_dtype(self.scalar_type()), params_of(ReduceOp::Prod),
+      true);
+}
+
+Tensor amax(const Tensor& self, IntArrayRef dims, bool keepdim) {
+  const auto reduced = reduced_dims("amax", self, dims);
+  return reduce(
+      "amax", self, reduced, keepdim, self.scalar_type(), params_of(ReduceOp::Max), false);
+}
+
+Tensor amin(const Tensor& self, IntArrayRef dims, bool keepdim) {
+  const auto reduced = reduced_dims("amin", self, dims);
+  return reduce(
+      "amin", self, reduced, keepdim, self.scalar_type(), params_of(ReduceOp::Min), false);
+}
+
+Tensor argmax(const Tensor& self, c10::optional<int64_t> dim, bool keepdim) {
+  std::vector<bool> reduced;
+  if (dim.has_value()) {
+    reduced = reduced_dims("argmax", self, {*dim});
+  } else {
+    reduced = reduced_dims("argmax", self, {});
+  }
+  return reduce(
+      "argmax", self, reduced, keepdim, ScalarType::Long, params_of(ReduceOp::ArgMax), false);
+}
+
+Tensor norm(const Tensor& self, double p, IntArrayRef dims, bool keepdim) {
+  check_floating("norm", self);
+  TORCH_CHECK(p >= 0 || std::isinf(p), "norm: expected a non-negative or infinite p, got ", p);
+  ReduceParams params = params_of(ReduceOp::Norm);
+  params.p = p;
+  return reduce(
+      "norm", self, reduced_dims("norm", self, dims), keepdim, self.scalar_type(), params,
+      !std::isinf(p));
+}
+
+} // namespace c10
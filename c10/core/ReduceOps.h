@@ -0,0 +1,60 @@
+#pragma once
+
+#include <c10/core/Tensor.h>
+#include <c10/util/ArrayRef.h>
+#include <c10/util/Optional.h>
+
+// Reductions of CPU tensors over any set of dimensions:
+//
+//   Tensor s = sum(x, {0, 2});               // sizes [x.size(1)]
+//   Tensor m = mean(x, {-1}, /*keepdim=*/true);
+//
+// dims may be negative and an empty list reduces every dimension.  The
+// reduced dimensions are removed from the result, or kept with size 1 with
+// keepdim.  The input may have any strides; the result is a new contiguous
+// tensor.
+//
+// Every dtype of AT_FORALL_SCALAR_TYPES_AND2(Half, BFloat16) is supported.
+// Half and BFloat16 accumulate in float and integers in int64_t; sum and prod
+// of integers return Long.  Sums (sum, mean and the norms that add) use a
+// cascade of partial sums, so that the rounding error grows with the log of
+// the number of elements: summing 2e7 float ones gives exactly 2e7, where a
+// running float sum stops at 2^24.
+//
+// The kernel (c10/cpu/ReduceKernel.cpp) is vectorized both when the reduced
+// elements are contiguous (inner reductions) and when consecutive outputs are
+// (outer reductions, e.g. summing the rows of a matrix), and runs on the
+// intra-op thread pool: across outputs, or when there are few outputs of
+// many elements, in two passes that reduce chunks of each output in parallel
+// and then combine the chunks' results in order.  The chunks don't depend on
+// the number of threads, so neither do the results.
+//
+// amax, amin and argmax propagate NaN: the result is NaN, or the index of the
+// first NaN, if any element is.  They reject empty reductions; the sum of
+// none is 0, the product 1 and the mean NaN.
+
+namespace c10 {
+
+C10_API Tensor sum(const Tensor& self, IntArrayRef dims = {}, bool keepdim = false);
+
+// Floating point dtypes only
+C10_API Tensor mean(const Tensor& self, IntArrayRef dims = {}, bool keepdim = false);
+
+C10_API Tensor prod(const Tensor& self, IntArrayRef dims = {}, bool keepdim = false);
+
+C10_API Tensor amax(const Tensor& self, IntArrayRef dims = {}, bool keepdim = false);
+
+C10_API Tensor amin(const Tensor& self, IntArrayRef dims = {}, bool keepdim = false);
+
+// The Long index of the first maximum along dim, or, without dim, in the
+// row-major order of all the elements.
+C10_API Tensor argmax(
+    const Tensor& self,
+    c10::optional<int64_t> dim = c10::nullopt,
+    bool keepdim = false);
+
+// (sum |x|^p)^(1/p), the number of non-zero elements for p = 0 and
+// max |x| / min |x| for p = +inf / -inf.  Floating point dtypes only.
+C10_API Tensor norm(const Tensor& self, double p = 2, IntArrayRef dims = {}, bool keepdim = false);
+
+} // namespace c10
@@ -60,6 +60,15 @@ public:
   StorageImpl(const StorageImpl&) = delete;
   ~StorageImpl() = default;
 
+  // Heap blocks of co_allocate(), so that a new tensor's TensorImpl and
+  // storage can share one (see empty() in Tensor.cpp)
+  static void* operator new(size_t nbytes) {
+    return c10::co_allocate(nbytes);
+  }
+  static void operator delete(void* ptr) noexcept {
+    c10::co_deallocate(ptr);
+  }
+
   template<typename T>
   inline T* data() const{
     return static_cast<T*>(this->data_ptr_.get());
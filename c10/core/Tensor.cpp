@@ -0,0 +1,62 @@
+#include <c10/core/Tensor.h>
+
+namespace c10 {
+
+namespace {
+
+c10::intrusive_ptr<TensorImpl> make_tensor_impl(ScalarType dtype, Device device) {
+  Allocator* allocator = GetAllocator(device.type());
+  // one heap block for the storage and the TensorImpl; the storage starts out
+  // without data, and resize_storage_if_needed() makes the data allocation
+  // once the shape is known
+  const size_t nbytes[] = {sizeof(StorageImpl), sizeof(TensorImpl)};
+  void* slots[2];
+  co_allocate(nbytes, slots, 2);
+  c10::intrusive_ptr<StorageImpl> storage;
+  try {
+    storage = c10::intrusive_ptr<StorageImpl>::make_in_place(
+        slots[0], StorageImpl::use_byte_size_t(), 0, DataPtr(nullptr, device), allocator,
+        /*resizable=*/true);
+  } catch (...) {
+    co_deallocate(slots[0]);
+    co_deallocate(slots[1]);
+    throw;
+  }
+  try {
+    return c10::intrusive_ptr<TensorImpl>::make_in_place(
+        slots[1], std::move(storage), DispatchKeySet(computeDispatchKey(device.type())), dtype);
+  } catch (...) {
+    // the storage frees its own slot
+    co_deallocate(slots[1]);
+    throw;
+  }
+}
+
+} // namespace
+
+Tensor Tensor::as_strided(IntArrayRef sizes, IntArrayRef strides, int64_t storage_offset) const {
+  auto impl = c10::make_intrusive<TensorImpl>(impl_->storage(), impl_->key_set(), impl_->dtype());
+  impl->set_sizes_and_strides(sizes, strides);
+  impl->set_storage_offset(storage_offset);
+  TORCH_CHECK(
+      impl->storage_nbytes_needed() <= impl->storage()->nbytes(),
+      "as_strided: sizes ", sizes, ", strides ", strides, " and storage offset ", storage_offset,
+      " reach past the end of a storage of ", impl->storage()->nbytes(), " bytes");
+  return Tensor(std::move(impl));
+}
+
+Tensor empty(IntArrayRef sizes, ScalarType dtype, MemoryFormat memory_format, Device device) {
+  auto impl = make_tensor_impl(dtype, device);
+  impl->set_sizes_contiguous(sizes, memory_format);
+  impl->resize_storage_if_needed();
+  return Tensor(std::move(impl));
+}
+
+Tensor empty_strided(IntArrayRef sizes, IntArrayRef strides, ScalarType dtype, Device device) {
+  auto impl = make_tensor_impl(dtype, device);
+  impl->set_sizes_and_strides(sizes, strides);
+  impl->resize_storage_if_needed();
+  return Tensor(std::move(impl));
+}
+
+} // namespace c10
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <c10/core/TensorImpl.h>
+
+namespace c10 {
+
+// Tensor is a reference counted handle to a TensorImpl: copying a Tensor
+// shares the TensorImpl (and so its sizes, strides and storage).  A default
+// constructed Tensor is undefined and has no TensorImpl.
+class C10_API Tensor {
+ public:
+  Tensor() = default;
+  explicit Tensor(c10::intrusive_ptr<TensorImpl> impl) : impl_(std::move(impl)) {}
+
+  bool defined() const {
+    return static_cast<bool>(impl_);
+  }
+
+  TensorImpl* unsafeGetTensorImpl() const {
+    return impl_.get();
+  }
+  const c10::intrusive_ptr<TensorImpl>& getIntrusivePtr() const {
+    return impl_;
+  }
+  size_t use_count() const {
+    return impl_.use_count();
+  }
+  bool is_same(const Tensor& other) const {
+    return impl_ == other.impl_;
+  }
+
+  IntArrayRef sizes() const {
+    return impl_->sizes();
+  }
+  IntArrayRef strides() const {
+    return impl_->strides();
+  }
+  int64_t dim() const {
+    return impl_->dim();
+  }
+  int64_t size(int64_t d) const {
+    return impl_->size(d);
+  }
+  int64_t stride(int64_t d) const {
+    return impl_->stride(d);
+  }
+  int64_t numel() const {
+    return impl_->numel();
+  }
+  ScalarType scalar_type() const {
+    return impl_->dtype();
+  }
+  size_t itemsize() const {
+    return impl_->itemsize();
+  }
+  size_t nbytes() const {
+    return impl_->nbytes();
+  }
+  Device device() const {
+    return impl_->device();
+  }
+  DispatchKeySet key_set() const {
+    return impl_->key_set();
+  }
+  int64_t storage_offset() const {
+    return impl_->storage_offset();
+  }
+  bool is_alias_of(const Tensor& other) const {
+    return impl_->storage() == other.impl_->storage();
+  }
+  bool is_contiguous(MemoryFormat memory_format = MemoryFormat::Contiguous) const {
+    return impl_->is_contiguous(memory_format);
+  }
+  MemoryFormat suggest_memory_format() const {
+    return impl_->suggest_memory_format();
+  }
+
+  void* data_ptr() const {
+    return impl_->data();
+  }
+  template <typename T>
+  T* data_ptr() const {
+    return impl_->data<T>();
+  }
+
+  // A view of the same storage with other sizes, strides and offset
+  Tensor as_strided(IntArrayRef sizes, IntArrayRef strides, int64_t storage_offset) const;
+  Tensor as_strided(IntArrayRef sizes, IntArrayRef strides) const {
+    return as_strided(sizes, strides, storage_offset());
+  }
+
+ private:
+  c10::intrusive_ptr<TensorImpl> impl_;
+};
+
+// Uninitialized dense tensors on device (CPU or Meta), allocated with the
+// device's registered allocator.
+C10_API Tensor empty(
+    IntArrayRef sizes,
+    ScalarType dtype,
+    MemoryFormat memory_format = MemoryFormat::Contiguous,
+    Device device = Device(DeviceType::CPU));
+
+C10_API Tensor empty_strided(
+    IntArrayRef sizes,
+    IntArrayRef strides,
+    ScalarType dtype,
+    Device device = Device(DeviceType::CPU));
+
+} // namespace c10
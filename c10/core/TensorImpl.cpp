@@ -0,0 +1,201 @@
+#include <c10/core/TensorImpl.h>
+#include <c10/util/llvmMathExtras.h>
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+
+namespace c10 {
+
+DispatchKey computeDispatchKey(DeviceType device) {
+  switch (device) {
+    case DeviceType::CPU:
+      return DispatchKey::CPU;
+    case DeviceType::FPGA:
+      return DispatchKey::FPGA;
+    case DeviceType::Meta:
+      return DispatchKey::Meta;
+    default:
+      TORCH_CHECK(false, "No dispatch key for device type ", device);
+  }
+}
+
+TensorImpl::TensorImpl(
+    c10::intrusive_ptr<StorageImpl> storage,
+    DispatchKeySet key_set,
+    ScalarType dtype)
+    : storage_(std::move(storage)), key_set_(key_set), dtype_(dtype) {
+  // starts out as a 0-d tensor of one element, which the default flags
+  // describe
+  TORCH_INTERNAL_ASSERT(storage_, "TensorImpl needs a storage");
+}
+
+void TensorImpl::set_sizes_contiguous(IntArrayRef new_size, MemoryFormat memory_format) {
+  for (int64_t s : new_size) {
+    TORCH_CHECK(s >= 0, "Trying to create tensor with negative dimension ", s, ": ", new_size);
+  }
+  sizes_.assign(new_size.begin(), new_size.end());
+  strides_.resize(sizes_.size());
+  switch (memory_format) {
+    case MemoryFormat::ChannelsLast: {
+      const auto strides = get_channels_last_strides_2d(new_size);
+      std::copy(strides.begin(), strides.end(), strides_.begin());
+      break;
+    }
+    case MemoryFormat::ChannelsLast3d: {
+      const auto strides = get_channels_last_strides_3d(new_size);
+      std::copy(strides.begin(), strides.end(), strides_.begin());
+      break;
+    }
+    case MemoryFormat::Contiguous: {
+      int64_t stride = 1;
+      for (int64_t d = dim() - 1; d >= 0; d--) {
+        strides_[d] = stride;
+        stride *= std::max<int64_t>(sizes_[d], 1);
+      }
+      break;
+    }
+    default:
+      TORCH_CHECK(false, "set_sizes_contiguous: unsupported memory format ", memory_format);
+  }
+  refresh_numel();
+  refresh_contiguous();
+}
+
+void TensorImpl::set_sizes_and_strides(IntArrayRef new_size, IntArrayRef new_stride) {
+  TORCH_CHECK(
+      new_size.size() == new_stride.size(),
+      "dimensionality of sizes (", new_size.size(),
+      ") must match dimensionality of strides (", new_stride.size(), ")");
+  for (int64_t s : new_size) {
+    TORCH_CHECK(s >= 0, "Trying to create tensor with negative dimension ", s, ": ", new_size);
+  }
+  for (int64_t s : new_stride) {
+    TORCH_CHECK(s >= 0, "Negative strides are not supported, got ", new_stride);
+  }
+  sizes_.assign(new_size.begin(), new_size.end());
+  strides_.assign(new_stride.begin(), new_stride.end());
+  refresh_numel();
+  refresh_contiguous();
+}
+
+size_t TensorImpl::storage_nbytes_needed() const {
+  if (numel_ == 0) {
+    return 0;
+  }
+  // the largest element offset this view can reach, plus one; sizes, strides
+  // and the offset are non-negative, so unsigned saturating math catches
+  // every overflow
+  bool overflowed = false;
+  size_t extent = static_cast<size_t>(storage_offset_) + 1;
+  for (int64_t d = 0; d < dim() && !overflowed; d++) {
+    extent = llvm::SaturatingMultiplyAdd(
+        static_cast<size_t>(sizes_[d] - 1), static_cast<size_t>(strides_[d]), extent, &overflowed);
+  }
+  size_t nbytes = 0;
+  if (!overflowed) {
+    nbytes = llvm::SaturatingMultiply(extent, itemsize(), &overflowed);
+  }
+  TORCH_CHECK(
+      !overflowed,
+      "storage size overflows size_t for sizes ", sizes(), ", strides ", strides(),
+      " and storage offset ", storage_offset_);
+  return nbytes;
+}
+
+void TensorImpl::resize_storage_if_needed() {
+  const size_t needed = storage_nbytes_needed();
+  if (needed <= storage_->nbytes()) {
+    return;
+  }
+  TORCH_CHECK(storage_->resizable(), "Trying to resize storage that is not resizable");
+  DataPtr new_data = storage_->allocator()->allocate(needed);
+  if (storage_->data() != nullptr && new_data.get() != nullptr) {
+    std::memcpy(new_data.get(), storage_->data(), storage_->nbytes());
+  }
+  storage_->set_data_ptr(std::move(new_data));
+  storage_->set_nbytes(needed);
+}
+
+void TensorImpl::refresh_numel() {
+  int64_t n = 1;
+  for (int64_t s : sizes_) {
+    TORCH_CHECK(
+        s == 0 || n <= std::numeric_limits<int64_t>::max() / s,
+        "numel overflows int64_t for sizes ", sizes());
+    n *= s;
+  }
+  numel_ = n;
+}
+
+void TensorImpl::refresh_contiguous() {
+  is_contiguous_ = compute_contiguous();
+  is_channels_last_contiguous_ = false;
+  is_channels_last_3d_contiguous_ = false;
+  is_channels_last_ = false;
+  is_channels_last_3d_ = false;
+  switch (dim()) {
+    case 4:
+      is_channels_last_contiguous_ = compute_channels_last_contiguous_2d();
+      is_channels_last_ = is_channels_last_strides_2d(sizes_, strides_);
+      break;
+    case 5:
+      is_channels_last_3d_contiguous_ = compute_channels_last_contiguous_3d();
+      is_channels_last_3d_ = is_channels_last_strides_3d(sizes_, strides_);
+      break;
+    default:
+      break;
+  }
+}
+
+// Strides of size-1 dimensions don't matter, and empty tensors are
+// contiguous whatever their strides.
+bool TensorImpl::compute_contiguous() const {
+  if (numel_ == 0) {
+    return true;
+  }
+  int64_t expected = 1;
+  for (int64_t d = dim() - 1; d >= 0; d--) {
+    if (sizes_[d] != 1) {
+      if (strides_[d] != expected) {
+        return false;
+      }
+      expected *= sizes_[d];
+    }
+  }
+  return true;
+}
+
+bool TensorImpl::compute_channels_last_contiguous_2d() const {
+  if (numel_ == 0) {
+    return true;
+  }
+  int64_t expected = 1;
+  for (int64_t d : {1, 3, 2, 0}) {
+    if (sizes_[d] != 1) {
+      if (strides_[d] != expected) {
+        return false;
+      }
+      expected *= sizes_[d];
+    }
+  }
+  return true;
+}
+
+bool TensorImpl::compute_channels_last_contiguous_3d() const {
+  if (numel_ == 0) {
+    return true;
+  }
+  int64_t expected = 1;
+  for (int64_t d : {1, 4, 3, 2, 0}) {
+    if (sizes_[d] != 1) {
+      if (strides_[d] != expected) {
+        return false;
+      }
+      expected *= sizes_[d];
+    }
+  }
+  return true;
+}
+
+} // namespace c10
@@ -0,0 +1,206 @@
+#pragma once
+
+#include <c10/core/Allocator.h>
+#include <c10/core/DispatchKeySet.h>
+#include <c10/core/MemoryFormat.h>
+#include <c10/core/ScalarType.h>
+#include <c10/core/StorageImpl.h>
+#include <c10/util/ArrayRef.h>
+#include <c10/util/Exception.h>
+#include <c10/util/SmallVector.h>
+#include <c10/util/intrusive_ptr.h>
+
+namespace c10 {
+
+// Sizes and strides of tensors up to this rank live inline in the TensorImpl.
+constexpr size_t kDimVectorStaticSize = 5;
+using DimVector = SmallVector<int64_t, kDimVectorStaticSize>;
+
+// Wraps a possibly negative dim into [0, dim_post_expr).
+inline int64_t maybe_wrap_dim(int64_t dim, int64_t dim_post_expr) {
+  if (dim_post_expr <= 0) {
+    dim_post_expr = 1; // a scalar tensor accepts dims -1 and 0
+  }
+  TORCH_CHECK(
+      dim >= -dim_post_expr && dim < dim_post_expr,
+      "Dimension out of range (expected to be in range of [",
+      -dim_post_expr, ", ", dim_post_expr - 1, "], but got ", dim, ")");
+  return dim < 0 ? dim + dim_post_expr : dim;
+}
+
+// TensorImpl is a strided view of a StorageImpl: element i0, ..., ik of the
+// tensor is the element at storage_offset + sum(ij * strides[j]) of the
+// storage, in units of the dtype.  Several TensorImpls (views) may share one
+// storage.
+//
+// Creating a tensor costs one heap block, which holds both the TensorImpl and
+// its StorageImpl, plus the data: sizes and strides are DimVectors, so shapes
+// up to rank kDimVectorStaticSize make no allocation of their own.  The block
+// lives until both objects are gone, so a view that outlives its base keeps
+// the base's TensorImpl bytes allocated.
+//
+// The contiguity flags are derived from sizes and strides, so they are
+// computed once whenever the shape changes (set_sizes_contiguous,
+// set_sizes_and_strides) instead of on every query.
+struct C10_API TensorImpl final : public c10::intrusive_ptr_target {
+  TensorImpl(
+      c10::intrusive_ptr<StorageImpl> storage,
+      DispatchKeySet key_set,
+      ScalarType dtype);
+
+  TensorImpl(const TensorImpl&) = delete;
+  TensorImpl& operator=(const TensorImpl&) = delete;
+  TensorImpl(TensorImpl&&) = delete;
+  TensorImpl& operator=(TensorImpl&&) = delete;
+
+  // See StorageImpl::operator new
+  static void* operator new(size_t nbytes) {
+    return c10::co_allocate(nbytes);
+  }
+  static void operator delete(void* ptr) noexcept {
+    c10::co_deallocate(ptr);
+  }
+
+  void release_resources() override {
+    storage_.reset();
+  }
+
+  IntArrayRef sizes() const {
+    return sizes_;
+  }
+  IntArrayRef strides() const {
+    return strides_;
+  }
+  int64_t dim() const {
+    return static_cast<int64_t>(sizes_.size());
+  }
+  int64_t size(int64_t d) const {
+    return sizes_[maybe_wrap_dim(d, dim())];
+  }
+  int64_t stride(int64_t d) const {
+    return strides_[maybe_wrap_dim(d, dim())];
+  }
+  int64_t numel() const {
+    return numel_;
+  }
+
+  ScalarType dtype() const {
+    return dtype_;
+  }
+  size_t itemsize() const {
+    return elementSize(dtype_);
+  }
+  size_t nbytes() const {
+    return static_cast<size_t>(numel_) * itemsize();
+  }
+  DispatchKeySet key_set() const {
+    return key_set_;
+  }
+  Device device() const {
+    return storage_->device();
+  }
+
+  const c10::intrusive_ptr<StorageImpl>& storage() const {
+    return storage_;
+  }
+  int64_t storage_offset() const {
+    return storage_offset_;
+  }
+
+  // Address of the first element.  Meta tensors have no data and return
+  // nullptr.
+  void* data() const {
+    auto* base = static_cast<char*>(storage_->data());
+    if (base == nullptr) {
+      return nullptr;
+    }
+    return base + storage_offset_ * static_cast<int64_t>(itemsize());
+  }
+
+  template <typename T>
+  T* data() const {
+    return static_cast<T*>(data());
+  }
+
+  // Whether the tensor is dense in memory_format's order: Contiguous is
+  // row-major, ChannelsLast is NHWC for 4-d tensors and ChannelsLast3d is NDHWC
+  // for 5-d tensors.
+  bool is_contiguous(MemoryFormat memory_format = MemoryFormat::Contiguous) const {
+    switch (memory_format) {
+      case MemoryFormat::ChannelsLast:
+        return is_channels_last_contiguous_;
+      case MemoryFormat::ChannelsLast3d:
+        return is_channels_last_3d_contiguous_;
+      default:
+        return is_contiguous_;
+    }
+  }
+
+  // Whether the strides look like channels last, dense or not; see
+  // is_channels_last_strides_2d in MemoryFormat.h.
+  bool is_strides_like_channels_last() const {
+    return is_channels_last_;
+  }
+  bool is_strides_like_channels_last_3d() const {
+    return is_channels_last_3d_;
+  }
+
+  // The memory format an operator should give its output to keep the layout
+  // of this tensor.
+  MemoryFormat suggest_memory_format() const {
+    if (is_channels_last_) {
+      return MemoryFormat::ChannelsLast;
+    }
+    if (is_channels_last_3d_) {
+      return MemoryFormat::ChannelsLast3d;
+    }
+    return MemoryFormat::Contiguous;
+  }
+
+  // Sets sizes, with the strides of a dense tensor in memory_format.  The
+  // storage is not resized; see resize_storage_if_needed().
+  void set_sizes_contiguous(
+      IntArrayRef new_size,
+      MemoryFormat memory_format = MemoryFormat::Contiguous);
+
+  void set_sizes_and_strides(IntArrayRef new_size, IntArrayRef new_stride);
+
+  void set_storage_offset(int64_t storage_offset) {
+    TORCH_CHECK(storage_offset >= 0, "storage_offset must be non-negative, got ", storage_offset);
+    storage_offset_ = storage_offset;
+  }
+
+  // Bytes of storage the elements of this view span, from the storage start
+  size_t storage_nbytes_needed() const;
+
+  // Grows the storage (through its allocator) so that it holds every element
+  // this view can address.  The old contents are copied over.
+  void resize_storage_if_needed();
+
+ private:
+  void refresh_numel();
+  void refresh_contiguous();
+
+  bool compute_contiguous() const;
+  bool compute_channels_last_contiguous_2d() const;
+  bool compute_channels_last_contiguous_3d() const;
+
+  c10::intrusive_ptr<StorageImpl> storage_;
+  int64_t storage_offset_ = 0;
+  DimVector sizes_;
+  DimVector strides_;
+  int64_t numel_ = 1;
+  DispatchKeySet key_set_;
+  ScalarType dtype_;
+
+  bool is_contiguous_ = true;
+  bool is_channels_last_contiguous_ = false;
+  bool is_channels_last_3d_contiguous_ = false;
+  bool is_channels_last_ = false;
+  bool is_channels_last_3d_ = false;
+};
+
+// The dispatch key of dense tensors on device
+C10_API DispatchKey computeDispatchKey(DeviceType device);
+
+} // namespace c10
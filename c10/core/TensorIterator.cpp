@@ -0,0 +1,303 @@
+#include <c10/core/TensorIterator.h>
+
+#include <algorithm>
+
+namespace c10 {
+
+namespace {
+
+OperandInfo makeOperand(
+    const void* data,
+    IntArrayRef sizes,
+    IntArrayRef strides,
+    size_t element_size,
+    bool is_output) {
+  TORCH_CHECK(
+      sizes.size() == strides.size(),
+      "TensorIterator: operand has ", sizes.size(), " sizes but ", strides.size(), " strides");
+  OperandInfo op;
+  op.data = static_cast<char*>(const_cast<void*>(data));
+  op.sizes.assign(sizes.begin(), sizes.end());
+  op.stride_bytes.reserve(strides.size());
+  for (int64_t s : strides) {
+    op.stride_bytes.push_back(s * static_cast<int64_t>(element_size));
+  }
+  op.element_size = static_cast<int64_t>(element_size);
+  op.is_output = is_output;
+  return op;
+}
+
+} // namespace
+
+TensorIterator& TensorIterator::add_output(
+    void* data,
+    IntArrayRef sizes,
+    IntArrayRef strides,
+    size_t element_size) {
+  TORCH_CHECK(
+      num_outputs_ == ntensors(), "TensorIterator: outputs must be added before inputs");
+  operands_.push_back(makeOperand(data, sizes, strides, element_size, /*is_output=*/true));
+  num_outputs_++;
+  return *this;
+}
+
+TensorIterator& TensorIterator::add_input(
+    const void* data,
+    IntArrayRef sizes,
+    IntArrayRef strides,
+    size_t element_size) {
+  operands_.push_back(makeOperand(data, sizes, strides, element_size, /*is_output=*/false));
+  return *this;
+}
+
+TensorIterator& TensorIterator::add_output(const Tensor& t) {
+  return add_output(t.data_ptr(), t.sizes(), t.strides(), t.itemsize());
+}
+
+TensorIterator& TensorIterator::add_input(const Tensor& t) {
+  return add_input(t.data_ptr(), t.sizes(), t.strides(), t.itemsize());
+}
+
+void TensorIterator::build() {
+  TORCH_CHECK(!built_, "TensorIterator: build() called twice");
+  TORCH_CHECK(ntensors() > 0, "TensorIterator: no operands");
+  built_ = true;
+  compute_shape();
+  compute_strides();
+  reorder_dimensions();
+  coalesce_dimensions();
+}
+
+// Broadcasting aligns sizes at the right; a size-1 dimension stretches to
+// match the others.
+void TensorIterator::compute_shape() {
+  size_t ndim = 0;
+  for (const auto& op : operands_) {
+    ndim = std::max(ndim, op.sizes.size());
+  }
+  DimVector shape(ndim, 1);
+  for (const auto& op : operands_) {
+    const size_t offset = ndim - op.sizes.size();
+    for (size_t d = 0; d < op.sizes.size(); d++) {
+      const int64_t size = op.sizes[d];
+      int64_t& target = shape[offset + d];
+      if (size == target || size == 1) {
+        continue;
+      }
+      TORCH_CHECK(
+          target == 1,
+          "TensorIterator: the size of an operand (", size, ") must match the size of another (",
+          target, ") at non-singleton dimension ", offset + d);
+      target = size;
+    }
+  }
+  for (const auto& op : operands_) {
+    if (op.is_output) {
+      TORCH_CHECK(
+          IntArrayRef(op.sizes) == IntArrayRef(shape),
+          "TensorIterator: output with shape ", IntArrayRef(op.sizes),
+          " doesn't match the broadcast shape ", IntArrayRef(shape));
+    }
+  }
+  // shape_ holds the fastest moving (last) dimension first
+  shape_.assign(shape.rbegin(), shape.rend());
+  numel_ = 1;
+  for (int64_t s : shape_) {
+    numel_ *= s;
+  }
+}
+
+// Reverses each operand's strides into iteration order, padding broadcast
+// dimensions with zeros.
+void TensorIterator::compute_strides() {
+  for (auto& op : operands_) {
+    DimVector strides(shape_.size(), 0);
+    for (size_t d = 0; d < op.sizes.size(); d++) {
+      const size_t it_dim = op.sizes.size() - 1 - d;
+      if (op.sizes[d] != 1 || shape_[it_dim] == 1) {
+        strides[it_dim] = op.stride_bytes[d];
+      }
+      if (op.is_output && op.sizes[d] > 1) {
+        TORCH_CHECK(
+            op.stride_bytes[d] != 0,
+            "TensorIterator: output has a zero stride in dimension ", d,
+            " of size ", op.sizes[d], ", so several elements would be written to one location");
+      }
+    }
+    op.stride_bytes = std::move(strides);
+  }
+}
+
+// Sorts the dimensions so that the one with the smallest strides comes first.
+// Operands vote in order, outputs first; a broadcast (zero) stride abstains,
+// and equal strides are left to the next operand.  Insertion sort keeps the
+// original order among dimensions nobody has an opinion on.
+void TensorIterator::reorder_dimensions() {
+  const int ndim = this->ndim();
+  if (ndim <= 1) {
+    return;
+  }
+  // 1: dim0 should move after dim1, -1: it should stay before, 0: no opinion
+  auto should_swap = [&](const DimVector& perm, int i0, int i1) {
+    const int dim0 = static_cast<int>(perm[i0]);
+    const int dim1 = static_cast<int>(perm[i1]);
+    for (const auto& op : operands_) {
+      const int64_t stride0 = op.stride_bytes[dim0];
+      const int64_t stride1 = op.stride_bytes[dim1];
+      if (stride0 == 0 || stride1 == 0) {
+        continue;
+      }
+      if (stride0 < stride1) {
+        return -1;
+      }
+      if (stride0 > stride1) {
+        return 1;
+      }
+      // equal strides: the smaller dimension goes first
+      if (shape_[dim0] > shape_[dim1]) {
+        return 1;
+      }
+    }
+    return 0;
+  };
+  DimVector perm(static_cast<size_t>(ndim));
+  for (int d = 0; d < ndim; d++) {
+    perm[d] = d;
+  }
+  for (int i = 1; i < ndim; i++) {
+    int i1 = i;
+    for (int i0 = i - 1; i0 >= 0; i0--) {
+      const int comparison = should_swap(perm, i0, i1);
+      if (comparison > 0) {
+        std::swap(perm[i0], perm[i1]);
+        i1 = i0;
+      } else if (comparison < 0) {
+        break;
+      }
+    }
+  }
+  auto apply = [&](DimVector& v) {
+    DimVector permuted(static_cast<size_t>(ndim));
+    for (int d = 0; d < ndim; d++) {
+      permuted[d] = v[perm[d]];
+    }
+    v = std::move(permuted);
+  };
+  apply(shape_);
+  for (auto& op : operands_) {
+    apply(op.stride_bytes);
+  }
+}
+
+// Merges dimension d into the one before when, for every operand, stepping
+// over the whole earlier dimension lands exactly one step along d.  Size-1
+// dimensions merge with anything.  The result has at least one dimension.
+void TensorIterator::coalesce_dimensions() {
+  if (ndim() == 0) {
+    shape_.push_back(1);
+    for (auto& op : operands_) {
+      op.stride_bytes.push_back(0);
+    }
+    return;
+  }
+  auto can_coalesce = [&](int dim0, int dim1) {
+    if (shape_[dim0] == 1 || shape_[dim1] == 1) {
+      return true;
+    }
+    for (const auto& op : operands_) {
+      if (shape_[dim0] * op.stride_bytes[dim0] != op.stride_bytes[dim1]) {
+        return false;
+      }
+    }
+    return true;
+  };
+  auto replace_stride = [&](int dim0, int dim1) {
+    for (auto& op : operands_) {
+      op.stride_bytes[dim0] = op.stride_bytes[dim1];
+    }
+  };
+  int prev_dim = 0;
+  for (int dim = 1; dim < ndim(); dim++) {
+    if (can_coalesce(prev_dim, dim)) {
+      if (shape_[prev_dim] == 1) {
+        replace_stride(prev_dim, dim);
+      }
+      shape_[prev_dim] *= shape_[dim];
+    } else {
+      prev_dim++;
+      if (prev_dim != dim) {
+        replace_stride(prev_dim, dim);
+        shape_[prev_dim] = shape_[dim];
+      }
+    }
+  }
+  shape_.resize(prev_dim + 1);
+  for (auto& op : operands_) {
+    op.stride_bytes.resize(prev_dim + 1);
+  }
+}
+
+bool TensorIterator::is_contiguous() const {
+  if (ndim() != 1) {
+    return numel_ <= 1;
+  }
+  for (const auto& op : operands_) {
+    if (op.stride_bytes[0] != op.element_size) {
+      return false;
+    }
+  }
+  return true;
+}
+
+void TensorIterator::serial_for_each(loop_t loop, int64_t begin, int64_t end) const {
+  TORCH_INTERNAL_ASSERT(built_, "TensorIterator: for_each before build()");
+  if (end <= begin) {
+    return;
+  }
+  const int ntensors = this->ntensors();
+  const int ndim = this->ndim();
+  SmallVector<char*, 4> ptrs(static_cast<size_t>(ntensors));
+  SmallVector<int64_t, 4> inner_strides(static_cast<size_t>(ntensors));
+  DimVector index(static_cast<size_t>(ndim));
+  int64_t linear = begin;
+  for (int d = 0; d < ndim; d++) {
+    index[d] = linear % shape_[d];
+    linear /= shape_[d];
+  }
+  for (int i = 0; i < ntensors; i++) {
+    const auto& op = operands_[i];
+    ptrs[i] = op.data;
+    for (int d = 0; d < ndim; d++) {
+      ptrs[i] += index[d] * op.stride_bytes[d];
+    }
+    inner_strides[i] = op.stride_bytes[0];
+  }
+  int64_t remaining = end - begin;
+  while (true) {
+    const int64_t n = std::min(shape_[0] - index[0], remaining);
+    loop(ptrs.data(), inner_strides.data(), n);
+    remaining -= n;
+    if (remaining == 0) {
+      break;
+    }
+    // back to the start of the row, then carry into the outer dimensions
+    for (int i = 0; i < ntensors; i++) {
+      ptrs[i] -= index[0] * inner_strides[i];
+    }
+    index[0] = 0;
+    for (int d = 1; d < ndim; d++) {
+      for (int i = 0; i < ntensors; i++) {
+        ptrs[i] += operands_[i].stride_bytes[d];
+      }
+      if (++index[d] < shape_[d]) {
+        break;
+      }
+      for (int i = 0; i < ntensors; i++) {
+        ptrs[i] -= shape_[d] * operands_[i].stride_bytes[d];
+      }
+      index[d] = 0;
+    }
+  }
+}
+
+} // namespace c10
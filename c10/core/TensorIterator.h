@@ -0,0 +1,113 @@
+#pragma once
+
+#include <c10/core/Tensor.h>
+#include <c10/util/ArrayRef.h>
+#include <c10/util/FunctionRef.h>
+#include <c10/util/SmallVector.h>
+
+// TensorIterator runs an elementwise kernel over N strided operands.
+//
+//   TensorIterator iter;
+//   iter.add_output(out).add_input(a).add_input(b).build();
+//   iter.for_each([](char** data, const int64_t* strides, int64_t n) {
+//     for (int64_t i = 0; i < n; i++) {
+//       *reinterpret_cast<float*>(data[0] + i * strides[0]) =
+//           *reinterpret_cast<float*>(data[1] + i * strides[1]) +
+//           *reinterpret_cast<float*>(data[2] + i * strides[2]);
+//     }
+//   });
+//
+// build() broadcasts the inputs against each other and the outputs (a size-1
+// dimension gets stride 0), sorts the dimensions from the smallest strides to
+// the largest, and merges dimensions that are contiguous with each other in
+// every operand.  The kernel then sees 1-d chunks: a data pointer and a byte
+// stride per operand (outputs first, in the order they were added) and a
+// length.  Dense operands coalesce to a single dimension, so the whole tensor
+// is one chunk whose strides are the element sizes; c10/cpu/Loops.h checks for
+// that case and runs the vectorized inner loop there.
+
+namespace c10 {
+
+struct OperandInfo {
+  char* data = nullptr;
+  // Sizes as given.  Strides are in bytes, as given until build() and in the
+  // iteration order of TensorIterator::shape() after.
+  DimVector sizes;
+  DimVector stride_bytes;
+  int64_t element_size = 0;
+  bool is_output = false;
+};
+
+class C10_API TensorIterator {
+ public:
+  // data and strides have one entry per operand
+  using loop_t = c10::function_ref<void(char** data, const int64_t* strides, int64_t n)>;
+
+  // Outputs come before inputs.  strides are in elements, like tensor
+  // strides.  Outputs are not resized: their sizes must be the broadcast
+  // shape.
+  TensorIterator& add_output(void* data, IntArrayRef sizes, IntArrayRef strides, size_t element_size);
+  TensorIterator& add_input(
+      const void* data,
+      IntArrayRef sizes,
+      IntArrayRef strides,
+      size_t element_size);
+  TensorIterator& add_output(const Tensor& t);
+  TensorIterator& add_input(const Tensor& t);
+
+  void build();
+
+  int ntensors() const {
+    return static_cast<int>(operands_.size());
+  }
+  int noutputs() const {
+    return num_outputs_;
+  }
+  // Number of dimensions after coalescing; at least 1
+  int ndim() const {
+    return static_cast<int>(shape_.size());
+  }
+  // Iteration shape, fastest moving dimension first
+  IntArrayRef shape() const {
+    return shape_;
+  }
+  int64_t numel() const {
+    return numel_;
+  }
+  // Byte strides of operand arg, in the order of shape()
+  IntArrayRef strides(int arg) const {
+    return operands_[arg].stride_bytes;
+  }
+  void* data_ptr(int arg) const {
+    return operands_[arg].data;
+  }
+  int64_t element_size(int arg) const {
+    return operands_[arg].element_size;
+  }
+  // Whether every operand is dense in iteration order, so that for_each
+  // makes a single call with strides equal to the element sizes.
+  bool is_contiguous() const;
+
+  // Calls loop on consecutive 1-d chunks covering every element.
+  void for_each(loop_t loop) const {
+    serial_for_each(loop, 0, numel_);
+  }
+  // Same, for the elements [begin, end) in iteration order: chunks never
+  // cross the end of the first dimension, and the position is only
+  // decomposed into indices once, at begin.
+  void serial_for_each(loop_t loop, int64_t begin, int64_t end) const;
+
+ private:
+  void compute_shape();
+  void compute_strides();
+  void reorder_dimensions();
+  void coalesce_dimensions();
+
+  SmallVector<OperandInfo, 4> operands_;
+  int num_outputs_ = 0;
+  DimVector shape_;
+  int64_t numel_ = 0;
+  bool built_ = false;
+};
+
+} // namespace c10
@@ -0,0 +1,39 @@
+#pragma once
+
+#include <c10/core/CPUAllocator.h>
+
+#include <cstddef>
+
+namespace c10 {
+
+// Scratch memory that grows to the largest size asked for and is kept from
+// one call to the next, for the packing and im2col buffers of the kernels.
+// A kernel keeps one per thread, as a thread_local of its own, so that
+// kernels calling each other do not share buffers.  Memory is 64-byte
+// aligned; its contents are not kept when it grows.
+class Workspace {
+ public:
+  Workspace() = default;
+  Workspace(const Workspace&) = delete;
+  Workspace& operator=(const Workspace&) = delete;
+  ~Workspace() {
+    free_cpu(data_);
+  }
+
+  void* get(size_t nbytes) {
+    if (nbytes > capacity_) {
+      free_cpu(data_);
+      data_ = nullptr;
+      capacity_ = 0;
+      data_ = alloc_cpu(nbytes);
+      capacity_ = nbytes;
+    }
+    return data_;
+  }
+
+ private:
+  void* data_ = nullptr;
+  size_t capacity_ = 0;
+};
+
+} // namespace c10
@@ -0,0 +1,295 @@
+#include <c10/cpu/BFloat16GemmKernel.h>
+#include <c10/core/Workspace.h>
+#include <c10/cpu/BlockedGemm.h>
+#include <c10/util/CPUCapability.h>
+#include <c10/util/Parallel.h>
+
+#if defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX512)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+// vdpbf16ps needs GCC 10 or clang 9, and is checked for at runtime
+#if defined(CPU_CAPABILITY_AVX512) &&                             \
+    ((defined(__clang__) && __clang_major__ >= 9) ||              \
+     (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 10))
+#define C10_BFLOAT16_GEMM_AVX512_BF16 1
+#else
+#define C10_BFLOAT16_GEMM_AVX512_BF16 0
+#endif
+
+namespace c10 {
+namespace {
+
+using namespace blocked_gemm;
+
+// Values of a group of 2 values of k of a block of packed B, see
+// PackedBFloat16Matrix
+constexpr int64_t kGroupSize = 2 * kBlockCols;
+
+// Packed A
+thread_local Workspace workspace;
+
+// The micro-kernels store in tile, kMR x kNR, the dot products of kMR rows of
+// packed A, lda elements apart, and the kNR columns of packed B from b, over
+// groups groups of 2 values of k.  The blocks of B are block_size values
+// apart.  vdpbf16ps takes A as BFloat16 pairs; the other kernels take it
+// widened to float, to broadcast it from memory.
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+void micro_kernel(
+    int64_t groups,
+    const float* a,
+    int64_t lda,
+    const BFloat16* b,
+    int64_t block_size,
+    float* tile) {
+  const __m512i high = _mm512_set1_epi32(0xFFFF0000);
+  __m512 acc0[kMR];
+  __m512 acc1[kMR];
+#pragma GCC unroll 8
+  for (int64_t i = 0; i < kMR; i++) {
+    acc0[i] = _mm512_setzero_ps();
+    acc1[i] = _mm512_setzero_ps();
+  }
+  for (int64_t g = 0; g < groups; g++) {
+    const __m512i b0 = _mm512_loadu_si512(b + g * kGroupSize);
+    const __m512i b1 = _mm512_loadu_si512(b + block_size + g * kGroupSize);
+    // the even values of k are the low halves of the 32-bit lanes
+    const __m512 b0_even = _mm512_castsi512_ps(_mm512_slli_epi32(b0, 16));
+    const __m512 b0_odd = _mm512_castsi512_ps(_mm512_and_si512(b0, high));
+    const __m512 b1_even = _mm512_castsi512_ps(_mm512_slli_epi32(b1, 16));
+    const __m512 b1_odd = _mm512_castsi512_ps(_mm512_and_si512(b1, high));
+#pragma GCC unroll 8
+    for (int64_t i = 0; i < kMR; i++) {
+      const __m512 a_even = _mm512_set1_ps(a[i * lda + 2 * g]);
+      const __m512 a_odd = _mm512_set1_ps(a[i * lda + 2 * g + 1]);
+      acc0[i] = _mm512_fmadd_ps(a_even, b0_even, acc0[i]);
+      acc1[i] = _mm512_fmadd_ps(a_even, b1_even, acc1[i]);
+      acc0[i] = _mm512_fmadd_ps(a_odd, b0_odd, acc0[i]);
+      acc1[i] = _mm512_fmadd_ps(a_odd, b1_odd, acc1[i]);
+    }
+  }
+#pragma GCC unroll 8
+  for (int64_t i = 0; i < kMR; i++) {
+    _mm512_storeu_ps(tile + i * kNR, acc0[i]);
+    _mm512_storeu_ps(tile + i * kNR + kBlockCols, acc1[i]);
+  }
+}
+
+#if C10_BFLOAT16_GEMM_AVX512_BF16
+// A pair of values of a row of A, to broadcast
+inline int32_t load_pair(const BFloat16* p) {
+  int32_t x;
+  std::memcpy(&x, p, sizeof(x));
+  return x;
+}
+
+__attribute__((target("avx512bf16"))) void micro_kernel_bf16(
+    int64_t groups,
+    const BFloat16* a,
+    int64_t lda,
+    const BFloat16* b,
+    int64_t block_size,
+    float* tile) {
+  __m512 acc0[kMR];
+  __m512 acc1[kMR];
+#pragma GCC unroll 8
+  for (int64_t i = 0; i < kMR; i++) {
+    acc0[i] = _mm512_setzero_ps();
+    acc1[i] = _mm512_setzero_ps();
+  }
+  for (int64_t g = 0; g < groups; g++) {
+    const __m512bh b0 = reinterpret_cast<__m512bh>(_mm512_loadu_si512(b + g * kGroupSize));
+    const __m512bh b1 =
+        reinterpret_cast<__m512bh>(_mm512_loadu_si512(b + block_size + g * kGroupSize));
+#pragma GCC unroll 8
+    for (int64_t i = 0; i < kMR; i++) {
+      const __m512bh ai =
+          reinterpret_cast<__m512bh>(_mm512_set1_epi32(load_pair(a + i * lda + 2 * g)));
+      acc0[i] = _mm512_dpbf16_ps(acc0[i], ai, b0);
+      acc1[i] = _mm512_dpbf16_ps(acc1[i], ai, b1);
+    }
+  }
+#pragma GCC unroll 8
+  for (int64_t i = 0; i < kMR; i++) {
+    _mm512_storeu_ps(tile + i * kNR, acc0[i]);
+    _mm512_storeu_ps(tile + i * kNR + kBlockCols, acc1[i]);
+  }
+}
+#endif
+
+#elif defined(CPU_CAPABILITY_AVX2)
+
+// A block of B is two vectors, columns 0-7 and 8-15
+void micro_kernel(
+    int64_t groups,
+    const float* a,
+    int64_t lda,
+    const BFloat16* b,
+    int64_t /*block_size*/,
+    float* tile) {
+  const __m256i high = _mm256_set1_epi32(0xFFFF0000);
+  __m256 acc0[kMR];
+  __m256 acc1[kMR];
+#pragma GCC unroll 8
+  for (int64_t i = 0; i < kMR; i++) {
+    acc0[i] = _mm256_setzero_ps();
+    acc1[i] = _mm256_setzero_ps();
+  }
+  for (int64_t g = 0; g < groups; g++) {
+    const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + g * kGroupSize));
+    const __m256i b1 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + g * kGroupSize + 16));
+    const __m256 b0_even = _mm256_castsi256_ps(_mm256_slli_epi32(b0, 16));
+    const __m256 b0_odd = _mm256_castsi256_ps(_mm256_and_si256(b0, high));
+    const __m256 b1_even = _mm256_castsi256_ps(_mm256_slli_epi32(b1, 16));
+    const __m256 b1_odd = _mm256_castsi256_ps(_mm256_and_si256(b1, high));
+#pragma GCC unroll 8
+    for (int64_t i = 0; i < kMR; i++) {
+      const __m256 a_even = _mm256_broadcast_ss(a + i * lda + 2 * g);
+      const __m256 a_odd = _mm256_broadcast_ss(a + i * lda + 2 * g + 1);
+      acc0[i] = _mm256_fmadd_ps(a_even, b0_even, acc0[i]);
+      acc1[i] = _mm256_fmadd_ps(a_even, b1_even, acc1[i]);
+      acc0[i] = _mm256_fmadd_ps(a_odd, b0_odd, acc0[i]);
+      acc1[i] = _mm256_fmadd_ps(a_odd, b1_odd, acc1[i]);
+    }
+  }
+#pragma GCC unroll 8
+  for (int64_t i = 0; i < kMR; i++) {
+    _mm256_storeu_ps(tile + i * kNR, acc0[i]);
+    _mm256_storeu_ps(tile + i * kNR + 8, acc1[i]);
+  }
+}
+
+#else
+
+void micro_kernel(
+    int64_t groups,
+    const float* a,
+    int64_t lda,
+    const BFloat16* b,
+    int64_t /*block_size*/,
+    float* tile) {
+  std::fill(tile, tile + kMR * kNR, 0.f);
+  for (int64_t g = 0; g < groups; g++) {
+    for (int64_t i = 0; i < kMR; i++) {
+      const float a_even = a[i * lda + 2 * g];
+      const float a_odd = a[i * lda + 2 * g + 1];
+      const BFloat16* bg = b + g * kGroupSize;
+      float* row = tile + i * kNR;
+      for (int64_t j = 0; j < kNR; j++) {
+        row[j] += a_even * static_cast<float>(bg[2 * j]);
+        row[j] += a_odd * static_cast<float>(bg[2 * j + 1]);
+      }
+    }
+  }
+}
+
+#endif
+
+template <typename scalar_a>
+using micro_kernel_fn =
+    void (*)(int64_t, const scalar_a*, int64_t, const BFloat16*, int64_t, float*);
+
+// Copies the rows of op(A) as scalar_a, padded with zeros to an even number
+// of values and to a multiple of kMR rows
+template <typename scalar_a>
+void pack_a(const BFloat16GemmParams& p, int64_t k, int64_t lda_packed, scalar_a* packed) {
+  const int64_t rows = round_up(p.m, kMR);
+  const int64_t grain_size = internal::divup(internal::GRAIN_SIZE, std::max<int64_t>(k, 1));
+  parallel_for(0, rows, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      scalar_a* dst = packed + i * lda_packed;
+      int64_t q = 0;
+      if (i < p.m && p.trans_a == Transpose::NoTrans) {
+        for (; q < k; q++) {
+          dst[q] = static_cast<scalar_a>(p.a[i * p.lda + q]);
+        }
+      } else if (i < p.m) {
+        for (; q < k; q++) {
+          dst[q] = static_cast<scalar_a>(p.a[q * p.lda + i]);
+        }
+      }
+      for (; q < lda_packed; q++) {
+        dst[q] = static_cast<scalar_a>(0.f);
+      }
+    }
+  });
+}
+
+// C = beta * C, for alpha == 0 or k == 0
+void scale_c(const BFloat16GemmParams& p) {
+  const int64_t n = p.b->n();
+  const int64_t grain_size = internal::divup(internal::GRAIN_SIZE, n);
+  parallel_for(0, p.m, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      float* row = p.c + i * p.ldc;
+      for (int64_t j = 0; j < n; j++) {
+        row[j] = p.beta == 0 ? 0.f : p.beta * row[j];
+      }
+    }
+  });
+}
+
+template <typename scalar_a>
+void run(const BFloat16GemmParams& p, micro_kernel_fn<scalar_a> micro) {
+  const PackedBFloat16Matrix& b = *p.b;
+  const int64_t m = p.m;
+  const int64_t n = b.n();
+  const int64_t k = b.k();
+  const int64_t lda_packed = PackedBFloat16Matrix::padded_k(k);
+  const int64_t groups = lda_packed / 2;
+  const int64_t block_size = groups * kGroupSize;
+
+  auto* packed_a =
+      static_cast<scalar_a*>(workspace.get(round_up(m, kMR) * lda_packed * sizeof(scalar_a)));
+  pack_a(p, k, lda_packed, packed_a);
+
+  for_each_tile<float>(
+      m, n, lda_packed,
+      [&](int64_t i, int64_t j, float* tile) {
+        micro(
+            groups, packed_a + i * lda_packed, lda_packed, b.data() + j / kBlockCols * block_size,
+            block_size, tile);
+      },
+      [&](int64_t i, int64_t j, int64_t rows, int64_t cols, const float* tile) {
+        for (int64_t r = 0; r < rows; r++) {
+          const float* t = tile + r * kNR;
+          float* row = p.c + (i + r) * p.ldc + j;
+          if (p.beta == 0) {
+            for (int64_t c = 0; c < cols; c++) {
+              row[c] = p.alpha * t[c];
+            }
+          } else {
+            for (int64_t c = 0; c < cols; c++) {
+              row[c] = p.alpha * t[c] + p.beta * row[c];
+            }
+          }
+        }
+      });
+}
+
+void bfloat16_gemm_kernel(const BFloat16GemmParams& p) {
+  if (p.alpha == 0 || p.b->k() == 0) {
+    scale_c(p);
+    return;
+  }
+#if C10_BFLOAT16_GEMM_AVX512_BF16
+  static const bool has_bf16 = cpu::cpuFeatures().avx512bf16;
+  if (has_bf16) {
+    run<BFloat16>(p, micro_kernel_bf16);
+    return;
+  }
+#endif
+  run<float>(p, micro_kernel);
+}
+
+} // namespace
+
+REGISTER_DISPATCH(bfloat16_gemm_stub, &bfloat16_gemm_kernel);
+
+} // namespace c10
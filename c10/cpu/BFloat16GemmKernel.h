@@ -0,0 +1,30 @@
+#pragma once
+
+#include <c10/util/BFloat16Gemm.h>
+#include <c10/util/DispatchStub.h>
+
+#include <cstdint>
+
+// Kernel of the BFloat16 matrix products in c10/util/BFloat16Gemm.h.
+
+namespace c10 {
+
+// One product C = alpha * op(A) * B + beta * C, op(A) m x k and b k x n;
+// sizes are checked by the caller.
+struct BFloat16GemmParams {
+  Transpose trans_a = Transpose::NoTrans;
+  int64_t m = 0;
+  float alpha = 1;
+  const BFloat16* a = nullptr;
+  int64_t lda = 1;
+  const PackedBFloat16Matrix* b = nullptr;
+  float beta = 0;
+  float* c = nullptr;
+  int64_t ldc = 1;
+};
+
+using bfloat16_gemm_fn = void (*)(const BFloat16GemmParams&);
+
+DECLARE_DISPATCH(bfloat16_gemm_fn, bfloat16_gemm_stub);
+
+} // namespace c10
@@ -0,0 +1,82 @@
+#pragma once
+
+// Tiling shared by the kernels that multiply rows of a packed A by a B packed
+// in blocks of 16 columns: QGemmKernel.cpp and BFloat16GemmKernel.cpp.
+//
+// C is split into kMC x kNC blocks, spread over the intra-op thread pool, and
+// each block into kMR x kNR register tiles.  for_each_tile() runs a kernel's
+// micro-kernel on every tile, into a buffer on the stack, then hands the
+// buffer to the kernel to finish the tile (zero points, alpha and beta,
+// requantization) and store it to C.
+//
+// The micro-kernels of these files unroll their loops with pragmas rather
+// than ForcedUnroll: lambdas would not get the target attribute of their
+// variants for ISA extensions (avx512vnni, avx512bf16), and could not inline
+// their intrinsics.
+
+#include <c10/util/Parallel.h>
+
+#include <algorithm>
+#include <cstdint>
+
+namespace c10 {
+inline namespace CPU_CAPABILITY {
+namespace blocked_gemm {
+
+// Columns of a block of packed B
+constexpr int64_t kBlockCols = 16;
+
+// Register tile of C: kMR rows by kNR columns, one or two blocks of B
+#if defined(CPU_CAPABILITY_AVX512)
+constexpr int64_t kMR = 6;
+constexpr int64_t kNR = 32;
+#else
+constexpr int64_t kMR = 4;
+constexpr int64_t kNR = 16;
+#endif
+
+// Threads take kMC x kNC blocks of C; the kMC rows of packed A stay in L2
+constexpr int64_t kMC = 96;
+constexpr int64_t kNC = 128;
+// Products of fewer multiply-adds than this run on one thread
+constexpr int64_t kMinParallelWork = int64_t(1) << 20;
+
+inline int64_t round_up(int64_t x, int64_t multiple) {
+  return internal::divup(x, multiple) * multiple;
+}
+
+// Calls micro(i, j, tile) for the kMR x kNR tile of C at row i and column j,
+// then finish(i, j, rows, cols, tile) with the rows x cols of it inside C.
+// depth is the padded k the micro-kernel runs over, to size the work.
+template <typename acc_t, typename micro_t, typename finish_t>
+void for_each_tile(
+    int64_t m,
+    int64_t n,
+    int64_t depth,
+    const micro_t& micro,
+    const finish_t& finish) {
+  const int64_t row_blocks = internal::divup(m, kMC);
+  const int64_t col_blocks = internal::divup(n, kNC);
+  const int64_t grain_size =
+      internal::divup(kMinParallelWork, kMC * kNC * std::max<int64_t>(depth, 1));
+  parallel_for(0, row_blocks * col_blocks, grain_size, [&](int64_t begin, int64_t end) {
+    alignas(64) acc_t tile[kMR * kNR];
+    for (int64_t block = begin; block < end; block++) {
+      const int64_t i_begin = block / col_blocks * kMC;
+      const int64_t i_end = std::min(m, i_begin + kMC);
+      const int64_t j_begin = block % col_blocks * kNC;
+      const int64_t j_end = std::min(n, j_begin + kNC);
+      for (int64_t j = j_begin; j < j_end; j += kNR) {
+        const int64_t cols = std::min(kNR, n - j);
+        for (int64_t i = i_begin; i < i_end; i += kMR) {
+          micro(i, j, tile);
+          finish(i, j, std::min(kMR, m - i), cols, tile);
+        }
+      }
+    }
+  });
+}
+
+} // namespace blocked_gemm
+} // namespace CPU_CAPABILITY
+} // namespace c10
@@ -0,0 +1,164 @@
+#include <c10/cpu/ComplexKernel.h>
+#include <c10/cpu/vec/vec.h>
+
+#include <algorithm>
+
+namespace c10 {
+namespace {
+
+using namespace vec;
+
+// The tails go through loadu / store with a count, which zero-fills the
+// unused lanes, so they are computed by the same vector code as the rest.
+
+template <typename T, typename Op>
+void complex_map(const complex<T>* src, complex<T>* dst, size_t n, const Op& op) {
+  using Vec = Vectorized<complex<T>>;
+  for (size_t i = 0; i < n; i += Vec::size()) {
+    const int64_t count = static_cast<int64_t>(std::min<size_t>(Vec::size(), n - i));
+    op(Vec::loadu(src + i, count)).store(dst + i, count);
+  }
+}
+
+// abs and arg leave their results in the real lanes; the real output is
+// packed from them.
+template <typename T, typename Op>
+void complex_map_real(const complex<T>* src, T* dst, size_t n, const Op& op) {
+  using Vec = Vectorized<complex<T>>;
+  C10_VEC_ALIGN complex<T> tmp[Vec::size()];
+  for (size_t i = 0; i < n; i += Vec::size()) {
+    const size_t count = std::min<size_t>(Vec::size(), n - i);
+    op(Vec::loadu(src + i, static_cast<int64_t>(count))).store(tmp);
+    for (size_t j = 0; j < count; j++) {
+      dst[i + j] = tmp[j].real();
+    }
+  }
+}
+
+template <typename T>
+void complex_unary_typed(ComplexOp op, const complex<T>* src, void* dst, size_t n) {
+  using Vec = Vectorized<complex<T>>;
+  switch (op) {
+    case ComplexOp::Conj:
+      complex_map(src, static_cast<complex<T>*>(dst), n, [](const Vec& z) { return z.conj(); });
+      break;
+    case ComplexOp::Exp:
+      complex_map(src, static_cast<complex<T>*>(dst), n, [](const Vec& z) { return z.exp(); });
+      break;
+    case ComplexOp::Abs:
+      complex_map_real(src, static_cast<T*>(dst), n, [](const Vec& z) { return z.abs(); });
+      break;
+    case ComplexOp::Arg:
+      complex_map_real(src, static_cast<T*>(dst), n, [](const Vec& z) { return z.angle(); });
+      break;
+    default:
+      TORCH_INTERNAL_ASSERT(false, "complex_unary_kernel: unexpected op");
+  }
+}
+
+void complex_unary_kernel(ComplexOp op, ScalarType dtype, const void* src, void* dst, size_t n) {
+  switch (dtype) {
+    case ScalarType::ComplexFloat:
+      complex_unary_typed(op, static_cast<const complex<float>*>(src), dst, n);
+      break;
+    case ScalarType::ComplexDouble:
+      complex_unary_typed(op, static_cast<const complex<double>*>(src), dst, n);
+      break;
+    default:
+      TORCH_INTERNAL_ASSERT(false, "complex_unary_kernel: unexpected dtype ", dtype);
+  }
+}
+
+template <typename T>
+void complex_binary_typed(
+    ComplexOp op,
+    const complex<T>* a,
+    const complex<T>* b,
+    complex<T>* dst,
+    size_t n) {
+  using Vec = Vectorized<complex<T>>;
+  for (size_t i = 0; i < n; i += Vec::size()) {
+    const int64_t count = static_cast<int64_t>(std::min<size_t>(Vec::size(), n - i));
+    const Vec product = Vec::loadu(a + i, count) * Vec::loadu(b + i, count);
+    if (op == ComplexOp::MulAdd) {
+      (Vec::loadu(dst + i, count) + product).store(dst + i, count);
+    } else {
+      product.store(dst + i, count);
+    }
+  }
+}
+
+void complex_binary_kernel(
+    ComplexOp op,
+    ScalarType dtype,
+    const void* a,
+    const void* b,
+    void* dst,
+    size_t n) {
+  TORCH_INTERNAL_ASSERT(
+      op == ComplexOp::Mul || op == ComplexOp::MulAdd, "complex_binary_kernel: unexpected op");
+  switch (dtype) {
+    case ScalarType::ComplexFloat:
+      complex_binary_typed(
+          op, static_cast<const complex<float>*>(a), static_cast<const complex<float>*>(b),
+          static_cast<complex<float>*>(dst), n);
+      break;
+    case ScalarType::ComplexDouble:
+      complex_binary_typed(
+          op, static_cast<const complex<double>*>(a), static_cast<const complex<double>*>(b),
+          static_cast<complex<double>*>(dst), n);
+      break;
+    default:
+      TORCH_INTERNAL_ASSERT(false, "complex_binary_kernel: unexpected dtype ", dtype);
+  }
+}
+
+// Four independent accumulators hide the latency of the multiply-adds.
+template <typename T>
+complex<T> complex_vdot_typed(const complex<T>* a, const complex<T>* b, size_t n) {
+  using Vec = Vectorized<complex<T>>;
+  constexpr size_t kUnroll = 4;
+  constexpr size_t kStep = kUnroll * Vec::size();
+  Vec acc[kUnroll] = {Vec(complex<T>()), Vec(complex<T>()), Vec(complex<T>()), Vec(complex<T>())};
+  size_t i = 0;
+  for (; i + kStep <= n; i += kStep) {
+    for (size_t k = 0; k < kUnroll; k++) {
+      const size_t offset = i + k * Vec::size();
+      acc[k] = acc[k] + Vec::loadu(a + offset).conj() * Vec::loadu(b + offset);
+    }
+  }
+  for (; i < n; i += Vec::size()) {
+    const int64_t count = static_cast<int64_t>(std::min<size_t>(Vec::size(), n - i));
+    acc[0] = acc[0] + Vec::loadu(a + i, count).conj() * Vec::loadu(b + i, count);
+  }
+  C10_VEC_ALIGN complex<T> tmp[Vec::size()];
+  ((acc[0] + acc[1]) + (acc[2] + acc[3])).store(tmp);
+  complex<T> result(0, 0);
+  for (size_t j = 0; j < Vec::size(); j++) {
+    result += tmp[j];
+  }
+  return result;
+}
+
+void complex_vdot_kernel(ScalarType dtype, const void* a, const void* b, size_t n, void* out) {
+  switch (dtype) {
+    case ScalarType::ComplexFloat:
+      *static_cast<complex<float>*>(out) = complex_vdot_typed(
+          static_cast<const complex<float>*>(a), static_cast<const complex<float>*>(b), n);
+      break;
+    case ScalarType::ComplexDouble:
+      *static_cast<complex<double>*>(out) = complex_vdot_typed(
+          static_cast<const complex<double>*>(a), static_cast<const complex<double>*>(b), n);
+      break;
+    default:
+      TORCH_INTERNAL_ASSERT(false, "complex_vdot_kernel: unexpected dtype ", dtype);
+  }
+}
+
+} // namespace
+
+REGISTER_DISPATCH(complex_unary_stub, &complex_unary_kernel);
+REGISTER_DISPATCH(complex_binary_stub, &complex_binary_kernel);
+REGISTER_DISPATCH(complex_vdot_stub, &complex_vdot_kernel);
+
+} // namespace c10
@@ -0,0 +1,24 @@
+#pragma once
+
+#include <c10/core/ScalarType.h>
+#include <c10/util/DispatchStub.h>
+
+// Kernels of the complex array functions in c10/util/vmath.h.  The dtype is
+// ComplexFloat or ComplexDouble; abs and arg write real arrays of the
+// matching precision.
+
+namespace c10 {
+
+enum class ComplexOp : uint8_t { Mul, MulAdd, Conj, Abs, Arg, Exp };
+
+// Conj, Abs, Arg, Exp
+using complex_unary_fn = void (*)(ComplexOp, ScalarType, const void*, void*, size_t);
+// Mul, MulAdd
+using complex_binary_fn = void (*)(ComplexOp, ScalarType, const void*, const void*, void*, size_t);
+using complex_vdot_fn = void (*)(ScalarType, const void*, const void*, size_t, void*);
+
+DECLARE_DISPATCH(complex_unary_fn, complex_unary_stub);
+DECLARE_DISPATCH(complex_binary_fn, complex_binary_stub);
+DECLARE_DISPATCH(complex_vdot_fn, complex_vdot_stub);
+
+} // namespace c10
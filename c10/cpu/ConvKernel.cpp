@@ -0,0 +1,713 @@
+#include <c10/cpu/ConvKernel.h>
+#include <c10/core/Workspace.h>
+#include <c10/cpu/vec/vec.h>
+#include <c10/util/Gemm.h>
+#include <c10/util/Parallel.h>
+#include <c10/util/Unroll.h>
+
+#include <algorithm>
+#include <cstring>
+
+namespace c10 {
+namespace {
+
+using namespace vec;
+using Vec = Vectorized<float>;
+
+// Reduction depth (taps * in_group_channels) up to which the direct kernel
+// beats im2col + GEMM: the first layers of image models, e.g. 3 x 3 over RGB
+constexpr int64_t kDirectMaxDepth = 64;
+// Output positions of the register tile of the direct kernel, whose columns
+// are two vectors of output channels
+constexpr int64_t kDirectRows = 4;
+// Channels per task of the depthwise weight gradient
+constexpr int64_t kDepthwiseBlock = 64;
+// Size of the im2col buffer of a tile of output positions, which stays in L2
+constexpr int64_t kColumnBytes = int64_t(1) << 19;
+constexpr int64_t kMinTileRows = 16;
+
+// Input of the padding taps of the direct kernel
+constexpr float kZeros[kDirectMaxDepth] = {};
+
+// Repacked weights and partial sums, of the calling thread
+thread_local Workspace weight_workspace;
+// im2col buffers, of every thread running tiles
+thread_local Workspace column_workspace;
+
+enum class ConvAlgorithm {
+  // groups == in_channels == out_channels: per channel, vectorized over them
+  Depthwise,
+  // 1 x 1, stride 1, no padding: a single GEMM on the input as is
+  Pointwise,
+  // small reductions: register tiles of output positions x channels
+  Direct,
+  Im2col,
+};
+
+ConvAlgorithm choose_algorithm(const ConvShape& s) {
+  if (s.groups > 1 && s.groups == s.in_channels && s.groups == s.out_channels) {
+    return ConvAlgorithm::Depthwise;
+  }
+  bool unit = s.taps() == 1;
+  for (int d = 0; d < 3; d++) {
+    unit = unit && s.stride[d] == 1 && s.padding[d] == 0;
+  }
+  if (unit) {
+    return ConvAlgorithm::Pointwise;
+  }
+  if (s.taps() * s.in_group_channels() <= kDirectMaxDepth) {
+    return ConvAlgorithm::Direct;
+  }
+  return ConvAlgorithm::Im2col;
+}
+
+int64_t round_up(int64_t x, int64_t multiple) {
+  return internal::divup(x, multiple) * multiple;
+}
+
+// Calls fn(t, p) for every tap t of output position q, p being the input
+// position that the tap reads, or -1 in the padding
+template <typename F>
+void for_each_tap(const ConvShape& s, int64_t q, const F& fn) {
+  const int64_t o[3] = {q / (s.output[1] * s.output[2]), q / s.output[2] % s.output[1],
+                        q % s.output[2]};
+  int64_t begin[3];
+  for (int d = 0; d < 3; d++) {
+    begin[d] = o[d] * s.stride[d] - s.padding[d];
+  }
+  int64_t t = 0;
+  for (int64_t kd = 0; kd < s.kernel[0]; kd++) {
+    const int64_t id = begin[0] + kd * s.dilation[0];
+    const bool inside_d = id >= 0 && id < s.input[0];
+    for (int64_t kh = 0; kh < s.kernel[1]; kh++) {
+      const int64_t ih = begin[1] + kh * s.dilation[1];
+      const bool inside_h = inside_d && ih >= 0 && ih < s.input[1];
+      for (int64_t kw = 0; kw < s.kernel[2]; kw++) {
+        const int64_t iw = begin[2] + kw * s.dilation[2];
+        const bool inside = inside_h && iw >= 0 && iw < s.input[2];
+        fn(t++, inside ? (id * s.input[1] + ih) * s.input[2] + iw : -1);
+      }
+    }
+  }
+}
+
+// Calls fn(t, q) for every tap t, q being the output position for which the
+// tap reads input position p, or -1 if there is none
+template <typename F>
+void for_each_reader(const ConvShape& s, int64_t p, const F& fn) {
+  const int64_t i[3] = {p / (s.input[1] * s.input[2]), p / s.input[2] % s.input[1],
+                        p % s.input[2]};
+  // the output coordinate of dimension d, or -1
+  auto output = [&](int d, int64_t k) -> int64_t {
+    const int64_t o = i[d] + s.padding[d] - k * s.dilation[d];
+    if (o < 0 || o % s.stride[d] != 0 || o / s.stride[d] >= s.output[d]) {
+      return -1;
+    }
+    return o / s.stride[d];
+  };
+  int64_t t = 0;
+  for (int64_t kd = 0; kd < s.kernel[0]; kd++) {
+    const int64_t od = output(0, kd);
+    for (int64_t kh = 0; kh < s.kernel[1]; kh++) {
+      const int64_t oh = od < 0 ? -1 : output(1, kh);
+      for (int64_t kw = 0; kw < s.kernel[2]; kw++) {
+        const int64_t ow = oh < 0 ? -1 : output(2, kw);
+        fn(t++, ow < 0 ? -1 : (od * s.output[1] + oh) * s.output[2] + ow);
+      }
+    }
+  }
+}
+
+void fill_zero(float* data, int64_t n) {
+  parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    std::fill(data + begin, data + end, 0.f);
+  });
+}
+
+// dst[i] += src[i]
+void add_to(float* dst, const float* src, int64_t n) {
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    (Vec::loadu(dst + i) + Vec::loadu(src + i)).store(dst + i);
+  }
+  if (i < n) {
+    (Vec::loadu(dst + i, n - i) + Vec::loadu(src + i, n - i)).store(dst + i, n - i);
+  }
+}
+
+// Copies bias, cols values, into rows rows of out, ld apart
+void fill_bias(const float* bias, int64_t cols, int64_t rows, float* out, int64_t ld) {
+  const int64_t grain_size = internal::divup(internal::GRAIN_SIZE, cols);
+  parallel_for(0, rows, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t r = begin; r < end; r++) {
+      std::memcpy(out + r * ld, bias, cols * sizeof(float));
+    }
+  });
+}
+
+// Output positions per im2col tile
+int64_t tile_rows(const ConvShape& s) {
+  const int64_t row_bytes = s.taps() * s.in_group_channels() * sizeof(float);
+  return std::min(std::max(kMinTileRows, kColumnBytes / row_bytes), s.output_positions());
+}
+
+// Rows [q_begin, q_end) of the im2col matrix of group g of image input_n:
+// row q holds, tap by tap, the in_group_channels values that the taps read
+// for output position q, zeros in the padding.
+void im2col(
+    const ConvShape& s,
+    const float* input_n,
+    int64_t g,
+    int64_t q_begin,
+    int64_t q_end,
+    float* cols) {
+  const int64_t channels = s.in_group_channels();
+  const int64_t depth = s.taps() * channels;
+  const int64_t grain_size = internal::divup(internal::GRAIN_SIZE, depth);
+  parallel_for(q_begin, q_end, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t q = begin; q < end; q++) {
+      float* dst = cols + (q - q_begin) * depth;
+      for_each_tap(s, q, [&](int64_t t, int64_t p) {
+        if (p < 0) {
+          std::fill(dst + t * channels, dst + (t + 1) * channels, 0.f);
+        } else {
+          std::memcpy(
+              dst + t * channels, input_n + p * s.in_channels + g * channels,
+              channels * sizeof(float));
+        }
+      });
+    }
+  });
+}
+
+// The reverse, adding: the values of the rows to the input positions they
+// came from, in order, on the calling thread
+void col2im(
+    const ConvShape& s,
+    const float* cols,
+    int64_t g,
+    int64_t q_begin,
+    int64_t q_end,
+    float* grad_input_n) {
+  const int64_t channels = s.in_group_channels();
+  const int64_t depth = s.taps() * channels;
+  for (int64_t q = q_begin; q < q_end; q++) {
+    const float* src = cols + (q - q_begin) * depth;
+    for_each_tap(s, q, [&](int64_t t, int64_t p) {
+      if (p >= 0) {
+        add_to(grad_input_n + p * s.in_channels + g * channels, src + t * channels, channels);
+      }
+    });
+  }
+}
+
+// Forward
+
+void forward_pointwise(
+    const ConvShape& s,
+    const float* input,
+    const float* weight,
+    const float* bias,
+    float* output) {
+  const int64_t rows = s.batch * s.output_positions();
+  const int64_t in_channels = s.in_group_channels();
+  const int64_t out_channels = s.out_group_channels();
+  for (int64_t g = 0; g < s.groups; g++) {
+    float* out = output + g * out_channels;
+    if (bias) {
+      fill_bias(bias + g * out_channels, out_channels, rows, out, s.out_channels);
+    }
+    gemm(
+        Transpose::NoTrans, Transpose::Trans, rows, out_channels, in_channels, 1.f,
+        input + g * in_channels, s.in_channels, weight + g * out_channels * in_channels,
+        in_channels, bias ? 1.f : 0.f, out, s.out_channels);
+  }
+}
+
+void forward_im2col(
+    const ConvShape& s,
+    const float* input,
+    const float* weight,
+    const float* bias,
+    float* output) {
+  const int64_t positions = s.output_positions();
+  const int64_t out_channels = s.out_group_channels();
+  const int64_t depth = s.taps() * s.in_group_channels();
+  const int64_t tile = tile_rows(s);
+  const int64_t tiles = internal::divup(positions, tile);
+  // one image, one tile is enough work for a thread; a single one runs its
+  // im2col and GEMM on the pool
+  parallel_for(0, s.batch * tiles, 1, [&](int64_t begin, int64_t end) {
+    auto* cols = static_cast<float*>(column_workspace.get(tile * depth * sizeof(float)));
+    for (int64_t item = begin; item < end; item++) {
+      const int64_t n = item / tiles;
+      const int64_t q_begin = item % tiles * tile;
+      const int64_t rows = std::min(tile, positions - q_begin);
+      const float* input_n = input + n * s.input_positions() * s.in_channels;
+      for (int64_t g = 0; g < s.groups; g++) {
+        im2col(s, input_n, g, q_begin, q_begin + rows, cols);
+        float* out = output + (n * positions + q_begin) * s.out_channels + g * out_channels;
+        if (bias) {
+          fill_bias(bias + g * out_channels, out_channels, rows, out, s.out_channels);
+        }
+        gemm(
+            Transpose::NoTrans, Transpose::Trans, rows, out_channels, depth, 1.f, cols, depth,
+            weight + g * out_channels * depth, depth, bias ? 1.f : 0.f, out, s.out_channels);
+      }
+    }
+  });
+}
+
+// Stores in out, ld apart, the rows x cols tile of output positions x output
+// channels that src reads: src[t][r] is the input of tap t for row r,
+// in_channels values, and w the weights as depth rows of cols, ldw apart.
+void direct_tile(
+    const float* const (*src)[kDirectRows],
+    int64_t taps,
+    int64_t in_channels,
+    const float* w,
+    int64_t ldw,
+    const float* bias,
+    int64_t rows,
+    int64_t cols,
+    float* out,
+    int64_t ld) {
+  constexpr int64_t kWidth = Vec::size();
+  Vec acc0[kDirectRows];
+  Vec acc1[kDirectRows];
+  ForcedUnroll<kDirectRows>{}([&](auto r) {
+    acc0[r] = Vec(0.f);
+    acc1[r] = Vec(0.f);
+  });
+  for (int64_t t = 0; t < taps; t++) {
+    for (int64_t c = 0; c < in_channels; c++) {
+      const Vec w0 = Vec::loadu(w);
+      const Vec w1 = Vec::loadu(w + kWidth);
+      ForcedUnroll<kDirectRows>{}([&](auto r) {
+        const Vec a(src[t][r][c]);
+        acc0[r] = fmadd(a, w0, acc0[r]);
+        acc1[r] = fmadd(a, w1, acc1[r]);
+      });
+      w += ldw;
+    }
+  }
+  const int64_t cols0 = std::min(cols, kWidth);
+  const int64_t cols1 = cols - cols0;
+  const Vec bias0 = bias ? Vec::loadu(bias, cols0) : Vec(0.f);
+  const Vec bias1 = bias && cols1 > 0 ? Vec::loadu(bias + kWidth, cols1) : Vec(0.f);
+  for (int64_t r = 0; r < rows; r++) {
+    (acc0[r] + bias0).store(out + r * ld, cols0);
+    if (cols1 > 0) {
+      (acc1[r] + bias1).store(out + r * ld + kWidth, cols1);
+    }
+  }
+}
+
+void forward_direct(
+    const ConvShape& s,
+    const float* input,
+    const float* weight,
+    const float* bias,
+    float* output) {
+  constexpr int64_t kTileCols = 2 * Vec::size();
+  const int64_t positions = s.output_positions();
+  const int64_t taps = s.taps();
+  const int64_t in_channels = s.in_group_channels();
+  const int64_t out_channels = s.out_group_channels();
+  const int64_t depth = taps * in_channels;
+  // the weights of each group as depth rows of ldw output channels, zero
+  // padded to whole tiles
+  const int64_t ldw = round_up(out_channels, kTileCols);
+  auto* packed =
+      static_cast<float*>(weight_workspace.get(s.groups * depth * ldw * sizeof(float)));
+  for (int64_t g = 0; g < s.groups; g++) {
+    for (int64_t i = 0; i < depth; i++) {
+      float* dst = packed + (g * depth + i) * ldw;
+      for (int64_t oc = 0; oc < ldw; oc++) {
+        dst[oc] = oc < out_channels ? weight[(g * out_channels + oc) * depth + i] : 0.f;
+      }
+    }
+  }
+  const int64_t blocks = internal::divup(positions, kDirectRows);
+  const int64_t grain_size =
+      internal::divup(internal::GRAIN_SIZE, kDirectRows * s.out_channels);
+  parallel_for(0, s.batch * blocks, grain_size, [&](int64_t begin, int64_t end) {
+    const float* src[kDirectMaxDepth][kDirectRows];
+    for (int64_t item = begin; item < end; item++) {
+      const int64_t n = item / blocks;
+      const int64_t q = item % blocks * kDirectRows;
+      const int64_t rows = std::min(kDirectRows, positions - q);
+      const float* input_n = input + n * s.input_positions() * s.in_channels;
+      float* out_rows = output + (n * positions + q) * s.out_channels;
+      for (int64_t g = 0; g < s.groups; g++) {
+        for (int64_t r = 0; r < kDirectRows; r++) {
+          if (r < rows) {
+            for_each_tap(s, q + r, [&](int64_t t, int64_t p) {
+              src[t][r] = p < 0 ? kZeros : input_n + p * s.in_channels + g * in_channels;
+            });
+          } else {
+            for (int64_t t = 0; t < taps; t++) {
+              src[t][r] = kZeros;
+            }
+          }
+        }
+        for (int64_t oc = 0; oc < out_channels; oc += kTileCols) {
+          const int64_t channel = g * out_channels + oc;
+          direct_tile(
+              src, taps, in_channels, packed + g * depth * ldw + oc, ldw,
+              bias ? bias + channel : nullptr, rows, std::min(kTileCols, out_channels - oc),
+              out_rows + channel, s.out_channels);
+        }
+      }
+    }
+  });
+}
+
+// Sums, over the taps (index, input position) of one output position, the
+// products of their channels with the weights wt, [taps][channels], into out
+void depthwise_position(
+    const int64_t* tap_index,
+    const int64_t* tap_position,
+    int64_t num_taps,
+    const float* input_n,
+    const float* wt,
+    const float* bias,
+    int64_t channels,
+    float* out) {
+  constexpr int64_t kWidth = Vec::size();
+  int64_t c = 0;
+  for (; c + 4 * kWidth <= channels; c += 4 * kWidth) {
+    Vec acc[4];
+    ForcedUnroll<4>{}([&](auto v) {
+      acc[v] = bias ? Vec::loadu(bias + c + v * kWidth) : Vec(0.f);
+    });
+    for (int64_t i = 0; i < num_taps; i++) {
+      const float* in = input_n + tap_position[i] * channels + c;
+      const float* w = wt + tap_index[i] * channels + c;
+      ForcedUnroll<4>{}([&](auto v) {
+        acc[v] = fmadd(Vec::loadu(in + v * kWidth), Vec::loadu(w + v * kWidth), acc[v]);
+      });
+    }
+    ForcedUnroll<4>{}([&](auto v) { acc[v].store(out + c + v * kWidth); });
+  }
+  for (; c < channels; c += kWidth) {
+    const int64_t count = std::min(kWidth, channels - c);
+    Vec acc = bias ? Vec::loadu(bias + c, count) : Vec(0.f);
+    for (int64_t i = 0; i < num_taps; i++) {
+      acc = fmadd(
+          Vec::loadu(input_n + tap_position[i] * channels + c, count),
+          Vec::loadu(wt + tap_index[i] * channels + c, count), acc);
+    }
+    acc.store(out + c, count);
+  }
+}
+
+// The weights of a depthwise convolution, [channels][taps], as [taps][channels]
+const float* depthwise_weights(const ConvShape& s, const float* weight) {
+  const int64_t channels = s.in_channels;
+  auto* wt = static_cast<float*>(weight_workspace.get(s.taps() * channels * sizeof(float)));
+  for (int64_t t = 0; t < s.taps(); t++) {
+    for (int64_t c = 0; c < channels; c++) {
+      wt[t * channels + c] = weight[c * s.taps() + t];
+    }
+  }
+  return wt;
+}
+
+void forward_depthwise(
+    const ConvShape& s,
+    const float* input,
+    const float* weight,
+    const float* bias,
+    float* output) {
+  const int64_t channels = s.in_channels;
+  const int64_t positions = s.output_positions();
+  const int64_t taps = s.taps();
+  const float* wt = depthwise_weights(s, weight);
+  const int64_t grain_size = internal::divup(internal::GRAIN_SIZE, channels * taps);
+  parallel_for(0, s.batch * positions, grain_size, [&](int64_t begin, int64_t end) {
+    auto* tap_index = static_cast<int64_t*>(column_workspace.get(2 * taps * sizeof(int64_t)));
+    int64_t* tap_position = tap_index + taps;
+    for (int64_t item = begin; item < end; item++) {
+      const int64_t n = item / positions;
+      const int64_t q = item % positions;
+      int64_t num_taps = 0;
+      for_each_tap(s, q, [&](int64_t t, int64_t p) {
+        if (p >= 0) {
+          tap_index[num_taps] = t;
+          tap_position[num_taps++] = p;
+        }
+      });
+      depthwise_position(
+          tap_index, tap_position, num_taps, input + n * s.input_positions() * channels, wt,
+          bias, channels, output + item * channels);
+    }
+  });
+}
+
+void conv_forward_kernel(
+    const ConvShape& s,
+    const float* input,
+    const float* weight,
+    const float* bias,
+    float* output) {
+  switch (choose_algorithm(s)) {
+    case ConvAlgorithm::Depthwise:
+      forward_depthwise(s, input, weight, bias, output);
+      break;
+    case ConvAlgorithm::Pointwise:
+      forward_pointwise(s, input, weight, bias, output);
+      break;
+    case ConvAlgorithm::Direct:
+      forward_direct(s, input, weight, bias, output);
+      break;
+    case ConvAlgorithm::Im2col:
+      forward_im2col(s, input, weight, bias, output);
+      break;
+  }
+}
+
+// Gradient of the input
+
+void backward_input_depthwise(
+    const ConvShape& s,
+    const float* grad_output,
+    const float* weight,
+    float* grad_input) {
+  const int64_t channels = s.in_channels;
+  const int64_t positions = s.input_positions();
+  const int64_t taps = s.taps();
+  const float* wt = depthwise_weights(s, weight);
+  const int64_t grain_size = internal::divup(internal::GRAIN_SIZE, channels * taps);
+  // each input position gathers from the output positions that read it
+  parallel_for(0, s.batch * positions, grain_size, [&](int64_t begin, int64_t end) {
+    auto* tap_index = static_cast<int64_t*>(column_workspace.get(2 * taps * sizeof(int64_t)));
+    int64_t* tap_position = tap_index + taps;
+    for (int64_t item = begin; item < end; item++) {
+      const int64_t n = item / positions;
+      const int64_t p = item % positions;
+      int64_t num_taps = 0;
+      for_each_reader(s, p, [&](int64_t t, int64_t q) {
+        if (q >= 0) {
+          tap_index[num_taps] = t;
+          tap_position[num_taps++] = q;
+        }
+      });
+      depthwise_position(
+          tap_index, tap_position, num_taps, grad_output + n * s.output_positions() * channels,
+          wt, nullptr, channels, grad_input + item * channels);
+    }
+  });
+}
+
+void backward_input_pointwise(
+    const ConvShape& s,
+    const float* grad_output,
+    const float* weight,
+    float* grad_input) {
+  const int64_t rows = s.batch * s.output_positions();
+  const int64_t in_channels = s.in_group_channels();
+  const int64_t out_channels = s.out_group_channels();
+  for (int64_t g = 0; g < s.groups; g++) {
+    gemm(
+        Transpose::NoTrans, Transpose::NoTrans, rows, in_channels, out_channels, 1.f,
+        grad_output + g * out_channels, s.out_channels,
+        weight + g * out_channels * in_channels, in_channels, 0.f, grad_input + g * in_channels,
+        s.in_channels);
+  }
+}
+
+void backward_input_im2col(
+    const ConvShape& s,
+    const float* grad_output,
+    const float* weight,
+    float* grad_input) {
+  const int64_t positions = s.output_positions();
+  const int64_t out_channels = s.out_group_channels();
+  const int64_t depth = s.taps() * s.in_group_channels();
+  const int64_t tile = tile_rows(s);
+  fill_zero(grad_input, s.batch * s.input_positions() * s.in_channels);
+  // The tiles of an image add to overlapping input positions, so images
+  // are the unit of work: one per thread when there are enough, else one
+  // after the other with the GEMMs on the pool
+  auto image = [&](int64_t n) {
+    auto* cols = static_cast<float*>(column_workspace.get(tile * depth * sizeof(float)));
+    float* grad_input_n = grad_input + n * s.input_positions() * s.in_channels;
+    for (int64_t q = 0; q < positions; q += tile) {
+      const int64_t rows = std::min(tile, positions - q);
+      for (int64_t g = 0; g < s.groups; g++) {
+        gemm(
+            Transpose::NoTrans, Transpose::NoTrans, rows, depth, out_channels, 1.f,
+            grad_output + (n * positions + q) * s.out_channels + g * out_channels,
+            s.out_channels, weight + g * out_channels * depth, depth, 0.f, cols, depth);
+        col2im(s, cols, g, q, q + rows, grad_input_n);
+      }
+    }
+  };
+  if (s.batch >= get_num_threads()) {
+    parallel_for(0, s.batch, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t n = begin; n < end; n++) {
+        image(n);
+      }
+    });
+  } else {
+    for (int64_t n = 0; n < s.batch; n++) {
+      image(n);
+    }
+  }
+}
+
+void conv_backward_input_kernel(
+    const ConvShape& s,
+    const float* grad_output,
+    const float* weight,
+    float* grad_input) {
+  switch (choose_algorithm(s)) {
+    case ConvAlgorithm::Depthwise:
+      backward_input_depthwise(s, grad_output, weight, grad_input);
+      break;
+    case ConvAlgorithm::Pointwise:
+      backward_input_pointwise(s, grad_output, weight, grad_input);
+      break;
+    case ConvAlgorithm::Direct:
+    case ConvAlgorithm::Im2col:
+      backward_input_im2col(s, grad_output, weight, grad_input);
+      break;
+  }
+}
+
+// Gradient of the weight
+
+void backward_weight_depthwise(
+    const ConvShape& s,
+    const float* grad_output,
+    const float* input,
+    float* grad_weight) {
+  const int64_t channels = s.in_channels;
+  const int64_t positions = s.output_positions();
+  const int64_t taps = s.taps();
+  const int64_t blocks = internal::divup(channels, kDepthwiseBlock);
+  // per image partial sums, [batch][taps][channels], added in order below so
+  // that the result does not depend on the thread count
+  auto* partial = static_cast<float*>(
+      weight_workspace.get(s.batch * taps * channels * sizeof(float)));
+  parallel_for(0, s.batch * blocks, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t item = begin; item < end; item++) {
+      const int64_t n = item / blocks;
+      const int64_t c = item % blocks * kDepthwiseBlock;
+      const int64_t width = std::min(kDepthwiseBlock, channels - c);
+      float* part = partial + n * taps * channels + c;
+      for (int64_t t = 0; t < taps; t++) {
+        std::fill(part + t * channels, part + t * channels + width, 0.f);
+      }
+      const float* input_n = input + n * s.input_positions() * channels + c;
+      for (int64_t q = 0; q < positions; q++) {
+        const float* go = grad_output + (n * positions + q) * channels + c;
+        for_each_tap(s, q, [&](int64_t t, int64_t p) {
+          if (p < 0) {
+            return;
+          }
+          const float* in = input_n + p * channels;
+          float* dst = part + t * channels;
+          int64_t i = 0;
+          for (; i + Vec::size() <= width; i += Vec::size()) {
+            fmadd(Vec::loadu(go + i), Vec::loadu(in + i), Vec::loadu(dst + i)).store(dst + i);
+          }
+          if (i < width) {
+            const int64_t count = width - i;
+            fmadd(
+                Vec::loadu(go + i, count), Vec::loadu(in + i, count), Vec::loadu(dst + i, count))
+                .store(dst + i, count);
+          }
+        });
+      }
+    }
+  });
+  const int64_t grain_size = internal::divup(internal::GRAIN_SIZE, taps * s.batch);
+  parallel_for(0, channels, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t c = begin; c < end; c++) {
+      for (int64_t t = 0; t < taps; t++) {
+        float sum = 0;
+        for (int64_t n = 0; n < s.batch; n++) {
+          sum += partial[(n * taps + t) * channels + c];
+        }
+        grad_weight[c * taps + t] = sum;
+      }
+    }
+  });
+}
+
+void backward_weight_pointwise(
+    const ConvShape& s,
+    const float* grad_output,
+    const float* input,
+    float* grad_weight) {
+  const int64_t rows = s.batch * s.output_positions();
+  const int64_t in_channels = s.in_group_channels();
+  const int64_t out_channels = s.out_group_channels();
+  for (int64_t g = 0; g < s.groups; g++) {
+    gemm(
+        Transpose::Trans, Transpose::NoTrans, out_channels, in_channels, rows, 1.f,
+        grad_output + g * out_channels, s.out_channels, input + g * in_channels, s.in_channels,
+        0.f, grad_weight + g * out_channels * in_channels, in_channels);
+  }
+}
+
+// The tiles add to the whole weight gradient, so they run one after the
+// other, each im2col and GEMM on the pool
+void backward_weight_im2col(
+    const ConvShape& s,
+    const float* grad_output,
+    const float* input,
+    float* grad_weight) {
+  const int64_t positions = s.output_positions();
+  const int64_t out_channels = s.out_group_channels();
+  const int64_t depth = s.taps() * s.in_group_channels();
+  const int64_t tile = tile_rows(s);
+  if (s.batch == 0) {
+    fill_zero(grad_weight, s.out_channels * depth);
+    return;
+  }
+  auto* cols = static_cast<float*>(column_workspace.get(tile * depth * sizeof(float)));
+  for (int64_t n = 0; n < s.batch; n++) {
+    const float* input_n = input + n * s.input_positions() * s.in_channels;
+    for (int64_t q = 0; q < positions; q += tile) {
+      const int64_t rows = std::min(tile, positions - q);
+      const float beta = n == 0 && q == 0 ? 0.f : 1.f;
+      for (int64_t g = 0; g < s.groups; g++) {
+        im2col(s, input_n, g, q, q + rows, cols);
+        gemm(
+            Transpose::Trans, Transpose::NoTrans, out_channels, depth, rows, 1.f,
+            grad_output + (n * positions + q) * s.out_channels + g * out_channels,
+            s.out_channels, cols, depth, beta, grad_weight + g * out_channels * depth, depth);
+      }
+    }
+  }
+}
+
+void conv_backward_weight_kernel(
+    const ConvShape& s,
+    const float* grad_output,
+    const float* input,
+    float* grad_weight) {
+  switch (choose_algorithm(s)) {
+    case ConvAlgorithm::Depthwise:
+      backward_weight_depthwise(s, grad_output, input, grad_weight);
+      break;
+    case ConvAlgorithm::Pointwise:
+      backward_weight_pointwise(s, grad_output, input, grad_weight);
+      break;
+    case ConvAlgorithm::Direct:
+    case ConvAlgorithm::Im2col:
+      backward_weight_im2col(s, grad_output, input, grad_weight);
+      break;
+  }
+}
+
+} // namespace
+
+REGISTER_DISPATCH(conv_forward_stub, &conv_forward_kernel);
+REGISTER_DISPATCH(conv_backward_input_stub, &conv_backward_input_kernel);
+REGISTER_DISPATCH(conv_backward_weight_stub, &conv_backward_weight_kernel);
+
+} // namespace c10
@@ -0,0 +1,75 @@
+#pragma once
+
+#include <c10/util/DispatchStub.h>
+
+#include <cstdint>
+
+// Kernels of the convolutions in c10/core/ConvOps.h.
+
+namespace c10 {
+
+// Sizes of a float convolution over channels last buffers:
+//
+//   input  [batch, input[0], input[1], input[2], in_channels]
+//   weight [out_channels, kernel[0], kernel[1], kernel[2], in_channels / groups]
+//   output [batch, output[0], output[1], output[2], out_channels]
+//
+// with depth, height and width in the arrays; a 2-d convolution has a depth
+// of 1 everywhere.  Sizes are checked by the caller.
+struct ConvShape {
+  int64_t batch = 0;
+  int64_t in_channels = 0;
+  int64_t out_channels = 0;
+  int64_t groups = 1;
+  int64_t input[3] = {1, 1, 1};
+  int64_t output[3] = {1, 1, 1};
+  int64_t kernel[3] = {1, 1, 1};
+  int64_t stride[3] = {1, 1, 1};
+  int64_t padding[3] = {0, 0, 0};
+  int64_t dilation[3] = {1, 1, 1};
+
+  int64_t input_positions() const {
+    return input[0] * input[1] * input[2];
+  }
+  int64_t output_positions() const {
+    return output[0] * output[1] * output[2];
+  }
+  int64_t taps() const {
+    return kernel[0] * kernel[1] * kernel[2];
+  }
+  int64_t in_group_channels() const {
+    return in_channels / groups;
+  }
+  int64_t out_group_channels() const {
+    return out_channels / groups;
+  }
+};
+
+// output = conv(input, weight) + bias; bias has out_channels values, or is
+// null.
+using conv_forward_fn = void (*)(
+    const ConvShape& shape,
+    const float* input,
+    const float* weight,
+    const float* bias,
+    float* output);
+
+// The gradient of the input, from the gradient of the output
+using conv_backward_input_fn = void (*)(
+    const ConvShape& shape,
+    const float* grad_output,
+    const float* weight,
+    float* grad_input);
+
+// The gradient of the weight, from the gradient of the output
+using conv_backward_weight_fn = void (*)(
+    const ConvShape& shape,
+    const float* grad_output,
+    const float* input,
+    float* grad_weight);
+
+DECLARE_DISPATCH(conv_forward_fn, conv_forward_stub);
+DECLARE_DISPATCH(conv_backward_input_fn, conv_backward_input_stub);
+DECLARE_DISPATCH(conv_backward_weight_fn, conv_backward_weight_stub);
+
+} // namespace c10
@@ -0,0 +1,293 @@
+#include <c10/cpu/ConvertKernel.h>
+
+#if defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX512)
+#include <immintrin.h>
+#endif
+
+// vcvtneps2bf16 is not part of any CPUCapability, the AVX512 kernel checks
+// for it at runtime and enables it per function.
+#if defined(CPU_CAPABILITY_AVX512) &&                             \
+    ((defined(__clang__) && __clang_major__ >= 9) ||              \
+     (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 10))
+#define C10_CONVERT_AVX512_BF16 1
+#else
+#define C10_CONVERT_AVX512_BF16 0
+#endif
+
+namespace c10 {
+namespace {
+
+#if !defined(CPU_CAPABILITY_AVX512)
+
+// The scalar conversions from Half.h and BFloat16.h, unrolled so the
+// independent chains overlap.  These are the DEFAULT kernels and handle the
+// tails of the AVX2 kernels.
+
+void half_to_float_scalar(const Half* src, float* dst, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    dst[i] = detail::fp16_ieee_to_fp32_value(src[i].x);
+    dst[i + 1] = detail::fp16_ieee_to_fp32_value(src[i + 1].x);
+    dst[i + 2] = detail::fp16_ieee_to_fp32_value(src[i + 2].x);
+    dst[i + 3] = detail::fp16_ieee_to_fp32_value(src[i + 3].x);
+  }
+  for (; i < n; ++i) {
+    dst[i] = detail::fp16_ieee_to_fp32_value(src[i].x);
+  }
+}
+
+void float_to_half_scalar(const float* src, Half* dst, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    dst[i].x = detail::fp16_ieee_from_fp32_value(src[i]);
+    dst[i + 1].x = detail::fp16_ieee_from_fp32_value(src[i + 1]);
+    dst[i + 2].x = detail::fp16_ieee_from_fp32_value(src[i + 2]);
+    dst[i + 3].x = detail::fp16_ieee_from_fp32_value(src[i + 3]);
+  }
+  for (; i < n; ++i) {
+    dst[i].x = detail::fp16_ieee_from_fp32_value(src[i]);
+  }
+}
+
+void bfloat16_to_float_scalar(const BFloat16* src, float* dst, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    dst[i] = detail::f32_from_bits(src[i].x);
+    dst[i + 1] = detail::f32_from_bits(src[i + 1].x);
+    dst[i + 2] = detail::f32_from_bits(src[i + 2].x);
+    dst[i + 3] = detail::f32_from_bits(src[i + 3].x);
+  }
+  for (; i < n; ++i) {
+    dst[i] = detail::f32_from_bits(src[i].x);
+  }
+}
+
+void float_to_bfloat16_scalar(const float* src, BFloat16* dst, size_t n) {
+  size_t i = 0;
+  for (; i + 4 <= n; i += 4) {
+    dst[i].x = detail::round_to_nearest_even(src[i]);
+    dst[i + 1].x = detail::round_to_nearest_even(src[i + 1]);
+    dst[i + 2].x = detail::round_to_nearest_even(src[i + 2]);
+    dst[i + 3].x = detail::round_to_nearest_even(src[i + 3]);
+  }
+  for (; i < n; ++i) {
+    dst[i].x = detail::round_to_nearest_even(src[i]);
+  }
+}
+
+#endif // !defined(CPU_CAPABILITY_AVX512)
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+// vcvtph2ps is exact, and quiets signaling NaNs the same way the scalar
+// path's multiply does.  vcvtps2ph rounds to nearest even like the scalar
+// path, but keeps NaN payloads, while fp16_ieee_from_fp32_value returns the
+// canonical NaN 0x7E00 (with the input's sign); we patch NaN lanes to match.
+//
+// For BFloat16 we do round_to_nearest_even's integer rounding lane-wise: add
+// 0x7FFF plus the lowest kept bit, shift, and replace NaNs by 0x7FC0.
+// vcvtneps2bf16 rounds the same way, except that it flushes denormal inputs
+// to zero and keeps NaN payloads, so those lanes are redone with the integer
+// rounding.
+
+inline __mmask16 tail_mask(size_t remaining) {
+  return remaining >= 16 ? static_cast<__mmask16>(0xFFFF)
+                         : static_cast<__mmask16>((1u << remaining) - 1);
+}
+
+void half_to_float_kernel(const Half* src, float* dst, size_t n) {
+  size_t i = 0;
+  for (; i + 32 <= n; i += 32) {
+    const __m256i h0 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i h1 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i + 16));
+    _mm512_storeu_ps(dst + i, _mm512_cvtph_ps(h0));
+    _mm512_storeu_ps(dst + i + 16, _mm512_cvtph_ps(h1));
+  }
+  for (; i < n; i += 16) {
+    const __mmask16 mask = tail_mask(n - i);
+    const __m256i h = _mm256_maskz_loadu_epi16(mask, src + i);
+    _mm512_mask_storeu_ps(dst + i, mask, _mm512_cvtph_ps(h));
+  }
+}
+
+void float_to_half_kernel(const float* src, Half* dst, size_t n) {
+  const __m256i sign_mask = _mm256_set1_epi16(static_cast<int16_t>(0x8000));
+  const __m256i canonical_nan = _mm256_set1_epi16(0x7E00);
+  for (size_t i = 0; i < n; i += 16) {
+    const __mmask16 mask = tail_mask(n - i);
+    const __m512 f = _mm512_maskz_loadu_ps(mask, src + i);
+    __m256i h = _mm512_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT);
+    const __mmask16 nan = _mm512_cmp_ps_mask(f, f, _CMP_UNORD_Q);
+    h = _mm256_mask_blend_epi16(
+        nan, h, _mm256_or_si256(_mm256_and_si256(h, sign_mask), canonical_nan));
+    _mm256_mask_storeu_epi16(dst + i, mask, h);
+  }
+}
+
+inline __m512i round_to_nearest_even_avx512(__m512 f) {
+  const __m512i u = _mm512_castps_si512(f);
+  const __m512i lsb =
+      _mm512_and_si512(_mm512_srli_epi32(u, 16), _mm512_set1_epi32(1));
+  const __m512i bias = _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7FFF));
+  const __m512i rounded = _mm512_srli_epi32(_mm512_add_epi32(u, bias), 16);
+  const __mmask16 nan = _mm512_cmp_ps_mask(f, f, _CMP_UNORD_Q);
+  return _mm512_mask_blend_epi32(nan, rounded, _mm512_set1_epi32(0x7FC0));
+}
+
+void bfloat16_to_float_kernel(const BFloat16* src, float* dst, size_t n) {
+  for (size_t i = 0; i < n; i += 16) {
+    const __mmask16 mask = tail_mask(n - i);
+    const __m256i b = _mm256_maskz_loadu_epi16(mask, src + i);
+    const __m512i u = _mm512_slli_epi32(_mm512_cvtepu16_epi32(b), 16);
+    _mm512_mask_storeu_ps(dst + i, mask, _mm512_castsi512_ps(u));
+  }
+}
+
+#if C10_CONVERT_AVX512_BF16
+__attribute__((target("avx512bf16"))) void float_to_bfloat16_avx512_bf16(
+    const float* src,
+    BFloat16* dst,
+    size_t n) {
+  const __m512i abs_mask = _mm512_set1_epi32(0x7FFFFFFF);
+  const __m512i min_normal = _mm512_set1_epi32(0x00800000);
+  const __m512i inf = _mm512_set1_epi32(0x7F800000);
+  for (size_t i = 0; i < n; i += 16) {
+    const __mmask16 mask = tail_mask(n - i);
+    const __m512 f = _mm512_maskz_loadu_ps(mask, src + i);
+    __m256i b = reinterpret_cast<__m256i>(_mm512_cvtneps_pbh(f));
+    const __m512i abs = _mm512_and_si512(_mm512_castps_si512(f), abs_mask);
+    // nonzero denormals and NaNs
+    const __mmask16 special =
+        _mm512_mask_cmplt_epu32_mask(
+            _mm512_test_epi32_mask(abs, abs), abs, min_normal) |
+        _mm512_cmpgt_epu32_mask(abs, inf);
+    if (C10_UNLIKELY(special != 0)) {
+      b = _mm256_mask_blend_epi16(
+          special, b, _mm512_cvtepi32_epi16(round_to_nearest_even_avx512(f)));
+    }
+    _mm256_mask_storeu_epi16(dst + i, mask, b);
+  }
+}
+#endif
+
+void float_to_bfloat16_kernel(const float* src, BFloat16* dst, size_t n) {
+#if C10_CONVERT_AVX512_BF16
+  static const bool has_bf16 = cpu::cpuFeatures().avx512bf16;
+  if (has_bf16) {
+    float_to_bfloat16_avx512_bf16(src, dst, n);
+    return;
+  }
+#endif
+  for (size_t i = 0; i < n; i += 16) {
+    const __mmask16 mask = tail_mask(n - i);
+    const __m512 f = _mm512_maskz_loadu_ps(mask, src + i);
+    const __m256i b = _mm512_cvtepi32_epi16(round_to_nearest_even_avx512(f));
+    _mm256_mask_storeu_epi16(dst + i, mask, b);
+  }
+}
+
+#elif defined(CPU_CAPABILITY_AVX2)
+
+// See the AVX512 kernels above for the NaN and rounding fixups.
+
+inline __m128i nan_fixup_f16c(__m256 in, __m128i out) {
+  const __m256i nan =
+      _mm256_castps_si256(_mm256_cmp_ps(in, in, _CMP_UNORD_Q));
+  const __m128i nan16 = _mm_packs_epi32(
+      _mm256_castsi256_si128(nan), _mm256_extractf128_si256(nan, 1));
+  const __m128i canonical = _mm_or_si128(
+      _mm_and_si128(out, _mm_set1_epi16(static_cast<int16_t>(0x8000))),
+      _mm_set1_epi16(0x7E00));
+  return _mm_blendv_epi8(out, canonical, nan16);
+}
+
+void half_to_float_kernel(const Half* src, float* dst, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m128i h0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m128i h1 =
+        _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i + 8));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h0));
+    _mm256_storeu_ps(dst + i + 8, _mm256_cvtph_ps(h1));
+  }
+  for (; i + 8 <= n; i += 8) {
+    const __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    _mm256_storeu_ps(dst + i, _mm256_cvtph_ps(h));
+  }
+  half_to_float_scalar(src + i, dst + i, n - i);
+}
+
+void float_to_half_kernel(const float* src, Half* dst, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256 f = _mm256_loadu_ps(src + i);
+    const __m128i h = _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + i), nan_fixup_f16c(f, h));
+  }
+  float_to_half_scalar(src + i, dst + i, n - i);
+}
+
+inline __m256i round_to_nearest_even_avx2(__m256 f) {
+  const __m256i u = _mm256_castps_si256(f);
+  const __m256i lsb =
+      _mm256_and_si256(_mm256_srli_epi32(u, 16), _mm256_set1_epi32(1));
+  const __m256i bias = _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7FFF));
+  const __m256i rounded = _mm256_srli_epi32(_mm256_add_epi32(u, bias), 16);
+  const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(f, f, _CMP_UNORD_Q));
+  return _mm256_blendv_epi8(rounded, _mm256_set1_epi32(0x7FC0), nan);
+}
+
+void bfloat16_to_float_kernel(const BFloat16* src, float* dst, size_t n) {
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+    const __m256i u = _mm256_slli_epi32(_mm256_cvtepu16_epi32(b), 16);
+    _mm256_storeu_ps(dst + i, _mm256_castsi256_ps(u));
+  }
+  bfloat16_to_float_scalar(src + i, dst + i, n - i);
+}
+
+void float_to_bfloat16_kernel(const float* src, BFloat16* dst, size_t n) {
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m256i lo = round_to_nearest_even_avx2(_mm256_loadu_ps(src + i));
+    const __m256i hi = round_to_nearest_even_avx2(_mm256_loadu_ps(src + i + 8));
+    // packus works within 128-bit lanes; put the quadwords back in order
+    const __m256i packed = _mm256_permute4x64_epi64(
+        _mm256_packus_epi32(lo, hi), _MM_SHUFFLE(3, 1, 2, 0));
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(dst + i), packed);
+  }
+  float_to_bfloat16_scalar(src + i, dst + i, n - i);
+}
+
+#else
+
+void half_to_float_kernel(const Half* src, float* dst, size_t n) {
+  half_to_float_scalar(src, dst, n);
+}
+
+void float_to_half_kernel(const float* src, Half* dst, size_t n) {
+  float_to_half_scalar(src, dst, n);
+}
+
+void bfloat16_to_float_kernel(const BFloat16* src, float* dst, size_t n) {
+  bfloat16_to_float_scalar(src, dst, n);
+}
+
+void float_to_bfloat16_kernel(const float* src, BFloat16* dst, size_t n) {
+  float_to_bfloat16_scalar(src, dst, n);
+}
+
+#endif
+
+} // namespace
+
+REGISTER_DISPATCH(half_to_float_stub, &half_to_float_kernel);
+REGISTER_DISPATCH(float_to_half_stub, &float_to_half_kernel);
+REGISTER_DISPATCH(bfloat16_to_float_stub, &bfloat16_to_float_kernel);
+REGISTER_DISPATCH(float_to_bfloat16_stub, &float_to_bfloat16_kernel);
+
+} // namespace c10
@@ -0,0 +1,21 @@
+#pragma once
+
+#include <c10/util/BFloat16.h>
+#include <c10/util/DispatchStub.h>
+#include <c10/util/Half.h>
+
+// Kernels of the bulk conversions in Half.h and BFloat16.h.
+
+namespace c10 {
+
+using half_to_float_fn = void (*)(const Half*, float*, size_t);
+using float_to_half_fn = void (*)(const float*, Half*, size_t);
+using bfloat16_to_float_fn = void (*)(const BFloat16*, float*, size_t);
+using float_to_bfloat16_fn = void (*)(const float*, BFloat16*, size_t);
+
+DECLARE_DISPATCH(half_to_float_fn, half_to_float_stub);
+DECLARE_DISPATCH(float_to_half_fn, float_to_half_stub);
+DECLARE_DISPATCH(bfloat16_to_float_fn, bfloat16_to_float_stub);
+DECLARE_DISPATCH(float_to_bfloat16_fn, float_to_bfloat16_stub);
+
+} // namespace c10
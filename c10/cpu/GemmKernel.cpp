@@ -0,0 +1,322 @@
+#include <c10/cpu/GemmKernel.h>
+#include <c10/core/Workspace.h>
+#include <c10/cpu/vec/vec.h>
+#include <c10/util/Exception.h>
+#include <c10/util/Parallel.h>
+#include <c10/util/Unroll.h>
+
+#include <algorithm>
+#include <cstddef>
+#include <cstring>
+
+namespace c10 {
+namespace {
+
+using namespace vec;
+
+// Rows of the register tile of C, whose columns are two vectors
+constexpr int64_t kMR = 6;
+// Depth of the packed panels: a kKC x NR micro-panel of op(B) stays in L1
+constexpr int64_t kKC = 256;
+// Rows of the packed blocks of op(A), which stay in L2
+constexpr int64_t kMC = 16 * kMR;
+// Products of fewer multiply-adds than this run on one thread
+constexpr int64_t kMinParallelWork = int64_t(1) << 18;
+// Below this, the products of a batch run one per thread
+constexpr int64_t kMinSplitWork = int64_t(1) << 21;
+
+// Columns of the register tile
+template <typename T>
+constexpr int64_t tile_cols() {
+  return 2 * Vectorized<T>::size();
+}
+
+// Columns of the packed panels of op(B), 4 MB of them at kKC rows
+template <typename T>
+constexpr int64_t panel_cols() {
+  return 16384 / sizeof(T);
+}
+
+// Threads take kMC x block_cols blocks of C
+template <typename T>
+constexpr int64_t block_cols() {
+  return 8 * tile_cols<T>();
+}
+
+int64_t round_up(int64_t x, int64_t multiple) {
+  return internal::divup(x, multiple) * multiple;
+}
+
+// Packed blocks of op(A), each thread packing those it multiplies
+thread_local Workspace a_workspace;
+// Packed panels of op(B), shared by the threads of a product
+thread_local Workspace b_workspace;
+
+// Packs rows x kc values of op(A), from a = &op(A)(i, p), as kc columns of kMR
+// values.  Rows past rows are zero.
+template <typename T>
+void pack_a(const T* a, int64_t lda, Transpose trans, int64_t rows, int64_t kc, T* dst) {
+  if (trans == Transpose::NoTrans) {
+    for (int64_t r = 0; r < rows; r++) {
+      for (int64_t p = 0; p < kc; p++) {
+        dst[p * kMR + r] = a[r * lda + p];
+      }
+    }
+  } else {
+    for (int64_t p = 0; p < kc; p++) {
+      std::memcpy(dst + p * kMR, a + p * lda, rows * sizeof(T));
+    }
+  }
+  for (int64_t p = 0; p < kc; p++) {
+    std::fill(dst + p * kMR + rows, dst + (p + 1) * kMR, T(0));
+  }
+}
+
+// Packs rows [i_begin, i_end) and columns [pc, pc + kc) of op(A) as panels
+// of kMR rows
+template <typename T>
+void pack_a_block(
+    const T* a,
+    int64_t lda,
+    Transpose trans,
+    int64_t i_begin,
+    int64_t i_end,
+    int64_t pc,
+    int64_t kc,
+    T* dst) {
+  for (int64_t i = i_begin; i < i_end; i += kMR) {
+    const T* src = trans == Transpose::NoTrans ? a + i * lda + pc : a + pc * lda + i;
+    pack_a(src, lda, trans, std::min(kMR, i_end - i), kc, dst + (i - i_begin) * kc);
+  }
+}
+
+// Packs kc x cols values of op(B), from b = &op(B)(p, j), as kc rows of NR
+// values.  Columns past cols are zero.
+template <typename T>
+void pack_b(const T* b, int64_t ldb, Transpose trans, int64_t kc, int64_t cols, T* dst) {
+  constexpr int64_t nr = tile_cols<T>();
+  if (trans == Transpose::NoTrans) {
+    for (int64_t p = 0; p < kc; p++) {
+      std::memcpy(dst + p * nr, b + p * ldb, cols * sizeof(T));
+    }
+  } else {
+    for (int64_t j = 0; j < cols; j++) {
+      for (int64_t p = 0; p < kc; p++) {
+        dst[p * nr + j] = b[j * ldb + p];
+      }
+    }
+  }
+  for (int64_t p = 0; p < kc; p++) {
+    std::fill(dst + p * nr + cols, dst + (p + 1) * nr, T(0));
+  }
+}
+
+// C = alpha * A * B + beta * C for a kMR x NR tile of C, A and B being packed
+// micro-panels of depth kc.  C is not read if beta is 0.
+template <typename T>
+void micro_kernel(int64_t kc, const T* a, const T* b, T* c, int64_t ldc, T alpha, T beta) {
+  using Vec = Vectorized<T>;
+  constexpr int64_t kWidth = Vec::size();
+  Vec acc0[kMR];
+  Vec acc1[kMR];
+  ForcedUnroll<kMR>{}([&](auto i) {
+    acc0[i] = Vec(T(0));
+    acc1[i] = Vec(T(0));
+  });
+  for (int64_t p = 0; p < kc; p++) {
+    const Vec b0 = Vec::loadu(b);
+    const Vec b1 = Vec::loadu(b + kWidth);
+    ForcedUnroll<kMR>{}([&](auto i) {
+      const Vec ai(a[i]);
+      acc0[i] = fmadd(ai, b0, acc0[i]);
+      acc1[i] = fmadd(ai, b1, acc1[i]);
+    });
+    a += kMR;
+    b += 2 * kWidth;
+  }
+  const Vec alpha_vec(alpha);
+  if (beta == T(0)) {
+    ForcedUnroll<kMR>{}([&](auto i) {
+      (acc0[i] * alpha_vec).store(c + i * ldc);
+      (acc1[i] * alpha_vec).store(c + i * ldc + kWidth);
+    });
+  } else {
+    const Vec beta_vec(beta);
+    ForcedUnroll<kMR>{}([&](auto i) {
+      T* row = c + i * ldc;
+      fmadd(acc0[i], alpha_vec, beta_vec * Vec::loadu(row)).store(row);
+      fmadd(acc1[i], alpha_vec, beta_vec * Vec::loadu(row + kWidth)).store(row + kWidth);
+    });
+  }
+}
+
+// The same for the rows x cols corner of the tile, on the edges of C
+template <typename T>
+void micro_kernel_edge(
+    int64_t kc,
+    const T* a,
+    const T* b,
+    T* c,
+    int64_t ldc,
+    T alpha,
+    T beta,
+    int64_t rows,
+    int64_t cols) {
+  constexpr int64_t nr = tile_cols<T>();
+  alignas(64) T tile[kMR * nr];
+  micro_kernel(kc, a, b, tile, nr, alpha, T(0));
+  for (int64_t i = 0; i < rows; i++) {
+    for (int64_t j = 0; j < cols; j++) {
+      c[i * ldc + j] = beta == T(0) ? tile[i * nr + j] : tile[i * nr + j] + beta * c[i * ldc + j];
+    }
+  }
+}
+
+// C = beta * C, zeros if beta is 0
+template <typename T>
+void scale_c(int64_t m, int64_t n, T beta, T* c, int64_t ldc) {
+  parallel_for(0, m, internal::divup(internal::GRAIN_SIZE, n), [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      T* row = c + i * ldc;
+      if (beta == T(0)) {
+        std::fill(row, row + n, T(0));
+      } else {
+        for (int64_t j = 0; j < n; j++) {
+          row[j] *= beta;
+        }
+      }
+    }
+  });
+}
+
+template <typename T>
+void gemm_single(
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    T alpha,
+    const T* a,
+    int64_t lda,
+    const T* b,
+    int64_t ldb,
+    T beta,
+    T* c,
+    int64_t ldc) {
+  if (m == 0 || n == 0) {
+    return;
+  }
+  if (k == 0 || alpha == T(0)) {
+    scale_c(m, n, beta, c, ldc);
+    return;
+  }
+  constexpr int64_t nr = tile_cols<T>();
+  constexpr int64_t nc_max = panel_cols<T>();
+  constexpr int64_t nb = block_cols<T>();
+  // op(B) is packed one kKC x nc_max panel at a time, and op(A) one kMC x kKC
+  // block at a time by each thread
+  const int64_t kc_max = std::min(k, kKC);
+  T* packed_b =
+      static_cast<T*>(b_workspace.get(kc_max * round_up(std::min(n, nc_max), nr) * sizeof(T)));
+
+  const int64_t row_blocks = internal::divup(m, kMC);
+  for (int64_t pc = 0; pc < k; pc += kKC) {
+    const int64_t kc = std::min(kKC, k - pc);
+    // the first panel applies beta, the others accumulate
+    const T beta_panel = pc == 0 ? beta : T(1);
+    for (int64_t jc = 0; jc < n; jc += nc_max) {
+      const int64_t nc = std::min(nc_max, n - jc);
+      const int64_t b_panels = internal::divup(nc, nr);
+      const int64_t b_grain_size = internal::divup(internal::GRAIN_SIZE, nr * kc);
+      parallel_for(0, b_panels, b_grain_size, [&](int64_t begin, int64_t end) {
+        for (int64_t jp = begin; jp < end; jp++) {
+          const int64_t j = jc + jp * nr;
+          const T* src = trans_b == Transpose::NoTrans ? b + pc * ldb + j : b + j * ldb + pc;
+          pack_b(src, ldb, trans_b, kc, std::min(nr, jc + nc - j), packed_b + jp * nr * kc);
+        }
+      });
+      // consecutive blocks share their rows, so a thread packs a block of
+      // op(A) once for several blocks of C and keeps it in cache
+      const int64_t col_blocks = internal::divup(nc, nb);
+      const int64_t grain_size = internal::divup(kMinParallelWork, kMC * nb * kc);
+      parallel_for(0, row_blocks * col_blocks, grain_size, [&](int64_t begin, int64_t end) {
+        T* packed_a = static_cast<T*>(a_workspace.get(kMC * kc * sizeof(T)));
+        int64_t packed_i = -1;
+        for (int64_t block = begin; block < end; block++) {
+          const int64_t i_begin = block / col_blocks * kMC;
+          const int64_t i_end = std::min(m, i_begin + kMC);
+          const int64_t j_begin = block % col_blocks * nb;
+          const int64_t j_end = std::min(nc, j_begin + nb);
+          if (i_begin != packed_i) {
+            pack_a_block(a, lda, trans_a, i_begin, i_end, pc, kc, packed_a);
+            packed_i = i_begin;
+          }
+          for (int64_t j = j_begin; j < j_end; j += nr) {
+            const T* b_panel = packed_b + j * kc;
+            const int64_t cols = std::min(nr, nc - j);
+            for (int64_t i = i_begin; i < i_end; i += kMR) {
+              const T* a_panel = packed_a + (i - i_begin) * kc;
+              const int64_t rows = std::min(kMR, m - i);
+              T* c_tile = c + i * ldc + jc + j;
+              if (rows == kMR && cols == nr) {
+                micro_kernel(kc, a_panel, b_panel, c_tile, ldc, alpha, beta_panel);
+              } else {
+                micro_kernel_edge(
+                    kc, a_panel, b_panel, c_tile, ldc, alpha, beta_panel, rows, cols);
+              }
+            }
+          }
+        }
+      });
+    }
+  }
+}
+
+template <typename T>
+void gemm_typed(const GemmParams& p) {
+  const T alpha = static_cast<T>(p.alpha);
+  const T beta = static_cast<T>(p.beta);
+  const auto* a = static_cast<const T*>(p.a);
+  const auto* b = static_cast<const T*>(p.b);
+  auto* c = static_cast<T*>(p.c);
+  auto product = [&](int64_t i) {
+    gemm_single(
+        p.trans_a, p.trans_b, p.m, p.n, p.k, alpha, a + i * p.stride_a, p.lda, b + i * p.stride_b,
+        p.ldb, beta, c + i * p.stride_c, p.ldc);
+  };
+  const int64_t work = p.m * p.n * std::max<int64_t>(p.k, 1);
+  if (p.batch > 1 && work < kMinSplitWork) {
+    // the products run whole on each thread, parallel_for inside them
+    // running inline
+    const int64_t grain_size = internal::divup(kMinParallelWork, std::max<int64_t>(work, 1));
+    parallel_for(0, p.batch, grain_size, [&](int64_t begin, int64_t end) {
+      for (int64_t i = begin; i < end; i++) {
+        product(i);
+      }
+    });
+  } else {
+    for (int64_t i = 0; i < p.batch; i++) {
+      product(i);
+    }
+  }
+}
+
+void gemm_kernel(const GemmParams& p) {
+  switch (p.dtype) {
+    case ScalarType::Float:
+      gemm_typed<float>(p);
+      break;
+    case ScalarType::Double:
+      gemm_typed<double>(p);
+      break;
+    default:
+      TORCH_INTERNAL_ASSERT(false, "gemm_kernel: unsupported dtype ", p.dtype);
+  }
+}
+
+} // namespace
+
+REGISTER_DISPATCH(gemm_stub, &gemm_kernel);
+
+} // namespace c10
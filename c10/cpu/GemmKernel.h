@@ -0,0 +1,41 @@
+#pragma once
+
+#include <c10/core/ScalarType.h>
+#include <c10/util/DispatchStub.h>
+#include <c10/util/Gemm.h>
+
+#include <cstdint>
+
+// Kernel of the matrix products in c10/util/Gemm.h.
+
+namespace c10 {
+
+// batch products C = alpha * op(A) * op(B) + beta * C of Float or Double
+// matrices, the i-th one on a + i * stride_a, and so on.  Sizes and leading
+// dimensions are checked by the caller.
+struct GemmParams {
+  ScalarType dtype = ScalarType::Undefined;
+  Transpose trans_a = Transpose::NoTrans;
+  Transpose trans_b = Transpose::NoTrans;
+  int64_t batch = 1;
+  int64_t m = 0;
+  int64_t n = 0;
+  int64_t k = 0;
+  double alpha = 1;
+  double beta = 0;
+  const void* a = nullptr;
+  int64_t lda = 1;
+  int64_t stride_a = 0;
+  const void* b = nullptr;
+  int64_t ldb = 1;
+  int64_t stride_b = 0;
+  void* c = nullptr;
+  int64_t ldc = 1;
+  int64_t stride_c = 0;
+};
+
+using gemm_fn = void (*)(const GemmParams&);
+
+DECLARE_DISPATCH(gemm_fn, gemm_stub);
+
+} // namespace c10
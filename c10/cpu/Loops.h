@@ -0,0 +1,206 @@
+#pragma once
+
+// Elementwise kernels on a TensorIterator with one output, for the c10/cpu
+// kernel files:
+//
+//   cpu_kernel(iter, [](float a, float b) -> float { return a + b; });
+//
+//   cpu_kernel_vec(
+//       iter,
+//       [](float a, float b) -> float { return a + b; },
+//       [](Vectorized<float> a, Vectorized<float> b) { return a + b; });
+//
+// The op's parameters are the inputs, in the order they were added to the
+// iterator, and its result is stored to the output.  Operand element sizes
+// must match the op's types.
+//
+// TensorIterator coalesces dense operands into one long chunk, so the inner
+// loop is specialized for that: cpu_kernel indexes contiguous chunks
+// directly, which the compiler vectorizes, and cpu_kernel_vec runs vop over
+// Vectorized<T> there.  cpu_kernel_vec also vectorizes chunks where a single
+// input is broadcast (stride 0) and the rest are contiguous, as in x + scalar.
+// Other chunks run op element by element along the strides.
+
+#include <c10/core/TensorIterator.h>
+#include <c10/cpu/vec/vec.h>
+#include <c10/util/Metaprogramming.h>
+
+#include <utility>
+
+namespace c10 {
+inline namespace CPU_CAPABILITY {
+namespace loops_detail {
+
+template <typename func_t>
+using traits_t = guts::infer_function_traits_t<func_t>;
+
+template <typename func_t, size_t I>
+using arg_t = std::decay_t<guts::typelist::element_t<I, typename traits_t<func_t>::parameter_types>>;
+
+template <typename func_t>
+using result_t = typename traits_t<func_t>::return_type;
+
+template <typename func_t, size_t... I>
+inline void basic_loop(
+    char** data,
+    const int64_t* strides,
+    int64_t n,
+    const func_t& op,
+    std::index_sequence<I...>) {
+  for (int64_t i = 0; i < n; i++) {
+    *reinterpret_cast<result_t<func_t>*>(data[0] + i * strides[0]) =
+        op(*reinterpret_cast<arg_t<func_t, I>*>(data[I + 1] + i * strides[I + 1])...);
+  }
+}
+
+// Dense operands: plain indexing lets the compiler vectorize the loop.
+template <typename func_t, size_t... I>
+inline void contiguous_loop(char** data, int64_t n, const func_t& op, std::index_sequence<I...>) {
+  auto* out = reinterpret_cast<result_t<func_t>*>(data[0]);
+  for (int64_t i = 0; i < n; i++) {
+    out[i] = op(reinterpret_cast<const arg_t<func_t, I>*>(data[I + 1])[i]...);
+  }
+}
+
+template <typename func_t, size_t... I>
+inline bool is_contiguous(const int64_t* strides, std::index_sequence<I...>) {
+  bool contiguous = strides[0] == static_cast<int64_t>(sizeof(result_t<func_t>));
+  const bool inputs[] = {true, (strides[I + 1] == static_cast<int64_t>(sizeof(arg_t<func_t, I>)))...};
+  for (bool b : inputs) {
+    contiguous = contiguous && b;
+  }
+  return contiguous;
+}
+
+// 1-based operand index of the only broadcast input when the others are
+// contiguous, else 0.
+template <typename func_t, size_t... I>
+inline int scalar_input(const int64_t* strides, std::index_sequence<I...>) {
+  if (strides[0] != static_cast<int64_t>(sizeof(result_t<func_t>))) {
+    return 0;
+  }
+  int scalar = 0;
+  const int64_t input_strides[] = {0, strides[I + 1]...};
+  const int64_t sizes[] = {0, static_cast<int64_t>(sizeof(arg_t<func_t, I>))...};
+  for (int k = 1; k <= static_cast<int>(sizeof...(I)); k++) {
+    if (input_strides[k] == 0 && scalar == 0) {
+      scalar = k;
+    } else if (input_strides[k] != sizes[k]) {
+      return 0;
+    }
+  }
+  return scalar;
+}
+
+template <typename Vec>
+inline Vec load_operand(char* base, int64_t i, bool is_scalar) {
+  using scalar_t = typename Vec::value_type;
+  return is_scalar ? Vec(*reinterpret_cast<scalar_t*>(base))
+                   : Vec::loadu(reinterpret_cast<scalar_t*>(base) + i);
+}
+
+// scalar is the 1-based index of a broadcast input, or 0.  Two vectors per
+// iteration keep two independent chains in flight; the tail goes through op.
+template <typename func_t, typename vec_func_t, size_t... I>
+inline void vectorized_loop(
+    char** data,
+    int64_t n,
+    int scalar,
+    const func_t& op,
+    const vec_func_t& vop,
+    std::index_sequence<I...> seq) {
+  using scalar_t = result_t<func_t>;
+  using Vec = vec::Vectorized<scalar_t>;
+  auto* out = reinterpret_cast<scalar_t*>(data[0]);
+  int64_t i = 0;
+  for (; i + 2 * Vec::size() <= n; i += 2 * Vec::size()) {
+    const Vec out0 = vop(load_operand<Vec>(data[I + 1], i, scalar == static_cast<int>(I) + 1)...);
+    const Vec out1 = vop(load_operand<Vec>(data[I + 1], i + Vec::size(), scalar == static_cast<int>(I) + 1)...);
+    out0.store(out + i);
+    out1.store(out + i + Vec::size());
+  }
+  if (i < n) {
+    constexpr size_t ntensors = sizeof...(I) + 1;
+    char* tail_data[ntensors];
+    int64_t strides[ntensors];
+    tail_data[0] = reinterpret_cast<char*>(out + i);
+    strides[0] = sizeof(scalar_t);
+    const int64_t element_size = sizeof(scalar_t);
+    char* inputs[] = {nullptr, data[I + 1]...};
+    for (size_t k = 1; k < ntensors; k++) {
+      const bool is_scalar = static_cast<int>(k) == scalar;
+      tail_data[k] = is_scalar ? inputs[k] : inputs[k] + i * element_size;
+      strides[k] = is_scalar ? 0 : element_size;
+    }
+    basic_loop(tail_data, strides, n - i, op, seq);
+  }
+}
+
+template <typename func_t, size_t... I>
+constexpr bool args_match_result(std::index_sequence<I...>) {
+  const bool same[] = {true, std::is_same<arg_t<func_t, I>, result_t<func_t>>::value...};
+  for (bool b : same) {
+    if (!b) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename func_t, size_t... I>
+inline void check_operands(const TensorIterator& iter, std::index_sequence<I...>) {
+  TORCH_INTERNAL_ASSERT(
+      iter.noutputs() == 1 && iter.ntensors() == static_cast<int>(sizeof...(I)) + 1,
+      "cpu_kernel: the op takes ", sizeof...(I), " inputs and makes one output, but the iterator has ",
+      iter.noutputs(), " outputs and ", iter.ntensors() - iter.noutputs(), " inputs");
+  const int64_t sizes[] = {static_cast<int64_t>(sizeof(result_t<func_t>)),
+                           static_cast<int64_t>(sizeof(arg_t<func_t, I>))...};
+  for (int k = 0; k < iter.ntensors(); k++) {
+    TORCH_INTERNAL_ASSERT(
+        iter.element_size(k) == sizes[k],
+        "cpu_kernel: operand ", k, " has element size ", iter.element_size(k),
+        " but the op uses ", sizes[k]);
+  }
+}
+
+} // namespace loops_detail
+
+template <typename func_t>
+void cpu_kernel(const TensorIterator& iter, const func_t& op) {
+  using namespace loops_detail;
+  constexpr size_t arity = traits_t<func_t>::number_of_parameters;
+  const auto seq = std::make_index_sequence<arity>();
+  check_operands<func_t>(iter, seq);
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    if (is_contiguous<func_t>(strides, seq)) {
+      contiguous_loop(data, n, op, seq);
+    } else {
+      basic_loop(data, strides, n, op, seq);
+    }
+  });
+}
+
+// vop takes and returns Vectorized<T>, where T is op's result type; op's
+// parameters must all be T too.
+template <typename func_t, typename vec_func_t>
+void cpu_kernel_vec(const TensorIterator& iter, const func_t& op, const vec_func_t& vop) {
+  using namespace loops_detail;
+  constexpr size_t arity = traits_t<func_t>::number_of_parameters;
+  const auto seq = std::make_index_sequence<arity>();
+  static_assert(
+      args_match_result<func_t>(std::make_index_sequence<arity>()),
+      "cpu_kernel_vec: the op's parameters must have its result type");
+  check_operands<func_t>(iter, seq);
+  iter.for_each([&](char** data, const int64_t* strides, int64_t n) {
+    if (is_contiguous<func_t>(strides, seq)) {
+      vectorized_loop(data, n, 0, op, vop, seq);
+    } else if (const int scalar = scalar_input<func_t>(strides, seq)) {
+      vectorized_loop(data, n, scalar, op, vop, seq);
+    } else {
+      basic_loop(data, strides, n, op, seq);
+    }
+  });
+}
+
+} // namespace CPU_CAPABILITY
+} // namespace c10
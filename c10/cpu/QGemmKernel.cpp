@@ -0,0 +1,300 @@
+#include <c10/cpu/QGemmKernel.h>
+#include <c10/core/Workspace.h>
+#include <c10/cpu/BlockedGemm.h>
+#include <c10/cpu/QuantizeKernel.h>
+#include <c10/util/CPUCapability.h>
+#include <c10/util/Parallel.h>
+
+#if defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX512)
+#include <immintrin.h>
+#endif
+
+#include <algorithm>
+#include <atomic>
+#include <cstring>
+
+// vpdpbusd needs GCC 9 or clang 9, and is checked for at runtime
+#if defined(CPU_CAPABILITY_AVX512) &&                             \
+    ((defined(__clang__) && __clang_major__ >= 9) ||              \
+     (!defined(__clang__) && defined(__GNUC__) && __GNUC__ >= 9))
+#define C10_QGEMM_AVX512_VNNI 1
+#else
+#define C10_QGEMM_AVX512_VNNI 0
+#endif
+
+namespace c10 {
+namespace {
+
+using namespace blocked_gemm;
+
+// Bytes of a group of 4 values of k of a block of packed B, see
+// PackedQInt8Matrix
+constexpr int64_t kGroupBytes = 4 * kBlockCols;
+
+// Packed A and its row sums
+thread_local Workspace workspace;
+
+// 4 bytes of a row of A, to broadcast
+inline int32_t load_group(const uint8_t* p) {
+  int32_t x;
+  std::memcpy(&x, p, sizeof(x));
+  return x;
+}
+
+// vpmaddubsw adds pairs of u8 x s8 products in 16 bits with saturation, which
+// 255 * -128 * 2 overflows.  When A has values above 127 the vpmaddubsw
+// kernels split each byte into its low 7 bits and its top bit (0 or 128):
+// pairs of products stay within [-32512, 32258] for the first and
+// [-32768, 32512] for the second, and are widened separately.
+
+// The micro-kernels store in tile, kMR x kNR, the dot products of kMR rows of
+// packed A, lda bytes apart, and the kNR columns of packed B from b, over
+// groups groups of 4 values of k.  The blocks of B are block_bytes apart.
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+template <bool full_range>
+void micro_kernel(
+    int64_t groups,
+    const uint8_t* a,
+    int64_t lda,
+    const int8_t* b,
+    int64_t block_bytes,
+    int32_t* tile) {
+  const __m512i ones = _mm512_set1_epi16(1);
+  const __m512i top_bits = _mm512_set1_epi8(static_cast<char>(0x80));
+  __m512i acc0[kMR];
+  __m512i acc1[kMR];
+#pragma GCC unroll 8
+  for (int64_t i = 0; i < kMR; i++) {
+    acc0[i] = _mm512_setzero_si512();
+    acc1[i] = _mm512_setzero_si512();
+  }
+  for (int64_t g = 0; g < groups; g++) {
+    const __m512i b0 = _mm512_loadu_si512(b + g * kGroupBytes);
+    const __m512i b1 = _mm512_loadu_si512(b + block_bytes + g * kGroupBytes);
+#pragma GCC unroll 8
+    for (int64_t i = 0; i < kMR; i++) {
+      __m512i ai = _mm512_set1_epi32(load_group(a + i * lda + 4 * g));
+      if (full_range) {
+        const __m512i hi = _mm512_and_si512(ai, top_bits);
+        ai = _mm512_andnot_si512(top_bits, ai);
+        acc0[i] = _mm512_add_epi32(acc0[i], _mm512_madd_epi16(_mm512_maddubs_epi16(hi, b0), ones));
+        acc1[i] = _mm512_add_epi32(acc1[i], _mm512_madd_epi16(_mm512_maddubs_epi16(hi, b1), ones));
+      }
+      // pairs of products in 16 bits, then the two pairs in 32
+      acc0[i] = _mm512_add_epi32(acc0[i], _mm512_madd_epi16(_mm512_maddubs_epi16(ai, b0), ones));
+      acc1[i] = _mm512_add_epi32(acc1[i], _mm512_madd_epi16(_mm512_maddubs_epi16(ai, b1), ones));
+    }
+  }
+#pragma GCC unroll 8
+  for (int64_t i = 0; i < kMR; i++) {
+    _mm512_storeu_si512(tile + i * kNR, acc0[i]);
+    _mm512_storeu_si512(tile + i * kNR + kBlockCols, acc1[i]);
+  }
+}
+
+#if C10_QGEMM_AVX512_VNNI
+__attribute__((target("avx512vnni"))) void micro_kernel_vnni(
+    int64_t groups,
+    const uint8_t* a,
+    int64_t lda,
+    const int8_t* b,
+    int64_t block_bytes,
+    int32_t* tile) {
+  __m512i acc0[kMR];
+  __m512i acc1[kMR];
+#pragma GCC unroll 8
+  for (int64_t i = 0; i < kMR; i++) {
+    acc0[i] = _mm512_setzero_si512();
+    acc1[i] = _mm512_setzero_si512();
+  }
+  for (int64_t g = 0; g < groups; g++) {
+    const __m512i b0 = _mm512_loadu_si512(b + g * kGroupBytes);
+    const __m512i b1 = _mm512_loadu_si512(b + block_bytes + g * kGroupBytes);
+#pragma GCC unroll 8
+    for (int64_t i = 0; i < kMR; i++) {
+      const __m512i ai = _mm512_set1_epi32(load_group(a + i * lda + 4 * g));
+      acc0[i] = _mm512_dpbusd_epi32(acc0[i], ai, b0);
+      acc1[i] = _mm512_dpbusd_epi32(acc1[i], ai, b1);
+    }
+  }
+#pragma GCC unroll 8
+  for (int64_t i = 0; i < kMR; i++) {
+    _mm512_storeu_si512(tile + i * kNR, acc0[i]);
+    _mm512_storeu_si512(tile + i * kNR + kBlockCols, acc1[i]);
+  }
+}
+#endif
+
+#elif defined(CPU_CAPABILITY_AVX2)
+
+// A block of B is two vectors, columns 0-7 and 8-15
+template <bool full_range>
+void micro_kernel(
+    int64_t groups,
+    const uint8_t* a,
+    int64_t lda,
+    const int8_t* b,
+    int64_t /*block_bytes*/,
+    int32_t* tile) {
+  const __m256i ones = _mm256_set1_epi16(1);
+  const __m256i top_bits = _mm256_set1_epi8(static_cast<char>(0x80));
+  __m256i acc0[kMR];
+  __m256i acc1[kMR];
+#pragma GCC unroll 8
+  for (int64_t i = 0; i < kMR; i++) {
+    acc0[i] = _mm256_setzero_si256();
+    acc1[i] = _mm256_setzero_si256();
+  }
+  for (int64_t g = 0; g < groups; g++) {
+    const __m256i b0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + g * kGroupBytes));
+    const __m256i b1 =
+        _mm256_loadu_si256(reinterpret_cast<const __m256i*>(b + g * kGroupBytes + 32));
+#pragma GCC unroll 8
+    for (int64_t i = 0; i < kMR; i++) {
+      __m256i ai = _mm256_set1_epi32(load_group(a + i * lda + 4 * g));
+      if (full_range) {
+        const __m256i hi = _mm256_and_si256(ai, top_bits);
+        ai = _mm256_andnot_si256(top_bits, ai);
+        acc0[i] = _mm256_add_epi32(acc0[i], _mm256_madd_epi16(_mm256_maddubs_epi16(hi, b0), ones));
+        acc1[i] = _mm256_add_epi32(acc1[i], _mm256_madd_epi16(_mm256_maddubs_epi16(hi, b1), ones));
+      }
+      acc0[i] = _mm256_add_epi32(acc0[i], _mm256_madd_epi16(_mm256_maddubs_epi16(ai, b0), ones));
+      acc1[i] = _mm256_add_epi32(acc1[i], _mm256_madd_epi16(_mm256_maddubs_epi16(ai, b1), ones));
+    }
+  }
+#pragma GCC unroll 8
+  for (int64_t i = 0; i < kMR; i++) {
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(tile + i * kNR), acc0[i]);
+    _mm256_storeu_si256(reinterpret_cast<__m256i*>(tile + i * kNR + 8), acc1[i]);
+  }
+}
+
+#else
+
+template <bool full_range>
+void micro_kernel(
+    int64_t groups,
+    const uint8_t* a,
+    int64_t lda,
+    const int8_t* b,
+    int64_t /*block_bytes*/,
+    int32_t* tile) {
+  std::fill(tile, tile + kMR * kNR, 0);
+  for (int64_t g = 0; g < groups; g++) {
+    for (int64_t i = 0; i < kMR; i++) {
+      const uint8_t* ag = a + i * lda + 4 * g;
+      const int8_t* bg = b + g * kGroupBytes;
+      int32_t* row = tile + i * kNR;
+      for (int64_t j = 0; j < kNR; j++) {
+        row[j] += ag[0] * bg[4 * j] + ag[1] * bg[4 * j + 1] + ag[2] * bg[4 * j + 2] +
+            ag[3] * bg[4 * j + 3];
+      }
+    }
+  }
+}
+
+#endif
+
+using micro_kernel_fn =
+    void (*)(int64_t, const uint8_t*, int64_t, const int8_t*, int64_t, int32_t*);
+
+// full_range: whether A has values above 127, which only the vpmaddubsw
+// kernels need to know; the scalar and the VNNI ones are exact for any quint8
+micro_kernel_fn select_micro_kernel(bool full_range) {
+#if C10_QGEMM_AVX512_VNNI
+  static const bool has_vnni = cpu::cpuFeatures().avx512vnni;
+  if (has_vnni) {
+    return micro_kernel_vnni;
+  }
+#endif
+  return full_range ? micro_kernel<true> : micro_kernel<false>;
+}
+
+// Copies the rows of A, padded with zeros to a multiple of 4 bytes and to a
+// multiple of kMR rows, and sums them.  Returns whether A has values above
+// 127.
+bool pack_a(const QGemmParams& p, int64_t k, int64_t lda_packed, uint8_t* packed, int32_t* sums) {
+  const int64_t rows = round_up(p.m, kMR);
+  const int64_t grain_size = internal::divup(internal::GRAIN_SIZE, std::max<int64_t>(k, 1));
+  std::atomic<bool> full_range{false};
+  parallel_for(0, rows, grain_size, [&](int64_t begin, int64_t end) {
+    uint8_t high = 0;
+    for (int64_t i = begin; i < end; i++) {
+      uint8_t* dst = packed + i * lda_packed;
+      int32_t sum = 0;
+      if (i < p.m) {
+        const auto* src = reinterpret_cast<const uint8_t*>(p.a + i * p.lda);
+        std::memcpy(dst, src, k);
+        for (int64_t q = 0; q < k; q++) {
+          sum += src[q];
+          high |= src[q];
+        }
+        std::fill(dst + k, dst + lda_packed, 0);
+      } else {
+        std::fill(dst, dst + lda_packed, 0);
+      }
+      sums[i] = sum;
+    }
+    if (high & 0x80) {
+      full_range.store(true, std::memory_order_relaxed);
+    }
+  });
+  return full_range.load(std::memory_order_relaxed);
+}
+
+void qgemm_kernel(const QGemmParams& p) {
+  const PackedQInt8Matrix& b = *p.b;
+  const int64_t m = p.m;
+  const int64_t n = b.n();
+  const int64_t k = b.k();
+  const int64_t lda_packed = PackedQInt8Matrix::padded_k(k);
+  const int64_t groups = lda_packed / 4;
+  const int64_t block_bytes = groups * kGroupBytes;
+  const int64_t rows = round_up(m, kMR);
+
+  auto* row_sums = static_cast<int32_t*>(
+      workspace.get(rows * sizeof(int32_t) + rows * lda_packed));
+  auto* packed_a = reinterpret_cast<uint8_t*>(row_sums + rows);
+  const bool full_range = pack_a(p, k, lda_packed, packed_a, row_sums);
+
+  // sum (a - za) (b - zb) = sum a b - za sum b - zb sum a + k za zb, in 64
+  // bits so that no term overflows
+  const int64_t a_zero_point = p.a_zero_point;
+  const int64_t b_zero_point = b.zero_point();
+  const int64_t zero_points_term = k * a_zero_point * b_zero_point;
+  const int32_t* column_sums = b.column_sums();
+  const micro_kernel_fn micro = select_micro_kernel(full_range);
+
+  for_each_tile<int32_t>(
+      m, n, lda_packed,
+      [&](int64_t i, int64_t j, int32_t* tile) {
+        micro(
+            groups, packed_a + i * lda_packed, lda_packed,
+            b.data() + j / kBlockCols * block_bytes, block_bytes, tile);
+      },
+      [&](int64_t i, int64_t j, int64_t rows, int64_t cols, int32_t* tile) {
+        for (int64_t r = 0; r < rows; r++) {
+          int32_t* t = tile + r * kNR;
+          const int64_t row_term = zero_points_term - b_zero_point * row_sums[i + r];
+          for (int64_t c = 0; c < cols; c++) {
+            const int64_t bias = p.bias ? p.bias[j + c] : 0;
+            t[c] = static_cast<int32_t>(t[c] + row_term - a_zero_point * column_sums[j + c] + bias);
+          }
+          if (p.c8) {
+            requantize_stub(
+                reinterpret_cast<const qint32*>(t), p.c8 + (i + r) * p.ldc + j, cols,
+                *p.requantization);
+          } else {
+            std::memcpy(p.c32 + (i + r) * p.ldc + j, t, cols * sizeof(int32_t));
+          }
+        }
+      });
+}
+
+} // namespace
+
+REGISTER_DISPATCH(qgemm_stub, &qgemm_kernel);
+
+} // namespace c10
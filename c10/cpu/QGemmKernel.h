@@ -0,0 +1,33 @@
+#pragma once
+
+#include <c10/util/DispatchStub.h>
+#include <c10/util/QGemm.h>
+#include <c10/util/Quantize.h>
+
+#include <cstdint>
+
+// Kernel of the quantized matrix products in c10/util/QGemm.h.
+
+namespace c10 {
+
+// One product: A, m x k, against b, which has k and n.  The output is either
+// c32, or c8 requantized with requantization; sizes are checked by the
+// caller.
+struct QGemmParams {
+  int64_t m = 0;
+  const quint8* a = nullptr;
+  int64_t lda = 0;
+  int32_t a_zero_point = 0;
+  const PackedQInt8Matrix* b = nullptr;
+  const int32_t* bias = nullptr;
+  qint32* c32 = nullptr;
+  quint8* c8 = nullptr;
+  const RequantizationParams* requantization = nullptr;
+  int64_t ldc = 0;
+};
+
+using qgemm_fn = void (*)(const QGemmParams&);
+
+DECLARE_DISPATCH(qgemm_fn, qgemm_stub);
+
+} // namespace c10
@@ -0,0 +1,277 @@
+#include <c10/cpu/QuantizeKernel.h>
+#include <c10/cpu/vec/vec.h>
+
+namespace c10 {
+namespace {
+
+using namespace vec;
+
+// The vector loops round and saturate exactly like quantize_val /
+// dequantize_val, which handle the tails.
+
+template <typename T>
+void quantize_loop(const float* src, T* dst, int64_t n, float scale, int32_t zero_point) {
+  using Vec = Vectorized<T>;
+  using FVec = Vectorized<float>;
+  const float inverse_scale = 1.0f / scale;
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    typename Vec::float_vec_return_type f;
+    for (int j = 0; j < Vec::float_num_vecs(); j++) {
+      f[j] = FVec::loadu(src + i + j * FVec::size());
+    }
+    Vec::quantize(f, scale, zero_point, inverse_scale).store(dst + i);
+  }
+  for (; i < n; i++) {
+    dst[i] = quantize_val<T>(inverse_scale, zero_point, src[i]);
+  }
+}
+
+template <typename T>
+void dequantize_loop(const T* src, float* dst, int64_t n, float scale, int32_t zero_point) {
+  using Vec = Vectorized<T>;
+  using FVec = Vectorized<float>;
+  const FVec scale_vec(scale);
+  const FVec zero_point_vec(static_cast<float>(zero_point));
+  int64_t i = 0;
+  for (; i + Vec::size() <= n; i += Vec::size()) {
+    const auto f = Vec::loadu(src + i).dequantize(scale_vec, zero_point_vec);
+    for (int j = 0; j < Vec::float_num_vecs(); j++) {
+      f[j].store(dst + i + j * FVec::size());
+    }
+  }
+  for (; i < n; i++) {
+    dst[i] = dequantize_val(scale, zero_point, src[i]);
+  }
+}
+
+void quantize_kernel(
+    const float* src,
+    void* dst,
+    ScalarType dtype,
+    size_t n,
+    float scale,
+    int32_t zero_point) {
+  switch (dtype) {
+#define QUANTIZE_CASE(type, name)                                                       \
+    case ScalarType::name:                                                              \
+      quantize_loop(src, static_cast<type*>(dst), static_cast<int64_t>(n), scale, zero_point); \
+      break;
+    AT_FORALL_QINT_TYPES(QUANTIZE_CASE)
+#undef QUANTIZE_CASE
+    default:
+      TORCH_INTERNAL_ASSERT(false, "quantize_kernel: unexpected dtype ", dtype);
+  }
+}
+
+void dequantize_kernel(
+    const void* src,
+    ScalarType dtype,
+    float* dst,
+    size_t n,
+    float scale,
+    int32_t zero_point) {
+  switch (dtype) {
+#define DEQUANTIZE_CASE(type, name)                                                     \
+    case ScalarType::name:                                                              \
+      dequantize_loop(                                                                  \
+          static_cast<const type*>(src), dst, static_cast<int64_t>(n), scale, zero_point); \
+      break;
+    AT_FORALL_QINT_TYPES(DEQUANTIZE_CASE)
+#undef DEQUANTIZE_CASE
+    default:
+      TORCH_INTERNAL_ASSERT(false, "dequantize_kernel: unexpected dtype ", dtype);
+  }
+}
+
+template <typename T>
+void quantize_per_channel_loop(
+    const float* src,
+    T* dst,
+    int64_t outer_size,
+    int64_t channels,
+    int64_t inner_size,
+    const float* scales,
+    const int32_t* zero_points) {
+  for (int64_t o = 0; o < outer_size; o++) {
+    for (int64_t c = 0; c < channels; c++) {
+      const int64_t offset = (o * channels + c) * inner_size;
+      quantize_loop(src + offset, dst + offset, inner_size, scales[c], zero_points[c]);
+    }
+  }
+}
+
+template <typename T>
+void dequantize_per_channel_loop(
+    const T* src,
+    float* dst,
+    int64_t outer_size,
+    int64_t channels,
+    int64_t inner_size,
+    const float* scales,
+    const int32_t* zero_points) {
+  for (int64_t o = 0; o < outer_size; o++) {
+    for (int64_t c = 0; c < channels; c++) {
+      const int64_t offset = (o * channels + c) * inner_size;
+      dequantize_loop(src + offset, dst + offset, inner_size, scales[c], zero_points[c]);
+    }
+  }
+}
+
+void quantize_per_channel_kernel(
+    const float* src,
+    void* dst,
+    ScalarType dtype,
+    int64_t outer_size,
+    int64_t channels,
+    int64_t inner_size,
+    const float* scales,
+    const int32_t* zero_points) {
+  switch (dtype) {
+#define QUANTIZE_CASE(type, name)                                                       \
+    case ScalarType::name:                                                              \
+      quantize_per_channel_loop(                                                        \
+          src, static_cast<type*>(dst), outer_size, channels, inner_size, scales, zero_points); \
+      break;
+    AT_FORALL_QINT_TYPES(QUANTIZE_CASE)
+#undef QUANTIZE_CASE
+    default:
+      TORCH_INTERNAL_ASSERT(false, "quantize_per_channel_kernel: unexpected dtype ", dtype);
+  }
+}
+
+void dequantize_per_channel_kernel(
+    const void* src,
+    ScalarType dtype,
+    float* dst,
+    int64_t outer_size,
+    int64_t channels,
+    int64_t inner_size,
+    const float* scales,
+    const int32_t* zero_points) {
+  switch (dtype) {
+#define DEQUANTIZE_CASE(type, name)                                                     \
+    case ScalarType::name:                                                              \
+      dequantize_per_channel_loop(                                                      \
+          static_cast<const type*>(src), dst, outer_size, channels, inner_size, scales, zero_points); \
+      break;
+    AT_FORALL_QINT_TYPES(DEQUANTIZE_CASE)
+#undef DEQUANTIZE_CASE
+    default:
+      TORCH_INTERNAL_ASSERT(false, "dequantize_per_channel_kernel: unexpected dtype ", dtype);
+  }
+}
+
+// requantize_val lane-wise: the 64-bit products x * multiplier come from
+// vpmuldq on the even and odd int32 lanes.  They are less than 2^62 in
+// magnitude, so adding 2^62 makes them non-negative and the logical right
+// shift (there is no 64-bit arithmetic shift in AVX2) floors them; shift <= 61
+// keeps the bias's contribution 2^(62 - shift) even, so it doesn't change
+// the parity used for rounding half to even.  The low 32 bits of each lane are
+// the result plus 2^(62 - shift), modulo 2^32.
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+inline __m512i round_shift_epi64(__m512i product, __m512i half_minus_one, __m128i shift) {
+  const __m512i floor = _mm512_srl_epi64(product, shift);
+  const __m512i lsb = _mm512_and_si512(floor, _mm512_set1_epi64(1));
+  return _mm512_srl_epi64(
+      _mm512_add_epi64(_mm512_add_epi64(product, half_minus_one), lsb), shift);
+}
+
+void requantize_kernel(
+    const qint32* src,
+    quint8* dst,
+    size_t n,
+    const RequantizationParams& params) {
+  const __m512i multiplier = _mm512_set1_epi64(params.multiplier);
+  const __m512i bias = _mm512_set1_epi64(int64_t(1) << 62);
+  const __m512i half_minus_one = _mm512_set1_epi64((int64_t(1) << (params.shift - 1)) - 1);
+  const __m128i shift = _mm_cvtsi32_si128(params.shift);
+  const __m512i unbias = _mm512_set1_epi32(
+      static_cast<int32_t>(static_cast<uint32_t>(uint64_t(1) << (62 - params.shift))));
+  const Vectorized<int32_t> lo(-params.zero_point);
+  const Vectorized<int32_t> hi(255 - params.zero_point);
+  const Vectorized<int32_t> zero_point(params.zero_point);
+  size_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    const __m512i x = _mm512_loadu_si512(src + i);
+    const __m512i even = _mm512_add_epi64(_mm512_mul_epi32(x, multiplier), bias);
+    const __m512i odd =
+        _mm512_add_epi64(_mm512_mul_epi32(_mm512_srli_epi64(x, 32), multiplier), bias);
+    const __m512i q = _mm512_mask_blend_epi32(
+        0xAAAA,
+        round_shift_epi64(even, half_minus_one, shift),
+        _mm512_slli_epi64(round_shift_epi64(odd, half_minus_one, shift), 32));
+    const Vectorized<int32_t> r(_mm512_sub_epi32(q, unbias));
+    store_from_int32(clamp(r, lo, hi) + zero_point, reinterpret_cast<uint8_t*>(dst + i));
+  }
+  for (; i < n; i++) {
+    dst[i] = requantize_val(params, src[i]);
+  }
+}
+
+#elif defined(CPU_CAPABILITY_AVX2)
+
+inline __m256i round_shift_epi64(__m256i product, __m256i half_minus_one, __m128i shift) {
+  const __m256i floor = _mm256_srl_epi64(product, shift);
+  const __m256i lsb = _mm256_and_si256(floor, _mm256_set1_epi64x(1));
+  return _mm256_srl_epi64(
+      _mm256_add_epi64(_mm256_add_epi64(product, half_minus_one), lsb), shift);
+}
+
+void requantize_kernel(
+    const qint32* src,
+    quint8* dst,
+    size_t n,
+    const RequantizationParams& params) {
+  const __m256i multiplier = _mm256_set1_epi64x(params.multiplier);
+  const __m256i bias = _mm256_set1_epi64x(int64_t(1) << 62);
+  const __m256i half_minus_one = _mm256_set1_epi64x((int64_t(1) << (params.shift - 1)) - 1);
+  const __m128i shift = _mm_cvtsi32_si128(params.shift);
+  const __m256i unbias = _mm256_set1_epi32(
+      static_cast<int32_t>(static_cast<uint32_t>(uint64_t(1) << (62 - params.shift))));
+  const Vectorized<int32_t> lo(-params.zero_point);
+  const Vectorized<int32_t> hi(255 - params.zero_point);
+  const Vectorized<int32_t> zero_point(params.zero_point);
+  size_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    const __m256i x = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(src + i));
+    const __m256i even = _mm256_add_epi64(_mm256_mul_epi32(x, multiplier), bias);
+    const __m256i odd =
+        _mm256_add_epi64(_mm256_mul_epi32(_mm256_srli_epi64(x, 32), multiplier), bias);
+    const __m256i q = _mm256_blend_epi32(
+        round_shift_epi64(even, half_minus_one, shift),
+        _mm256_slli_epi64(round_shift_epi64(odd, half_minus_one, shift), 32),
+        0xAA);
+    const Vectorized<int32_t> r(_mm256_sub_epi32(q, unbias));
+    store_from_int32(clamp(r, lo, hi) + zero_point, reinterpret_cast<uint8_t*>(dst + i));
+  }
+  for (; i < n; i++) {
+    dst[i] = requantize_val(params, src[i]);
+  }
+}
+
+#else
+
+void requantize_kernel(
+    const qint32* src,
+    quint8* dst,
+    size_t n,
+    const RequantizationParams& params) {
+  for (size_t i = 0; i < n; i++) {
+    dst[i] = requantize_val(params, src[i]);
+  }
+}
+
+#endif
+
+} // namespace
+
+REGISTER_DISPATCH(quantize_stub, &quantize_kernel);
+REGISTER_DISPATCH(dequantize_stub, &dequantize_kernel);
+REGISTER_DISPATCH(quantize_per_channel_stub, &quantize_per_channel_kernel);
+REGISTER_DISPATCH(dequantize_per_channel_stub, &dequantize_per_channel_kernel);
+REGISTER_DISPATCH(requantize_stub, &requantize_kernel);
+
+} // namespace c10
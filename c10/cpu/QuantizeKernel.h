@@ -0,0 +1,26 @@
+#pragma once
+
+#include <c10/core/ScalarType.h>
+#include <c10/util/DispatchStub.h>
+#include <c10/util/Quantize.h>
+
+// Kernels of the bulk quantization functions in Quantize.h.  The dtypes are
+// QInt8, QUInt8 and QInt32; the callers check the parameters.
+
+namespace c10 {
+
+using quantize_fn = void (*)(const float*, void*, ScalarType, size_t, float, int32_t);
+using dequantize_fn = void (*)(const void*, ScalarType, float*, size_t, float, int32_t);
+using quantize_per_channel_fn = void (*)(
+    const float*, void*, ScalarType, int64_t, int64_t, int64_t, const float*, const int32_t*);
+using dequantize_per_channel_fn = void (*)(
+    const void*, ScalarType, float*, int64_t, int64_t, int64_t, const float*, const int32_t*);
+using requantize_fn = void (*)(const qint32*, quint8*, size_t, const RequantizationParams&);
+
+DECLARE_DISPATCH(quantize_fn, quantize_stub);
+DECLARE_DISPATCH(dequantize_fn, dequantize_stub);
+DECLARE_DISPATCH(quantize_per_channel_fn, quantize_per_channel_stub);
+DECLARE_DISPATCH(dequantize_per_channel_fn, dequantize_per_channel_stub);
+DECLARE_DISPATCH(requantize_fn, requantize_stub);
+
+} // namespace c10
@@ -0,0 +1,805 @@
+#include <c10/cpu/ReduceKernel.h>
+#include <c10/cpu/vec/vec.h>
+#include <c10/util/Parallel.h>
+
+#include <cmath>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+#include <vector>
+
+namespace c10 {
+namespace {
+
+using namespace vec;
+
+// Integers accumulate in int64_t, Half and BFloat16 in float.
+template <typename T>
+struct acc_type {
+  using type = typename std::conditional<std::is_integral<T>::value, int64_t, T>::type;
+};
+template <>
+struct acc_type<Half> {
+  using type = float;
+};
+template <>
+struct acc_type<BFloat16> {
+  using type = float;
+};
+template <typename T>
+using acc_type_t = typename acc_type<T>::type;
+
+template <typename T>
+struct is_floating {
+  static constexpr bool value =
+      std::is_floating_point<T>::value || is_reduced_floating_point<T>::value;
+};
+
+// Loads of scalar_t as Vectorized<acc_type_t<scalar_t>>, for the floating
+// point types.
+template <typename T>
+struct VecLoader {
+  static constexpr bool value = false;
+};
+
+template <typename T>
+struct PlainVecLoader {
+  static constexpr bool value = true;
+  static Vectorized<T> load(const T* p) {
+    return Vectorized<T>::loadu(p);
+  }
+  static Vectorized<T> load(const T* p, int64_t count) {
+    return Vectorized<T>::loadu(p, count);
+  }
+};
+
+template <>
+struct VecLoader<float> : PlainVecLoader<float> {};
+template <>
+struct VecLoader<double> : PlainVecLoader<double> {};
+
+template <typename T>
+struct ReducedFloatVecLoader {
+  static constexpr bool value = true;
+  static Vectorized<float> load(const T* p) {
+    return load_to_float(p);
+  }
+  static Vectorized<float> load(const T* p, int64_t count) {
+    T tmp[Vectorized<float>::size()] = {};
+    for (int64_t i = 0; i < count; i++) {
+      tmp[i] = p[i];
+    }
+    return load_to_float(tmp);
+  }
+};
+
+template <>
+struct VecLoader<Half> : ReducedFloatVecLoader<Half> {};
+template <>
+struct VecLoader<BFloat16> : ReducedFloatVecLoader<BFloat16> {};
+
+inline bool is_nan(float x) {
+  return std::isnan(x);
+}
+inline bool is_nan(double x) {
+  return std::isnan(x);
+}
+inline bool is_nan(int64_t) {
+  return false;
+}
+
+// Sums a stream of values in levels of partial sums: every kFanout additions
+// to level k, level k + 1 takes its total and level k restarts from zero.  A
+// value then goes through O(log n) additions, each with a sum of a similar
+// number of values, so the rounding error grows with log(n) instead of n.
+template <typename T>
+class CascadeSum {
+ public:
+  explicit CascadeSum(const T& zero) : zero_(zero) {
+    for (auto& level : levels_) {
+      level = zero;
+    }
+  }
+
+  void add(const T& x) {
+    levels_[0] = levels_[0] + x;
+    count_++;
+    if ((count_ & (kFanout - 1)) == 0) {
+      carry();
+    }
+  }
+
+  T result() const {
+    T sum = levels_[0];
+    for (int k = 1; k < kLevels; k++) {
+      sum = sum + levels_[k];
+    }
+    return sum;
+  }
+
+ private:
+  static constexpr int kLevelBits = 4;
+  static constexpr int64_t kFanout = int64_t(1) << kLevelBits;
+  static constexpr int kLevels = 8;
+
+  void carry() {
+    int64_t count = count_;
+    for (int k = 0; k + 1 < kLevels && (count & (kFanout - 1)) == 0; k++) {
+      levels_[k + 1] = levels_[k + 1] + levels_[k];
+      levels_[k] = zero_;
+      count >>= kLevelBits;
+    }
+  }
+
+  T levels_[kLevels];
+  T zero_;
+  int64_t count_ = 0;
+};
+
+// Combines values in the order they are added
+template <typename T, typename Combine>
+class Fold {
+ public:
+  explicit Fold(const T& identity) : acc_(identity) {}
+
+  void add(const T& x) {
+    acc_ = Combine()(acc_, x);
+  }
+  T result() const {
+    return acc_;
+  }
+
+ private:
+  T acc_;
+};
+
+// Element maps, applied to each input element before it is reduced
+
+struct MapIdentity {
+  static constexpr bool kVectorized = true;
+  template <typename T>
+  T operator()(const T& x) const {
+    return x;
+  }
+};
+
+struct MapAbs {
+  static constexpr bool kVectorized = true;
+  template <typename T>
+  T operator()(const T& x) const {
+    return std::abs(x);
+  }
+  template <typename T>
+  Vectorized<T> operator()(const Vectorized<T>& x) const {
+    return x.abs();
+  }
+};
+
+struct MapSquare {
+  static constexpr bool kVectorized = true;
+  template <typename T>
+  T operator()(const T& x) const {
+    return x * x;
+  }
+};
+
+struct MapNonZero {
+  static constexpr bool kVectorized = true;
+  template <typename T>
+  T operator()(const T& x) const {
+    return x != T(0) ? T(1) : T(0);
+  }
+  template <typename T>
+  Vectorized<T> operator()(const Vectorized<T>& x) const {
+    return (x != Vectorized<T>(T(0))) & Vectorized<T>(T(1));
+  }
+};
+
+struct MapPow {
+  static constexpr bool kVectorized = false;
+  double p;
+  template <typename T>
+  T operator()(const T& x) const {
+    return std::pow(std::abs(x), static_cast<T>(p));
+  }
+};
+
+struct Add {
+  template <typename T>
+  T operator()(const T& a, const T& b) const {
+    return a + b;
+  }
+};
+
+struct Mul {
+  template <typename T>
+  T operator()(const T& a, const T& b) const {
+    return a * b;
+  }
+};
+
+// NaN wins, like vec::maximum / vec::minimum
+struct Max {
+  template <typename T>
+  T operator()(const T& a, const T& b) const {
+    return (b > a || is_nan(b)) ? b : a;
+  }
+  template <typename T>
+  Vectorized<T> operator()(const Vectorized<T>& a, const Vectorized<T>& b) const {
+    return maximum(a, b);
+  }
+};
+
+struct Min {
+  template <typename T>
+  T operator()(const T& a, const T& b) const {
+    return (b < a || is_nan(b)) ? b : a;
+  }
+  template <typename T>
+  Vectorized<T> operator()(const Vectorized<T>& a, const Vectorized<T>& b) const {
+    return minimum(a, b);
+  }
+};
+
+// A reducer folds mapped elements into a state_t:
+//  - identity(), fold(s, x, index) and combine(a, b) work on states, where
+//    combine(a, b) merges the state of the elements before b's
+//  - accumulator() makes an object with add(state) and result() that
+//    combines many states; for sums it is a CascadeSum
+// Reducers with kVectorized also have the same on Vectorized<acc_t>, with
+// map_vec instead of fold, and reduce_lanes to merge the lanes of a vector.
+template <typename scalar_t, typename Map, typename Combine, bool kCascade>
+struct MapReducer {
+  using acc_t = acc_type_t<scalar_t>;
+  using state_t = acc_t;
+  using Vec = Vectorized<acc_t>;
+  template <typename T>
+  using Accumulator = typename std::conditional<kCascade, CascadeSum<T>, Fold<T, Combine>>::type;
+  static constexpr bool kVectorized = VecLoader<scalar_t>::value && Map::kVectorized;
+
+  MapReducer(acc_t identity, const Map& map) : identity_(identity), map_(map) {}
+
+  state_t identity() const {
+    return identity_;
+  }
+  void fold(state_t& s, scalar_t x, int64_t /*index*/) const {
+    s = Combine()(s, map_(static_cast<acc_t>(x)));
+  }
+  state_t combine(const state_t& a, const state_t& b) const {
+    return Combine()(a, b);
+  }
+  Accumulator<state_t> accumulator() const {
+    return Accumulator<state_t>(identity_);
+  }
+
+  Vec vec_identity() const {
+    return Vec(identity_);
+  }
+  Vec map_vec(const Vec& x) const {
+    return map_(x);
+  }
+  Vec combine_vec(const Vec& a, const Vec& b) const {
+    return Combine()(a, b);
+  }
+  Accumulator<Vec> vec_accumulator() const {
+    return Accumulator<Vec>(vec_identity());
+  }
+  acc_t reduce_lanes(const Vec& v) const {
+    return vec_reduce_all([](const Vec& a, const Vec& b) { return Combine()(a, b); }, v);
+  }
+
+ private:
+  acc_t identity_;
+  Map map_;
+};
+
+template <typename scalar_t, typename Map>
+using SumReducer = MapReducer<scalar_t, Map, Add, true>;
+template <typename scalar_t>
+using ProdReducer = MapReducer<scalar_t, MapIdentity, Mul, false>;
+template <typename scalar_t, typename Map>
+using MaxReducer = MapReducer<scalar_t, Map, Max, false>;
+template <typename scalar_t, typename Map>
+using MinReducer = MapReducer<scalar_t, Map, Min, false>;
+
+template <typename T>
+T lowest() {
+  return std::numeric_limits<T>::has_infinity ? -std::numeric_limits<T>::infinity()
+                                              : std::numeric_limits<T>::lowest();
+}
+
+template <typename T>
+T highest() {
+  return std::numeric_limits<T>::has_infinity ? std::numeric_limits<T>::infinity()
+                                              : std::numeric_limits<T>::max();
+}
+
+// The index of the first maximum, or of the first NaN
+template <typename scalar_t>
+struct ArgMaxReducer {
+  using acc_t = acc_type_t<scalar_t>;
+  struct state_t {
+    acc_t value;
+    int64_t index;
+  };
+  static constexpr bool kVectorized = false;
+
+  struct Combine {
+    state_t operator()(const state_t& a, const state_t& b) const {
+      return a.index < 0 || (b.index >= 0 && beats(b.value, a.value)) ? b : a;
+    }
+  };
+
+  static bool beats(acc_t x, acc_t best) {
+    return x > best || (is_nan(x) && !is_nan(best));
+  }
+
+  state_t identity() const {
+    return {lowest<acc_t>(), -1};
+  }
+  void fold(state_t& s, scalar_t x, int64_t index) const {
+    const acc_t value = static_cast<acc_t>(x);
+    if (s.index < 0 || beats(value, s.value)) {
+      s = {value, index};
+    }
+  }
+  state_t combine(const state_t& a, const state_t& b) const {
+    return Combine()(a, b);
+  }
+  Fold<state_t, Combine> accumulator() const {
+    return Fold<state_t, Combine>(identity());
+  }
+};
+
+// Chunks of elements folded into one state before it goes to the accumulator
+constexpr int64_t kScalarBlock = 64;
+// Iterations of the vector loops between two additions to the accumulator
+constexpr int64_t kVecBlock = 16;
+
+// Reduces n elements at p, stride apart; index is the position of the first
+// one among the reduced elements.
+template <typename R, typename scalar_t>
+typename R::state_t reduce_row(
+    const R& r,
+    const scalar_t* p,
+    int64_t n,
+    int64_t stride,
+    int64_t index,
+    std::false_type /*vectorized*/) {
+  auto acc = r.accumulator();
+  for (int64_t i = 0; i < n;) {
+    auto s = r.identity();
+    const int64_t block_end = std::min(n, i + kScalarBlock);
+    for (; i < block_end; i++) {
+      r.fold(s, p[i * stride], index + i);
+    }
+    acc.add(s);
+  }
+  return acc.result();
+}
+
+// Contiguous rows go through four vector accumulators, which reach the
+// row's accumulator every kVecBlock iterations.
+template <typename R, typename scalar_t>
+typename R::state_t reduce_row(
+    const R& r,
+    const scalar_t* p,
+    int64_t n,
+    int64_t stride,
+    int64_t index,
+    std::true_type /*vectorized*/) {
+  if (stride != 1) {
+    return reduce_row(r, p, n, stride, index, std::false_type());
+  }
+  using Vec = typename R::Vec;
+  using Loader = VecLoader<scalar_t>;
+  constexpr int64_t W = Vec::size();
+  auto vacc = r.vec_accumulator();
+  int64_t i = 0;
+  while (i + 4 * W <= n) {
+    Vec a0 = r.vec_identity();
+    Vec a1 = a0;
+    Vec a2 = a0;
+    Vec a3 = a0;
+    const int64_t iterations = std::min(kVecBlock, (n - i) / (4 * W));
+    for (int64_t k = 0; k < iterations; k++, i += 4 * W) {
+      a0 = r.combine_vec(a0, r.map_vec(Loader::load(p + i)));
+      a1 = r.combine_vec(a1, r.map_vec(Loader::load(p + i + W)));
+      a2 = r.combine_vec(a2, r.map_vec(Loader::load(p + i + 2 * W)));
+      a3 = r.combine_vec(a3, r.map_vec(Loader::load(p + i + 3 * W)));
+    }
+    vacc.add(r.combine_vec(r.combine_vec(a0, a1), r.combine_vec(a2, a3)));
+  }
+  for (; i + W <= n; i += W) {
+    vacc.add(r.map_vec(Loader::load(p + i)));
+  }
+  auto tail = r.identity();
+  for (; i < n; i++) {
+    r.fold(tail, p[i], index + i);
+  }
+  return r.combine(r.reduce_lanes(vacc.result()), tail);
+}
+
+// Calls row(p, n, stride, index) on the runs of the reduced elements
+// [begin, end) along the fastest reduced dimension, in order.
+template <typename scalar_t, typename F>
+void for_each_row(
+    const scalar_t* base,
+    const ReduceGeometry& g,
+    int64_t begin,
+    int64_t end,
+    const F& row) {
+  if (begin >= end) {
+    return;
+  }
+  const int64_t ndim = static_cast<int64_t>(g.reduce_sizes.size());
+  if (ndim == 0) {
+    row(base, 1, 1, 0);
+    return;
+  }
+  const int64_t size0 = g.reduce_sizes[0];
+  const int64_t stride0 = g.reduce_strides[0];
+  DimVector index(static_cast<size_t>(ndim), 0);
+  // offset of the row start in the dimensions above the first
+  int64_t offset = 0;
+  int64_t rem = begin;
+  for (int64_t d = 0; d < ndim; d++) {
+    index[d] = rem % g.reduce_sizes[d];
+    rem /= g.reduce_sizes[d];
+    if (d > 0) {
+      offset += index[d] * g.reduce_strides[d];
+    }
+  }
+  for (int64_t pos = begin; pos < end;) {
+    const int64_t n = std::min(end - pos, size0 - index[0]);
+    row(base + offset + index[0] * stride0, n, stride0, pos);
+    pos += n;
+    index[0] += n;
+    if (index[0] == size0) {
+      index[0] = 0;
+      for (int64_t d = 1; d < ndim; d++) {
+        index[d]++;
+        offset += g.reduce_strides[d];
+        if (index[d] < g.reduce_sizes[d]) {
+          break;
+        }
+        offset -= g.reduce_sizes[d] * g.reduce_strides[d];
+        index[d] = 0;
+      }
+    }
+  }
+}
+
+// Reduces the reduced elements [begin, end) of one output
+template <typename R, typename scalar_t>
+typename R::state_t reduce_range(
+    const R& r,
+    const scalar_t* base,
+    const ReduceGeometry& g,
+    int64_t begin,
+    int64_t end) {
+  auto acc = r.accumulator();
+  const std::integral_constant<bool, R::kVectorized> vectorized;
+  for_each_row(
+      base, g, begin, end, [&](const scalar_t* p, int64_t n, int64_t stride, int64_t index) {
+        acc.add(reduce_row(r, p, n, stride, index, vectorized));
+      });
+  return acc.result();
+}
+
+// Same for lanes consecutive outputs, which must be contiguous in the input:
+// lane l of the result is the state of output l.
+template <typename R, typename scalar_t>
+typename R::Vec reduce_range_lanes(
+    const R& r,
+    const scalar_t* base,
+    const ReduceGeometry& g,
+    int64_t begin,
+    int64_t end,
+    int64_t lanes) {
+  using Vec = typename R::Vec;
+  using Loader = VecLoader<scalar_t>;
+  auto vacc = r.vec_accumulator();
+  for_each_row(base, g, begin, end, [&](const scalar_t* p, int64_t n, int64_t stride, int64_t) {
+    for (int64_t j = 0; j < n;) {
+      Vec a = r.vec_identity();
+      const int64_t block_end = std::min(n, j + kVecBlock);
+      for (; j < block_end; j++) {
+        const scalar_t* q = p + j * stride;
+        const Vec x = lanes == Vec::size() ? Loader::load(q) : Loader::load(q, lanes);
+        a = r.combine_vec(a, r.map_vec(x));
+      }
+      vacc.add(a);
+    }
+  });
+  return vacc.result();
+}
+
+// The outputs are computed in units: one output, or for outer reductions
+// (the fastest kept dimension is contiguous in the input, the fastest reduced
+// one is not) up to a vector's worth of consecutive outputs.
+class OutputUnits {
+ public:
+  OutputUnits(const ReduceGeometry& g, int64_t lanes) : g_(g), lanes_(lanes) {
+    count_ = 1;
+    for (size_t d = 0; d < g.outer_sizes.size(); d++) {
+      count_ *= d == 0 ? internal::divup(g.outer_sizes[0], lanes) : g.outer_sizes[d];
+    }
+  }
+
+  int64_t count() const {
+    return count_;
+  }
+
+  struct Location {
+    int64_t in_offset = 0;
+    int64_t out_offset = 0;
+    // outputs in the unit
+    int64_t width = 1;
+  };
+
+  Location locate(int64_t unit) const {
+    Location loc;
+    int64_t rem = unit;
+    for (size_t d = 0; d < g_.outer_sizes.size(); d++) {
+      const int64_t size = d == 0 ? internal::divup(g_.outer_sizes[0], lanes_) : g_.outer_sizes[d];
+      int64_t i = rem % size;
+      rem /= size;
+      if (d == 0) {
+        i *= lanes_;
+        loc.width = std::min(lanes_, g_.outer_sizes[0] - i);
+      }
+      loc.in_offset += i * g_.outer_in_strides[d];
+      loc.out_offset += i * g_.outer_out_strides[d];
+    }
+    return loc;
+  }
+
+ private:
+  const ReduceGeometry& g_;
+  int64_t lanes_;
+  int64_t count_;
+};
+
+int64_t reduce_numel(const ReduceGeometry& g) {
+  int64_t n = 1;
+  for (int64_t s : g.reduce_sizes) {
+    n *= s;
+  }
+  return n;
+}
+
+// A few outputs over many elements split their reductions into chunks that
+// run in parallel, and combine the chunks' states in order.  The chunks
+// don't depend on the number of threads, so neither do the results.
+constexpr int64_t kMaxSplitUnits = 16;
+constexpr int64_t kMaxChunks = 64;
+
+bool should_split(int64_t units, int64_t rnumel) {
+  return units < kMaxSplitUnits && rnumel >= 2 * internal::GRAIN_SIZE;
+}
+
+int64_t split_chunk_size(int64_t rnumel) {
+  return std::max(internal::GRAIN_SIZE, internal::divup(rnumel, kMaxChunks));
+}
+
+template <typename scalar_t, typename out_t, typename R, typename F>
+void reduce_outputs(
+    const ReduceGeometry& g,
+    const R& r,
+    const F& finalize,
+    std::false_type /*lanes*/) {
+  const auto* in = static_cast<const scalar_t*>(g.in);
+  auto* out = static_cast<out_t*>(g.out);
+  const OutputUnits units(g, 1);
+  const int64_t rnumel = reduce_numel(g);
+  if (should_split(units.count(), rnumel)) {
+    const int64_t chunk = split_chunk_size(rnumel);
+    const int64_t num_chunks = internal::divup(rnumel, chunk);
+    std::vector<typename R::state_t> partial(units.count() * num_chunks, r.identity());
+    parallel_for(0, units.count() * num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t t = begin; t < end; t++) {
+        const int64_t c = t % num_chunks;
+        const auto loc = units.locate(t / num_chunks);
+        partial[t] = reduce_range(
+            r, in + loc.in_offset, g, c * chunk, std::min(rnumel, (c + 1) * chunk));
+      }
+    });
+    for (int64_t u = 0; u < units.count(); u++) {
+      auto acc = r.accumulator();
+      for (int64_t c = 0; c < num_chunks; c++) {
+        acc.add(partial[u * num_chunks + c]);
+      }
+      out[units.locate(u).out_offset] = finalize(acc.result());
+    }
+    return;
+  }
+  const int64_t grain_size =
+      std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(rnumel, 1));
+  parallel_for(0, units.count(), grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t u = begin; u < end; u++) {
+      const auto loc = units.locate(u);
+      out[loc.out_offset] = finalize(reduce_range(r, in + loc.in_offset, g, 0, rnumel));
+    }
+  });
+}
+
+template <typename scalar_t, typename out_t, typename R, typename F>
+void reduce_outputs(
+    const ReduceGeometry& g,
+    const R& r,
+    const F& finalize,
+    std::true_type /*lanes*/) {
+  using acc_t = typename R::acc_t;
+  using Vec = typename R::Vec;
+  constexpr int64_t W = Vec::size();
+  const auto* in = static_cast<const scalar_t*>(g.in);
+  auto* out = static_cast<out_t*>(g.out);
+  const OutputUnits units(g, W);
+  const int64_t rnumel = reduce_numel(g);
+  const int64_t out_stride = g.outer_out_strides[0];
+  if (should_split(units.count(), rnumel)) {
+    const int64_t chunk = split_chunk_size(rnumel);
+    const int64_t num_chunks = internal::divup(rnumel, chunk);
+    std::vector<acc_t> partial(units.count() * num_chunks * W);
+    parallel_for(0, units.count() * num_chunks, 1, [&](int64_t begin, int64_t end) {
+      for (int64_t t = begin; t < end; t++) {
+        const int64_t c = t % num_chunks;
+        const auto loc = units.locate(t / num_chunks);
+        reduce_range_lanes(
+            r, in + loc.in_offset, g, c * chunk, std::min(rnumel, (c + 1) * chunk), loc.width)
+            .store(partial.data() + t * W);
+      }
+    });
+    for (int64_t u = 0; u < units.count(); u++) {
+      const auto loc = units.locate(u);
+      for (int64_t l = 0; l < loc.width; l++) {
+        auto acc = r.accumulator();
+        for (int64_t c = 0; c < num_chunks; c++) {
+          acc.add(partial[(u * num_chunks + c) * W + l]);
+        }
+        out[loc.out_offset + l * out_stride] = finalize(acc.result());
+      }
+    }
+    return;
+  }
+  const int64_t grain_size =
+      std::max<int64_t>(1, internal::GRAIN_SIZE / std::max<int64_t>(rnumel * W, 1));
+  parallel_for(0, units.count(), grain_size, [&](int64_t begin, int64_t end) {
+    C10_VEC_ALIGN acc_t lanes[W];
+    for (int64_t u = begin; u < end; u++) {
+      const auto loc = units.locate(u);
+      reduce_range_lanes(r, in + loc.in_offset, g, 0, rnumel, loc.width).store(lanes);
+      for (int64_t l = 0; l < loc.width; l++) {
+        out[loc.out_offset + l * out_stride] = finalize(lanes[l]);
+      }
+    }
+  });
+}
+
+template <typename scalar_t, typename out_t, typename R, typename F>
+void reduce_outputs(const ReduceGeometry& g, const R& r, const F& finalize) {
+  const bool outer_reduction = R::kVectorized && !g.outer_sizes.empty() &&
+      g.outer_in_strides[0] == 1 && (g.reduce_strides.empty() || g.reduce_strides[0] != 1);
+  if (outer_reduction) {
+    reduce_outputs<scalar_t, out_t>(g, r, finalize, std::integral_constant<bool, R::kVectorized>());
+  } else {
+    reduce_outputs<scalar_t, out_t>(g, r, finalize, std::false_type());
+  }
+}
+
+template <typename out_t>
+struct Cast {
+  template <typename T>
+  out_t operator()(const T& x) const {
+    return static_cast<out_t>(x);
+  }
+};
+
+template <typename out_t, typename acc_t>
+struct Divide {
+  acc_t divisor;
+  out_t operator()(acc_t x) const {
+    return static_cast<out_t>(x / divisor);
+  }
+};
+
+template <typename out_t>
+struct Sqrt {
+  template <typename T>
+  out_t operator()(const T& x) const {
+    return static_cast<out_t>(std::sqrt(x));
+  }
+};
+
+template <typename out_t, typename acc_t>
+struct Root {
+  acc_t inverse_p;
+  out_t operator()(acc_t x) const {
+    return static_cast<out_t>(std::pow(x, inverse_p));
+  }
+};
+
+template <typename scalar_t>
+void reduce_norm(const ReduceGeometry& g, double p, std::true_type /*floating*/) {
+  using acc_t = acc_type_t<scalar_t>;
+  if (p == 0) {
+    reduce_outputs<scalar_t, scalar_t>(
+        g, SumReducer<scalar_t, MapNonZero>(0, MapNonZero()), Cast<scalar_t>());
+  } else if (p == 1) {
+    reduce_outputs<scalar_t, scalar_t>(
+        g, SumReducer<scalar_t, MapAbs>(0, MapAbs()), Cast<scalar_t>());
+  } else if (p == 2) {
+    reduce_outputs<scalar_t, scalar_t>(
+        g, SumReducer<scalar_t, MapSquare>(0, MapSquare()), Sqrt<scalar_t>());
+  } else if (std::isinf(p) && p > 0) {
+    reduce_outputs<scalar_t, scalar_t>(
+        g, MaxReducer<scalar_t, MapAbs>(lowest<acc_t>(), MapAbs()), Cast<scalar_t>());
+  } else if (std::isinf(p)) {
+    reduce_outputs<scalar_t, scalar_t>(
+        g, MinReducer<scalar_t, MapAbs>(highest<acc_t>(), MapAbs()), Cast<scalar_t>());
+  } else {
+    reduce_outputs<scalar_t, scalar_t>(
+        g, SumReducer<scalar_t, MapPow>(0, MapPow{p}),
+        Root<scalar_t, acc_t>{static_cast<acc_t>(1.0 / p)});
+  }
+}
+
+template <typename scalar_t>
+void reduce_norm(const ReduceGeometry&, double, std::false_type /*floating*/) {
+  TORCH_INTERNAL_ASSERT(false, "reduce_kernel: norm of a non floating point dtype");
+}
+
+template <typename scalar_t>
+void reduce_typed(const ReduceGeometry& g, const ReduceParams& params) {
+  using acc_t = acc_type_t<scalar_t>;
+  // sums and products of integers are int64_t
+  using sum_t =
+      typename std::conditional<std::is_integral<scalar_t>::value, int64_t, scalar_t>::type;
+  switch (params.op) {
+    case ReduceOp::Sum:
+      reduce_outputs<scalar_t, sum_t>(
+          g, SumReducer<scalar_t, MapIdentity>(0, MapIdentity()),
+          Divide<sum_t, acc_t>{static_cast<acc_t>(params.divisor)});
+      break;
+    case ReduceOp::Prod:
+      reduce_outputs<scalar_t, sum_t>(g, ProdReducer<scalar_t>(1, MapIdentity()), Cast<sum_t>());
+      break;
+    case ReduceOp::Max:
+      reduce_outputs<scalar_t, scalar_t>(
+          g, MaxReducer<scalar_t, MapIdentity>(lowest<acc_t>(), MapIdentity()), Cast<scalar_t>());
+      break;
+    case ReduceOp::Min:
+      reduce_outputs<scalar_t, scalar_t>(
+          g, MinReducer<scalar_t, MapIdentity>(highest<acc_t>(), MapIdentity()), Cast<scalar_t>());
+      break;
+    case ReduceOp::ArgMax:
+      reduce_outputs<scalar_t, int64_t>(
+          g, ArgMaxReducer<scalar_t>(),
+          [](const typename ArgMaxReducer<scalar_t>::state_t& s) { return s.index; });
+      break;
+    case ReduceOp::Norm:
+      reduce_norm<scalar_t>(
+          g, params.p, std::integral_constant<bool, is_floating<scalar_t>::value>());
+      break;
+  }
+}
+
+void reduce_kernel(const ReduceGeometry& g, const ReduceParams& params) {
+  switch (g.in_dtype) {
+#define REDUCE_CASE(type, name)    \
+    case ScalarType::name:         \
+      reduce_typed<type>(g, params); \
+      break;
+    AT_FORALL_SCALAR_TYPES_AND2(Half, BFloat16, REDUCE_CASE)
+#undef REDUCE_CASE
+    default:
+      TORCH_INTERNAL_ASSERT(false, "reduce_kernel: unexpected dtype ", g.in_dtype);
+  }
+}
+
+} // namespace
+
+REGISTER_DISPATCH(reduce_stub, &reduce_kernel);
+
+} // namespace c10
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <c10/core/ScalarType.h>
+#include <c10/core/TensorImpl.h>
+#include <c10/util/DispatchStub.h>
+
+// Kernel of the reductions in c10/core/ReduceOps.h.
+
+namespace c10 {
+
+enum class ReduceOp : uint8_t {
+  Sum, // also mean, with divisor
+  Prod,
+  Max,
+  Min,
+  ArgMax,
+  Norm, // with p
+};
+
+// Each output element reduces the input elements at the same position in the
+// kept dimensions.  The dimensions are coalesced and have no size-1
+// dimensions left; strides are in elements.  The reduced dimensions are in
+// the order the reduction visits them, fastest first, which for ArgMax is the
+// reverse of their logical order so that the index of an element is its
+// row-major position among the reduced elements.
+struct ReduceGeometry {
+  const void* in = nullptr;
+  ScalarType in_dtype = ScalarType::Undefined;
+  void* out = nullptr;
+  ScalarType out_dtype = ScalarType::Undefined;
+  DimVector outer_sizes;
+  DimVector outer_in_strides;
+  DimVector outer_out_strides;
+  DimVector reduce_sizes;
+  DimVector reduce_strides;
+};
+
+struct ReduceParams {
+  ReduceOp op = ReduceOp::Sum;
+  // Sum results are divided by divisor
+  double divisor = 1;
+  // Norm order, one of 0, 1, 2, +-inf or any other positive value
+  double p = 2;
+};
+
+using reduce_fn = void (*)(const ReduceGeometry&, const ReduceParams&);
+
+DECLARE_DISPATCH(reduce_fn, reduce_stub);
+
+} // namespace c10
@@ -0,0 +1,246 @@
+#include <c10/cpu/TransposeKernel.h>
+
+#if defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX512)
+#include <immintrin.h>
+#endif
+
+#include <c10/util/Exception.h>
+
+namespace c10 {
+namespace {
+
+// The elements are moved as opaque bytes
+template <size_t N>
+struct Item {
+  unsigned char bytes[N];
+};
+
+template <typename T>
+void transpose_scalar(
+    const T* src,
+    int64_t ld_src,
+    T* dst,
+    int64_t ld_dst,
+    int64_t rows,
+    int64_t cols) {
+  for (int64_t j = 0; j < cols; j++) {
+    for (int64_t i = 0; i < rows; i++) {
+      dst[j * ld_dst + i] = src[i * ld_src + j];
+    }
+  }
+}
+
+// Transposes the R x R tiles with micro, and the edges with the scalar code
+template <int64_t R, typename T, typename Micro>
+void transpose_tiled(
+    const T* src,
+    int64_t ld_src,
+    T* dst,
+    int64_t ld_dst,
+    int64_t rows,
+    int64_t cols,
+    const Micro& micro) {
+  const int64_t rows_main = rows - rows % R;
+  const int64_t cols_main = cols - cols % R;
+  for (int64_t i = 0; i < rows_main; i += R) {
+    for (int64_t j = 0; j < cols_main; j += R) {
+      micro(src + i * ld_src + j, ld_src, dst + j * ld_dst + i, ld_dst);
+    }
+  }
+  // the right edge, then the bottom one
+  transpose_scalar(
+      src + cols_main, ld_src, dst + cols_main * ld_dst, ld_dst, rows_main, cols - cols_main);
+  transpose_scalar(
+      src + rows_main * ld_src, ld_src, dst + rows_main, ld_dst, rows - rows_main, cols);
+}
+
+#if defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX512)
+
+// 8 x 8 bytes: rows are 8-byte loads, interleaved three times
+void transpose_8x8_8bit(const Item<1>* src, int64_t ld_src, Item<1>* dst, int64_t ld_dst) {
+  __m128i r[8];
+  for (int k = 0; k < 8; k++) {
+    r[k] = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + k * ld_src));
+  }
+  // rows 2k and 2k + 1, interleaved
+  const __m128i a0 = _mm_unpacklo_epi8(r[0], r[1]);
+  const __m128i a1 = _mm_unpacklo_epi8(r[2], r[3]);
+  const __m128i a2 = _mm_unpacklo_epi8(r[4], r[5]);
+  const __m128i a3 = _mm_unpacklo_epi8(r[6], r[7]);
+  // rows 0-3 and 4-7 of columns 0-3 and 4-7
+  const __m128i b0 = _mm_unpacklo_epi16(a0, a1);
+  const __m128i b1 = _mm_unpackhi_epi16(a0, a1);
+  const __m128i b2 = _mm_unpacklo_epi16(a2, a3);
+  const __m128i b3 = _mm_unpackhi_epi16(a2, a3);
+  // two columns each
+  const __m128i c[4] = {
+      _mm_unpacklo_epi32(b0, b2),
+      _mm_unpackhi_epi32(b0, b2),
+      _mm_unpacklo_epi32(b1, b3),
+      _mm_unpackhi_epi32(b1, b3)};
+  for (int k = 0; k < 4; k++) {
+    _mm_storel_epi64(reinterpret_cast<__m128i*>(dst + (2 * k) * ld_dst), c[k]);
+    _mm_storel_epi64(
+        reinterpret_cast<__m128i*>(dst + (2 * k + 1) * ld_dst), _mm_unpackhi_epi64(c[k], c[k]));
+  }
+}
+
+// 8 x 8 16-bit elements, in SSE registers
+void transpose_8x8_16bit(const Item<2>* src, int64_t ld_src, Item<2>* dst, int64_t ld_dst) {
+  __m128i r[8];
+  for (int k = 0; k < 8; k++) {
+    r[k] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + k * ld_src));
+  }
+  __m128i a[8];
+  for (int k = 0; k < 4; k++) {
+    a[2 * k] = _mm_unpacklo_epi16(r[2 * k], r[2 * k + 1]);
+    a[2 * k + 1] = _mm_unpackhi_epi16(r[2 * k], r[2 * k + 1]);
+  }
+  // b[k] has two columns of rows 0-3 (k < 4) or 4-7 (k >= 4)
+  __m128i b[8];
+  for (int h = 0; h < 2; h++) {
+    b[4 * h] = _mm_unpacklo_epi32(a[4 * h], a[4 * h + 2]);
+    b[4 * h + 1] = _mm_unpackhi_epi32(a[4 * h], a[4 * h + 2]);
+    b[4 * h + 2] = _mm_unpacklo_epi32(a[4 * h + 1], a[4 * h + 3]);
+    b[4 * h + 3] = _mm_unpackhi_epi32(a[4 * h + 1], a[4 * h + 3]);
+  }
+  for (int k = 0; k < 4; k++) {
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + (2 * k) * ld_dst), _mm_unpacklo_epi64(b[k], b[k + 4]));
+    _mm_storeu_si128(
+        reinterpret_cast<__m128i*>(dst + (2 * k + 1) * ld_dst), _mm_unpackhi_epi64(b[k], b[k + 4]));
+  }
+}
+
+// 8 x 8 32-bit elements, in AVX registers
+void transpose_8x8_32bit(const Item<4>* src, int64_t ld_src, Item<4>* dst, int64_t ld_dst) {
+  __m256 r[8];
+  for (int k = 0; k < 8; k++) {
+    r[k] = _mm256_loadu_ps(reinterpret_cast<const float*>(src + k * ld_src));
+  }
+  __m256 a[8];
+  for (int k = 0; k < 4; k++) {
+    a[2 * k] = _mm256_unpacklo_ps(r[2 * k], r[2 * k + 1]);
+    a[2 * k + 1] = _mm256_unpackhi_ps(r[2 * k], r[2 * k + 1]);
+  }
+  // b[k] has column k of rows 0-3 and column k + 4 of the same rows in its
+  // upper half, for rows 0-3 (k < 4) or 4-7 (k >= 4)
+  __m256 b[8];
+  for (int h = 0; h < 2; h++) {
+    b[4 * h] = _mm256_shuffle_ps(a[4 * h], a[4 * h + 2], _MM_SHUFFLE(1, 0, 1, 0));
+    b[4 * h + 1] = _mm256_shuffle_ps(a[4 * h], a[4 * h + 2], _MM_SHUFFLE(3, 2, 3, 2));
+    b[4 * h + 2] = _mm256_shuffle_ps(a[4 * h + 1], a[4 * h + 3], _MM_SHUFFLE(1, 0, 1, 0));
+    b[4 * h + 3] = _mm256_shuffle_ps(a[4 * h + 1], a[4 * h + 3], _MM_SHUFFLE(3, 2, 3, 2));
+  }
+  for (int k = 0; k < 4; k++) {
+    _mm256_storeu_ps(
+        reinterpret_cast<float*>(dst + k * ld_dst), _mm256_permute2f128_ps(b[k], b[k + 4], 0x20));
+    _mm256_storeu_ps(
+        reinterpret_cast<float*>(dst + (k + 4) * ld_dst),
+        _mm256_permute2f128_ps(b[k], b[k + 4], 0x31));
+  }
+}
+
+// 4 x 4 64-bit elements, in AVX registers
+void transpose_4x4_64bit(const Item<8>* src, int64_t ld_src, Item<8>* dst, int64_t ld_dst) {
+  __m256d r[4];
+  for (int k = 0; k < 4; k++) {
+    r[k] = _mm256_loadu_pd(reinterpret_cast<const double*>(src + k * ld_src));
+  }
+  const __m256d a0 = _mm256_unpacklo_pd(r[0], r[1]);
+  const __m256d a1 = _mm256_unpackhi_pd(r[0], r[1]);
+  const __m256d a2 = _mm256_unpacklo_pd(r[2], r[3]);
+  const __m256d a3 = _mm256_unpackhi_pd(r[2], r[3]);
+  _mm256_storeu_pd(reinterpret_cast<double*>(dst), _mm256_permute2f128_pd(a0, a2, 0x20));
+  _mm256_storeu_pd(reinterpret_cast<double*>(dst + ld_dst), _mm256_permute2f128_pd(a1, a3, 0x20));
+  _mm256_storeu_pd(
+      reinterpret_cast<double*>(dst + 2 * ld_dst), _mm256_permute2f128_pd(a0, a2, 0x31));
+  _mm256_storeu_pd(
+      reinterpret_cast<double*>(dst + 3 * ld_dst), _mm256_permute2f128_pd(a1, a3, 0x31));
+}
+
+// Whether itemsize has a SIMD kernel; 16-byte elements are already one
+// vector each and go through the scalar code.
+bool transpose_vectorized(
+    const void* src,
+    int64_t ld_src,
+    void* dst,
+    int64_t ld_dst,
+    int64_t rows,
+    int64_t cols,
+    size_t itemsize) {
+  switch (itemsize) {
+    case 1:
+      transpose_tiled<8>(
+          static_cast<const Item<1>*>(src), ld_src, static_cast<Item<1>*>(dst), ld_dst, rows, cols,
+          transpose_8x8_8bit);
+      return true;
+    case 2:
+      transpose_tiled<8>(
+          static_cast<const Item<2>*>(src), ld_src, static_cast<Item<2>*>(dst), ld_dst, rows, cols,
+          transpose_8x8_16bit);
+      return true;
+    case 4:
+      transpose_tiled<8>(
+          static_cast<const Item<4>*>(src), ld_src, static_cast<Item<4>*>(dst), ld_dst, rows, cols,
+          transpose_8x8_32bit);
+      return true;
+    case 8:
+      transpose_tiled<4>(
+          static_cast<const Item<8>*>(src), ld_src, static_cast<Item<8>*>(dst), ld_dst, rows, cols,
+          transpose_4x4_64bit);
+      return true;
+    default:
+      return false;
+  }
+}
+
+#endif // defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX512)
+
+void transpose_kernel(
+    const void* src,
+    int64_t ld_src,
+    void* dst,
+    int64_t ld_dst,
+    int64_t rows,
+    int64_t cols,
+    size_t itemsize) {
+#if defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX512)
+  if (transpose_vectorized(src, ld_src, dst, ld_dst, rows, cols, itemsize)) {
+    return;
+  }
+#endif
+  switch (itemsize) {
+#define TRANSPOSE_CASE(N)                                                                  \
+    case N:                                                                                \
+      transpose_scalar(                                                                    \
+          static_cast<const Item<N>*>(src), ld_src, static_cast<Item<N>*>(dst), ld_dst, rows, \
+          cols);                                                                           \
+      break;
+    TRANSPOSE_CASE(1)
+    TRANSPOSE_CASE(2)
+    TRANSPOSE_CASE(3)
+    TRANSPOSE_CASE(4)
+    TRANSPOSE_CASE(5)
+    TRANSPOSE_CASE(6)
+    TRANSPOSE_CASE(7)
+    TRANSPOSE_CASE(8)
+    TRANSPOSE_CASE(9)
+    TRANSPOSE_CASE(10)
+    TRANSPOSE_CASE(11)
+    TRANSPOSE_CASE(12)
+    TRANSPOSE_CASE(13)
+    TRANSPOSE_CASE(14)
+    TRANSPOSE_CASE(15)
+    TRANSPOSE_CASE(16)
+#undef TRANSPOSE_CASE
+    default:
+      TORCH_INTERNAL_ASSERT(false, "transpose_kernel: unsupported element size ", itemsize);
+  }
+}
+
+} // namespace
+
+REGISTER_DISPATCH(transpose_stub, &transpose_kernel);
+
+} // namespace c10
@@ -0,0 +1,28 @@
+#pragma once
+
+#include <c10/util/DispatchStub.h>
+
+#include <cstddef>
+#include <cstdint>
+
+// Kernel of the layout conversions in c10/core/MemoryFormatOps.h.
+
+namespace c10 {
+
+// Transposes the rows x cols matrix at src, whose rows are ld_src elements
+// apart, into the cols x rows matrix at dst, whose rows are ld_dst elements
+// apart.  Elements are itemsize bytes, any size from 1 to 16.  Meant for
+// blocks that fit in cache; the caller does the cache blocking and the
+// threading.
+using transpose_fn = void (*)(
+    const void* src,
+    int64_t ld_src,
+    void* dst,
+    int64_t ld_dst,
+    int64_t rows,
+    int64_t cols,
+    size_t itemsize);
+
+DECLARE_DISPATCH(transpose_fn, transpose_stub);
+
+} // namespace c10
@@ -0,0 +1,87 @@
+#include <c10/cpu/VmathKernel.h>
+#include <c10/cpu/vec/vec.h>
+
+#include <algorithm>
+
+namespace c10 {
+namespace {
+
+using namespace vec;
+using FVec = Vectorized<float>;
+
+// exp(-|x|) is at most 1, so it neither overflows nor cancels; for negative x
+// sigmoid(x) = exp(x) / (1 + exp(x)) keeps the relative accuracy of exp all
+// the way down to the denormals.
+FVec sigmoid(const FVec& x) {
+  const FVec e = x.abs().neg().exp();
+  const FVec r = FVec(1.f) / (FVec(1.f) + e);
+  return FVec::blendv(e * r, r, x >= FVec(0.f));
+}
+
+FVec gelu(const FVec& x) {
+  const FVec half_x = x * FVec(0.5f);
+  return half_x * (FVec(1.f) + (x * FVec(static_cast<float>(M_SQRT1_2))).erf());
+}
+
+// Computes in float and rounds once to T.  The tail goes through a full
+// vector too, so it is rounded like the rest.
+template <typename T, typename Op>
+void vmath_loop(const T* src, T* dst, size_t n, const Op& op) {
+  size_t i = 0;
+  for (; i + FVec::size() <= n; i += FVec::size()) {
+    store_from_float(op(load_to_float(src + i)), dst + i);
+  }
+  if (i < n) {
+    T src_tail[FVec::size()] = {};
+    T dst_tail[FVec::size()];
+    std::copy(src + i, src + n, src_tail);
+    store_from_float(op(load_to_float(src_tail)), dst_tail);
+    std::copy(dst_tail, dst_tail + (n - i), dst + i);
+  }
+}
+
+template <typename T>
+void vmath_typed(VmathOp op, const T* src, T* dst, size_t n) {
+  switch (op) {
+    case VmathOp::Exp:
+      vmath_loop(src, dst, n, [](const FVec& x) { return x.exp(); });
+      break;
+    case VmathOp::Log:
+      vmath_loop(src, dst, n, [](const FVec& x) { return x.log(); });
+      break;
+    case VmathOp::Tanh:
+      vmath_loop(src, dst, n, [](const FVec& x) { return x.tanh(); });
+      break;
+    case VmathOp::Sigmoid:
+      vmath_loop(src, dst, n, [](const FVec& x) { return sigmoid(x); });
+      break;
+    case VmathOp::Erf:
+      vmath_loop(src, dst, n, [](const FVec& x) { return x.erf(); });
+      break;
+    case VmathOp::Gelu:
+      vmath_loop(src, dst, n, [](const FVec& x) { return gelu(x); });
+      break;
+  }
+}
+
+void vmath_kernel(VmathOp op, ScalarType dtype, const void* src, void* dst, size_t n) {
+  switch (dtype) {
+    case ScalarType::Float:
+      vmath_typed(op, static_cast<const float*>(src), static_cast<float*>(dst), n);
+      break;
+    case ScalarType::BFloat16:
+      vmath_typed(op, static_cast<const BFloat16*>(src), static_cast<BFloat16*>(dst), n);
+      break;
+    case ScalarType::Half:
+      vmath_typed(op, static_cast<const Half*>(src), static_cast<Half*>(dst), n);
+      break;
+    default:
+      TORCH_INTERNAL_ASSERT(false, "vmath_kernel: unexpected dtype ", dtype);
+  }
+}
+
+} // namespace
+
+REGISTER_DISPATCH(vmath_stub, &vmath_kernel);
+
+} // namespace c10
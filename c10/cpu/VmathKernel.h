@@ -0,0 +1,17 @@
+#pragma once
+
+#include <c10/core/ScalarType.h>
+#include <c10/util/DispatchStub.h>
+
+// Kernel of the array math functions in c10/util/vmath.h.  The dtype is
+// Float, BFloat16 or Half.
+
+namespace c10 {
+
+enum class VmathOp : uint8_t { Exp, Log, Tanh, Sigmoid, Erf, Gelu };
+
+using vmath_fn = void (*)(VmathOp, ScalarType, const void*, void*, size_t);
+
+DECLARE_DISPATCH(vmath_fn, vmath_stub);
+
+} // namespace c10
@@ -0,0 +1,30 @@
+#pragma once
+
+// Vectorized<T>: a SIMD register of T, with the widest implementation the
+// current CPU_CAPABILITY build of a c10/cpu kernel file allows.  Include
+// this header, not the ones it includes.
+//
+//   using Vec = c10::vec::Vectorized<float>;
+//   int64_t i = 0;
+//   for (; i + Vec::size() <= n; i += Vec::size()) {
+//     (Vec::loadu(a + i) * Vec::loadu(b + i)).store(out + i);
+//   }
+//   (Vec::loadu(a + i, n - i) * Vec::loadu(b + i, n - i)).store(out + i, n - i);
+//
+// Element types: float, double, int64_t, int32_t, int16_t, int8_t, uint8_t,
+// BFloat16, Half, c10::complex<float>, c10::complex<double>, qint8, quint8 and
+// qint32.  See vec_base.h for the interface.
+
+#include <c10/cpu/vec/vec_base.h>
+
+#if defined(CPU_CAPABILITY_AVX512)
+#include <c10/cpu/vec/vec512/vec512.h>
+#elif defined(CPU_CAPABILITY_AVX2)
+#include <c10/cpu/vec/vec256/vec256.h>
+#endif
+
+#include <c10/cpu/vec/vec_complex.h>
+#include <c10/cpu/vec/vec_convert.h>
+#include <c10/cpu/vec/vec_math.h>
+#include <c10/cpu/vec/vec_qint.h>
+#include <c10/cpu/vec/vec_reduced_float.h>
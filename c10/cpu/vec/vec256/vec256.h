@@ -0,0 +1,10 @@
+#pragma once
+
+// AVX2 specializations of Vectorized<T>.  Only meaningful in the AVX2 build of
+// a c10/cpu kernel file; in the other builds the headers are empty.
+
+#include <c10/cpu/vec/vec_base.h>
+#include <c10/cpu/vec/vec256/vec256_convert.h>
+#include <c10/cpu/vec/vec256/vec256_double.h>
+#include <c10/cpu/vec/vec256/vec256_float.h>
+#include <c10/cpu/vec/vec256/vec256_int.h>
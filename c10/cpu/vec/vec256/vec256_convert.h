@@ -0,0 +1,147 @@
+#pragma once
+
+// Conversions between the AVX2 Vectorized types, and the BFloat16 / Half /
+// int8 building blocks declared in vec_base.h.
+
+#include <c10/cpu/vec/vec256/vec256_double.h>
+#include <c10/cpu/vec/vec256/vec256_float.h>
+#include <c10/cpu/vec/vec256/vec256_int.h>
+
+namespace c10 {
+namespace vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX2)
+
+template <>
+inline Vectorized<float> cast<float, int32_t>(const Vectorized<int32_t>& src) {
+  return _mm256_castsi256_ps(src);
+}
+
+template <>
+inline Vectorized<int32_t> cast<int32_t, float>(const Vectorized<float>& src) {
+  return _mm256_castps_si256(src);
+}
+
+template <>
+inline Vectorized<double> cast<double, int64_t>(const Vectorized<int64_t>& src) {
+  return _mm256_castsi256_pd(src);
+}
+
+template <>
+inline Vectorized<int64_t> cast<int64_t, double>(const Vectorized<double>& src) {
+  return _mm256_castpd_si256(src);
+}
+
+template <>
+inline Vectorized<int32_t> convert_to_int_of_same_size<float>(const Vectorized<float>& src) {
+  return _mm256_cvttps_epi32(src);
+}
+
+template <>
+inline Vectorized<float> convert_to_fp_of_same_size<int32_t>(const Vectorized<int32_t>& src) {
+  return _mm256_cvtepi32_ps(src);
+}
+
+// Same rounding and NaN handling as float_to_bfloat16_kernel in
+// c10/cpu/ConvertKernel.cpp: the result has the BFloat16 in the high half.
+inline __m256i round_float_to_bfloat16_bits(__m256 f) {
+  const __m256i u = _mm256_castps_si256(f);
+  const __m256i lsb = _mm256_and_si256(_mm256_srli_epi32(u, 16), _mm256_set1_epi32(1));
+  const __m256i bias = _mm256_add_epi32(lsb, _mm256_set1_epi32(0x7FFF));
+  const __m256i rounded = _mm256_and_si256(
+      _mm256_add_epi32(u, bias), _mm256_set1_epi32(static_cast<int32_t>(0xFFFF0000)));
+  const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(f, f, _CMP_UNORD_Q));
+  return _mm256_blendv_epi8(rounded, _mm256_set1_epi32(0x7FC00000), nan);
+}
+
+// vcvtps2ph keeps NaN payloads, Half(float) returns 0x7E00 with the input's
+// sign.
+inline __m128i float_to_half_bits(__m256 f) {
+  const __m128i h = _mm256_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT);
+  const __m256i nan = _mm256_castps_si256(_mm256_cmp_ps(f, f, _CMP_UNORD_Q));
+  const __m128i nan16 =
+      _mm_packs_epi32(_mm256_castsi256_si128(nan), _mm256_extractf128_si256(nan, 1));
+  const __m128i canonical = _mm_or_si128(
+      _mm_and_si128(h, _mm_set1_epi16(static_cast<int16_t>(0x8000))), _mm_set1_epi16(0x7E00));
+  return _mm_blendv_epi8(h, canonical, nan16);
+}
+
+template <>
+inline Vectorized<float> load_to_float<BFloat16>(const BFloat16* ptr) {
+  const __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr));
+  return _mm256_castsi256_ps(_mm256_slli_epi32(_mm256_cvtepu16_epi32(b), 16));
+}
+
+template <>
+inline Vectorized<float> load_to_float<Half>(const Half* ptr) {
+  return _mm256_cvtph_ps(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)));
+}
+
+template <>
+inline void store_from_float<BFloat16>(const Vectorized<float>& v, BFloat16* ptr) {
+  const __m256i bits = _mm256_srli_epi32(round_float_to_bfloat16_bits(v), 16);
+  const __m128i packed =
+      _mm_packus_epi32(_mm256_castsi256_si128(bits), _mm256_extractf128_si256(bits, 1));
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), packed);
+}
+
+template <>
+inline void store_from_float<Half>(const Vectorized<float>& v, Half* ptr) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), float_to_half_bits(v));
+}
+
+template <>
+inline Vectorized<float> round_to_precision<BFloat16>(const Vectorized<float>& v) {
+  return _mm256_castsi256_ps(round_float_to_bfloat16_bits(v));
+}
+
+template <>
+inline Vectorized<float> round_to_precision<Half>(const Vectorized<float>& v) {
+  return _mm256_cvtph_ps(_mm256_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+}
+
+template <>
+inline Vectorized<int32_t> load_to_int32<int8_t>(const int8_t* ptr) {
+  return _mm256_cvtepi8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ptr)));
+}
+
+template <>
+inline Vectorized<int32_t> load_to_int32<uint8_t>(const uint8_t* ptr) {
+  return _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(ptr)));
+}
+
+template <>
+inline Vectorized<int32_t> load_to_int32<int32_t>(const int32_t* ptr) {
+  return Vectorized<int32_t>::loadu(ptr);
+}
+
+// packs works within 128-bit lanes: after packing to 16 and then 8 bits,
+// elements 0-3 are in the low dword of the low lane and 4-7 in the low dword
+// of the high lane.
+template <>
+inline void store_from_int32<int8_t>(const Vectorized<int32_t>& v, int8_t* ptr) {
+  const __m256i w = _mm256_packs_epi32(v, v);
+  const __m256i b = _mm256_packs_epi16(w, w);
+  const __m128i r = _mm_unpacklo_epi32(_mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1));
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(ptr), r);
+}
+
+template <>
+inline void store_from_int32<uint8_t>(const Vectorized<int32_t>& v, uint8_t* ptr) {
+  const __m256i w = _mm256_packs_epi32(v, v);
+  const __m256i b = _mm256_packus_epi16(w, w);
+  const __m128i r = _mm_unpacklo_epi32(_mm256_castsi256_si128(b), _mm256_extracti128_si256(b, 1));
+  _mm_storel_epi64(reinterpret_cast<__m128i*>(ptr), r);
+}
+
+template <>
+inline void store_from_int32<int32_t>(const Vectorized<int32_t>& v, int32_t* ptr) {
+  v.store(ptr);
+}
+
+#endif
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace c10
@@ -0,0 +1,389 @@
+#pragma once
+
+#include <c10/cpu/vec/vec_base.h>
+
+namespace c10 {
+namespace vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX2)
+
+namespace detail {
+
+// Per element type AVX2 instructions used by VectorizedInt.  Operations
+// without an AVX2 instruction (64-bit multiply / max / shifts, 8-bit
+// shifts, ...) are emulated.
+template <typename T>
+struct Avx2IntOps;
+
+template <typename T, typename Op>
+inline __m256i avx2_int_emulate(__m256i a, __m256i b, Op op) {
+  C10_VEC_ALIGN T a_arr[32 / sizeof(T)];
+  C10_VEC_ALIGN T b_arr[32 / sizeof(T)];
+  _mm256_store_si256(reinterpret_cast<__m256i*>(a_arr), a);
+  _mm256_store_si256(reinterpret_cast<__m256i*>(b_arr), b);
+  for (size_t i = 0; i < 32 / sizeof(T); i++) {
+    a_arr[i] = op(a_arr[i], b_arr[i]);
+  }
+  return _mm256_load_si256(reinterpret_cast<const __m256i*>(a_arr));
+}
+
+template <typename T>
+inline __m256i avx2_int_shift_left(__m256i a, int count) {
+  using U = typename std::make_unsigned<T>::type;
+  return avx2_int_emulate<T>(a, a, [count](T x, T) {
+    return static_cast<T>(static_cast<U>(x) << count);
+  });
+}
+
+template <typename T>
+inline __m256i avx2_int_shift_right(__m256i a, int count) {
+  return avx2_int_emulate<T>(a, a, [count](T x, T) { return static_cast<T>(x >> count); });
+}
+
+template <>
+struct Avx2IntOps<int64_t> {
+  static __m256i set1(int64_t v) { return _mm256_set1_epi64x(v); }
+  static __m256i add(__m256i a, __m256i b) { return _mm256_add_epi64(a, b); }
+  static __m256i sub(__m256i a, __m256i b) { return _mm256_sub_epi64(a, b); }
+  static __m256i mul(__m256i a, __m256i b) {
+    return avx2_int_emulate<int64_t>(a, b, [](int64_t x, int64_t y) {
+      return static_cast<int64_t>(static_cast<uint64_t>(x) * static_cast<uint64_t>(y));
+    });
+  }
+  static __m256i cmpeq(__m256i a, __m256i b) { return _mm256_cmpeq_epi64(a, b); }
+  static __m256i cmpgt(__m256i a, __m256i b) { return _mm256_cmpgt_epi64(a, b); }
+  static __m256i max(__m256i a, __m256i b) { return _mm256_blendv_epi8(b, a, cmpgt(a, b)); }
+  static __m256i min(__m256i a, __m256i b) { return _mm256_blendv_epi8(a, b, cmpgt(a, b)); }
+  static __m256i abs(__m256i a) {
+    __m256i zero = _mm256_setzero_si256();
+    return _mm256_blendv_epi8(a, _mm256_sub_epi64(zero, a), cmpgt(zero, a));
+  }
+  static __m256i shl(__m256i a, int count) { return _mm256_slli_epi64(a, count); }
+  static __m256i shr(__m256i a, int count) { return avx2_int_shift_right<int64_t>(a, count); }
+};
+
+template <>
+struct Avx2IntOps<int32_t> {
+  static __m256i set1(int32_t v) { return _mm256_set1_epi32(v); }
+  static __m256i add(__m256i a, __m256i b) { return _mm256_add_epi32(a, b); }
+  static __m256i sub(__m256i a, __m256i b) { return _mm256_sub_epi32(a, b); }
+  static __m256i mul(__m256i a, __m256i b) { return _mm256_mullo_epi32(a, b); }
+  static __m256i cmpeq(__m256i a, __m256i b) { return _mm256_cmpeq_epi32(a, b); }
+  static __m256i cmpgt(__m256i a, __m256i b) { return _mm256_cmpgt_epi32(a, b); }
+  static __m256i max(__m256i a, __m256i b) { return _mm256_max_epi32(a, b); }
+  static __m256i min(__m256i a, __m256i b) { return _mm256_min_epi32(a, b); }
+  static __m256i abs(__m256i a) { return _mm256_abs_epi32(a); }
+  static __m256i shl(__m256i a, int count) { return _mm256_slli_epi32(a, count); }
+  static __m256i shr(__m256i a, int count) { return _mm256_srai_epi32(a, count); }
+};
+
+template <>
+struct Avx2IntOps<int16_t> {
+  static __m256i set1(int16_t v) { return _mm256_set1_epi16(v); }
+  static __m256i add(__m256i a, __m256i b) { return _mm256_add_epi16(a, b); }
+  static __m256i sub(__m256i a, __m256i b) { return _mm256_sub_epi16(a, b); }
+  static __m256i mul(__m256i a, __m256i b) { return _mm256_mullo_epi16(a, b); }
+  static __m256i cmpeq(__m256i a, __m256i b) { return _mm256_cmpeq_epi16(a, b); }
+  static __m256i cmpgt(__m256i a, __m256i b) { return _mm256_cmpgt_epi16(a, b); }
+  static __m256i max(__m256i a, __m256i b) { return _mm256_max_epi16(a, b); }
+  static __m256i min(__m256i a, __m256i b) { return _mm256_min_epi16(a, b); }
+  static __m256i abs(__m256i a) { return _mm256_abs_epi16(a); }
+  static __m256i shl(__m256i a, int count) { return _mm256_slli_epi16(a, count); }
+  static __m256i shr(__m256i a, int count) { return _mm256_srai_epi16(a, count); }
+};
+
+// There is no 8-bit multiply: multiply the even and odd bytes as 16-bit
+// values and keep the low byte of each product.
+inline __m256i avx2_mul_epi8(__m256i a, __m256i b) {
+  __m256i even = _mm256_mullo_epi16(a, b);
+  __m256i odd = _mm256_mullo_epi16(_mm256_srli_epi16(a, 8), _mm256_srli_epi16(b, 8));
+  return _mm256_or_si256(
+      _mm256_and_si256(even, _mm256_set1_epi16(0x00FF)), _mm256_slli_epi16(odd, 8));
+}
+
+template <>
+struct Avx2IntOps<int8_t> {
+  static __m256i set1(int8_t v) { return _mm256_set1_epi8(v); }
+  static __m256i add(__m256i a, __m256i b) { return _mm256_add_epi8(a, b); }
+  static __m256i sub(__m256i a, __m256i b) { return _mm256_sub_epi8(a, b); }
+  static __m256i mul(__m256i a, __m256i b) { return avx2_mul_epi8(a, b); }
+  static __m256i cmpeq(__m256i a, __m256i b) { return _mm256_cmpeq_epi8(a, b); }
+  static __m256i cmpgt(__m256i a, __m256i b) { return _mm256_cmpgt_epi8(a, b); }
+  static __m256i max(__m256i a, __m256i b) { return _mm256_max_epi8(a, b); }
+  static __m256i min(__m256i a, __m256i b) { return _mm256_min_epi8(a, b); }
+  static __m256i abs(__m256i a) { return _mm256_abs_epi8(a); }
+  static __m256i shl(__m256i a, int count) { return avx2_int_shift_left<int8_t>(a, count); }
+  static __m256i shr(__m256i a, int count) { return avx2_int_shift_right<int8_t>(a, count); }
+};
+
+template <>
+struct Avx2IntOps<uint8_t> {
+  static __m256i set1(uint8_t v) { return _mm256_set1_epi8(static_cast<char>(v)); }
+  static __m256i add(__m256i a, __m256i b) { return _mm256_add_epi8(a, b); }
+  static __m256i sub(__m256i a, __m256i b) { return _mm256_sub_epi8(a, b); }
+  static __m256i mul(__m256i a, __m256i b) { return avx2_mul_epi8(a, b); }
+  static __m256i cmpeq(__m256i a, __m256i b) { return _mm256_cmpeq_epi8(a, b); }
+  // Flip the sign bits to compare unsigned bytes as signed ones.
+  static __m256i cmpgt(__m256i a, __m256i b) {
+    __m256i sign = _mm256_set1_epi8(static_cast<char>(0x80));
+    return _mm256_cmpgt_epi8(_mm256_xor_si256(a, sign), _mm256_xor_si256(b, sign));
+  }
+  static __m256i max(__m256i a, __m256i b) { return _mm256_max_epu8(a, b); }
+  static __m256i min(__m256i a, __m256i b) { return _mm256_min_epu8(a, b); }
+  static __m256i abs(__m256i a) { return a; }
+  static __m256i shl(__m256i a, int count) { return avx2_int_shift_left<uint8_t>(a, count); }
+  static __m256i shr(__m256i a, int count) { return avx2_int_shift_right<uint8_t>(a, count); }
+};
+
+} // namespace detail
+
+// Common implementation of Vectorized<int64_t>, <int32_t>, <int16_t>,
+// <int8_t> and <uint8_t>.
+template <typename T>
+class VectorizedInt {
+ protected:
+  using Ops = detail::Avx2IntOps<T>;
+  __m256i values;
+
+ public:
+  using value_type = T;
+  using size_type = int;
+  static constexpr size_type size() {
+    return 32 / sizeof(T);
+  }
+  VectorizedInt() : values(_mm256_setzero_si256()) {}
+  VectorizedInt(__m256i v) : values(v) {}
+  VectorizedInt(T v) : values(Ops::set1(v)) {}
+  template <
+      typename... Args,
+      typename = typename std::enable_if<(sizeof...(Args) == size())>::type>
+  VectorizedInt(Args... vals) {
+    C10_VEC_ALIGN T tmp[size()] = {static_cast<T>(vals)...};
+    values = _mm256_load_si256(reinterpret_cast<const __m256i*>(tmp));
+  }
+  operator __m256i() const {
+    return values;
+  }
+  template <int64_t mask>
+  static Vectorized<T> blend(const Vectorized<T>& a, const Vectorized<T>& b) {
+    C10_VEC_ALIGN T tmp[size()];
+    for (int i = 0; i < size(); i++) {
+      tmp[i] = ((mask >> i) & 1) ? static_cast<T>(-1) : 0;
+    }
+    return blendv(a, b, loadu(tmp));
+  }
+  static Vectorized<T> blendv(const Vectorized<T>& a, const Vectorized<T>& b,
+                              const Vectorized<T>& mask) {
+    return _mm256_blendv_epi8(a, b, mask);
+  }
+  template <typename step_t>
+  static Vectorized<T> arange(T base = 0, step_t step = static_cast<step_t>(1)) {
+    C10_VEC_ALIGN T tmp[size()];
+    for (int i = 0; i < size(); i++) {
+      tmp[i] = static_cast<T>(base + i * step);
+    }
+    return loadu(tmp);
+  }
+  static Vectorized<T> set(const Vectorized<T>& a, const Vectorized<T>& b,
+                           int64_t count = size()) {
+    C10_VEC_ALIGN T tmp[size()];
+    a.store(tmp);
+    b.store(tmp, count);
+    return loadu(tmp);
+  }
+  static Vectorized<T> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size()) {
+      return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+    }
+    C10_VEC_ALIGN T tmp_values[size()] = {};
+    std::memcpy(tmp_values, ptr, count * sizeof(T));
+    return _mm256_load_si256(reinterpret_cast<const __m256i*>(tmp_values));
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), values);
+    } else if (count > 0) {
+      C10_VEC_ALIGN T tmp_values[size()];
+      _mm256_store_si256(reinterpret_cast<__m256i*>(tmp_values), values);
+      std::memcpy(ptr, tmp_values, count * sizeof(T));
+    }
+  }
+  T operator[](int idx) const {
+    C10_VEC_ALIGN T tmp[size()];
+    store(tmp);
+    return tmp[idx];
+  }
+  int64_t zero_mask() const {
+    C10_VEC_ALIGN T tmp[size()];
+    store(tmp);
+    int64_t mask = 0;
+    for (int i = 0; i < size(); ++i) {
+      if (tmp[i] == 0) {
+        mask |= (int64_t(1) << i);
+      }
+    }
+    return mask;
+  }
+  Vectorized<T> isnan() const {
+    return _mm256_setzero_si256();
+  }
+  Vectorized<T> map(T (*f)(T)) const {
+    C10_VEC_ALIGN T tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); i++) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+  Vectorized<T> abs() const {
+    return Ops::abs(values);
+  }
+  Vectorized<T> neg() const {
+    return Ops::sub(_mm256_setzero_si256(), values);
+  }
+
+  Vectorized<T> operator==(const Vectorized<T>& other) const {
+    return Ops::cmpeq(values, other);
+  }
+  Vectorized<T> operator!=(const Vectorized<T>& other) const {
+    return invert(Ops::cmpeq(values, other));
+  }
+  Vectorized<T> operator<(const Vectorized<T>& other) const {
+    return Ops::cmpgt(other, values);
+  }
+  Vectorized<T> operator<=(const Vectorized<T>& other) const {
+    return invert(Ops::cmpgt(values, other));
+  }
+  Vectorized<T> operator>(const Vectorized<T>& other) const {
+    return Ops::cmpgt(values, other);
+  }
+  Vectorized<T> operator>=(const Vectorized<T>& other) const {
+    return invert(Ops::cmpgt(other, values));
+  }
+  Vectorized<T> eq(const Vectorized<T>& other) const {
+    return to_one(*this == other);
+  }
+  Vectorized<T> ne(const Vectorized<T>& other) const {
+    return to_one(*this != other);
+  }
+  Vectorized<T> gt(const Vectorized<T>& other) const {
+    return to_one(*this > other);
+  }
+  Vectorized<T> ge(const Vectorized<T>& other) const {
+    return to_one(*this >= other);
+  }
+  Vectorized<T> lt(const Vectorized<T>& other) const {
+    return to_one(*this < other);
+  }
+  Vectorized<T> le(const Vectorized<T>& other) const {
+    return to_one(*this <= other);
+  }
+
+ private:
+  static __m256i invert(__m256i v) {
+    return _mm256_xor_si256(v, _mm256_set1_epi32(-1));
+  }
+  static __m256i to_one(__m256i mask) {
+    return _mm256_and_si256(mask, Ops::set1(1));
+  }
+};
+
+template <>
+class Vectorized<int64_t> : public VectorizedInt<int64_t> {
+ public:
+  using VectorizedInt<int64_t>::VectorizedInt;
+};
+
+template <>
+class Vectorized<int32_t> : public VectorizedInt<int32_t> {
+ public:
+  using VectorizedInt<int32_t>::VectorizedInt;
+};
+
+template <>
+class Vectorized<int16_t> : public VectorizedInt<int16_t> {
+ public:
+  using VectorizedInt<int16_t>::VectorizedInt;
+};
+
+template <>
+class Vectorized<int8_t> : public VectorizedInt<int8_t> {
+ public:
+  using VectorizedInt<int8_t>::VectorizedInt;
+};
+
+template <>
+class Vectorized<uint8_t> : public VectorizedInt<uint8_t> {
+ public:
+  using VectorizedInt<uint8_t>::VectorizedInt;
+};
+
+#define C10_DEFINE_AVX2_INT_OPS(T)                                                     \
+  template <>                                                                          \
+  Vectorized<T> inline operator+(const Vectorized<T>& a, const Vectorized<T>& b) {     \
+    return detail::Avx2IntOps<T>::add(a, b);                                           \
+  }                                                                                    \
+  template <>                                                                          \
+  Vectorized<T> inline operator-(const Vectorized<T>& a, const Vectorized<T>& b) {     \
+    return detail::Avx2IntOps<T>::sub(a, b);                                           \
+  }                                                                                    \
+  template <>                                                                          \
+  Vectorized<T> inline operator*(const Vectorized<T>& a, const Vectorized<T>& b) {     \
+    return detail::Avx2IntOps<T>::mul(a, b);                                           \
+  }                                                                                    \
+  template <>                                                                          \
+  Vectorized<T> inline operator&(const Vectorized<T>& a, const Vectorized<T>& b) {     \
+    return _mm256_and_si256(a, b);                                                     \
+  }                                                                                    \
+  template <>                                                                          \
+  Vectorized<T> inline operator|(const Vectorized<T>& a, const Vectorized<T>& b) {     \
+    return _mm256_or_si256(a, b);                                                      \
+  }                                                                                    \
+  template <>                                                                          \
+  Vectorized<T> inline operator^(const Vectorized<T>& a, const Vectorized<T>& b) {     \
+    return _mm256_xor_si256(a, b);                                                     \
+  }                                                                                    \
+  template <>                                                                          \
+  Vectorized<T> inline operator<<(const Vectorized<T>& a, int count) {                 \
+    return detail::Avx2IntOps<T>::shl(a, count);                                       \
+  }                                                                                    \
+  template <>                                                                          \
+  Vectorized<T> inline operator>>(const Vectorized<T>& a, int count) {                 \
+    return detail::Avx2IntOps<T>::shr(a, count);                                       \
+  }                                                                                    \
+  template <>                                                                          \
+  Vectorized<T> inline maximum(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return detail::Avx2IntOps<T>::max(a, b);                                           \
+  }                                                                                    \
+  template <>                                                                          \
+  Vectorized<T> inline minimum(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return detail::Avx2IntOps<T>::min(a, b);                                           \
+  }                                                                                    \
+  template <>                                                                          \
+  Vectorized<T> inline clamp(const Vectorized<T>& a, const Vectorized<T>& min_vec,     \
+                             const Vectorized<T>& max_vec) {                           \
+    return detail::Avx2IntOps<T>::min(max_vec, detail::Avx2IntOps<T>::max(a, min_vec)); \
+  }                                                                                    \
+  template <>                                                                          \
+  Vectorized<T> inline clamp_max(const Vectorized<T>& a, const Vectorized<T>& max_vec) { \
+    return detail::Avx2IntOps<T>::min(max_vec, a);                                     \
+  }                                                                                    \
+  template <>                                                                          \
+  Vectorized<T> inline clamp_min(const Vectorized<T>& a, const Vectorized<T>& min_vec) { \
+    return detail::Avx2IntOps<T>::max(min_vec, a);                                     \
+  }
+
+C10_DEFINE_AVX2_INT_OPS(int64_t)
+C10_DEFINE_AVX2_INT_OPS(int32_t)
+C10_DEFINE_AVX2_INT_OPS(int16_t)
+C10_DEFINE_AVX2_INT_OPS(int8_t)
+C10_DEFINE_AVX2_INT_OPS(uint8_t)
+
+#undef C10_DEFINE_AVX2_INT_OPS
+
+#endif
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace c10
@@ -0,0 +1,10 @@
+#pragma once
+
+// AVX512 specializations of Vectorized<T>.  Only meaningful in the AVX512
+// build of a c10/cpu kernel file; in the other builds the headers are empty.
+
+#include <c10/cpu/vec/vec_base.h>
+#include <c10/cpu/vec/vec512/vec512_convert.h>
+#include <c10/cpu/vec/vec512/vec512_double.h>
+#include <c10/cpu/vec/vec512/vec512_float.h>
+#include <c10/cpu/vec/vec512/vec512_int.h>
@@ -0,0 +1,137 @@
+#pragma once
+
+// Conversions between the AVX512 Vectorized types, and the BFloat16 / Half /
+// int8 building blocks declared in vec_base.h.
+
+#include <c10/cpu/vec/vec512/vec512_double.h>
+#include <c10/cpu/vec/vec512/vec512_float.h>
+#include <c10/cpu/vec/vec512/vec512_int.h>
+
+namespace c10 {
+namespace vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+template <>
+inline Vectorized<float> cast<float, int32_t>(const Vectorized<int32_t>& src) {
+  return _mm512_castsi512_ps(src);
+}
+
+template <>
+inline Vectorized<int32_t> cast<int32_t, float>(const Vectorized<float>& src) {
+  return _mm512_castps_si512(src);
+}
+
+template <>
+inline Vectorized<double> cast<double, int64_t>(const Vectorized<int64_t>& src) {
+  return _mm512_castsi512_pd(src);
+}
+
+template <>
+inline Vectorized<int64_t> cast<int64_t, double>(const Vectorized<double>& src) {
+  return _mm512_castpd_si512(src);
+}
+
+template <>
+inline Vectorized<int32_t> convert_to_int_of_same_size<float>(const Vectorized<float>& src) {
+  return _mm512_cvttps_epi32(src);
+}
+
+template <>
+inline Vectorized<float> convert_to_fp_of_same_size<int32_t>(const Vectorized<int32_t>& src) {
+  return _mm512_cvtepi32_ps(src);
+}
+
+// Same rounding and NaN handling as float_to_bfloat16_kernel in
+// c10/cpu/ConvertKernel.cpp: the result has the BFloat16 in the high half.
+inline __m512i round_float_to_bfloat16_bits(__m512 f) {
+  const __m512i u = _mm512_castps_si512(f);
+  const __m512i lsb = _mm512_and_si512(_mm512_srli_epi32(u, 16), _mm512_set1_epi32(1));
+  const __m512i bias = _mm512_add_epi32(lsb, _mm512_set1_epi32(0x7FFF));
+  const __m512i rounded = _mm512_and_si512(
+      _mm512_add_epi32(u, bias), _mm512_set1_epi32(static_cast<int32_t>(0xFFFF0000)));
+  const __mmask16 nan = _mm512_cmp_ps_mask(f, f, _CMP_UNORD_Q);
+  return _mm512_mask_set1_epi32(rounded, nan, 0x7FC00000);
+}
+
+// vcvtps2ph keeps NaN payloads, Half(float) returns 0x7E00 with the input's
+// sign.
+inline __m256i float_to_half_bits(__m512 f) {
+  const __m256i h = _mm512_cvtps_ph(f, _MM_FROUND_TO_NEAREST_INT);
+  const __mmask16 nan = _mm512_cmp_ps_mask(f, f, _CMP_UNORD_Q);
+  const __m256i canonical = _mm256_or_si256(
+      _mm256_and_si256(h, _mm256_set1_epi16(static_cast<int16_t>(0x8000))),
+      _mm256_set1_epi16(0x7E00));
+  return _mm256_mask_blend_epi16(nan, h, canonical);
+}
+
+template <>
+inline Vectorized<float> load_to_float<BFloat16>(const BFloat16* ptr) {
+  const __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr));
+  return _mm512_castsi512_ps(_mm512_slli_epi32(_mm512_cvtepu16_epi32(b), 16));
+}
+
+template <>
+inline Vectorized<float> load_to_float<Half>(const Half* ptr) {
+  return _mm512_cvtph_ps(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(ptr)));
+}
+
+template <>
+inline void store_from_float<BFloat16>(const Vectorized<float>& v, BFloat16* ptr) {
+  const __m512i bits = _mm512_srli_epi32(round_float_to_bfloat16_bits(v), 16);
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), _mm512_cvtepi32_epi16(bits));
+}
+
+template <>
+inline void store_from_float<Half>(const Vectorized<float>& v, Half* ptr) {
+  _mm256_storeu_si256(reinterpret_cast<__m256i*>(ptr), float_to_half_bits(v));
+}
+
+template <>
+inline Vectorized<float> round_to_precision<BFloat16>(const Vectorized<float>& v) {
+  return _mm512_castsi512_ps(round_float_to_bfloat16_bits(v));
+}
+
+template <>
+inline Vectorized<float> round_to_precision<Half>(const Vectorized<float>& v) {
+  return _mm512_cvtph_ps(_mm512_cvtps_ph(v, _MM_FROUND_TO_NEAREST_INT));
+}
+
+template <>
+inline Vectorized<int32_t> load_to_int32<int8_t>(const int8_t* ptr) {
+  return _mm512_cvtepi8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)));
+}
+
+template <>
+inline Vectorized<int32_t> load_to_int32<uint8_t>(const uint8_t* ptr) {
+  return _mm512_cvtepu8_epi32(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)));
+}
+
+template <>
+inline Vectorized<int32_t> load_to_int32<int32_t>(const int32_t* ptr) {
+  return Vectorized<int32_t>::loadu(ptr);
+}
+
+// Saturating narrowing, like the packs/packus sequence of the AVX2 version.
+template <>
+inline void store_from_int32<int8_t>(const Vectorized<int32_t>& v, int8_t* ptr) {
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), _mm512_cvtsepi32_epi8(v));
+}
+
+template <>
+inline void store_from_int32<uint8_t>(const Vectorized<int32_t>& v, uint8_t* ptr) {
+  const __m512i non_negative = _mm512_max_epi32(v, _mm512_setzero_si512());
+  _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), _mm512_cvtusepi32_epi8(non_negative));
+}
+
+template <>
+inline void store_from_int32<int32_t>(const Vectorized<int32_t>& v, int32_t* ptr) {
+  v.store(ptr);
+}
+
+#endif
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace c10
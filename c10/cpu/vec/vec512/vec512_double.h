@@ -0,0 +1,280 @@
+#pragma once
+
+#include <c10/cpu/vec/vec_base.h>
+
+namespace c10 {
+namespace vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+template <>
+class Vectorized<double> {
+ private:
+  __m512d values;
+  static __mmask8 count_mask(int64_t count) {
+    return count >= size() ? static_cast<__mmask8>(0xFF)
+                           : static_cast<__mmask8>((1u << count) - 1);
+  }
+  static __m512d to_vec_mask(__mmask8 mask) {
+    return _mm512_castsi512_pd(_mm512_maskz_set1_epi64(mask, -1));
+  }
+  static __m512d ones_where(__mmask8 mask) {
+    return _mm512_maskz_mov_pd(mask, _mm512_set1_pd(1.0));
+  }
+
+ public:
+  using value_type = double;
+  using size_type = int;
+  static constexpr size_type size() {
+    return 8;
+  }
+  Vectorized() : values(_mm512_setzero_pd()) {}
+  Vectorized(__m512d v) : values(v) {}
+  Vectorized(double val) : values(_mm512_set1_pd(val)) {}
+  Vectorized(double val1, double val2, double val3, double val4,
+             double val5, double val6, double val7, double val8)
+      : values(_mm512_setr_pd(val1, val2, val3, val4, val5, val6, val7, val8)) {}
+  operator __m512d() const {
+    return values;
+  }
+  template <int64_t mask>
+  static Vectorized<double> blend(const Vectorized<double>& a, const Vectorized<double>& b) {
+    return _mm512_mask_blend_pd(static_cast<__mmask8>(mask & 0xFF), a.values, b.values);
+  }
+  static Vectorized<double> blendv(const Vectorized<double>& a, const Vectorized<double>& b,
+                                   const Vectorized<double>& mask) {
+    const __m512i m = _mm512_castpd_si512(mask.values);
+    return _mm512_mask_blend_pd(_mm512_test_epi64_mask(m, m), a.values, b.values);
+  }
+  template <typename step_t>
+  static Vectorized<double> arange(double base = 0., step_t step = static_cast<step_t>(1)) {
+    return Vectorized<double>(
+        base,            base +     step, base + 2 * step, base + 3 * step,
+        base + 4 * step, base + 5 * step, base + 6 * step, base + 7 * step);
+  }
+  static Vectorized<double> set(const Vectorized<double>& a, const Vectorized<double>& b,
+                                int64_t count = size()) {
+    return _mm512_mask_blend_pd(count_mask(count), a.values, b.values);
+  }
+  static Vectorized<double> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size()) {
+      return _mm512_loadu_pd(reinterpret_cast<const double*>(ptr));
+    }
+    return _mm512_maskz_loadu_pd(count_mask(count), ptr);
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm512_storeu_pd(reinterpret_cast<double*>(ptr), values);
+    } else if (count > 0) {
+      _mm512_mask_storeu_pd(ptr, count_mask(count), values);
+    }
+  }
+  double operator[](int idx) const {
+    C10_VEC_ALIGN double tmp[size()];
+    store(tmp);
+    return tmp[idx];
+  }
+  int64_t zero_mask() const {
+    return _mm512_cmp_pd_mask(values, _mm512_setzero_pd(), _CMP_EQ_OQ);
+  }
+  Vectorized<double> isnan() const {
+    return to_vec_mask(_mm512_cmp_pd_mask(values, values, _CMP_UNORD_Q));
+  }
+  Vectorized<double> map(double (*f)(double)) const {
+    C10_VEC_ALIGN double tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); i++) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+  Vectorized<double> abs() const {
+    return _mm512_castsi512_pd(_mm512_and_si512(
+        _mm512_castpd_si512(values), _mm512_set1_epi64(0x7FFFFFFFFFFFFFFFLL)));
+  }
+  Vectorized<double> neg() const {
+    return _mm512_castsi512_pd(_mm512_xor_si512(
+        _mm512_castpd_si512(values), _mm512_set1_epi64(static_cast<int64_t>(0x8000000000000000ULL))));
+  }
+  Vectorized<double> sqrt() const {
+    return _mm512_sqrt_pd(values);
+  }
+  Vectorized<double> rsqrt() const {
+    return _mm512_div_pd(_mm512_set1_pd(1), _mm512_sqrt_pd(values));
+  }
+  Vectorized<double> reciprocal() const {
+    return _mm512_div_pd(_mm512_set1_pd(1), values);
+  }
+  Vectorized<double> floor() const {
+    return _mm512_roundscale_pd(values, (_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+  }
+  Vectorized<double> ceil() const {
+    return _mm512_roundscale_pd(values, (_MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC));
+  }
+  Vectorized<double> round() const {
+    return _mm512_roundscale_pd(values, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+  Vectorized<double> trunc() const {
+    return _mm512_roundscale_pd(values, (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+  }
+  // No polynomial approximations for double; these go through libm.
+  Vectorized<double> exp() const {
+    return map(std::exp);
+  }
+  Vectorized<double> log() const {
+    return map(std::log);
+  }
+  Vectorized<double> tanh() const {
+    return map(std::tanh);
+  }
+  Vectorized<double> erf() const {
+    return map(std::erf);
+  }
+  Vectorized<double> sin() const {
+    return map(std::sin);
+  }
+  Vectorized<double> cos() const {
+    return map(std::cos);
+  }
+  // atan2(*this, x)
+  Vectorized<double> atan2(const Vectorized<double>& x) const {
+    C10_VEC_ALIGN double y_arr[size()];
+    C10_VEC_ALIGN double x_arr[size()];
+    store(y_arr);
+    x.store(x_arr);
+    for (int i = 0; i < size(); i++) {
+      y_arr[i] = std::atan2(y_arr[i], x_arr[i]);
+    }
+    return loadu(y_arr);
+  }
+
+  Vectorized<double> operator==(const Vectorized<double>& other) const {
+    return to_vec_mask(_mm512_cmp_pd_mask(values, other.values, _CMP_EQ_OQ));
+  }
+  Vectorized<double> operator!=(const Vectorized<double>& other) const {
+    return to_vec_mask(_mm512_cmp_pd_mask(values, other.values, _CMP_NEQ_UQ));
+  }
+  Vectorized<double> operator<(const Vectorized<double>& other) const {
+    return to_vec_mask(_mm512_cmp_pd_mask(values, other.values, _CMP_LT_OQ));
+  }
+  Vectorized<double> operator<=(const Vectorized<double>& other) const {
+    return to_vec_mask(_mm512_cmp_pd_mask(values, other.values, _CMP_LE_OQ));
+  }
+  Vectorized<double> operator>(const Vectorized<double>& other) const {
+    return to_vec_mask(_mm512_cmp_pd_mask(values, other.values, _CMP_GT_OQ));
+  }
+  Vectorized<double> operator>=(const Vectorized<double>& other) const {
+    return to_vec_mask(_mm512_cmp_pd_mask(values, other.values, _CMP_GE_OQ));
+  }
+  Vectorized<double> eq(const Vectorized<double>& other) const {
+    return ones_where(_mm512_cmp_pd_mask(values, other.values, _CMP_EQ_OQ));
+  }
+  Vectorized<double> ne(const Vectorized<double>& other) const {
+    return ones_where(_mm512_cmp_pd_mask(values, other.values, _CMP_NEQ_UQ));
+  }
+  Vectorized<double> gt(const Vectorized<double>& other) const {
+    return ones_where(_mm512_cmp_pd_mask(values, other.values, _CMP_GT_OQ));
+  }
+  Vectorized<double> ge(const Vectorized<double>& other) const {
+    return ones_where(_mm512_cmp_pd_mask(values, other.values, _CMP_GE_OQ));
+  }
+  Vectorized<double> lt(const Vectorized<double>& other) const {
+    return ones_where(_mm512_cmp_pd_mask(values, other.values, _CMP_LT_OQ));
+  }
+  Vectorized<double> le(const Vectorized<double>& other) const {
+    return ones_where(_mm512_cmp_pd_mask(values, other.values, _CMP_LE_OQ));
+  }
+};
+
+template <>
+Vectorized<double> inline operator+(const Vectorized<double>& a, const Vectorized<double>& b) {
+  return _mm512_add_pd(a, b);
+}
+
+template <>
+Vectorized<double> inline operator-(const Vectorized<double>& a, const Vectorized<double>& b) {
+  return _mm512_sub_pd(a, b);
+}
+
+template <>
+Vectorized<double> inline operator*(const Vectorized<double>& a, const Vectorized<double>& b) {
+  return _mm512_mul_pd(a, b);
+}
+
+template <>
+Vectorized<double> inline operator/(const Vectorized<double>& a, const Vectorized<double>& b) {
+  return _mm512_div_pd(a, b);
+}
+
+template <>
+Vectorized<double> inline maximum(const Vectorized<double>& a, const Vectorized<double>& b) {
+  const __m512d max = _mm512_max_pd(a, b);
+  const __mmask8 isnan = _mm512_cmp_pd_mask(a, b, _CMP_UNORD_Q);
+  return _mm512_castsi512_pd(_mm512_mask_set1_epi64(_mm512_castpd_si512(max), isnan, -1));
+}
+
+template <>
+Vectorized<double> inline minimum(const Vectorized<double>& a, const Vectorized<double>& b) {
+  const __m512d min = _mm512_min_pd(a, b);
+  const __mmask8 isnan = _mm512_cmp_pd_mask(a, b, _CMP_UNORD_Q);
+  return _mm512_castsi512_pd(_mm512_mask_set1_epi64(_mm512_castpd_si512(min), isnan, -1));
+}
+
+template <>
+Vectorized<double> inline clamp(const Vectorized<double>& a, const Vectorized<double>& min,
+                                const Vectorized<double>& max) {
+  return _mm512_min_pd(max, _mm512_max_pd(min, a));
+}
+
+template <>
+Vectorized<double> inline clamp_max(const Vectorized<double>& a, const Vectorized<double>& max) {
+  return _mm512_min_pd(max, a);
+}
+
+template <>
+Vectorized<double> inline clamp_min(const Vectorized<double>& a, const Vectorized<double>& min) {
+  return _mm512_max_pd(min, a);
+}
+
+template <>
+Vectorized<double> inline operator&(const Vectorized<double>& a, const Vectorized<double>& b) {
+  return _mm512_castsi512_pd(_mm512_and_si512(_mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+}
+
+template <>
+Vectorized<double> inline operator|(const Vectorized<double>& a, const Vectorized<double>& b) {
+  return _mm512_castsi512_pd(_mm512_or_si512(_mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+}
+
+template <>
+Vectorized<double> inline operator^(const Vectorized<double>& a, const Vectorized<double>& b) {
+  return _mm512_castsi512_pd(_mm512_xor_si512(_mm512_castpd_si512(a), _mm512_castpd_si512(b)));
+}
+
+template <>
+Vectorized<double> inline fmadd(const Vectorized<double>& a, const Vectorized<double>& b,
+                                const Vectorized<double>& c) {
+  return _mm512_fmadd_pd(a, b, c);
+}
+
+template <>
+inline Vectorized<double> swap_pairs(const Vectorized<double>& a) {
+  return _mm512_permute_pd(a, 0x55);
+}
+
+template <>
+inline Vectorized<double> dup_even(const Vectorized<double>& a) {
+  return _mm512_movedup_pd(a);
+}
+
+template <>
+inline Vectorized<double> dup_odd(const Vectorized<double>& a) {
+  return _mm512_permute_pd(a, 0xFF);
+}
+
+#endif
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace c10
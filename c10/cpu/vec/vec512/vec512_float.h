@@ -0,0 +1,278 @@
+#pragma once
+
+#include <c10/cpu/vec/vec_base.h>
+
+namespace c10 {
+namespace vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+// AVX512F has no floating point and / or / xor, they go through the integer
+// instructions.
+
+template <>
+class Vectorized<float> {
+ private:
+  __m512 values;
+  static __mmask16 count_mask(int64_t count) {
+    return count >= size() ? static_cast<__mmask16>(0xFFFF)
+                           : static_cast<__mmask16>((1u << count) - 1);
+  }
+  static __m512 to_vec_mask(__mmask16 mask) {
+    return _mm512_castsi512_ps(_mm512_maskz_set1_epi32(mask, -1));
+  }
+  static __m512 ones_where(__mmask16 mask) {
+    return _mm512_maskz_mov_ps(mask, _mm512_set1_ps(1.0f));
+  }
+
+ public:
+  using value_type = float;
+  using size_type = int;
+  static constexpr size_type size() {
+    return 16;
+  }
+  Vectorized() : values(_mm512_setzero_ps()) {}
+  Vectorized(__m512 v) : values(v) {}
+  Vectorized(float val) : values(_mm512_set1_ps(val)) {}
+  Vectorized(float val1, float val2, float val3, float val4,
+             float val5, float val6, float val7, float val8,
+             float val9, float val10, float val11, float val12,
+             float val13, float val14, float val15, float val16)
+      : values(_mm512_setr_ps(val1, val2, val3, val4, val5, val6, val7, val8,
+                              val9, val10, val11, val12, val13, val14, val15, val16)) {}
+  operator __m512() const {
+    return values;
+  }
+  template <int64_t mask>
+  static Vectorized<float> blend(const Vectorized<float>& a, const Vectorized<float>& b) {
+    return _mm512_mask_blend_ps(static_cast<__mmask16>(mask & 0xFFFF), a.values, b.values);
+  }
+  static Vectorized<float> blendv(const Vectorized<float>& a, const Vectorized<float>& b,
+                                  const Vectorized<float>& mask) {
+    const __m512i m = _mm512_castps_si512(mask.values);
+    return _mm512_mask_blend_ps(_mm512_test_epi32_mask(m, m), a.values, b.values);
+  }
+  template <typename step_t>
+  static Vectorized<float> arange(float base = 0.f, step_t step = static_cast<step_t>(1)) {
+    return Vectorized<float>(
+        base,             base +      step, base +  2 * step, base +  3 * step,
+        base +  4 * step, base +  5 * step, base +  6 * step, base +  7 * step,
+        base +  8 * step, base +  9 * step, base + 10 * step, base + 11 * step,
+        base + 12 * step, base + 13 * step, base + 14 * step, base + 15 * step);
+  }
+  static Vectorized<float> set(const Vectorized<float>& a, const Vectorized<float>& b,
+                               int64_t count = size()) {
+    return _mm512_mask_blend_ps(count_mask(count), a.values, b.values);
+  }
+  // Masked loads and stores don't touch memory past count.
+  static Vectorized<float> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size()) {
+      return _mm512_loadu_ps(reinterpret_cast<const float*>(ptr));
+    }
+    return _mm512_maskz_loadu_ps(count_mask(count), ptr);
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm512_storeu_ps(reinterpret_cast<float*>(ptr), values);
+    } else if (count > 0) {
+      _mm512_mask_storeu_ps(ptr, count_mask(count), values);
+    }
+  }
+  float operator[](int idx) const {
+    C10_VEC_ALIGN float tmp[size()];
+    store(tmp);
+    return tmp[idx];
+  }
+  int64_t zero_mask() const {
+    return _mm512_cmp_ps_mask(values, _mm512_setzero_ps(), _CMP_EQ_OQ);
+  }
+  Vectorized<float> isnan() const {
+    return to_vec_mask(_mm512_cmp_ps_mask(values, values, _CMP_UNORD_Q));
+  }
+  Vectorized<float> map(float (*f)(float)) const {
+    C10_VEC_ALIGN float tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); i++) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+  Vectorized<float> abs() const {
+    return _mm512_castsi512_ps(
+        _mm512_and_si512(_mm512_castps_si512(values), _mm512_set1_epi32(0x7FFFFFFF)));
+  }
+  Vectorized<float> neg() const {
+    return _mm512_castsi512_ps(_mm512_xor_si512(
+        _mm512_castps_si512(values), _mm512_set1_epi32(static_cast<int32_t>(0x80000000))));
+  }
+  Vectorized<float> sqrt() const {
+    return _mm512_sqrt_ps(values);
+  }
+  Vectorized<float> rsqrt() const {
+    return _mm512_div_ps(_mm512_set1_ps(1), _mm512_sqrt_ps(values));
+  }
+  Vectorized<float> reciprocal() const {
+    return _mm512_div_ps(_mm512_set1_ps(1), values);
+  }
+  Vectorized<float> floor() const {
+    return _mm512_roundscale_ps(values, (_MM_FROUND_TO_NEG_INF | _MM_FROUND_NO_EXC));
+  }
+  Vectorized<float> ceil() const {
+    return _mm512_roundscale_ps(values, (_MM_FROUND_TO_POS_INF | _MM_FROUND_NO_EXC));
+  }
+  Vectorized<float> round() const {
+    return _mm512_roundscale_ps(values, (_MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC));
+  }
+  Vectorized<float> trunc() const {
+    return _mm512_roundscale_ps(values, (_MM_FROUND_TO_ZERO | _MM_FROUND_NO_EXC));
+  }
+  // Defined in vec_math.h
+  Vectorized<float> exp() const;
+  Vectorized<float> log() const;
+  Vectorized<float> tanh() const;
+  Vectorized<float> erf() const;
+  Vectorized<float> sin() const;
+  Vectorized<float> cos() const;
+  // atan2(*this, x)
+  Vectorized<float> atan2(const Vectorized<float>& x) const;
+
+  Vectorized<float> operator==(const Vectorized<float>& other) const {
+    return to_vec_mask(_mm512_cmp_ps_mask(values, other.values, _CMP_EQ_OQ));
+  }
+  Vectorized<float> operator!=(const Vectorized<float>& other) const {
+    return to_vec_mask(_mm512_cmp_ps_mask(values, other.values, _CMP_NEQ_UQ));
+  }
+  Vectorized<float> operator<(const Vectorized<float>& other) const {
+    return to_vec_mask(_mm512_cmp_ps_mask(values, other.values, _CMP_LT_OQ));
+  }
+  Vectorized<float> operator<=(const Vectorized<float>& other) const {
+    return to_vec_mask(_mm512_cmp_ps_mask(values, other.values, _CMP_LE_OQ));
+  }
+  Vectorized<float> operator>(const Vectorized<float>& other) const {
+    return to_vec_mask(_mm512_cmp_ps_mask(values, other.values, _CMP_GT_OQ));
+  }
+  Vectorized<float> operator>=(const Vectorized<float>& other) const {
+    return to_vec_mask(_mm512_cmp_ps_mask(values, other.values, _CMP_GE_OQ));
+  }
+  Vectorized<float> eq(const Vectorized<float>& other) const {
+    return ones_where(_mm512_cmp_ps_mask(values, other.values, _CMP_EQ_OQ));
+  }
+  Vectorized<float> ne(const Vectorized<float>& other) const {
+    return ones_where(_mm512_cmp_ps_mask(values, other.values, _CMP_NEQ_UQ));
+  }
+  Vectorized<float> gt(const Vectorized<float>& other) const {
+    return ones_where(_mm512_cmp_ps_mask(values, other.values, _CMP_GT_OQ));
+  }
+  Vectorized<float> ge(const Vectorized<float>& other) const {
+    return ones_where(_mm512_cmp_ps_mask(values, other.values, _CMP_GE_OQ));
+  }
+  Vectorized<float> lt(const Vectorized<float>& other) const {
+    return ones_where(_mm512_cmp_ps_mask(values, other.values, _CMP_LT_OQ));
+  }
+  Vectorized<float> le(const Vectorized<float>& other) const {
+    return ones_where(_mm512_cmp_ps_mask(values, other.values, _CMP_LE_OQ));
+  }
+};
+
+template <>
+Vectorized<float> inline operator+(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return _mm512_add_ps(a, b);
+}
+
+template <>
+Vectorized<float> inline operator-(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return _mm512_sub_ps(a, b);
+}
+
+template <>
+Vectorized<float> inline operator*(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return _mm512_mul_ps(a, b);
+}
+
+template <>
+Vectorized<float> inline operator/(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return _mm512_div_ps(a, b);
+}
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vectorized<float> inline maximum(const Vectorized<float>& a, const Vectorized<float>& b) {
+  const __m512 max = _mm512_max_ps(a, b);
+  const __mmask16 isnan = _mm512_cmp_ps_mask(a, b, _CMP_UNORD_Q);
+  // all-ones is a NaN
+  return _mm512_castsi512_ps(_mm512_mask_set1_epi32(_mm512_castps_si512(max), isnan, -1));
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN.
+template <>
+Vectorized<float> inline minimum(const Vectorized<float>& a, const Vectorized<float>& b) {
+  const __m512 min = _mm512_min_ps(a, b);
+  const __mmask16 isnan = _mm512_cmp_ps_mask(a, b, _CMP_UNORD_Q);
+  return _mm512_castsi512_ps(_mm512_mask_set1_epi32(_mm512_castps_si512(min), isnan, -1));
+}
+
+template <>
+Vectorized<float> inline clamp(const Vectorized<float>& a, const Vectorized<float>& min,
+                               const Vectorized<float>& max) {
+  return _mm512_min_ps(max, _mm512_max_ps(min, a));
+}
+
+template <>
+Vectorized<float> inline clamp_max(const Vectorized<float>& a, const Vectorized<float>& max) {
+  return _mm512_min_ps(max, a);
+}
+
+template <>
+Vectorized<float> inline clamp_min(const Vectorized<float>& a, const Vectorized<float>& min) {
+  return _mm512_max_ps(min, a);
+}
+
+template <>
+Vectorized<float> inline operator&(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return _mm512_castsi512_ps(_mm512_and_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+}
+
+template <>
+Vectorized<float> inline operator|(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return _mm512_castsi512_ps(_mm512_or_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+}
+
+template <>
+Vectorized<float> inline operator^(const Vectorized<float>& a, const Vectorized<float>& b) {
+  return _mm512_castsi512_ps(_mm512_xor_si512(_mm512_castps_si512(a), _mm512_castps_si512(b)));
+}
+
+template <>
+Vectorized<float> inline fmadd(const Vectorized<float>& a, const Vectorized<float>& b,
+                               const Vectorized<float>& c) {
+  return _mm512_fmadd_ps(a, b, c);
+}
+
+template <>
+inline Vectorized<float> swap_pairs(const Vectorized<float>& a) {
+  return _mm512_permute_ps(a, 0xB1); // 2 3 0 1 in each 128-bit lane
+}
+
+template <>
+inline Vectorized<float> dup_even(const Vectorized<float>& a) {
+  return _mm512_moveldup_ps(a);
+}
+
+template <>
+inline Vectorized<float> dup_odd(const Vectorized<float>& a) {
+  return _mm512_movehdup_ps(a);
+}
+
+template <>
+inline float vec_reduce_add(const Vectorized<float>& v) {
+  return _mm512_reduce_add_ps(v);
+}
+
+#endif
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace c10
@@ -0,0 +1,374 @@
+#pragma once
+
+#include <c10/cpu/vec/vec_base.h>
+
+namespace c10 {
+namespace vec {
+inline namespace CPU_CAPABILITY {
+
+#if defined(CPU_CAPABILITY_AVX512)
+
+namespace detail {
+
+// Per element type AVX512 instructions used by VectorizedInt.  Comparisons
+// give k-masks; mask_to_vec turns them into vector masks.  Operations
+// without an instruction in AVX512F/BW (8-bit multiply and shifts) are
+// emulated.
+template <typename T>
+struct Avx512IntOps;
+
+template <typename T, typename Op>
+inline __m512i avx512_int_emulate(__m512i a, Op op) {
+  C10_VEC_ALIGN T a_arr[64 / sizeof(T)];
+  _mm512_store_si512(a_arr, a);
+  for (size_t i = 0; i < 64 / sizeof(T); i++) {
+    a_arr[i] = op(a_arr[i]);
+  }
+  return _mm512_load_si512(a_arr);
+}
+
+template <>
+struct Avx512IntOps<int64_t> {
+  using mask_t = __mmask8;
+  static __m512i set1(int64_t v) { return _mm512_set1_epi64(v); }
+  static __m512i add(__m512i a, __m512i b) { return _mm512_add_epi64(a, b); }
+  static __m512i sub(__m512i a, __m512i b) { return _mm512_sub_epi64(a, b); }
+  // vpmullq needs AVX512DQ: lo(a) * lo(b) + (hi(a) * lo(b) + lo(a) * hi(b)) << 32
+  static __m512i mul(__m512i a, __m512i b) {
+    const __m512i lo = _mm512_mul_epu32(a, b);
+    const __m512i cross = _mm512_add_epi64(
+        _mm512_mul_epu32(_mm512_srli_epi64(a, 32), b), _mm512_mul_epu32(a, _mm512_srli_epi64(b, 32)));
+    return _mm512_add_epi64(lo, _mm512_slli_epi64(cross, 32));
+  }
+  static mask_t cmpeq(__m512i a, __m512i b) { return _mm512_cmpeq_epi64_mask(a, b); }
+  static mask_t cmpgt(__m512i a, __m512i b) { return _mm512_cmpgt_epi64_mask(a, b); }
+  static mask_t test(__m512i a) { return _mm512_test_epi64_mask(a, a); }
+  static __m512i mask_to_vec(mask_t m) { return _mm512_maskz_set1_epi64(m, -1); }
+  static __m512i mask_blend(mask_t m, __m512i a, __m512i b) { return _mm512_mask_blend_epi64(m, a, b); }
+  static __m512i max(__m512i a, __m512i b) { return _mm512_max_epi64(a, b); }
+  static __m512i min(__m512i a, __m512i b) { return _mm512_min_epi64(a, b); }
+  static __m512i abs(__m512i a) { return _mm512_abs_epi64(a); }
+  static __m512i shl(__m512i a, int count) { return _mm512_sll_epi64(a, _mm_cvtsi32_si128(count)); }
+  static __m512i shr(__m512i a, int count) { return _mm512_sra_epi64(a, _mm_cvtsi32_si128(count)); }
+};
+
+template <>
+struct Avx512IntOps<int32_t> {
+  using mask_t = __mmask16;
+  static __m512i set1(int32_t v) { return _mm512_set1_epi32(v); }
+  static __m512i add(__m512i a, __m512i b) { return _mm512_add_epi32(a, b); }
+  static __m512i sub(__m512i a, __m512i b) { return _mm512_sub_epi32(a, b); }
+  static __m512i mul(__m512i a, __m512i b) { return _mm512_mullo_epi32(a, b); }
+  static mask_t cmpeq(__m512i a, __m512i b) { return _mm512_cmpeq_epi32_mask(a, b); }
+  static mask_t cmpgt(__m512i a, __m512i b) { return _mm512_cmpgt_epi32_mask(a, b); }
+  static mask_t test(__m512i a) { return _mm512_test_epi32_mask(a, a); }
+  static __m512i mask_to_vec(mask_t m) { return _mm512_maskz_set1_epi32(m, -1); }
+  static __m512i mask_blend(mask_t m, __m512i a, __m512i b) { return _mm512_mask_blend_epi32(m, a, b); }
+  static __m512i max(__m512i a, __m512i b) { return _mm512_max_epi32(a, b); }
+  static __m512i min(__m512i a, __m512i b) { return _mm512_min_epi32(a, b); }
+  static __m512i abs(__m512i a) { return _mm512_abs_epi32(a); }
+  static __m512i shl(__m512i a, int count) { return _mm512_sll_epi32(a, _mm_cvtsi32_si128(count)); }
+  static __m512i shr(__m512i a, int count) { return _mm512_sra_epi32(a, _mm_cvtsi32_si128(count)); }
+};
+
+template <>
+struct Avx512IntOps<int16_t> {
+  using mask_t = __mmask32;
+  static __m512i set1(int16_t v) { return _mm512_set1_epi16(v); }
+  static __m512i add(__m512i a, __m512i b) { return _mm512_add_epi16(a, b); }
+  static __m512i sub(__m512i a, __m512i b) { return _mm512_sub_epi16(a, b); }
+  static __m512i mul(__m512i a, __m512i b) { return _mm512_mullo_epi16(a, b); }
+  static mask_t cmpeq(__m512i a, __m512i b) { return _mm512_cmpeq_epi16_mask(a, b); }
+  static mask_t cmpgt(__m512i a, __m512i b) { return _mm512_cmpgt_epi16_mask(a, b); }
+  static mask_t test(__m512i a) { return _mm512_test_epi16_mask(a, a); }
+  static __m512i mask_to_vec(mask_t m) { return _mm512_movm_epi16(m); }
+  static __m512i mask_blend(mask_t m, __m512i a, __m512i b) { return _mm512_mask_blend_epi16(m, a, b); }
+  static __m512i max(__m512i a, __m512i b) { return _mm512_max_epi16(a, b); }
+  static __m512i min(__m512i a, __m512i b) { return _mm512_min_epi16(a, b); }
+  static __m512i abs(__m512i a) { return _mm512_abs_epi16(a); }
+  static __m512i shl(__m512i a, int count) { return _mm512_sll_epi16(a, _mm_cvtsi32_si128(count)); }
+  static __m512i shr(__m512i a, int count) { return _mm512_sra_epi16(a, _mm_cvtsi32_si128(count)); }
+};
+
+// There is no 8-bit multiply: multiply the even and odd bytes as 16-bit
+// values and keep the low byte of each product.
+inline __m512i avx512_mul_epi8(__m512i a, __m512i b) {
+  const __m512i even = _mm512_mullo_epi16(a, b);
+  const __m512i odd = _mm512_mullo_epi16(_mm512_srli_epi16(a, 8), _mm512_srli_epi16(b, 8));
+  return _mm512_mask_blend_epi8(
+      static_cast<__mmask64>(0xAAAAAAAAAAAAAAAAULL), even, _mm512_slli_epi16(odd, 8));
+}
+
+template <typename T>
+struct Avx512Int8Ops {
+  using mask_t = __mmask64;
+  using U = typename std::make_unsigned<T>::type;
+  static __m512i set1(T v) { return _mm512_set1_epi8(static_cast<char>(v)); }
+  static __m512i add(__m512i a, __m512i b) { return _mm512_add_epi8(a, b); }
+  static __m512i sub(__m512i a, __m512i b) { return _mm512_sub_epi8(a, b); }
+  static __m512i mul(__m512i a, __m512i b) { return avx512_mul_epi8(a, b); }
+  static mask_t cmpeq(__m512i a, __m512i b) { return _mm512_cmpeq_epi8_mask(a, b); }
+  static mask_t test(__m512i a) { return _mm512_test_epi8_mask(a, a); }
+  static __m512i mask_to_vec(mask_t m) { return _mm512_movm_epi8(m); }
+  static __m512i mask_blend(mask_t m, __m512i a, __m512i b) { return _mm512_mask_blend_epi8(m, a, b); }
+  static __m512i shl(__m512i a, int count) {
+    return avx512_int_emulate<T>(a, [count](T x) { return static_cast<T>(static_cast<U>(x) << count); });
+  }
+  static __m512i shr(__m512i a, int count) {
+    return avx512_int_emulate<T>(a, [count](T x) { return static_cast<T>(x >> count); });
+  }
+};
+
+template <>
+struct Avx512IntOps<int8_t> : Avx512Int8Ops<int8_t> {
+  static mask_t cmpgt(__m512i a, __m512i b) { return _mm512_cmpgt_epi8_mask(a, b); }
+  static __m512i max(__m512i a, __m512i b) { return _mm512_max_epi8(a, b); }
+  static __m512i min(__m512i a, __m512i b) { return _mm512_min_epi8(a, b); }
+  static __m512i abs(__m512i a) { return _mm512_abs_epi8(a); }
+};
+
+template <>
+struct Avx512IntOps<uint8_t> : Avx512Int8Ops<uint8_t> {
+  static mask_t cmpgt(__m512i a, __m512i b) { return _mm512_cmpgt_epu8_mask(a, b); }
+  static __m512i max(__m512i a, __m512i b) { return _mm512_max_epu8(a, b); }
+  static __m512i min(__m512i a, __m512i b) { return _mm512_min_epu8(a, b); }
+  static __m512i abs(__m512i a) { return a; }
+};
+
+} // namespace detail
+
+// Common implementation of Vectorized<int64_t>, <int32_t>, <int16_t>,
+// <int8_t> and <uint8_t>.
+template <typename T>
+class VectorizedInt {
+ protected:
+  using Ops = detail::Avx512IntOps<T>;
+  using mask_t = typename Ops::mask_t;
+  __m512i values;
+
+  // The first count * sizeof(T) bytes
+  static __mmask64 count_mask(int64_t count) {
+    const int64_t bytes = count * static_cast<int64_t>(sizeof(T));
+    return bytes >= 64 ? ~static_cast<__mmask64>(0) : (static_cast<__mmask64>(1) << bytes) - 1;
+  }
+
+ public:
+  using value_type = T;
+  using size_type = int;
+  static constexpr size_type size() {
+    return 64 / sizeof(T);
+  }
+  VectorizedInt() : values(_mm512_setzero_si512()) {}
+  VectorizedInt(__m512i v) : values(v) {}
+  VectorizedInt(T v) : values(Ops::set1(v)) {}
+  template <
+      typename... Args,
+      typename = typename std::enable_if<(sizeof...(Args) == size())>::type>
+  VectorizedInt(Args... vals) {
+    C10_VEC_ALIGN T tmp[size()] = {static_cast<T>(vals)...};
+    values = _mm512_load_si512(tmp);
+  }
+  operator __m512i() const {
+    return values;
+  }
+  template <int64_t mask>
+  static Vectorized<T> blend(const Vectorized<T>& a, const Vectorized<T>& b) {
+    return Ops::mask_blend(static_cast<mask_t>(mask), a, b);
+  }
+  static Vectorized<T> blendv(const Vectorized<T>& a, const Vectorized<T>& b,
+                              const Vectorized<T>& mask) {
+    return Ops::mask_blend(Ops::test(mask), a, b);
+  }
+  template <typename step_t>
+  static Vectorized<T> arange(T base = 0, step_t step = static_cast<step_t>(1)) {
+    C10_VEC_ALIGN T tmp[size()];
+    for (int i = 0; i < size(); i++) {
+      tmp[i] = static_cast<T>(base + i * step);
+    }
+    return loadu(tmp);
+  }
+  static Vectorized<T> set(const Vectorized<T>& a, const Vectorized<T>& b,
+                           int64_t count = size()) {
+    return _mm512_mask_blend_epi8(count_mask(count), a.values, b.values);
+  }
+  // Masked loads and stores don't touch memory past count.
+  static Vectorized<T> loadu(const void* ptr, int64_t count = size()) {
+    if (count == size()) {
+      return _mm512_loadu_si512(ptr);
+    }
+    return _mm512_maskz_loadu_epi8(count_mask(count), ptr);
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    if (count == size()) {
+      _mm512_storeu_si512(ptr, values);
+    } else if (count > 0) {
+      _mm512_mask_storeu_epi8(ptr, count_mask(count), values);
+    }
+  }
+  T operator[](int idx) const {
+    C10_VEC_ALIGN T tmp[size()];
+    store(tmp);
+    return tmp[idx];
+  }
+  int64_t zero_mask() const {
+    return static_cast<int64_t>(Ops::cmpeq(values, _mm512_setzero_si512()));
+  }
+  Vectorized<T> isnan() const {
+    return _mm512_setzero_si512();
+  }
+  Vectorized<T> map(T (*f)(T)) const {
+    C10_VEC_ALIGN T tmp[size()];
+    store(tmp);
+    for (int64_t i = 0; i < size(); i++) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+  Vectorized<T> abs() const {
+    return Ops::abs(values);
+  }
+  Vectorized<T> neg() const {
+    return Ops::sub(_mm512_setzero_si512(), values);
+  }
+
+  Vectorized<T> operator==(const Vectorized<T>& other) const {
+    return Ops::mask_to_vec(Ops::cmpeq(values, other));
+  }
+  Vectorized<T> operator!=(const Vectorized<T>& other) const {
+    return Ops::mask_to_vec(static_cast<mask_t>(~Ops::cmpeq(values, other)));
+  }
+  Vectorized<T> operator<(const Vectorized<T>& other) const {
+    return Ops::mask_to_vec(Ops::cmpgt(other, values));
+  }
+  Vectorized<T> operator<=(const Vectorized<T>& other) const {
+    return Ops::mask_to_vec(static_cast<mask_t>(~Ops::cmpgt(values, other)));
+  }
+  Vectorized<T> operator>(const Vectorized<T>& other) const {
+    return Ops::mask_to_vec(Ops::cmpgt(values, other));
+  }
+  Vectorized<T> operator>=(const Vectorized<T>& other) const {
+    return Ops::mask_to_vec(static_cast<mask_t>(~Ops::cmpgt(other, values)));
+  }
+  Vectorized<T> eq(const Vectorized<T>& other) const {
+    return to_one(*this == other);
+  }
+  Vectorized<T> ne(const Vectorized<T>& other) const {
+    return to_one(*this != other);
+  }
+  Vectorized<T> gt(const Vectorized<T>& other) const {
+    return to_one(*this > other);
+  }
+  Vectorized<T> ge(const Vectorized<T>& other) const {
+    return to_one(*this >= other);
+  }
+  Vectorized<T> lt(const Vectorized<T>& other) const {
+    return to_one(*this < other);
+  }
+  Vectorized<T> le(const Vectorized<T>& other) const {
+    return to_one(*this <= other);
+  }
+
+ private:
+  static __m512i to_one(__m512i mask) {
+    return _mm512_and_si512(mask, Ops::set1(1));
+  }
+};
+
+template <>
+class Vectorized<int64_t> : public VectorizedInt<int64_t> {
+ public:
+  using VectorizedInt<int64_t>::VectorizedInt;
+};
+
+template <>
+class Vectorized<int32_t> : public VectorizedInt<int32_t> {
+ public:
+  using VectorizedInt<int32_t>::VectorizedInt;
+};
+
+template <>
+class Vectorized<int16_t> : public VectorizedInt<int16_t> {
+ public:
+  using VectorizedInt<int16_t>::VectorizedInt;
+};
+
+template <>
+class Vectorized<int8_t> : public VectorizedInt<int8_t> {
+ public:
+  using VectorizedInt<int8_t>::VectorizedInt;
+};
+
+template <>
+class Vectorized<uint8_t> : public VectorizedInt<uint8_t> {
+ public:
+  using VectorizedInt<uint8_t>::VectorizedInt;
+};
+
+#define C10_DEFINE_AVX512_INT_OPS(T)                                                     \
+  template <>                                                                            \
+  Vectorized<T> inline operator+(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return detail::Avx512IntOps<T>::add(a, b);                                           \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline operator-(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return detail::Avx512IntOps<T>::sub(a, b);                                           \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline operator*(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return detail::Avx512IntOps<T>::mul(a, b);                                           \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline operator&(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return _mm512_and_si512(a, b);                                                       \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline operator|(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return _mm512_or_si512(a, b);                                                        \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline operator^(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return _mm512_xor_si512(a, b);                                                       \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline operator<<(const Vectorized<T>& a, int count) {                   \
+    return detail::Avx512IntOps<T>::shl(a, count);                                       \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline operator>>(const Vectorized<T>& a, int count) {                   \
+    return detail::Avx512IntOps<T>::shr(a, count);                                       \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline maximum(const Vectorized<T>& a, const Vectorized<T>& b) {         \
+    return detail::Avx512IntOps<T>::max(a, b);                                           \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline minimum(const Vectorized<T>& a, const Vectorized<T>& b) {         \
+    return detail::Avx512IntOps<T>::min(a, b);                                           \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline clamp(const Vectorized<T>& a, const Vectorized<T>& min_vec,       \
+                             const Vectorized<T>& max_vec) {                             \
+    return detail::Avx512IntOps<T>::min(max_vec, detail::Avx512IntOps<T>::max(a, min_vec)); \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline clamp_max(const Vectorized<T>& a, const Vectorized<T>& max_vec) { \
+    return detail::Avx512IntOps<T>::min(max_vec, a);                                     \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline clamp_min(const Vectorized<T>& a, const Vectorized<T>& min_vec) { \
+    return detail::Avx512IntOps<T>::max(min_vec, a);                                     \
+  }
+
+C10_DEFINE_AVX512_INT_OPS(int64_t)
+C10_DEFINE_AVX512_INT_OPS(int32_t)
+C10_DEFINE_AVX512_INT_OPS(int16_t)
+C10_DEFINE_AVX512_INT_OPS(int8_t)
+C10_DEFINE_AVX512_INT_OPS(uint8_t)
+
+#undef C10_DEFINE_AVX512_INT_OPS
+
+#endif
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace c10
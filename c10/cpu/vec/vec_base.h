@@ -0,0 +1,586 @@
+#pragma once
+
+// Generic Vectorized<T>: the DEFAULT implementation, with scalar loops over a
+// C10_VECTOR_WIDTH byte array.  The AVX2 and AVX512 builds of c10/cpu
+// specialize it for float, double and the integer types (see vec256/ and
+// vec512/); BFloat16, Half, complex and the quantized types are built on top
+// of those in vec_reduced_float.h, vec_complex.h and vec_qint.h.
+//
+// Everything lives in an inline namespace named after CPU_CAPABILITY, so the
+// differently compiled copies of a kernel file don't share definitions.
+//
+// NOTE: comparison operators (==, <, ...) return masks, i.e. elements with
+// all bits set or zero, meant for blendv.  eq(), lt(), ... return 1 or 0.
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <type_traits>
+
+#include <c10/macros/Macros.h>
+#include <c10/util/BFloat16.h>
+#include <c10/util/Half.h>
+#include <c10/util/complex_type.h>
+#include <c10/util/qint32.h>
+#include <c10/util/qint8.h>
+#include <c10/util/quint8.h>
+
+#if !defined(CPU_CAPABILITY)
+// Included outside of c10/cpu
+#define CPU_CAPABILITY DEFAULT
+#define CPU_CAPABILITY_DEFAULT
+#endif
+
+#if defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX512)
+#include <immintrin.h>
+#endif
+
+#if defined(CPU_CAPABILITY_AVX512)
+#define C10_VECTOR_WIDTH 64
+#else
+#define C10_VECTOR_WIDTH 32
+#endif
+
+#define C10_VEC_ALIGN alignas(C10_VECTOR_WIDTH)
+
+namespace c10 {
+namespace vec {
+inline namespace CPU_CAPABILITY {
+
+template <typename T>
+struct is_reduced_floating_point
+    : std::integral_constant<
+          bool,
+          std::is_same<T, BFloat16>::value || std::is_same<T, Half>::value> {};
+
+namespace detail {
+
+template <typename T>
+bool all_bits_zero(const T& v) {
+  unsigned char bytes[sizeof(T)];
+  std::memcpy(bytes, &v, sizeof(T));
+  for (size_t i = 0; i < sizeof(T); ++i) {
+    if (bytes[i] != 0) {
+      return false;
+    }
+  }
+  return true;
+}
+
+template <typename T>
+T all_bits_set() {
+  T v;
+  std::memset(&v, 0xFF, sizeof(T));
+  return v;
+}
+
+template <typename T>
+T mask_for(bool b) {
+  if (b) {
+    return all_bits_set<T>();
+  }
+  T v;
+  std::memset(&v, 0, sizeof(T));
+  return v;
+}
+
+template <typename T>
+typename std::enable_if<std::is_floating_point<T>::value, bool>::type
+isnan_scalar(T v) {
+  return std::isnan(v);
+}
+
+template <typename T>
+typename std::enable_if<!std::is_floating_point<T>::value, bool>::type
+isnan_scalar(T) {
+  return false;
+}
+
+} // namespace detail
+
+template <class T>
+struct Vectorized {
+ private:
+  C10_VEC_ALIGN T values[C10_VECTOR_WIDTH / sizeof(T)];
+
+ public:
+  using value_type = T;
+  using size_type = int;
+
+  static constexpr size_type size() {
+    return C10_VECTOR_WIDTH / sizeof(T);
+  }
+  Vectorized() : values{static_cast<T>(0)} {}
+  Vectorized(T val) {
+    for (int i = 0; i != size(); i++) {
+      values[i] = val;
+    }
+  }
+  template <
+      typename... Args,
+      typename = typename std::enable_if<(sizeof...(Args) == size())>::type>
+  Vectorized(Args... vals) : values{static_cast<T>(vals)...} {}
+
+  // Element i comes from b if bit i of mask is set, from a otherwise.
+  template <int64_t mask_>
+  static Vectorized<T> blend(const Vectorized<T>& a, const Vectorized<T>& b) {
+    int64_t mask = mask_;
+    Vectorized vec;
+    for (int64_t i = 0; i < size(); i++) {
+      vec.values[i] = (mask & 0x01) ? b.values[i] : a.values[i];
+      mask = mask >> 1;
+    }
+    return vec;
+  }
+  // Element i comes from b if element i of mask is nonzero.
+  static Vectorized<T> blendv(
+      const Vectorized<T>& a,
+      const Vectorized<T>& b,
+      const Vectorized<T>& mask) {
+    Vectorized vec;
+    for (int64_t i = 0; i < size(); i++) {
+      vec.values[i] =
+          detail::all_bits_zero(mask.values[i]) ? a.values[i] : b.values[i];
+    }
+    return vec;
+  }
+  template <typename step_t> // step sometimes requires a higher precision type
+  static Vectorized<T> arange(T base = static_cast<T>(0), step_t step = static_cast<step_t>(1)) {
+    Vectorized vec;
+    for (int64_t i = 0; i < size(); i++) {
+      vec.values[i] = base + i * step;
+    }
+    return vec;
+  }
+  // The first count elements come from b, the rest from a.
+  static Vectorized<T> set(
+      const Vectorized<T>& a,
+      const Vectorized<T>& b,
+      int64_t count = size()) {
+    Vectorized vec;
+    for (int64_t i = 0; i < size(); i++) {
+      vec.values[i] = i < count ? b.values[i] : a.values[i];
+    }
+    return vec;
+  }
+  // Loads count elements, the rest are zero.
+  static Vectorized<T> loadu(const void* ptr, int64_t count = size()) {
+    Vectorized vec;
+    std::memcpy(vec.values, ptr, count * sizeof(T));
+    return vec;
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    std::memcpy(ptr, values, count * sizeof(T));
+  }
+  const T& operator[](int idx) const {
+    return values[idx];
+  }
+  T& operator[](int idx) {
+    return values[idx];
+  }
+  // Bit i is set if element i is zero.
+  int64_t zero_mask() const {
+    int64_t mask = 0;
+    for (int i = 0; i < size(); ++i) {
+      if (values[i] == static_cast<T>(0)) {
+        mask |= (int64_t(1) << i);
+      }
+    }
+    return mask;
+  }
+  Vectorized<T> isnan() const {
+    Vectorized vec;
+    for (int64_t i = 0; i != size(); i++) {
+      vec.values[i] = detail::mask_for<T>(detail::isnan_scalar(values[i]));
+    }
+    return vec;
+  }
+  Vectorized<T> map(T (*f)(T)) const {
+    Vectorized<T> ret;
+    for (int64_t i = 0; i != size(); i++) {
+      ret.values[i] = f(values[i]);
+    }
+    return ret;
+  }
+  Vectorized<T> map(T (*f)(const T&)) const {
+    Vectorized<T> ret;
+    for (int64_t i = 0; i != size(); i++) {
+      ret.values[i] = f(values[i]);
+    }
+    return ret;
+  }
+  Vectorized<T> abs() const {
+    return map([](T x) -> T { return x < static_cast<T>(0) ? -x : x; });
+  }
+  Vectorized<T> neg() const {
+    return map([](T x) -> T { return -x; });
+  }
+  Vectorized<T> sqrt() const {
+    return map([](T x) -> T { return std::sqrt(x); });
+  }
+  Vectorized<T> rsqrt() const {
+    return map([](T x) -> T { return 1 / std::sqrt(x); });
+  }
+  Vectorized<T> reciprocal() const {
+    return map([](T x) -> T { return 1 / x; });
+  }
+  Vectorized<T> floor() const {
+    return map([](T x) -> T { return std::floor(x); });
+  }
+  Vectorized<T> ceil() const {
+    return map([](T x) -> T { return std::ceil(x); });
+  }
+  // Rounds half to even, like the AVX rounding mode.
+  Vectorized<T> round() const {
+    return map([](T x) -> T { return std::nearbyint(x); });
+  }
+  Vectorized<T> trunc() const {
+    return map([](T x) -> T { return std::trunc(x); });
+  }
+  Vectorized<T> exp() const {
+    return map([](T x) -> T { return std::exp(x); });
+  }
+  Vectorized<T> log() const {
+    return map([](T x) -> T { return std::log(x); });
+  }
+  Vectorized<T> tanh() const {
+    return map([](T x) -> T { return std::tanh(x); });
+  }
+  Vectorized<T> erf() const {
+    return map([](T x) -> T { return std::erf(x); });
+  }
+  Vectorized<T> sin() const {
+    return map([](T x) -> T { return std::sin(x); });
+  }
+  Vectorized<T> cos() const {
+    return map([](T x) -> T { return std::cos(x); });
+  }
+  // atan2(*this, x)
+  Vectorized<T> atan2(const Vectorized<T>& x) const {
+    Vectorized<T> ret;
+    for (int64_t i = 0; i != size(); i++) {
+      ret.values[i] = std::atan2(values[i], x.values[i]);
+    }
+    return ret;
+  }
+
+ private:
+  template <typename Op>
+  inline Vectorized<T> binary_pred(const Vectorized<T>& other, Op op) const {
+    Vectorized<T> vec;
+    for (int64_t i = 0; i != size(); i++) {
+      vec.values[i] = detail::mask_for<T>(op(values[i], other.values[i]));
+    }
+    return vec;
+  }
+  template <typename Op>
+  inline Vectorized<T> binary_pred_bool(const Vectorized<T>& other, Op op) const {
+    Vectorized<T> vec;
+    for (int64_t i = 0; i != size(); i++) {
+      vec.values[i] = static_cast<T>(op(values[i], other.values[i]));
+    }
+    return vec;
+  }
+
+ public:
+  Vectorized<T> operator==(const Vectorized<T>& other) const {
+    return binary_pred(other, std::equal_to<T>());
+  }
+  Vectorized<T> operator!=(const Vectorized<T>& other) const {
+    return binary_pred(other, std::not_equal_to<T>());
+  }
+  Vectorized<T> operator>=(const Vectorized<T>& other) const {
+    return binary_pred(other, std::greater_equal<T>());
+  }
+  Vectorized<T> operator<=(const Vectorized<T>& other) const {
+    return binary_pred(other, std::less_equal<T>());
+  }
+  Vectorized<T> operator>(const Vectorized<T>& other) const {
+    return binary_pred(other, std::greater<T>());
+  }
+  Vectorized<T> operator<(const Vectorized<T>& other) const {
+    return binary_pred(other, std::less<T>());
+  }
+  Vectorized<T> eq(const Vectorized<T>& other) const {
+    return binary_pred_bool(other, std::equal_to<T>());
+  }
+  Vectorized<T> ne(const Vectorized<T>& other) const {
+    return binary_pred_bool(other, std::not_equal_to<T>());
+  }
+  Vectorized<T> gt(const Vectorized<T>& other) const {
+    return binary_pred_bool(other, std::greater<T>());
+  }
+  Vectorized<T> ge(const Vectorized<T>& other) const {
+    return binary_pred_bool(other, std::greater_equal<T>());
+  }
+  Vectorized<T> lt(const Vectorized<T>& other) const {
+    return binary_pred_bool(other, std::less<T>());
+  }
+  Vectorized<T> le(const Vectorized<T>& other) const {
+    return binary_pred_bool(other, std::less_equal<T>());
+  }
+};
+
+// The generic free functions below go through aligned buffers rather than
+// operator[], so they also work for the specializations in vec256/ and
+// vec512/ that a backend doesn't cover.
+
+template <class T, typename Op>
+Vectorized<T> inline binary_op(const Vectorized<T>& a, const Vectorized<T>& b, Op op) {
+  C10_VEC_ALIGN T a_arr[Vectorized<T>::size()];
+  C10_VEC_ALIGN T b_arr[Vectorized<T>::size()];
+  a.store(a_arr);
+  b.store(b_arr);
+  for (int i = 0; i != Vectorized<T>::size(); i++) {
+    a_arr[i] = op(a_arr[i], b_arr[i]);
+  }
+  return Vectorized<T>::loadu(a_arr);
+}
+
+template <class T>
+Vectorized<T> inline operator+(const Vectorized<T>& a, const Vectorized<T>& b) {
+  return binary_op(a, b, std::plus<T>());
+}
+
+template <class T>
+Vectorized<T> inline operator-(const Vectorized<T>& a, const Vectorized<T>& b) {
+  return binary_op(a, b, std::minus<T>());
+}
+
+template <class T>
+Vectorized<T> inline operator*(const Vectorized<T>& a, const Vectorized<T>& b) {
+  return binary_op(a, b, std::multiplies<T>());
+}
+
+template <class T>
+Vectorized<T> inline operator/(const Vectorized<T>& a, const Vectorized<T>& b) {
+  return binary_op(a, b, std::divides<T>());
+}
+
+// Bitwise operators work on the bits of the elements, for any T.
+template <class T, typename Op>
+Vectorized<T> inline bitwise_binary_op(const Vectorized<T>& a, const Vectorized<T>& b, Op op) {
+  static constexpr uint32_t element_no = C10_VECTOR_WIDTH / sizeof(intmax_t);
+  C10_VEC_ALIGN intmax_t buffer[element_no];
+  C10_VEC_ALIGN intmax_t a_buffer[element_no];
+  C10_VEC_ALIGN intmax_t b_buffer[element_no];
+  a.store(a_buffer);
+  b.store(b_buffer);
+  for (uint32_t i = 0; i < element_no; ++i) {
+    buffer[i] = op(a_buffer[i], b_buffer[i]);
+  }
+  return Vectorized<T>::loadu(buffer);
+}
+
+template <class T>
+Vectorized<T> inline operator&(const Vectorized<T>& a, const Vectorized<T>& b) {
+  return bitwise_binary_op(a, b, std::bit_and<intmax_t>());
+}
+template <class T>
+Vectorized<T> inline operator|(const Vectorized<T>& a, const Vectorized<T>& b) {
+  return bitwise_binary_op(a, b, std::bit_or<intmax_t>());
+}
+template <class T>
+Vectorized<T> inline operator^(const Vectorized<T>& a, const Vectorized<T>& b) {
+  return bitwise_binary_op(a, b, std::bit_xor<intmax_t>());
+}
+
+// Shifts of integer elements by a scalar count
+template <class T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+Vectorized<T> inline operator<<(const Vectorized<T>& a, int count) {
+  using U = typename std::make_unsigned<T>::type;
+  return binary_op(a, a, [count](T x, T) { return static_cast<T>(static_cast<U>(x) << count); });
+}
+// Arithmetic shift for signed T
+template <class T, typename std::enable_if<std::is_integral<T>::value, int>::type = 0>
+Vectorized<T> inline operator>>(const Vectorized<T>& a, int count) {
+  return binary_op(a, a, [count](T x, T) { return static_cast<T>(x >> count); });
+}
+
+// Implements the IEEE 754 201X `maximum` operation, which propagates NaN if
+// either input is a NaN.
+template <class T>
+Vectorized<T> inline maximum(const Vectorized<T>& a, const Vectorized<T>& b) {
+  return binary_op(a, b, [](T x, T y) {
+    if (detail::isnan_scalar(x) || detail::isnan_scalar(y)) {
+      return detail::isnan_scalar(x) ? x : y;
+    }
+    return x > y ? x : y;
+  });
+}
+
+// Implements the IEEE 754 201X `minimum` operation, which propagates NaN if
+// either input is a NaN.
+template <class T>
+Vectorized<T> inline minimum(const Vectorized<T>& a, const Vectorized<T>& b) {
+  return binary_op(a, b, [](T x, T y) {
+    if (detail::isnan_scalar(x) || detail::isnan_scalar(y)) {
+      return detail::isnan_scalar(x) ? x : y;
+    }
+    return x < y ? x : y;
+  });
+}
+
+template <class T>
+Vectorized<T> inline clamp_max(const Vectorized<T>& a, const Vectorized<T>& max_vec) {
+  return binary_op(a, max_vec, [](T x, T hi) { return x > hi ? hi : x; });
+}
+
+template <class T>
+Vectorized<T> inline clamp_min(const Vectorized<T>& a, const Vectorized<T>& min_vec) {
+  return binary_op(a, min_vec, [](T x, T lo) { return x < lo ? lo : x; });
+}
+
+template <class T>
+Vectorized<T> inline clamp(const Vectorized<T>& a, const Vectorized<T>& min_vec, const Vectorized<T>& max_vec) {
+  return clamp_max(clamp_min(a, min_vec), max_vec);
+}
+
+template <typename T>
+inline Vectorized<T> fmadd(const Vectorized<T>& a, const Vectorized<T>& b, const Vectorized<T>& c) {
+  return a * b + c;
+}
+
+// Reinterprets the bits of a vector as a vector of another type of the same
+// width.
+template <typename dst_t, typename src_t>
+inline Vectorized<dst_t> cast(const Vectorized<src_t>& src) {
+  C10_VEC_ALIGN src_t buffer[Vectorized<src_t>::size()];
+  src.store(buffer);
+  return Vectorized<dst_t>::loadu(buffer);
+}
+
+template <size_t N>
+struct int_of_size;
+
+template <>
+struct int_of_size<4> {
+  using type = int32_t;
+};
+
+template <>
+struct int_of_size<8> {
+  using type = int64_t;
+};
+
+template <typename T>
+using int_same_size_t = typename int_of_size<sizeof(T)>::type;
+
+// Element-wise static_cast between vectors with the same number of elements.
+template <typename dst_t, typename src_t>
+inline Vectorized<dst_t> convert(const Vectorized<src_t>& src) {
+  static_assert(Vectorized<dst_t>::size() == Vectorized<src_t>::size(), "");
+  C10_VEC_ALIGN src_t src_arr[Vectorized<src_t>::size()];
+  C10_VEC_ALIGN dst_t dst_arr[Vectorized<dst_t>::size()];
+  src.store(src_arr);
+  for (int i = 0; i != Vectorized<src_t>::size(); i++) {
+    dst_arr[i] = static_cast<dst_t>(src_arr[i]);
+  }
+  return Vectorized<dst_t>::loadu(dst_arr);
+}
+
+// Converts a floating point vector to the integer vector of the same element
+// size, truncating like static_cast.
+template <class T, class IntType = int_same_size_t<T>>
+inline Vectorized<IntType> convert_to_int_of_same_size(const Vectorized<T>& src) {
+  return convert<IntType>(src);
+}
+
+// Converts an integer vector to the floating point vector of the same element
+// size, like static_cast.
+template <class IntType, class T = typename std::conditional<sizeof(IntType) == 4, float, double>::type>
+inline Vectorized<T> convert_to_fp_of_same_size(const Vectorized<IntType>& src) {
+  return convert<T>(src);
+}
+
+// Building blocks for vec_complex.h: swap the elements of each pair, and
+// duplicate the even / odd element of each pair.
+template <typename T>
+inline Vectorized<T> swap_pairs(const Vectorized<T>& a) {
+  C10_VEC_ALIGN T arr[Vectorized<T>::size()];
+  a.store(arr);
+  for (int i = 0; i < Vectorized<T>::size(); i += 2) {
+    std::swap(arr[i], arr[i + 1]);
+  }
+  return Vectorized<T>::loadu(arr);
+}
+
+template <typename T>
+inline Vectorized<T> dup_even(const Vectorized<T>& a) {
+  C10_VEC_ALIGN T arr[Vectorized<T>::size()];
+  a.store(arr);
+  for (int i = 0; i < Vectorized<T>::size(); i += 2) {
+    arr[i + 1] = arr[i];
+  }
+  return Vectorized<T>::loadu(arr);
+}
+
+template <typename T>
+inline Vectorized<T> dup_odd(const Vectorized<T>& a) {
+  C10_VEC_ALIGN T arr[Vectorized<T>::size()];
+  a.store(arr);
+  for (int i = 0; i < Vectorized<T>::size(); i += 2) {
+    arr[i] = arr[i + 1];
+  }
+  return Vectorized<T>::loadu(arr);
+}
+
+// Building blocks for vec_reduced_float.h and vec_qint.h, over
+// Vectorized<float>::size() elements:
+//  - load_to_float: load BFloat16 / Half values as floats
+//  - store_from_float: round floats to BFloat16 / Half like their
+//    constructors do, and store them
+//  - round_to_precision: round floats to the precision of BFloat16 / Half
+//  - load_to_int32: load int8 / uint8 / int32 values as int32
+//  - store_from_int32: narrow int32 values, which must be in range, and
+//    store them
+// The generic definitions are in vec_convert.h, after the backends had the
+// chance to specialize Vectorized<float> and Vectorized<int32_t>.
+template <typename T>
+inline Vectorized<float> load_to_float(const T* ptr);
+
+template <typename T>
+inline void store_from_float(const Vectorized<float>& v, T* ptr);
+
+template <typename T>
+inline Vectorized<float> round_to_precision(const Vectorized<float>& v);
+
+template <typename T>
+inline Vectorized<int32_t> load_to_int32(const T* ptr);
+
+template <typename T>
+inline void store_from_int32(const Vectorized<int32_t>& v, T* ptr);
+
+// Horizontal reductions, in element order.
+template <typename T, typename Op>
+inline T vec_reduce_all(const Op& vec_fun, const Vectorized<T>& acc_vec) {
+  C10_VEC_ALIGN T acc_arr[Vectorized<T>::size()];
+  acc_vec.store(acc_arr);
+  T acc = acc_arr[0];
+  for (int64_t i = 1; i < Vectorized<T>::size(); i++) {
+    acc = vec_fun(Vectorized<T>(acc), Vectorized<T>(acc_arr[i]))[0];
+  }
+  return acc;
+}
+
+template <typename T>
+inline T vec_reduce_add(const Vectorized<T>& v) {
+  return vec_reduce_all([](const Vectorized<T>& a, const Vectorized<T>& b) { return a + b; }, v);
+}
+
+template <typename T>
+inline T vec_reduce_max(const Vectorized<T>& v) {
+  return vec_reduce_all([](const Vectorized<T>& a, const Vectorized<T>& b) { return maximum(a, b); }, v);
+}
+
+template <typename T>
+inline T vec_reduce_min(const Vectorized<T>& v) {
+  return vec_reduce_all([](const Vectorized<T>& a, const Vectorized<T>& b) { return minimum(a, b); }, v);
+}
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace c10
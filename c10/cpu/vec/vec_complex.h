@@ -0,0 +1,312 @@
+#pragma once
+
+// Vectorized<c10::complex<float>> and Vectorized<c10::complex<double>>, for
+// every CPU_CAPABILITY.
+//
+// The elements are kept interleaved (re, im, re, im, ...) in a single
+// Vectorized<float> / Vectorized<double>, the memory layout of c10::complex.
+// Multiplication and division use the same formulas as c10::complex, with
+// the swap_pairs / dup_even / dup_odd shuffles from the backend.  Functions
+// that give a real result (abs, angle, real, imag) return it in the real
+// part, with a zero imaginary part.
+
+#include <cmath>
+#include <limits>
+
+#include <c10/cpu/vec/vec_base.h>
+
+namespace c10 {
+namespace vec {
+inline namespace CPU_CAPABILITY {
+
+namespace detail {
+
+// Spreads bit i of mask to bits 2i and 2i + 1.
+constexpr int64_t expand_mask_to_pairs(int64_t mask, int bit = 0) {
+  return bit == 32
+      ? 0
+      : (((mask >> bit) & 1) * (int64_t(3) << (2 * bit))) | expand_mask_to_pairs(mask, bit + 1);
+}
+
+// Ranges of the fast paths of abs() and exp()
+template <typename T>
+struct ComplexLimits {
+  // The squares of max(|re|, |im|) in [abs_min, abs_max] neither overflow
+  // nor lose precision to underflow.
+  static T abs_min() {
+    return std::ldexp(T(1), std::numeric_limits<T>::min_exponent / 2 + 13);
+  }
+  static T abs_max() {
+    return std::ldexp(T(1), std::numeric_limits<T>::max_exponent / 2 - 4);
+  }
+  // exp(re) is finite
+  static T exp_real_max() {
+    return std::is_same<T, float>::value ? T(88) : T(709);
+  }
+  // the float sin / cos approximations fall back to libm above 8192
+  static T exp_imag_max() {
+    return std::is_same<T, float>::value ? T(8192) : std::numeric_limits<T>::max();
+  }
+  // Vectorized<double> has no approximations: its exp, sin, cos and atan2
+  // call libm for every lane, so one std:: call per element is cheaper.
+  static constexpr bool libm_only = std::is_same<T, double>::value;
+};
+
+} // namespace detail
+
+template <typename T>
+class VectorizedComplex {
+  static_assert(std::is_floating_point<T>::value, "");
+  using value_vec = Vectorized<T>;
+  static constexpr int64_t real_lanes =
+      0x5555555555555555LL & ((int64_t(1) << value_vec::size()) - 1);
+  static constexpr int64_t imag_lanes = real_lanes << 1;
+
+ protected:
+  value_vec values_;
+
+  // -0 in the real or the imaginary lanes, for flipping their signs
+  static value_vec real_sign() {
+    return value_vec::template blend<real_lanes>(value_vec(T(0)), value_vec(T(-0.0)));
+  }
+  static value_vec imag_sign() {
+    return value_vec::template blend<imag_lanes>(value_vec(T(0)), value_vec(T(-0.0)));
+  }
+  // |z|^2 in both lanes
+  value_vec abs_2() const {
+    value_vec sq = values_ * values_;
+    return sq + swap_pairs(sq);
+  }
+  static Vectorized<c10::complex<T>> real_only(const value_vec& v) {
+    return value_vec::template blend<imag_lanes>(v, value_vec(T(0)));
+  }
+
+ public:
+  using value_type = c10::complex<T>;
+  using size_type = int;
+  static constexpr size_type size() {
+    return value_vec::size() / 2;
+  }
+  VectorizedComplex() {}
+  VectorizedComplex(const value_vec& v) : values_(v) {}
+  VectorizedComplex(c10::complex<T> val)
+      : values_(value_vec::template blend<real_lanes>(value_vec(val.imag()), value_vec(val.real()))) {}
+
+  // The interleaved real and imaginary parts
+  const value_vec& values() const {
+    return values_;
+  }
+
+  template <int64_t mask>
+  static Vectorized<c10::complex<T>> blend(
+      const Vectorized<c10::complex<T>>& a,
+      const Vectorized<c10::complex<T>>& b) {
+    return value_vec::template blend<detail::expand_mask_to_pairs(mask & ((int64_t(1) << size()) - 1))>(
+        a.values_, b.values_);
+  }
+  static Vectorized<c10::complex<T>> blendv(
+      const Vectorized<c10::complex<T>>& a,
+      const Vectorized<c10::complex<T>>& b,
+      const Vectorized<c10::complex<T>>& mask) {
+    return value_vec::blendv(a.values_, b.values_, mask.values_);
+  }
+  template <typename step_t>
+  static Vectorized<c10::complex<T>> arange(
+      c10::complex<T> base = c10::complex<T>(0),
+      step_t step = static_cast<step_t>(1)) {
+    C10_VEC_ALIGN c10::complex<T> tmp[size()];
+    for (int i = 0; i < size(); i++) {
+      tmp[i] = base + c10::complex<T>(i) * c10::complex<T>(step);
+    }
+    return loadu(tmp);
+  }
+  static Vectorized<c10::complex<T>> set(
+      const Vectorized<c10::complex<T>>& a,
+      const Vectorized<c10::complex<T>>& b,
+      int64_t count = size()) {
+    return value_vec::set(a.values_, b.values_, 2 * count);
+  }
+  static Vectorized<c10::complex<T>> loadu(const void* ptr, int64_t count = size()) {
+    return value_vec::loadu(ptr, 2 * count);
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    values_.store(ptr, 2 * count);
+  }
+  c10::complex<T> operator[](int idx) const {
+    C10_VEC_ALIGN c10::complex<T> tmp[size()];
+    store(tmp);
+    return tmp[idx];
+  }
+  int64_t zero_mask() const {
+    int64_t lane_mask = values_.zero_mask();
+    int64_t mask = 0;
+    for (int i = 0; i < size(); i++) {
+      if (((lane_mask >> (2 * i)) & 3) == 3) {
+        mask |= int64_t(1) << i;
+      }
+    }
+    return mask;
+  }
+  Vectorized<c10::complex<T>> isnan() const {
+    value_vec nan = values_.isnan();
+    return nan | swap_pairs(nan);
+  }
+  Vectorized<c10::complex<T>> map(c10::complex<T> (*f)(const c10::complex<T>&)) const {
+    C10_VEC_ALIGN c10::complex<T> tmp[size()];
+    store(tmp);
+    for (int i = 0; i < size(); i++) {
+      tmp[i] = f(tmp[i]);
+    }
+    return loadu(tmp);
+  }
+  // sqrt(re^2 + im^2) is accurate unless the squares overflow or lose bits to
+  // underflow; vectors with such elements (or NaN / inf) use std::abs.
+  Vectorized<c10::complex<T>> abs() const {
+    const value_vec a = values_.abs();
+    const value_vec m = maximum(a, swap_pairs(a));
+    const value_vec in_range =
+        ((m >= value_vec(detail::ComplexLimits<T>::abs_min())) &
+         (m <= value_vec(detail::ComplexLimits<T>::abs_max()))) |
+        (m == value_vec(T(0)));
+    if (in_range.zero_mask() != 0) {
+      return map([](const c10::complex<T>& z) { return c10::complex<T>(std::abs(z)); });
+    }
+    return real_only(abs_2().sqrt());
+  }
+  Vectorized<c10::complex<T>> angle() const {
+    if (detail::ComplexLimits<T>::libm_only) {
+      return map([](const c10::complex<T>& z) { return c10::complex<T>(std::arg(z)); });
+    }
+    return real_only(swap_pairs(values_).atan2(values_));
+  }
+  Vectorized<c10::complex<T>> real() const {
+    return real_only(values_);
+  }
+  Vectorized<c10::complex<T>> imag() const {
+    return real_only(swap_pairs(values_));
+  }
+  Vectorized<c10::complex<T>> conj() const {
+    return values_ ^ imag_sign();
+  }
+  Vectorized<c10::complex<T>> neg() const {
+    return values_.neg();
+  }
+  // 1 / z = conj(z) / |z|^2
+  Vectorized<c10::complex<T>> reciprocal() const {
+    return (values_ ^ imag_sign()) / abs_2();
+  }
+  Vectorized<c10::complex<T>> sqrt() const {
+    return map([](const c10::complex<T>& z) { return std::sqrt(z); });
+  }
+  // exp(a + bi) = exp(a) * (cos(b) + i sin(b)).  Vectors where exp(a) may
+  // overflow, where b is out of range of the sin / cos approximations, or
+  // with NaN / inf use std::exp, which handles those carefully.
+  Vectorized<c10::complex<T>> exp() const {
+    if (detail::ComplexLimits<T>::libm_only) {
+      return map([](const c10::complex<T>& z) { return std::exp(z); });
+    }
+    const value_vec limits = value_vec::template blend<imag_lanes>(
+        value_vec(detail::ComplexLimits<T>::exp_real_max()),
+        value_vec(detail::ComplexLimits<T>::exp_imag_max()));
+    // a <= limit (a = -inf is fine), |b| <= limit
+    const value_vec in_range =
+        value_vec::template blend<imag_lanes>(values_, values_.abs()) <= limits;
+    if (in_range.zero_mask() != 0) {
+      return map([](const c10::complex<T>& z) { return std::exp(z); });
+    }
+    const value_vec exp_re = dup_even(values_.exp());
+    const value_vec im = dup_odd(values_);
+    const value_vec cos_sin = value_vec::template blend<imag_lanes>(im.cos(), im.sin());
+    return exp_re * cos_sin;
+  }
+  Vectorized<c10::complex<T>> log() const {
+    return map([](const c10::complex<T>& z) { return std::log(z); });
+  }
+  Vectorized<c10::complex<T>> tanh() const {
+    return map([](const c10::complex<T>& z) { return std::tanh(z); });
+  }
+
+  // Only (in)equality is defined for complex numbers.
+  Vectorized<c10::complex<T>> operator==(const Vectorized<c10::complex<T>>& other) const {
+    value_vec eq = values_ == other.values_;
+    return eq & swap_pairs(eq);
+  }
+  Vectorized<c10::complex<T>> operator!=(const Vectorized<c10::complex<T>>& other) const {
+    value_vec ne = values_ != other.values_;
+    return ne | swap_pairs(ne);
+  }
+  Vectorized<c10::complex<T>> eq(const Vectorized<c10::complex<T>>& other) const {
+    return real_only((*this == other).values_ & value_vec(T(1)));
+  }
+  Vectorized<c10::complex<T>> ne(const Vectorized<c10::complex<T>>& other) const {
+    return real_only((*this != other).values_ & value_vec(T(1)));
+  }
+
+  // (a + bi) * (c + di) = (ac - bd) + (bc + ad)i
+  static Vectorized<c10::complex<T>> mul(
+      const Vectorized<c10::complex<T>>& x,
+      const Vectorized<c10::complex<T>>& y) {
+    value_vec ac_bc = x.values_ * dup_even(y.values_);
+    value_vec bd_ad = swap_pairs(x.values_) * dup_odd(y.values_);
+    return ac_bc + (bd_ad ^ real_sign());
+  }
+  // (a + bi) / (c + di) = ((ac + bd) + (bc - ad)i) / (c^2 + d^2)
+  static Vectorized<c10::complex<T>> div(
+      const Vectorized<c10::complex<T>>& x,
+      const Vectorized<c10::complex<T>>& y) {
+    value_vec ac_bc = x.values_ * dup_even(y.values_);
+    value_vec bd_ad = swap_pairs(x.values_) * dup_odd(y.values_);
+    return (ac_bc + (bd_ad ^ imag_sign())) / y.abs_2();
+  }
+};
+
+template <>
+class Vectorized<c10::complex<float>> : public VectorizedComplex<float> {
+ public:
+  using VectorizedComplex<float>::VectorizedComplex;
+};
+
+template <>
+class Vectorized<c10::complex<double>> : public VectorizedComplex<double> {
+ public:
+  using VectorizedComplex<double>::VectorizedComplex;
+};
+
+#define C10_DEFINE_COMPLEX_OPS(T)                                                        \
+  template <>                                                                            \
+  Vectorized<T> inline operator+(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return a.values() + b.values();                                                      \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline operator-(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return a.values() - b.values();                                                      \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline operator*(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return Vectorized<T>::mul(a, b);                                                     \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline operator/(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return Vectorized<T>::div(a, b);                                                     \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline operator&(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return a.values() & b.values();                                                      \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline operator|(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return a.values() | b.values();                                                      \
+  }                                                                                      \
+  template <>                                                                            \
+  Vectorized<T> inline operator^(const Vectorized<T>& a, const Vectorized<T>& b) {       \
+    return a.values() ^ b.values();                                                      \
+  }
+
+C10_DEFINE_COMPLEX_OPS(c10::complex<float>)
+C10_DEFINE_COMPLEX_OPS(c10::complex<double>)
+
+#undef C10_DEFINE_COMPLEX_OPS
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace c10
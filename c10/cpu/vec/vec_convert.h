@@ -0,0 +1,76 @@
+#pragma once
+
+// Generic definitions of the building blocks declared in vec_base.h, for the
+// element types a backend doesn't specialize them for.
+
+#include <c10/cpu/vec/vec_base.h>
+
+namespace c10 {
+namespace vec {
+inline namespace CPU_CAPABILITY {
+
+template <typename T>
+inline Vectorized<float> load_to_float(const T* ptr) {
+  C10_VEC_ALIGN float arr[Vectorized<float>::size()];
+  for (int i = 0; i < Vectorized<float>::size(); i++) {
+    arr[i] = static_cast<float>(ptr[i]);
+  }
+  return Vectorized<float>::loadu(arr);
+}
+
+template <typename T>
+inline void store_from_float(const Vectorized<float>& v, T* ptr) {
+  C10_VEC_ALIGN float arr[Vectorized<float>::size()];
+  v.store(arr);
+  for (int i = 0; i < Vectorized<float>::size(); i++) {
+    ptr[i] = static_cast<T>(arr[i]);
+  }
+}
+
+template <typename T>
+inline Vectorized<float> round_to_precision(const Vectorized<float>& v) {
+  C10_VEC_ALIGN float arr[Vectorized<float>::size()];
+  v.store(arr);
+  for (int i = 0; i < Vectorized<float>::size(); i++) {
+    arr[i] = static_cast<float>(static_cast<T>(arr[i]));
+  }
+  return Vectorized<float>::loadu(arr);
+}
+
+// For code that is generic over float, BFloat16 and Half
+template <>
+inline Vectorized<float> load_to_float<float>(const float* ptr) {
+  return Vectorized<float>::loadu(ptr);
+}
+
+template <>
+inline void store_from_float<float>(const Vectorized<float>& v, float* ptr) {
+  v.store(ptr);
+}
+
+template <>
+inline Vectorized<float> round_to_precision<float>(const Vectorized<float>& v) {
+  return v;
+}
+
+template <typename T>
+inline Vectorized<int32_t> load_to_int32(const T* ptr) {
+  C10_VEC_ALIGN int32_t arr[Vectorized<int32_t>::size()];
+  for (int i = 0; i < Vectorized<int32_t>::size(); i++) {
+    arr[i] = static_cast<int32_t>(ptr[i]);
+  }
+  return Vectorized<int32_t>::loadu(arr);
+}
+
+template <typename T>
+inline void store_from_int32(const Vectorized<int32_t>& v, T* ptr) {
+  C10_VEC_ALIGN int32_t arr[Vectorized<int32_t>::size()];
+  v.store(arr);
+  for (int i = 0; i < Vectorized<int32_t>::size(); i++) {
+    ptr[i] = static_cast<T>(arr[i]);
+  }
+}
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace c10
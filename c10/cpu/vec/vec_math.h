@@ -0,0 +1,273 @@
+#pragma once
+
+// Polynomial approximations of exp, log, tanh, erf, sin, cos and atan2 for
+// Vectorized<float>, written against the Vectorized API only.  The AVX2 and
+// AVX512 Vectorized<float> use them; the DEFAULT one calls libm.
+//
+// Maximum errors, measured against double precision libm over all finite
+// floats:
+//   exp_approx   1.3 ulp
+//   log_approx   0.8 ulp
+//   tanh_approx  1.4 ulp
+//   erf_approx   3.4e-7 absolute, 2.5 ulp for |x| < 0.5
+//   sincos       9.3e-8 absolute (libm for |x| > 8192)
+//   atan2        3.2 ulp
+
+#include <cstdint>
+#include <limits>
+#include <utility>
+
+#include <c10/cpu/vec/vec_base.h>
+
+namespace c10 {
+namespace vec {
+inline namespace CPU_CAPABILITY {
+
+// Cephes expf: exp(x) = 2^n * exp(r), with n = round(x / ln2) and
+// r = x - n * ln2 in [-ln2/2, ln2/2].  ln2 is split in two so n * ln2_hi is
+// exact.
+inline Vectorized<float> exp_approx(const Vectorized<float>& x) {
+  using VF = Vectorized<float>;
+  using VI = Vectorized<int32_t>;
+  const VF max_input(88.72283935546875f); // above: inf
+  const VF min_input(-103.97208f); // below: 0
+  const VF log2e(1.44269504088896341f);
+  const VF ln2_hi(0.693359375f);
+  const VF ln2_lo(-2.12194440e-4f);
+
+  VF x_clamped = clamp(x, min_input, max_input);
+  VF n = fmadd(x_clamped, log2e, VF(0.5f)).floor();
+  VF r = x_clamped - n * ln2_hi;
+  r = r - n * ln2_lo;
+
+  VF p(1.9875691500E-4f);
+  p = fmadd(p, r, VF(1.3981999507E-3f));
+  p = fmadd(p, r, VF(8.3334519073E-3f));
+  p = fmadd(p, r, VF(4.1665795894E-2f));
+  p = fmadd(p, r, VF(1.6666665459E-1f));
+  p = fmadd(p, r, VF(5.0000001201E-1f));
+  p = fmadd(p, r * r, r + VF(1.0f));
+
+  // 2^n, with n in [-150, 128], doesn't fit a single float; multiply by
+  // 2^(n/2) twice so the result only rounds once when it is denormal.
+  VI ni = convert_to_int_of_same_size(n);
+  VI n1 = ni >> 1;
+  VI n2 = ni - n1;
+  VF pow2_n1 = cast<float>((n1 + VI(127)) << 23);
+  VF pow2_n2 = cast<float>((n2 + VI(127)) << 23);
+  VF result = p * pow2_n1 * pow2_n2;
+
+  result = VF::blendv(result, VF(std::numeric_limits<float>::infinity()), x > max_input);
+  result = VF::blendv(result, VF(0.f), x < min_input);
+  return VF::blendv(result, x, x.isnan());
+}
+
+// Cephes logf: log(x) = e * ln2 + log(m), with x = m * 2^e and m in
+// [sqrt(0.5), sqrt(2)).  Offsetting the bits by those of sqrt(0.5) before
+// splitting them puts m in that range without a compare.  Denormals are scaled
+// up by 2^23 first, behind a branch: a blend there sits at the head of every
+// dependency chain and costs more than the rest of the function.
+inline Vectorized<float> log_approx(const Vectorized<float>& x) {
+  using VF = Vectorized<float>;
+  using VI = Vectorized<int32_t>;
+  const VF min_normal(std::numeric_limits<float>::min());
+  const VI sqrt_half_bits(0x3F3504F3);
+
+  VF xs = x;
+  VF e_bias(0.f);
+  VF denormal = x < min_normal;
+  if (C10_UNLIKELY(denormal.zero_mask() != (int64_t(1) << VF::size()) - 1)) {
+    xs = VF::blendv(x, x * VF(8388608.f), denormal);
+    e_bias = VF::blendv(VF(0.f), VF(-23.f), denormal);
+  }
+
+  VI bits = cast<int32_t>(xs) - sqrt_half_bits;
+  VF e = convert_to_fp_of_same_size(bits >> 23) + e_bias;
+  // m - 1, in [sqrt(0.5) - 1, sqrt(2) - 1)
+  VF m = cast<float>((bits & VI(0x007FFFFF)) + sqrt_half_bits) - VF(1.f);
+
+  VF z = m * m;
+  VF p(7.0376836292E-2f);
+  p = fmadd(p, m, VF(-1.1514610310E-1f));
+  p = fmadd(p, m, VF(1.1676998740E-1f));
+  p = fmadd(p, m, VF(-1.2420140846E-1f));
+  p = fmadd(p, m, VF(1.4249322787E-1f));
+  p = fmadd(p, m, VF(-1.6668057665E-1f));
+  p = fmadd(p, m, VF(2.0000714765E-1f));
+  p = fmadd(p, m, VF(-2.4999993993E-1f));
+  p = fmadd(p, m, VF(3.3333331174E-1f));
+  p = p * m * z;
+
+  p = fmadd(e, VF(-2.12194440e-4f), p);
+  p = fmadd(z, VF(-0.5f), p);
+  VF result = fmadd(e, VF(0.693359375f), m + p);
+
+  const float inf = std::numeric_limits<float>::infinity();
+  result = VF::blendv(result, VF(-inf), x == VF(0.f));
+  result = VF::blendv(result, VF(inf), x == VF(inf));
+  return VF::blendv(
+      result, VF(std::numeric_limits<float>::quiet_NaN()), (x < VF(0.f)) | x.isnan());
+}
+
+// Cephes tanhf: an odd polynomial for |x| < 0.625, 1 - 2 / (exp(2|x|) + 1)
+// with the sign of x otherwise.
+inline Vectorized<float> tanh_approx(const Vectorized<float>& x) {
+  using VF = Vectorized<float>;
+  const VF sign_mask(-0.f);
+
+  VF ax = x.abs();
+  VF z = x * x;
+  VF p(-5.70498872745E-3f);
+  p = fmadd(p, z, VF(2.06390887954E-2f));
+  p = fmadd(p, z, VF(-5.37397155531E-2f));
+  p = fmadd(p, z, VF(1.33314422036E-1f));
+  p = fmadd(p, z, VF(-3.33332819422E-1f));
+  // | keeps the sign of -0
+  VF small_result = fmadd(p * z, x, x) | (x & sign_mask);
+
+  VF e = exp_approx(ax + ax);
+  VF large_result = VF(1.f) - VF(2.f) / (e + VF(1.f));
+  large_result = large_result | (x & sign_mask);
+
+  return VF::blendv(large_result, small_result, ax < VF(0.625f));
+}
+
+// Abramowitz and Stegun 7.1.26 for |x| >= 0.5; its absolute error of 1.5e-7
+// is too much relative to erf(x) near 0, where we use the Taylor series.
+inline Vectorized<float> erf_approx(const Vectorized<float>& x) {
+  using VF = Vectorized<float>;
+  const VF sign_mask(-0.f);
+
+  VF ax = x.abs();
+  VF t = VF(1.f) / fmadd(VF(0.3275911f), ax, VF(1.f));
+  VF p(1.061405429f);
+  p = fmadd(p, t, VF(-1.453152027f));
+  p = fmadd(p, t, VF(1.421413741f));
+  p = fmadd(p, t, VF(-0.284496736f));
+  p = fmadd(p, t, VF(0.254829592f));
+  p = p * t;
+  VF large_result = VF(1.f) - p * exp_approx((ax * ax).neg());
+  large_result = large_result | (x & sign_mask);
+
+  // 2/sqrt(pi) * (x - x^3/3 + x^5/10 - x^7/42 + x^9/216 - x^11/1320)
+  VF z = x * x;
+  VF s(-1.f / 1320);
+  s = fmadd(s, z, VF(1.f / 216));
+  s = fmadd(s, z, VF(-1.f / 42));
+  s = fmadd(s, z, VF(1.f / 10));
+  s = fmadd(s, z, VF(-1.f / 3));
+  s = fmadd(s, z, VF(1.f));
+  VF small_result = s * x * VF(1.12837916709551257f);
+
+  return VF::blendv(large_result, small_result, ax < VF(0.5f));
+}
+
+// Cephes sinf / cosf: with j the even integer nearest to |x| / (pi/4),
+// r = |x| - j * pi/4 is in [-pi/4, pi/4], and sin and cos of |x| are
+// +-sin(r) or +-cos(r) depending on j mod 8.  pi/4 is split in three so
+// j * pi/4 is exact for |x| <= 8192; vectors with larger (or non-finite)
+// elements go through libm.
+inline std::pair<Vectorized<float>, Vectorized<float>> sincos_approx(const Vectorized<float>& x) {
+  using VF = Vectorized<float>;
+  using VI = Vectorized<int32_t>;
+  const VF sign_mask(-0.f);
+
+  VF ax = x.abs();
+  if ((ax <= VF(8192.f)).zero_mask() != 0) {
+    return {x.map(std::sin), x.map(std::cos)};
+  }
+  VI j = convert_to_int_of_same_size(ax * VF(1.27323954473516268615f));
+  j = (j + VI(1)) & VI(~1);
+  VF y = convert_to_fp_of_same_size(j);
+  VF r = fmadd(y, VF(-0.78515625f), ax);
+  r = fmadd(y, VF(-2.4187564849853515625e-4f), r);
+  r = fmadd(y, VF(-3.77489497744594108e-8f), r);
+  VF z = r * r;
+
+  VF sp(-1.9515295891E-4f);
+  sp = fmadd(sp, z, VF(8.3321608736E-3f));
+  sp = fmadd(sp, z, VF(-1.6666654611E-1f));
+  sp = fmadd(sp * z, r, r);
+  VF cp(2.443315711809948E-5f);
+  cp = fmadd(cp, z, VF(-1.388731625493765E-3f));
+  cp = fmadd(cp, z, VF(4.166664568298827E-2f));
+  cp = fmadd(cp * z, z, fmadd(z, VF(-0.5f), VF(1.f)));
+
+  // j = 2, 6: swap the polynomials; j = 4, 6 negate sin; j = 2, 4 negate cos
+  VF swap = cast<float>((j & VI(2)) != VI(0));
+  VF s = VF::blendv(sp, cp, swap);
+  VF c = VF::blendv(cp, sp, swap);
+  s = s ^ cast<float>((j & VI(4)) << 29) ^ (x & sign_mask);
+  c = c ^ cast<float>(((j + VI(2)) & VI(4)) << 29);
+  return {s, c};
+}
+
+// Cephes atanf on t = min(|x|, |y|) / max(|x|, |y|) in [0, 1], then moved to
+// the right octant.  Zeros and infinities give the atan2 special values.
+inline Vectorized<float> atan2_approx(const Vectorized<float>& y, const Vectorized<float>& x) {
+  using VF = Vectorized<float>;
+  using VI = Vectorized<int32_t>;
+  const VF sign_mask(-0.f);
+  const VF inf(std::numeric_limits<float>::infinity());
+  const VF pi(3.14159265358979323846f);
+  const VF pi_2(1.57079632679489661923f);
+  const VF pi_4(0.785398163397448309616f);
+
+  VF ax = x.abs();
+  VF ay = y.abs();
+  VF den = maximum(ax, ay);
+  VF t = minimum(ax, ay) / den;
+  t = VF::blendv(t, VF(0.f), den == VF(0.f));
+  t = VF::blendv(t, VF(1.f), (ax == inf) & (ay == inf));
+
+  // atan(t) = pi/4 + atan((t - 1) / (t + 1)) for t > tan(pi/8)
+  VF big = t > VF(0.414213562373095f);
+  VF u = VF::blendv(t, (t - VF(1.f)) / (t + VF(1.f)), big);
+  VF z = u * u;
+  VF p(8.05374449538e-2f);
+  p = fmadd(p, z, VF(-1.38776856032E-1f));
+  p = fmadd(p, z, VF(1.99777106478E-1f));
+  p = fmadd(p, z, VF(-3.33329491539E-1f));
+  VF r = fmadd(p * z, u, u) + (big & pi_4);
+
+  r = VF::blendv(r, pi_2 - r, ay > ax);
+  // sign bit of x, so that x = -0 gives pi
+  r = VF::blendv(r, pi - r, cast<float>(cast<int32_t>(x) < VI(0)));
+  return r | (y & sign_mask);
+}
+
+#if defined(CPU_CAPABILITY_AVX2) || defined(CPU_CAPABILITY_AVX512)
+
+inline Vectorized<float> Vectorized<float>::exp() const {
+  return exp_approx(*this);
+}
+
+inline Vectorized<float> Vectorized<float>::log() const {
+  return log_approx(*this);
+}
+
+inline Vectorized<float> Vectorized<float>::tanh() const {
+  return tanh_approx(*this);
+}
+
+inline Vectorized<float> Vectorized<float>::erf() const {
+  return erf_approx(*this);
+}
+
+inline Vectorized<float> Vectorized<float>::sin() const {
+  return sincos_approx(*this).first;
+}
+
+inline Vectorized<float> Vectorized<float>::cos() const {
+  return sincos_approx(*this).second;
+}
+
+inline Vectorized<float> Vectorized<float>::atan2(const Vectorized<float>& x) const {
+  return atan2_approx(*this, x);
+}
+
+#endif
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace c10
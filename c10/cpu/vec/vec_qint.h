@@ -0,0 +1,221 @@
+#pragma once
+
+// Vectorized<c10::qint8>, Vectorized<c10::quint8> and Vectorized<c10::qint32>,
+// for every CPU_CAPABILITY.
+//
+// A quantized vector holds the integers as a Vectorized<underlying>, so it has
+// as many elements as fit in a register; dequantize() returns them as
+// float_num_vecs() Vectorized<float>, and quantize() takes that many back.
+//
+//   dequantize:  x = (q - zero_point) * scale
+//   quantize:    q = clamp(round(x * inverse_scale) + zero_point, qmin, qmax)
+//
+// round() rounds half to even, like std::nearbyint in the default rounding
+// mode.
+
+#include <limits>
+#include <utility>
+
+#include <c10/cpu/vec/vec_base.h>
+
+namespace c10 {
+namespace vec {
+inline namespace CPU_CAPABILITY {
+
+template <typename T>
+class VectorizedQuantized {
+ public:
+  using underlying = typename T::underlying;
+  static constexpr int kFloatNumVecs =
+      C10_VECTOR_WIDTH / sizeof(underlying) / (C10_VECTOR_WIDTH / sizeof(float));
+
+ protected:
+  Vectorized<underlying> vals_;
+
+  // The range of round(x * inverse_scale) before adding zero_point, rounded
+  // inwards to floats.
+  static std::pair<float, float> scaled_range(int32_t zero_point) {
+    const double lo = static_cast<double>(std::numeric_limits<underlying>::min()) - zero_point;
+    const double hi = static_cast<double>(std::numeric_limits<underlying>::max()) - zero_point;
+    float lo_f = static_cast<float>(lo);
+    float hi_f = static_cast<float>(hi);
+    if (static_cast<double>(lo_f) < lo) {
+      lo_f = std::nextafter(lo_f, 0.f);
+    }
+    if (static_cast<double>(hi_f) > hi) {
+      hi_f = std::nextafter(hi_f, 0.f);
+    }
+    return {lo_f, hi_f};
+  }
+
+  static Vectorized<T> quantize_scaled(
+      const Vectorized<float>* rhs,
+      float multiplier,
+      int32_t zero_point) {
+    const auto range = scaled_range(zero_point);
+    const Vectorized<float> multiplier_vec(multiplier);
+    const Vectorized<float> lo(range.first);
+    const Vectorized<float> hi(range.second);
+    const Vectorized<int32_t> zero_point_vec(zero_point);
+    const Vectorized<int32_t> qmin(static_cast<int32_t>(std::numeric_limits<underlying>::min()));
+    const Vectorized<int32_t> qmax(static_cast<int32_t>(std::numeric_limits<underlying>::max()));
+    C10_VEC_ALIGN underlying tmp[size()];
+    for (int i = 0; i < float_num_vecs(); i++) {
+      Vectorized<float> r = (rhs[i] * multiplier_vec).round();
+      // NaNs quantize to zero_point
+      r = Vectorized<float>::blendv(r, Vectorized<float>(0.f), r.isnan());
+      Vectorized<int32_t> q = convert_to_int_of_same_size(clamp(r, lo, hi)) + zero_point_vec;
+      // lo and hi may be inside the range for qint32, saturate explicitly.
+      q = Vectorized<int32_t>::blendv(q, qmax, cast<int32_t>(r > hi));
+      q = Vectorized<int32_t>::blendv(q, qmin, cast<int32_t>(r < lo));
+      store_from_int32(q, tmp + i * Vectorized<float>::size());
+    }
+    return Vectorized<T>(Vectorized<underlying>::loadu(tmp));
+  }
+
+ public:
+  using value_type = T;
+  using size_type = int;
+  using float_vec_return_type = std::array<Vectorized<float>, kFloatNumVecs>;
+  using int_vec_return_type = std::array<Vectorized<int32_t>, kFloatNumVecs>;
+
+  static constexpr size_type size() {
+    return Vectorized<underlying>::size();
+  }
+  static constexpr int float_num_vecs() {
+    return kFloatNumVecs;
+  }
+  static constexpr int int_num_vecs() {
+    return kFloatNumVecs;
+  }
+
+  VectorizedQuantized() {}
+  VectorizedQuantized(const Vectorized<underlying>& vals) : vals_(vals) {}
+  VectorizedQuantized(T val) : vals_(val.val_) {}
+
+  // The underlying integers
+  const Vectorized<underlying>& vals() const {
+    return vals_;
+  }
+
+  static Vectorized<T> loadu(const void* ptr, int64_t count = size()) {
+    return Vectorized<T>(Vectorized<underlying>::loadu(ptr, count));
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    vals_.store(ptr, count);
+  }
+  T operator[](int idx) const {
+    return T(vals_[idx]);
+  }
+
+  float_vec_return_type dequantize(
+      const Vectorized<float>& scale,
+      const Vectorized<float>& zero_point) const {
+    C10_VEC_ALIGN underlying tmp[size()];
+    vals_.store(tmp);
+    float_vec_return_type rv;
+    for (int i = 0; i < float_num_vecs(); i++) {
+      Vectorized<float> f =
+          convert_to_fp_of_same_size(load_to_int32(tmp + i * Vectorized<float>::size()));
+      rv[i] = (f - zero_point) * scale;
+    }
+    return rv;
+  }
+  // With scale_neg_zp_premul = -zero_point * scale precomputed, one fmadd
+  // per element.  Rounds differently from the overload above.
+  float_vec_return_type dequantize(
+      const Vectorized<float>& scale,
+      const Vectorized<float>& zero_point,
+      const Vectorized<float>& scale_neg_zp_premul) const {
+    (void)zero_point;
+    C10_VEC_ALIGN underlying tmp[size()];
+    vals_.store(tmp);
+    float_vec_return_type rv;
+    for (int i = 0; i < float_num_vecs(); i++) {
+      Vectorized<float> f =
+          convert_to_fp_of_same_size(load_to_int32(tmp + i * Vectorized<float>::size()));
+      rv[i] = fmadd(f, scale, scale_neg_zp_premul);
+    }
+    return rv;
+  }
+
+  static Vectorized<T> quantize(
+      const float_vec_return_type& rhs,
+      float scale,
+      int32_t zero_point,
+      float inverse_scale) {
+    (void)scale;
+    return quantize_scaled(rhs.data(), inverse_scale, zero_point);
+  }
+
+  Vectorized<T> relu(const Vectorized<T>& zero_point) const {
+    return Vectorized<T>(maximum(vals_, zero_point.vals_));
+  }
+  Vectorized<T> relu6(const Vectorized<T>& zero_point, const Vectorized<T>& q_six) const {
+    return Vectorized<T>(minimum(maximum(vals_, zero_point.vals_), q_six.vals_));
+  }
+
+  // this - b, widened to int32
+  int_vec_return_type widening_subtract(const Vectorized<T>& b) const {
+    C10_VEC_ALIGN underlying a_tmp[size()];
+    C10_VEC_ALIGN underlying b_tmp[size()];
+    vals_.store(a_tmp);
+    b.vals_.store(b_tmp);
+    int_vec_return_type rv;
+    for (int i = 0; i < int_num_vecs(); i++) {
+      const int offset = i * Vectorized<int32_t>::size();
+      rv[i] = load_to_int32(a_tmp + offset) - load_to_int32(b_tmp + offset);
+    }
+    return rv;
+  }
+
+  // q = clamp(round(inp * multiplier) + zero_point, qmin, qmax)
+  static Vectorized<T> requantize_from_int(
+      const int_vec_return_type& inp,
+      float multiplier,
+      int32_t zero_point) {
+    std::array<Vectorized<float>, kFloatNumVecs> f;
+    for (int i = 0; i < int_num_vecs(); i++) {
+      f[i] = convert_to_fp_of_same_size(inp[i]);
+    }
+    return quantize_scaled(f.data(), multiplier, zero_point);
+  }
+};
+
+template <>
+class Vectorized<c10::qint8> : public VectorizedQuantized<c10::qint8> {
+ public:
+  using VectorizedQuantized<c10::qint8>::VectorizedQuantized;
+};
+
+template <>
+class Vectorized<c10::quint8> : public VectorizedQuantized<c10::quint8> {
+ public:
+  using VectorizedQuantized<c10::quint8>::VectorizedQuantized;
+};
+
+template <>
+class Vectorized<c10::qint32> : public VectorizedQuantized<c10::qint32> {
+ public:
+  using VectorizedQuantized<c10::qint32>::VectorizedQuantized;
+};
+
+#define C10_DEFINE_QINT_OPS(T)                                                       \
+  template <>                                                                        \
+  Vectorized<T> inline maximum(const Vectorized<T>& a, const Vectorized<T>& b) {     \
+    return Vectorized<T>(maximum(a.vals(), b.vals()));                               \
+  }                                                                                  \
+  template <>                                                                        \
+  Vectorized<T> inline minimum(const Vectorized<T>& a, const Vectorized<T>& b) {     \
+    return Vectorized<T>(minimum(a.vals(), b.vals()));                               \
+  }
+
+C10_DEFINE_QINT_OPS(c10::qint8)
+C10_DEFINE_QINT_OPS(c10::quint8)
+C10_DEFINE_QINT_OPS(c10::qint32)
+
+#undef C10_DEFINE_QINT_OPS
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace c10
@@ -0,0 +1,271 @@
+#pragma once
+
+// Vectorized<BFloat16> and Vectorized<Half>, for every CPU_CAPABILITY.
+//
+// The elements are kept as two Vectorized<float>.  Each operation is done in
+// float and its result rounded back to the precision of T, so a chain of
+// operations gives the same results as the scalar BFloat16 / Half code, which
+// also computes in float and rounds on every assignment.  Only fmadd rounds
+// once, like a fused multiply-add.  Values are converted from / to T by
+// loadu / store.
+
+#include <c10/cpu/vec/vec_base.h>
+
+namespace c10 {
+namespace vec {
+inline namespace CPU_CAPABILITY {
+
+template <typename T>
+class VectorizedReducedFloat {
+  static_assert(is_reduced_floating_point<T>::value, "");
+
+ protected:
+  Vectorized<float> lo_;
+  Vectorized<float> hi_;
+
+  static Vectorized<T> rounded(const Vectorized<float>& lo, const Vectorized<float>& hi) {
+    return Vectorized<T>(round_to_precision<T>(lo), round_to_precision<T>(hi));
+  }
+
+ public:
+  using value_type = T;
+  using size_type = int;
+  static constexpr size_type size() {
+    return 2 * Vectorized<float>::size();
+  }
+  VectorizedReducedFloat() {}
+  VectorizedReducedFloat(T val) : lo_(static_cast<float>(val)), hi_(static_cast<float>(val)) {}
+  // lo and hi must already be representable in T
+  VectorizedReducedFloat(const Vectorized<float>& lo, const Vectorized<float>& hi) : lo_(lo), hi_(hi) {}
+
+  // The halves as floats
+  const Vectorized<float>& lo() const {
+    return lo_;
+  }
+  const Vectorized<float>& hi() const {
+    return hi_;
+  }
+  // Rounds float values to T
+  static Vectorized<T> from_float(const Vectorized<float>& lo, const Vectorized<float>& hi) {
+    return rounded(lo, hi);
+  }
+
+  template <int64_t mask>
+  static Vectorized<T> blend(const Vectorized<T>& a, const Vectorized<T>& b) {
+    constexpr int half = Vectorized<float>::size();
+    return Vectorized<T>(
+        Vectorized<float>::template blend<mask & ((int64_t(1) << half) - 1)>(a.lo_, b.lo_),
+        Vectorized<float>::template blend<(mask >> half) & ((int64_t(1) << half) - 1)>(a.hi_, b.hi_));
+  }
+  // mask must come from a comparison of Vectorized<T>.  Masks are float
+  // masks internally and don't survive a store().
+  static Vectorized<T> blendv(const Vectorized<T>& a, const Vectorized<T>& b, const Vectorized<T>& mask) {
+    return Vectorized<T>(
+        Vectorized<float>::blendv(a.lo_, b.lo_, mask.lo_),
+        Vectorized<float>::blendv(a.hi_, b.hi_, mask.hi_));
+  }
+  template <typename step_t>
+  static Vectorized<T> arange(T base = static_cast<T>(0), step_t step = static_cast<step_t>(1)) {
+    C10_VEC_ALIGN T tmp[size()];
+    for (int i = 0; i < size(); i++) {
+      tmp[i] = static_cast<T>(static_cast<float>(base) + i * step);
+    }
+    return loadu(tmp);
+  }
+  static Vectorized<T> set(const Vectorized<T>& a, const Vectorized<T>& b, int64_t count = size()) {
+    constexpr int half = Vectorized<float>::size();
+    if (count <= half) {
+      return Vectorized<T>(Vectorized<float>::set(a.lo_, b.lo_, count), a.hi_);
+    }
+    return Vectorized<T>(b.lo_, Vectorized<float>::set(a.hi_, b.hi_, count - half));
+  }
+  static Vectorized<T> loadu(const void* ptr, int64_t count = size()) {
+    const T* p = reinterpret_cast<const T*>(ptr);
+    if (count == size()) {
+      return Vectorized<T>(load_to_float(p), load_to_float(p + Vectorized<float>::size()));
+    }
+    C10_VEC_ALIGN T tmp[size()] = {};
+    std::memcpy(tmp, ptr, count * sizeof(T));
+    return loadu(tmp);
+  }
+  void store(void* ptr, int64_t count = size()) const {
+    T* p = reinterpret_cast<T*>(ptr);
+    if (count == size()) {
+      store_from_float(lo_, p);
+      store_from_float(hi_, p + Vectorized<float>::size());
+    } else if (count > 0) {
+      C10_VEC_ALIGN T tmp[size()];
+      store(tmp);
+      std::memcpy(ptr, tmp, count * sizeof(T));
+    }
+  }
+  T operator[](int idx) const {
+    constexpr int half = Vectorized<float>::size();
+    return static_cast<T>(idx < half ? lo_[idx] : hi_[idx - half]);
+  }
+  int64_t zero_mask() const {
+    return lo_.zero_mask() | (hi_.zero_mask() << Vectorized<float>::size());
+  }
+  Vectorized<T> isnan() const {
+    return Vectorized<T>(lo_.isnan(), hi_.isnan());
+  }
+  Vectorized<T> map(float (*f)(float)) const {
+    return rounded(lo_.map(f), hi_.map(f));
+  }
+  Vectorized<T> abs() const {
+    return Vectorized<T>(lo_.abs(), hi_.abs());
+  }
+  Vectorized<T> neg() const {
+    return Vectorized<T>(lo_.neg(), hi_.neg());
+  }
+  Vectorized<T> sqrt() const {
+    return rounded(lo_.sqrt(), hi_.sqrt());
+  }
+  Vectorized<T> rsqrt() const {
+    return rounded(lo_.rsqrt(), hi_.rsqrt());
+  }
+  Vectorized<T> reciprocal() const {
+    return rounded(lo_.reciprocal(), hi_.reciprocal());
+  }
+  Vectorized<T> floor() const {
+    return Vectorized<T>(lo_.floor(), hi_.floor());
+  }
+  Vectorized<T> ceil() const {
+    return Vectorized<T>(lo_.ceil(), hi_.ceil());
+  }
+  Vectorized<T> round() const {
+    return Vectorized<T>(lo_.round(), hi_.round());
+  }
+  Vectorized<T> trunc() const {
+    return Vectorized<T>(lo_.trunc(), hi_.trunc());
+  }
+  Vectorized<T> exp() const {
+    return rounded(lo_.exp(), hi_.exp());
+  }
+  Vectorized<T> log() const {
+    return rounded(lo_.log(), hi_.log());
+  }
+  Vectorized<T> tanh() const {
+    return rounded(lo_.tanh(), hi_.tanh());
+  }
+  Vectorized<T> erf() const {
+    return rounded(lo_.erf(), hi_.erf());
+  }
+
+  Vectorized<T> operator==(const Vectorized<T>& other) const {
+    return Vectorized<T>(lo_ == other.lo_, hi_ == other.hi_);
+  }
+  Vectorized<T> operator!=(const Vectorized<T>& other) const {
+    return Vectorized<T>(lo_ != other.lo_, hi_ != other.hi_);
+  }
+  Vectorized<T> operator<(const Vectorized<T>& other) const {
+    return Vectorized<T>(lo_ < other.lo_, hi_ < other.hi_);
+  }
+  Vectorized<T> operator<=(const Vectorized<T>& other) const {
+    return Vectorized<T>(lo_ <= other.lo_, hi_ <= other.hi_);
+  }
+  Vectorized<T> operator>(const Vectorized<T>& other) const {
+    return Vectorized<T>(lo_ > other.lo_, hi_ > other.hi_);
+  }
+  Vectorized<T> operator>=(const Vectorized<T>& other) const {
+    return Vectorized<T>(lo_ >= other.lo_, hi_ >= other.hi_);
+  }
+  Vectorized<T> eq(const Vectorized<T>& other) const {
+    return Vectorized<T>(lo_.eq(other.lo_), hi_.eq(other.hi_));
+  }
+  Vectorized<T> ne(const Vectorized<T>& other) const {
+    return Vectorized<T>(lo_.ne(other.lo_), hi_.ne(other.hi_));
+  }
+  Vectorized<T> gt(const Vectorized<T>& other) const {
+    return Vectorized<T>(lo_.gt(other.lo_), hi_.gt(other.hi_));
+  }
+  Vectorized<T> ge(const Vectorized<T>& other) const {
+    return Vectorized<T>(lo_.ge(other.lo_), hi_.ge(other.hi_));
+  }
+  Vectorized<T> lt(const Vectorized<T>& other) const {
+    return Vectorized<T>(lo_.lt(other.lo_), hi_.lt(other.hi_));
+  }
+  Vectorized<T> le(const Vectorized<T>& other) const {
+    return Vectorized<T>(lo_.le(other.lo_), hi_.le(other.hi_));
+  }
+};
+
+template <>
+class Vectorized<BFloat16> : public VectorizedReducedFloat<BFloat16> {
+ public:
+  using VectorizedReducedFloat<BFloat16>::VectorizedReducedFloat;
+};
+
+template <>
+class Vectorized<Half> : public VectorizedReducedFloat<Half> {
+ public:
+  using VectorizedReducedFloat<Half>::VectorizedReducedFloat;
+};
+
+// Exact ops (abs, neg, comparisons, min / max, bitwise) skip the rounding.
+#define C10_DEFINE_REDUCED_FLOAT_OPS(T)                                                   \
+  template <>                                                                             \
+  Vectorized<T> inline operator+(const Vectorized<T>& a, const Vectorized<T>& b) {        \
+    return Vectorized<T>::from_float(a.lo() + b.lo(), a.hi() + b.hi());                   \
+  }                                                                                       \
+  template <>                                                                             \
+  Vectorized<T> inline operator-(const Vectorized<T>& a, const Vectorized<T>& b) {        \
+    return Vectorized<T>::from_float(a.lo() - b.lo(), a.hi() - b.hi());                   \
+  }                                                                                       \
+  template <>                                                                             \
+  Vectorized<T> inline operator*(const Vectorized<T>& a, const Vectorized<T>& b) {        \
+    return Vectorized<T>::from_float(a.lo() * b.lo(), a.hi() * b.hi());                   \
+  }                                                                                       \
+  template <>                                                                             \
+  Vectorized<T> inline operator/(const Vectorized<T>& a, const Vectorized<T>& b) {        \
+    return Vectorized<T>::from_float(a.lo() / b.lo(), a.hi() / b.hi());                   \
+  }                                                                                       \
+  template <>                                                                             \
+  Vectorized<T> inline operator&(const Vectorized<T>& a, const Vectorized<T>& b) {        \
+    return Vectorized<T>(a.lo() & b.lo(), a.hi() & b.hi());                               \
+  }                                                                                       \
+  template <>                                                                             \
+  Vectorized<T> inline operator|(const Vectorized<T>& a, const Vectorized<T>& b) {        \
+    return Vectorized<T>(a.lo() | b.lo(), a.hi() | b.hi());                               \
+  }                                                                                       \
+  template <>                                                                             \
+  Vectorized<T> inline operator^(const Vectorized<T>& a, const Vectorized<T>& b) {        \
+    return Vectorized<T>(a.lo() ^ b.lo(), a.hi() ^ b.hi());                               \
+  }                                                                                       \
+  template <>                                                                             \
+  Vectorized<T> inline maximum(const Vectorized<T>& a, const Vectorized<T>& b) {          \
+    return Vectorized<T>(maximum(a.lo(), b.lo()), maximum(a.hi(), b.hi()));               \
+  }                                                                                       \
+  template <>                                                                             \
+  Vectorized<T> inline minimum(const Vectorized<T>& a, const Vectorized<T>& b) {          \
+    return Vectorized<T>(minimum(a.lo(), b.lo()), minimum(a.hi(), b.hi()));               \
+  }                                                                                       \
+  template <>                                                                             \
+  Vectorized<T> inline clamp(const Vectorized<T>& a, const Vectorized<T>& min_vec,        \
+                             const Vectorized<T>& max_vec) {                              \
+    return Vectorized<T>(                                                                 \
+        clamp(a.lo(), min_vec.lo(), max_vec.lo()), clamp(a.hi(), min_vec.hi(), max_vec.hi())); \
+  }                                                                                       \
+  template <>                                                                             \
+  Vectorized<T> inline clamp_max(const Vectorized<T>& a, const Vectorized<T>& max_vec) {  \
+    return Vectorized<T>(clamp_max(a.lo(), max_vec.lo()), clamp_max(a.hi(), max_vec.hi())); \
+  }                                                                                       \
+  template <>                                                                             \
+  Vectorized<T> inline clamp_min(const Vectorized<T>& a, const Vectorized<T>& min_vec) {  \
+    return Vectorized<T>(clamp_min(a.lo(), min_vec.lo()), clamp_min(a.hi(), min_vec.hi())); \
+  }                                                                                       \
+  template <>                                                                             \
+  Vectorized<T> inline fmadd(const Vectorized<T>& a, const Vectorized<T>& b,              \
+                             const Vectorized<T>& c) {                                    \
+    return Vectorized<T>::from_float(                                                     \
+        fmadd(a.lo(), b.lo(), c.lo()), fmadd(a.hi(), b.hi(), c.hi()));                    \
+  }
+
+C10_DEFINE_REDUCED_FLOAT_OPS(BFloat16)
+C10_DEFINE_REDUCED_FLOAT_OPS(Half)
+
+#undef C10_DEFINE_REDUCED_FLOAT_OPS
+
+} // namespace CPU_CAPABILITY
+} // namespace vec
+} // namespace c10
@@ -105,6 +105,14 @@
 
 #define C10_RESTRICT __restrict
 
+#if defined(_MSC_VER)
+#define C10_ALWAYS_INLINE __forceinline
+#elif defined(__GNUC__)
+#define C10_ALWAYS_INLINE __attribute__((__always_inline__)) inline
+#else
+#define C10_ALWAYS_INLINE inline
+#endif
+
 // Simply define the namespace, in case a dependent library want to refer to
 // the c10 namespace but not any nontrivial files.
 namespace c10 {} // namespace c10
@@ -149,6 +157,11 @@ namespace at { namespace cuda { using namespace c10::hip; }}
 #define C10_UNLIKELY(expr)  (expr)
 #endif
 
+// Size of a destructive-interference unit, i.e. how far apart two hot atomics
+// must be so that writing one does not invalidate the other in other cores'
+// caches.  64 bytes holds for every x86 and most ARM server parts.
+#define C10_CACHE_LINE_SIZE 64
+
 #include <sstream>
 #include <string>
 
@@ -0,0 +1,340 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/ConvOps.h>
+#include <c10/core/MemoryFormatOps.h>
+#include <c10/test/util/parallel_test_util.h>
+#include <c10/util/Exception.h>
+#include <c10/util/Parallel.h>
+
+#include <cmath>
+#include <vector>
+
+using namespace c10;
+
+namespace {
+
+// A dense tensor of the given layout with values in [-1, 1)
+Tensor random_tensor(IntArrayRef sizes, uint32_t seed, MemoryFormat memory_format) {
+  Tensor t = empty(sizes, ScalarType::Float);
+  float* data = t.data_ptr<float>();
+  for (int64_t i = 0; i < t.numel(); i++) {
+    seed = seed * 1664525u + 1013904223u;
+    data[i] = static_cast<float>(seed >> 8) / (1 << 23) - 1.f;
+  }
+  return contiguous(t, memory_format);
+}
+
+struct Case {
+  int64_t batch;
+  int64_t in_channels;
+  int64_t out_channels;
+  int64_t groups;
+  std::vector<int64_t> input;
+  std::vector<int64_t> kernel;
+  std::vector<int64_t> stride;
+  std::vector<int64_t> padding;
+  std::vector<int64_t> dilation;
+
+  int64_t spatial() const {
+    return input.size();
+  }
+  // parameters of dimension i of 3, 2-d cases having a depth of 1
+  int64_t value(const std::vector<int64_t>& v, int64_t i, int64_t fill) const {
+    const int64_t j = i - (3 - spatial());
+    if (j < 0) {
+      return fill;
+    }
+    return v.size() == 1 ? v[0] : v[j];
+  }
+  std::vector<int64_t> input_sizes() const {
+    std::vector<int64_t> sizes = {batch, in_channels};
+    sizes.insert(sizes.end(), input.begin(), input.end());
+    return sizes;
+  }
+  std::vector<int64_t> weight_sizes() const {
+    std::vector<int64_t> sizes = {out_channels, in_channels / groups};
+    sizes.insert(sizes.end(), kernel.begin(), kernel.end());
+    return sizes;
+  }
+  MemoryFormat channels_last() const {
+    return spatial() == 2 ? MemoryFormat::ChannelsLast : MemoryFormat::ChannelsLast3d;
+  }
+};
+
+// The reference, in double, of the forward pass and of both gradients
+struct Reference {
+  Case c;
+  int64_t in[3];
+  int64_t out[3];
+  int64_t k[3];
+  int64_t stride[3];
+  int64_t padding[3];
+  int64_t dilation[3];
+
+  explicit Reference(const Case& c) : c(c) {
+    for (int64_t i = 0; i < 3; i++) {
+      in[i] = c.value(c.input, i, 1);
+      k[i] = c.value(c.kernel, i, 1);
+      stride[i] = c.value(c.stride, i, 1);
+      padding[i] = c.value(c.padding, i, 0);
+      dilation[i] = c.value(c.dilation, i, 1);
+      out[i] = (in[i] + 2 * padding[i] - dilation[i] * (k[i] - 1) - 1) / stride[i] + 1;
+    }
+  }
+
+  // Calls fn(n, oc, ic, o[3], i[3], t[3]) for every product of the
+  // convolution
+  template <typename F>
+  void for_each_product(const F& fn) const {
+    const int64_t icg = c.in_channels / c.groups;
+    const int64_t ocg = c.out_channels / c.groups;
+    int64_t o[3];
+    int64_t i[3];
+    int64_t t[3];
+    for (int64_t n = 0; n < c.batch; n++) {
+      for (int64_t oc = 0; oc < c.out_channels; oc++) {
+        const int64_t g = oc / ocg;
+        for (o[0] = 0; o[0] < out[0]; o[0]++) {
+          for (o[1] = 0; o[1] < out[1]; o[1]++) {
+            for (o[2] = 0; o[2] < out[2]; o[2]++) {
+              for (int64_t ic = g * icg; ic < (g + 1) * icg; ic++) {
+                for (t[0] = 0; t[0] < k[0]; t[0]++) {
+                  for (t[1] = 0; t[1] < k[1]; t[1]++) {
+                    for (t[2] = 0; t[2] < k[2]; t[2]++) {
+                      bool inside = true;
+                      for (int d = 0; d < 3; d++) {
+                        i[d] = o[d] * stride[d] - padding[d] + t[d] * dilation[d];
+                        inside = inside && i[d] >= 0 && i[d] < in[d];
+                      }
+                      if (inside) {
+                        fn(n, oc, ic - g * icg, ic, o, i, t);
+                      }
+                    }
+                  }
+                }
+              }
+            }
+          }
+        }
+      }
+    }
+  }
+};
+
+// Checks actual against expected, where the sums of the absolute values of
+// the products are scale
+void expect_close(
+    const Tensor& actual,
+    const std::vector<double>& expected,
+    const std::vector<double>& scale,
+    const char* what) {
+  // expected and scale are dense [n][c][d][h][w]
+  const Tensor dense = contiguous(actual);
+  const float* data = dense.data_ptr<float>();
+  ASSERT_EQ(static_cast<size_t>(dense.numel()), expected.size()) << what;
+  for (size_t i = 0; i < expected.size(); i++) {
+    ASSERT_NEAR(data[i], expected[i], 1e-5 * scale[i] + 1e-6) << what << " at " << i;
+  }
+}
+
+void check_case(const Case& c, bool with_bias) {
+  const Reference ref(c);
+  for (MemoryFormat memory_format : {MemoryFormat::Contiguous, c.channels_last()}) {
+    const Tensor input = random_tensor(c.input_sizes(), 1, memory_format);
+    const Tensor weight = random_tensor(c.weight_sizes(), 2, memory_format);
+    const Tensor bias =
+        with_bias ? random_tensor({c.out_channels}, 3, MemoryFormat::Contiguous) : Tensor();
+    const Tensor output =
+        convolution(input, weight, bias, c.stride, c.padding, c.dilation, c.groups);
+    EXPECT_TRUE(output.is_contiguous(c.channels_last()));
+    std::vector<int64_t> out_sizes = {c.batch, c.out_channels};
+    for (int64_t i = 3 - c.spatial(); i < 3; i++) {
+      out_sizes.push_back(ref.out[i]);
+    }
+    ASSERT_EQ(output.sizes(), IntArrayRef(out_sizes));
+
+    const int64_t out_numel = output.numel();
+    const int64_t out_positions = ref.out[0] * ref.out[1] * ref.out[2];
+    const int64_t in_positions = ref.in[0] * ref.in[1] * ref.in[2];
+    const int64_t taps = ref.k[0] * ref.k[1] * ref.k[2];
+    const int64_t icg = c.in_channels / c.groups;
+    auto out_index = [&](int64_t n, int64_t oc, const int64_t* o) {
+      return ((n * c.out_channels + oc) * ref.out[0] + o[0]) * ref.out[1] * ref.out[2] +
+          o[1] * ref.out[2] + o[2];
+    };
+    auto in_index = [&](int64_t n, int64_t ic, const int64_t* i) {
+      return ((n * c.in_channels + ic) * in_positions) + (i[0] * ref.in[1] + i[1]) * ref.in[2] +
+          i[2];
+    };
+    auto w_index = [&](int64_t oc, int64_t icg_index, const int64_t* t) {
+      return (oc * icg + icg_index) * taps + (t[0] * ref.k[1] + t[1]) * ref.k[2] + t[2];
+    };
+    const Tensor input_dense = contiguous(input);
+    const Tensor weight_dense = contiguous(weight);
+    const float* x = input_dense.data_ptr<float>();
+    const float* w = weight_dense.data_ptr<float>();
+
+    // forward
+    std::vector<double> y(out_numel, 0);
+    std::vector<double> y_scale(out_numel, 0);
+    if (with_bias) {
+      for (int64_t n = 0; n < c.batch; n++) {
+        for (int64_t oc = 0; oc < c.out_channels; oc++) {
+          for (int64_t q = 0; q < out_positions; q++) {
+            const int64_t index = (n * c.out_channels + oc) * out_positions + q;
+            y[index] = bias.data_ptr<float>()[oc];
+            y_scale[index] = std::abs(y[index]);
+          }
+        }
+      }
+    }
+    ref.for_each_product([&](int64_t n, int64_t oc, int64_t icg_index, int64_t ic,
+                             const int64_t* o, const int64_t* i, const int64_t* t) {
+      const double product =
+          static_cast<double>(x[in_index(n, ic, i)]) * w[w_index(oc, icg_index, t)];
+      y[out_index(n, oc, o)] += product;
+      y_scale[out_index(n, oc, o)] += std::abs(product);
+    });
+    expect_close(output, y, y_scale, "output");
+
+    // gradients, for a grad_output of the layout of the input
+    const Tensor grad_output = random_tensor(out_sizes, 4, memory_format);
+    const Tensor go_dense = contiguous(grad_output);
+    const float* go = go_dense.data_ptr<float>();
+    std::vector<double> gx(input.numel(), 0);
+    std::vector<double> gx_scale(input.numel(), 0);
+    std::vector<double> gw(weight.numel(), 0);
+    std::vector<double> gw_scale(weight.numel(), 0);
+    ref.for_each_product([&](int64_t n, int64_t oc, int64_t icg_index, int64_t ic,
+                             const int64_t* o, const int64_t* i, const int64_t* t) {
+      const double g = go[out_index(n, oc, o)];
+      const double px = g * w[w_index(oc, icg_index, t)];
+      gx[in_index(n, ic, i)] += px;
+      gx_scale[in_index(n, ic, i)] += std::abs(px);
+      const double pw = g * x[in_index(n, ic, i)];
+      gw[w_index(oc, icg_index, t)] += pw;
+      gw_scale[w_index(oc, icg_index, t)] += std::abs(pw);
+    });
+    const Tensor grad_input = convolution_backward_input(
+        c.input_sizes(), grad_output, weight, c.stride, c.padding, c.dilation, c.groups);
+    EXPECT_TRUE(grad_input.is_contiguous(c.channels_last()));
+    expect_close(grad_input, gx, gx_scale, "grad_input");
+    const Tensor grad_weight = convolution_backward_weight(
+        c.weight_sizes(), grad_output, input, c.stride, c.padding, c.dilation, c.groups);
+    ASSERT_EQ(grad_weight.sizes(), IntArrayRef(c.weight_sizes()));
+    expect_close(grad_weight, gw, gw_scale, "grad_weight");
+  }
+}
+
+class ConvOpsTest : public c10::test::ParallelFixture {};
+
+// Reductions deeper than 64 values: im2col + GEMM
+TEST_F(ConvOpsTest, Im2col) {
+  check_case({2, 16, 20, 1, {9, 9}, {3, 3}, {1}, {1}, {1}}, true);
+  check_case({3, 32, 12, 2, {11, 8}, {3, 2}, {2, 1}, {1, 0}, {2, 1}}, false);
+  check_case({1, 8, 70, 1, {40, 3}, {5, 3}, {3}, {2}, {1}}, true);
+}
+
+// 1 x 1, stride 1, no padding: a single GEMM
+TEST_F(ConvOpsTest, Pointwise) {
+  check_case({2, 24, 10, 2, {5, 7}, {1, 1}, {1}, {0}, {1}}, true);
+  check_case({3, 5, 33, 1, {4, 4}, {1, 1}, {1}, {0}, {3}}, false);
+  // strided 1 x 1 goes through the direct kernel
+  check_case({2, 24, 10, 1, {5, 7}, {1, 1}, {2}, {0}, {1}}, true);
+}
+
+// Shallow reductions: the direct kernel
+TEST_F(ConvOpsTest, Direct) {
+  check_case({2, 3, 40, 1, {13, 10}, {3, 3}, {2}, {1}, {1}}, true);
+  check_case({1, 4, 6, 2, {6, 9}, {3, 5}, {1, 2}, {2, 1}, {1, 2}}, false);
+  check_case({3, 1, 70, 1, {7, 7}, {7, 7}, {1}, {3}, {1}}, true);
+}
+
+TEST_F(ConvOpsTest, Depthwise) {
+  check_case({2, 37, 37, 37, {9, 8}, {3, 3}, {1}, {1}, {1}}, true);
+  check_case({1, 70, 70, 70, {12, 11}, {5, 3}, {2, 1}, {2, 1}, {1, 2}}, false);
+}
+
+TEST_F(ConvOpsTest, ThreeDimensional) {
+  check_case({2, 5, 7, 1, {4, 5, 6}, {2, 3, 3}, {1, 2, 1}, {1}, {1}}, true);
+  check_case({1, 3, 16, 1, {5, 6, 4}, {3, 3, 3}, {2}, {1}, {1}}, false);
+  check_case({1, 20, 20, 20, {4, 5, 6}, {3, 3, 3}, {1}, {1}, {1}}, true);
+  check_case({2, 8, 4, 1, {3, 3, 3}, {1, 1, 1}, {1}, {0}, {1}}, false);
+}
+
+TEST_F(ConvOpsTest, ResultsDoNotDependOnThreadCount) {
+  const std::vector<Case> cases = {
+      {4, 32, 24, 1, {14, 14}, {3, 3}, {1}, {1}, {1}},
+      {4, 48, 48, 48, {14, 14}, {3, 3}, {1}, {1}, {1}},
+      {4, 3, 24, 1, {14, 14}, {3, 3}, {1}, {1}, {1}}};
+  for (const Case& c : cases) {
+    const Tensor input = random_tensor(c.input_sizes(), 1, c.channels_last());
+    const Tensor weight = random_tensor(c.weight_sizes(), 2, c.channels_last());
+    std::vector<Tensor> results[2];
+    for (int threads : {1, 4}) {
+      set_num_threads(threads);
+      const Tensor output =
+          convolution(input, weight, Tensor(), c.stride, c.padding, c.dilation, c.groups);
+      results[threads == 4].push_back(output);
+      results[threads == 4].push_back(convolution_backward_input(
+          c.input_sizes(), output, weight, c.stride, c.padding, c.dilation, c.groups));
+      results[threads == 4].push_back(convolution_backward_weight(
+          c.weight_sizes(), output, input, c.stride, c.padding, c.dilation, c.groups));
+    }
+    for (size_t i = 0; i < results[0].size(); i++) {
+      const float* a = results[0][i].data_ptr<float>();
+      const float* b = results[1][i].data_ptr<float>();
+      for (int64_t j = 0; j < results[0][i].numel(); j++) {
+        ASSERT_EQ(a[j], b[j]) << "result " << i;
+      }
+    }
+  }
+}
+
+TEST_F(ConvOpsTest, EmptyBatch) {
+  const Tensor input = empty({0, 4, 5, 5}, ScalarType::Float);
+  const Tensor weight = random_tensor({6, 4, 3, 3}, 1, MemoryFormat::Contiguous);
+  const Tensor output = convolution(input, weight, Tensor(), {1}, {0}, {1}, 1);
+  EXPECT_EQ(output.sizes(), IntArrayRef({0, 6, 3, 3}));
+  const Tensor grad_weight =
+      convolution_backward_weight({6, 4, 3, 3}, output, input, {1}, {0}, {1}, 1);
+  const Tensor dense = contiguous(grad_weight);
+  for (int64_t i = 0; i < dense.numel(); i++) {
+    ASSERT_EQ(dense.data_ptr<float>()[i], 0.f);
+  }
+}
+
+TEST_F(ConvOpsTest, InvalidArguments) {
+  const Tensor input = random_tensor({1, 4, 5, 5}, 1, MemoryFormat::Contiguous);
+  const Tensor weight = random_tensor({6, 4, 3, 3}, 2, MemoryFormat::Contiguous);
+  // channels, groups
+  EXPECT_THROW(convolution(input, weight, Tensor(), {1}, {0}, {1}, 2), c10::Error);
+  EXPECT_THROW(
+      convolution(
+          input, random_tensor({6, 2, 3, 3}, 2, MemoryFormat::Contiguous), Tensor(), {1}, {0},
+          {1}, 4),
+      c10::Error);
+  // parameters
+  EXPECT_THROW(convolution(input, weight, Tensor(), {0}, {0}, {1}, 1), c10::Error);
+  EXPECT_THROW(convolution(input, weight, Tensor(), {1}, {-1}, {1}, 1), c10::Error);
+  EXPECT_THROW(convolution(input, weight, Tensor(), {1, 1, 1}, {0}, {1}, 1), c10::Error);
+  EXPECT_THROW(convolution(input, weight, Tensor(), {1}, {0}, {3}, 1), c10::Error);
+  // bias, dtype, dims
+  EXPECT_THROW(
+      convolution(
+          input, weight, random_tensor({5}, 3, MemoryFormat::Contiguous), {1}, {0}, {1}, 1),
+      c10::Error);
+  EXPECT_THROW(
+      convolution(empty({1, 4, 5, 5}, ScalarType::Double), weight, Tensor(), {1}, {0}, {1}, 1),
+      c10::Error);
+  EXPECT_THROW(
+      convolution(empty({4, 5, 5}, ScalarType::Float), weight, Tensor(), {1}, {0}, {1}, 1),
+      c10::Error);
+  // grad_output sizes
+  EXPECT_THROW(
+      convolution_backward_input(
+          {1, 4, 5, 5}, empty({1, 6, 4, 3}, ScalarType::Float), weight, {1}, {0}, {1}, 1),
+      c10::Error);
+}
+
+} // namespace
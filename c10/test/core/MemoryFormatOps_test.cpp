@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/MemoryFormatOps.h>
+#include <c10/test/util/parallel_test_util.h>
+
+#include <cstring>
+#include <vector>
+
+using namespace c10;
+
+namespace {
+
+// Distinct byte patterns for every byte of every element
+std::vector<unsigned char> pattern(size_t nbytes) {
+  std::vector<unsigned char> bytes(nbytes);
+  for (size_t i = 0; i < nbytes; i++) {
+    bytes[i] = static_cast<unsigned char>((i * 131 + i / 251) & 0xff);
+  }
+  return bytes;
+}
+
+// dst[b][s][c] = src[b][c][s], by elements of itemsize bytes
+std::vector<unsigned char> reference_first_to_last(
+    const std::vector<unsigned char>& src,
+    int64_t batch,
+    int64_t channels,
+    int64_t spatial,
+    size_t itemsize) {
+  std::vector<unsigned char> dst(src.size());
+  for (int64_t b = 0; b < batch; b++) {
+    for (int64_t c = 0; c < channels; c++) {
+      for (int64_t s = 0; s < spatial; s++) {
+        std::memcpy(
+            &dst[((b * spatial + s) * channels + c) * itemsize],
+            &src[((b * channels + c) * spatial + s) * itemsize], itemsize);
+      }
+    }
+  }
+  return dst;
+}
+
+class MemoryFormatOpsTest : public c10::test::ParallelFixture {};
+
+// Sizes around the 4 x 4 and 8 x 8 SIMD tiles and the cache tiles
+TEST_F(MemoryFormatOpsTest, EveryElementSize) {
+  const std::vector<std::vector<int64_t>> shapes = {
+      {1, 3, 5},   {2, 8, 8},   {1, 16, 16}, {3, 7, 33}, {1, 64, 64}, {2, 65, 129},
+      {1, 1, 50},  {2, 30, 1},  {1, 200, 3}, {0, 4, 4},  {2, 0, 4}};
+  for (size_t itemsize = 1; itemsize <= 16; itemsize++) {
+    for (const auto& shape : shapes) {
+      const int64_t batch = shape[0];
+      const int64_t channels = shape[1];
+      const int64_t spatial = shape[2];
+      const auto src = pattern(batch * channels * spatial * itemsize);
+      const auto expected = reference_first_to_last(src, batch, channels, spatial, itemsize);
+      std::vector<unsigned char> last(src.size());
+      channels_first_to_last(src.data(), last.data(), batch, channels, spatial, itemsize);
+      ASSERT_EQ(last, expected) << "itemsize " << itemsize << " channels " << channels
+                                << " spatial " << spatial;
+      std::vector<unsigned char> first(src.size());
+      channels_last_to_first(last.data(), first.data(), batch, channels, spatial, itemsize);
+      ASSERT_EQ(first, src) << "itemsize " << itemsize << " channels " << channels << " spatial "
+                            << spatial;
+    }
+  }
+}
+
+TEST_F(MemoryFormatOpsTest, LargeInputsSplitAcrossThreads) {
+  for (size_t itemsize : {1, 2, 4, 8, 16}) {
+    const int64_t batch = 3;
+    const int64_t channels = 96;
+    const int64_t spatial = 57 * 61;
+    const auto src = pattern(batch * channels * spatial * itemsize);
+    std::vector<unsigned char> last(src.size());
+    channels_first_to_last(src.data(), last.data(), batch, channels, spatial, itemsize);
+    EXPECT_EQ(last, reference_first_to_last(src, batch, channels, spatial, itemsize))
+        << "itemsize " << itemsize;
+  }
+}
+
+TEST_F(MemoryFormatOpsTest, InvalidArguments) {
+  char buffer[16] = {};
+  EXPECT_THROW(channels_first_to_last(buffer, buffer + 8, 1, 2, 2, 0), c10::Error);
+  EXPECT_THROW(channels_first_to_last(buffer, buffer + 8, 1, 2, 2, 17), c10::Error);
+  EXPECT_THROW(channels_last_to_first(buffer, buffer + 8, 1, -2, 2, 1), c10::Error);
+}
+
+Tensor iota_tensor(IntArrayRef sizes, ScalarType dtype) {
+  Tensor t = empty(sizes, dtype);
+  auto* bytes = static_cast<unsigned char*>(t.data_ptr());
+  const auto p = pattern(t.nbytes());
+  std::copy(p.begin(), p.end(), bytes);
+  return t;
+}
+
+// The bytes of element (i0, i1, ...) at the same indices in both tensors
+void expect_same_elements(const Tensor& a, const Tensor& b) {
+  ASSERT_EQ(a.sizes(), b.sizes());
+  const int64_t ndim = a.dim();
+  std::vector<int64_t> index(ndim, 0);
+  for (int64_t i = 0; i < a.numel(); i++) {
+    int64_t offset_a = 0;
+    int64_t offset_b = 0;
+    for (int64_t d = 0; d < ndim; d++) {
+      offset_a += index[d] * a.stride(d);
+      offset_b += index[d] * b.stride(d);
+    }
+    ASSERT_EQ(
+        std::memcmp(
+            static_cast<const char*>(a.data_ptr()) + offset_a * a.itemsize(),
+            static_cast<const char*>(b.data_ptr()) + offset_b * b.itemsize(), a.itemsize()),
+        0)
+        << "element " << i;
+    for (int64_t d = ndim - 1; d >= 0; d--) {
+      if (++index[d] < a.size(d)) {
+        break;
+      }
+      index[d] = 0;
+    }
+  }
+}
+
+TEST_F(MemoryFormatOpsTest, TensorRoundTrips) {
+  for (ScalarType dtype :
+       {ScalarType::Byte, ScalarType::Half, ScalarType::Float, ScalarType::Double,
+        ScalarType::ComplexDouble}) {
+    const Tensor x = iota_tensor({2, 19, 9, 11}, dtype);
+    const Tensor nhwc = contiguous(x, MemoryFormat::ChannelsLast);
+    EXPECT_TRUE(nhwc.is_contiguous(MemoryFormat::ChannelsLast));
+    expect_same_elements(x, nhwc);
+    const Tensor nchw = contiguous(nhwc);
+    EXPECT_TRUE(nchw.is_contiguous());
+    expect_same_elements(x, nchw);
+
+    const Tensor y = iota_tensor({2, 5, 3, 7, 6}, dtype);
+    const Tensor ndhwc = contiguous(y, MemoryFormat::ChannelsLast3d);
+    EXPECT_TRUE(ndhwc.is_contiguous(MemoryFormat::ChannelsLast3d));
+    expect_same_elements(y, ndhwc);
+    expect_same_elements(y, contiguous(ndhwc));
+  }
+}
+
+TEST_F(MemoryFormatOpsTest, AlreadyInFormatIsReturnedAsIs) {
+  const Tensor x = iota_tensor({2, 3, 4, 5}, ScalarType::Float);
+  EXPECT_TRUE(contiguous(x).is_same(x));
+  const Tensor nhwc = contiguous(x, MemoryFormat::ChannelsLast);
+  EXPECT_FALSE(nhwc.is_same(x));
+  EXPECT_TRUE(contiguous(nhwc, MemoryFormat::ChannelsLast).is_same(nhwc));
+}
+
+TEST_F(MemoryFormatOpsTest, OtherStridesAreCopied) {
+  // a view with H and W swapped is in neither layout
+  const Tensor x = iota_tensor({2, 3, 4, 5}, ScalarType::Short);
+  const Tensor view = x.as_strided({2, 3, 5, 4}, {60, 20, 1, 5});
+  for (MemoryFormat format : {MemoryFormat::Contiguous, MemoryFormat::ChannelsLast}) {
+    const Tensor y = contiguous(view, format);
+    EXPECT_TRUE(y.is_contiguous(format));
+    expect_same_elements(view, y);
+  }
+  const Tensor m = iota_tensor({6, 7}, ScalarType::Int);
+  const Tensor t = m.as_strided({7, 6}, {1, 7});
+  expect_same_elements(t, contiguous(t));
+}
+
+TEST_F(MemoryFormatOpsTest, InvalidFormats) {
+  const Tensor x = empty({2, 3, 4}, ScalarType::Float);
+  EXPECT_THROW(contiguous(x, MemoryFormat::ChannelsLast), c10::Error);
+  EXPECT_THROW(contiguous(x, MemoryFormat::ChannelsLast3d), c10::Error);
+  EXPECT_THROW(contiguous(x, MemoryFormat::Preserve), c10::Error);
+}
+
+} // namespace
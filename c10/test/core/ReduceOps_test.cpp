@@ -0,0 +1,488 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/ReduceOps.h>
+#include <c10/test/util/parallel_test_util.h>
+#include <c10/util/BFloat16.h>
+#include <c10/util/Half.h>
+#include <c10/util/Parallel.h>
+
+#include <cmath>
+#include <functional>
+#include <limits>
+#include <vector>
+
+using namespace c10;
+
+namespace {
+
+template <typename T>
+double to_double(T x) {
+  return static_cast<double>(x);
+}
+double to_double(Half x) {
+  return static_cast<float>(x);
+}
+double to_double(BFloat16 x) {
+  return static_cast<float>(x);
+}
+
+double get(const Tensor& t, int64_t offset) {
+  switch (t.scalar_type()) {
+#define GET_CASE(type, name) \
+    case ScalarType::name:   \
+      return to_double(t.data_ptr<type>()[offset]);
+    AT_FORALL_SCALAR_TYPES_AND2(Half, BFloat16, GET_CASE)
+#undef GET_CASE
+    default:
+      throw std::runtime_error("unexpected dtype");
+  }
+}
+
+void set(const Tensor& t, int64_t offset, double value) {
+  switch (t.scalar_type()) {
+#define SET_CASE(type, name)                                 \
+    case ScalarType::name:                                   \
+      t.data_ptr<type>()[offset] = static_cast<type>(value); \
+      break;
+    AT_FORALL_SCALAR_TYPES_AND2(Half, BFloat16, SET_CASE)
+#undef SET_CASE
+    default:
+      throw std::runtime_error("unexpected dtype");
+  }
+}
+
+// Calls fn(logical_index, offset) on the elements of t in row-major order
+void for_each_element(const Tensor& t, const std::function<void(int64_t, int64_t)>& fn) {
+  const int64_t ndim = t.dim();
+  std::vector<int64_t> index(ndim, 0);
+  for (int64_t i = 0; i < t.numel(); i++) {
+    int64_t offset = 0;
+    for (int64_t d = 0; d < ndim; d++) {
+      offset += index[d] * t.stride(d);
+    }
+    fn(i, offset);
+    for (int64_t d = ndim - 1; d >= 0; d--) {
+      if (++index[d] < t.size(d)) {
+        break;
+      }
+      index[d] = 0;
+    }
+  }
+}
+
+// A tensor of sizes whose elements are value(i), i being the row-major index
+Tensor make(IntArrayRef sizes, ScalarType dtype, const std::function<double(int64_t)>& value) {
+  Tensor t = empty(sizes, dtype);
+  for_each_element(t, [&](int64_t i, int64_t offset) { set(t, offset, value(i)); });
+  return t;
+}
+
+// Swaps dims 0 and 1 of t's strides without moving the data: a transposed,
+// non-contiguous view
+Tensor transposed(const Tensor& t) {
+  std::vector<int64_t> sizes(t.sizes().begin(), t.sizes().end());
+  std::vector<int64_t> strides(t.strides().begin(), t.strides().end());
+  std::swap(sizes[0], sizes[1]);
+  std::swap(strides[0], strides[1]);
+  return t.as_strided(sizes, strides);
+}
+
+std::vector<double> values(const Tensor& t) {
+  std::vector<double> result;
+  for_each_element(t, [&](int64_t, int64_t offset) { result.push_back(get(t, offset)); });
+  return result;
+}
+
+enum class Op { Sum, Mean, Prod, Max, Min, ArgMax, Norm };
+
+// Naive reduction in double of the dims of x marked in reduced, the outputs
+// in row-major order
+std::vector<double> reference(
+    const Tensor& x,
+    const std::vector<bool>& reduced,
+    Op op,
+    double p = 2) {
+  const int64_t ndim = x.dim();
+  int64_t out_numel = 1;
+  int64_t rnumel = 1;
+  for (int64_t d = 0; d < ndim; d++) {
+    (reduced[d] ? rnumel : out_numel) *= x.size(d);
+  }
+  std::vector<std::vector<double>> groups(out_numel);
+  std::vector<int64_t> index(ndim, 0);
+  for (double v : values(x)) {
+    int64_t out = 0;
+    for (int64_t d = 0; d < ndim; d++) {
+      if (!reduced[d]) {
+        out = out * x.size(d) + index[d];
+      }
+    }
+    groups[out].push_back(v);
+    for (int64_t d = ndim - 1; d >= 0; d--) {
+      if (++index[d] < x.size(d)) {
+        break;
+      }
+      index[d] = 0;
+    }
+  }
+  std::vector<double> result;
+  for (const auto& g : groups) {
+    double r = 0;
+    switch (op) {
+      case Op::Sum:
+      case Op::Mean:
+        for (double v : g) {
+          r += v;
+        }
+        r = op == Op::Mean ? r / rnumel : r;
+        break;
+      case Op::Prod:
+        r = 1;
+        for (double v : g) {
+          r *= v;
+        }
+        break;
+      case Op::Max:
+        r = -std::numeric_limits<double>::infinity();
+        for (double v : g) {
+          r = std::max(r, v);
+        }
+        break;
+      case Op::Min:
+        r = std::numeric_limits<double>::infinity();
+        for (double v : g) {
+          r = std::min(r, v);
+        }
+        break;
+      case Op::ArgMax:
+        for (size_t i = 1; i < g.size(); i++) {
+          if (g[i] > g[static_cast<size_t>(r)]) {
+            r = static_cast<double>(i);
+          }
+        }
+        break;
+      case Op::Norm:
+        if (p == 0) {
+          for (double v : g) {
+            r += v != 0;
+          }
+        } else if (std::isinf(p)) {
+          r = p > 0 ? 0 : std::numeric_limits<double>::infinity();
+          for (double v : g) {
+            r = p > 0 ? std::max(r, std::abs(v)) : std::min(r, std::abs(v));
+          }
+        } else {
+          for (double v : g) {
+            r += std::pow(std::abs(v), p);
+          }
+          r = std::pow(r, 1 / p);
+        }
+        break;
+    }
+    result.push_back(r);
+  }
+  return result;
+}
+
+std::vector<int64_t> dims_of(const std::vector<bool>& reduced) {
+  std::vector<int64_t> dims;
+  for (size_t d = 0; d < reduced.size(); d++) {
+    if (reduced[d]) {
+      dims.push_back(static_cast<int64_t>(d));
+    }
+  }
+  return dims;
+}
+
+std::vector<int64_t> expected_sizes(
+    const Tensor& x,
+    const std::vector<bool>& reduced,
+    bool keepdim) {
+  std::vector<int64_t> sizes;
+  for (int64_t d = 0; d < x.dim(); d++) {
+    if (!reduced[d]) {
+      sizes.push_back(x.size(d));
+    } else if (keepdim) {
+      sizes.push_back(1);
+    }
+  }
+  return sizes;
+}
+
+void expect_close(
+    const Tensor& result,
+    const std::vector<double>& expected,
+    double rtol,
+    const std::string& what) {
+  const auto actual = values(result);
+  ASSERT_EQ(actual.size(), expected.size()) << what;
+  for (size_t i = 0; i < actual.size(); i++) {
+    const double tol = rtol * std::max(1.0, std::abs(expected[i]));
+    ASSERT_NEAR(actual[i], expected[i], tol) << what << " at " << i;
+  }
+}
+
+// Every subset of the dims of a few shapes, contiguous and transposed,
+// against the reference.  Shapes with a dim of 8 or 16 floats exercise the
+// vector paths of both the inner and the outer reductions.
+TEST(ReduceOpsTest, FloatMatchesReferenceOverAllDims) {
+  const std::vector<std::vector<int64_t>> shapes = {
+      {5, 7, 9}, {3, 16, 33}, {4, 1, 17}, {2, 3, 2, 40}};
+  for (const auto& shape : shapes) {
+    const Tensor base = make(shape, ScalarType::Float, [](int64_t i) {
+      return std::sin(static_cast<double>(i)) * 3;
+    });
+    for (const Tensor& x : {base, transposed(base)}) {
+      for (int mask = 0; mask < (1 << x.dim()); mask++) {
+        std::vector<bool> reduced(x.dim());
+        for (int64_t d = 0; d < x.dim(); d++) {
+          reduced[d] = (mask >> d) & 1;
+        }
+        const auto dims = dims_of(reduced);
+        if (dims.empty()) {
+          continue; // an empty list means all of them
+        }
+        for (bool keepdim : {false, true}) {
+          const std::string what = "sizes " + std::to_string(x.size(0)) + "x" +
+              std::to_string(x.size(1)) + " mask " + std::to_string(mask) + " keepdim " +
+              std::to_string(keepdim);
+          const Tensor s = sum(x, dims, keepdim);
+          EXPECT_EQ(s.sizes(), IntArrayRef(expected_sizes(x, reduced, keepdim))) << what;
+          EXPECT_TRUE(s.is_contiguous());
+          expect_close(s, reference(x, reduced, Op::Sum), 1e-5, "sum " + what);
+          expect_close(
+              mean(x, dims, keepdim), reference(x, reduced, Op::Mean), 1e-5, "mean " + what);
+          expect_close(amax(x, dims, keepdim), reference(x, reduced, Op::Max), 0, "amax " + what);
+          expect_close(amin(x, dims, keepdim), reference(x, reduced, Op::Min), 0, "amin " + what);
+          for (double p : {0.0, 1.0, 2.0, 3.0, std::numeric_limits<double>::infinity(),
+                           -std::numeric_limits<double>::infinity()}) {
+            expect_close(
+                norm(x, p, dims, keepdim), reference(x, reduced, Op::Norm, p), 1e-5,
+                "norm " + std::to_string(p) + " " + what);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST(ReduceOpsTest, Prod) {
+  const Tensor base =
+      make({6, 5, 4}, ScalarType::Double, [](int64_t i) { return 0.5 + (i % 7) * 0.25; });
+  for (const Tensor& x : {base, transposed(base)}) {
+    expect_close(prod(x, {1}), reference(x, {false, true, false}, Op::Prod), 1e-12, "prod dim 1");
+    expect_close(
+        prod(x, {0, 2}), reference(x, {true, false, true}, Op::Prod), 1e-12, "prod dims 0, 2");
+    expect_close(prod(x), reference(x, {true, true, true}, Op::Prod), 1e-12, "prod");
+  }
+}
+
+TEST(ReduceOpsTest, ArgMaxIsTheFirstRowMajorMaximum) {
+  // few distinct values, so that there are many ties
+  const Tensor base = make({6, 9, 5}, ScalarType::Float, [](int64_t i) { return (i * 7) % 5; });
+  for (const Tensor& x : {base, transposed(base)}) {
+    for (int64_t d = 0; d < 3; d++) {
+      std::vector<bool> reduced(3, false);
+      reduced[d] = true;
+      const Tensor a = argmax(x, d);
+      EXPECT_EQ(a.scalar_type(), ScalarType::Long);
+      expect_close(a, reference(x, reduced, Op::ArgMax), 0, "argmax dim " + std::to_string(d));
+      EXPECT_EQ(argmax(x, d - 3, true).sizes(), IntArrayRef(expected_sizes(x, reduced, true)));
+    }
+    const Tensor all = argmax(x);
+    EXPECT_EQ(all.dim(), 0);
+    expect_close(all, reference(x, {true, true, true}, Op::ArgMax), 0, "argmax");
+  }
+}
+
+// Every dtype, with small integer values that every dtype represents exactly
+TEST(ReduceOpsTest, AllDtypes) {
+  const std::vector<ScalarType> dtypes = {
+      ScalarType::Byte,
+      ScalarType::Char,
+      ScalarType::Short,
+      ScalarType::Int,
+      ScalarType::Long,
+      ScalarType::Float,
+      ScalarType::Double,
+      ScalarType::Half,
+      ScalarType::BFloat16};
+  for (ScalarType dtype : dtypes) {
+    const std::string what = toString(dtype);
+    const Tensor base = make({7, 37, 3}, dtype, [](int64_t i) { return (i * 13) % 11; });
+    for (const Tensor& x : {base, transposed(base)}) {
+      const Tensor s = sum(x, {1});
+      EXPECT_EQ(s.scalar_type(), isFloatingType(dtype) ? dtype : ScalarType::Long) << what;
+      expect_close(s, reference(x, {false, true, false}, Op::Sum), 0, "sum " + what);
+      const Tensor m = amax(x, {0, 2});
+      EXPECT_EQ(m.scalar_type(), dtype) << what;
+      expect_close(m, reference(x, {true, false, true}, Op::Max), 0, "amax " + what);
+      expect_close(amin(x, {1}), reference(x, {false, true, false}, Op::Min), 0, "amin " + what);
+      expect_close(
+          argmax(x, 1), reference(x, {false, true, false}, Op::ArgMax), 0, "argmax " + what);
+      const Tensor small = make({4, 3}, dtype, [](int64_t i) { return i % 3 + 1; });
+      expect_close(prod(small, {0}), reference(small, {true, false}, Op::Prod), 0, "prod " + what);
+      if (isFloatingType(dtype)) {
+        expect_close(
+            norm(x, 1, {1}), reference(x, {false, true, false}, Op::Norm, 1), 0, "norm " + what);
+      } else {
+        EXPECT_THROW(mean(x), c10::Error) << what;
+        EXPECT_THROW(norm(x), c10::Error) << what;
+      }
+    }
+  }
+}
+
+TEST(ReduceOpsTest, LowPrecisionAccumulatesInFloat) {
+  // 4096 ones: Half accumulation would get stuck at 2048, BFloat16 at 256
+  for (ScalarType dtype : {ScalarType::Half, ScalarType::BFloat16}) {
+    const Tensor x = make({4096}, dtype, [](int64_t) { return 1; });
+    EXPECT_EQ(get(sum(x), 0), 4096) << toString(dtype);
+    EXPECT_EQ(get(mean(x), 0), 1) << toString(dtype);
+    // and for outer reductions
+    const Tensor y = make({4096, 16}, dtype, [](int64_t) { return 1; });
+    for (double v : values(sum(y, {0}))) {
+      EXPECT_EQ(v, 4096) << toString(dtype);
+    }
+  }
+}
+
+TEST(ReduceOpsTest, CascadeSumIsAccurate) {
+  // A float running sum of ones stops at 2^24 = 16777216
+  const int64_t n = 20000000;
+  Tensor ones = empty({n}, ScalarType::Float);
+  std::fill(ones.data_ptr<float>(), ones.data_ptr<float>() + n, 1.f);
+  EXPECT_EQ(sum(ones).data_ptr<float>()[0], static_cast<float>(n));
+  EXPECT_EQ(mean(ones).data_ptr<float>()[0], 1.f);
+
+  // 0.1 isn't exact in float, the sum should be within a few ulps of the
+  // sum of the float values
+  Tensor tenths = empty({n}, ScalarType::Float);
+  std::fill(tenths.data_ptr<float>(), tenths.data_ptr<float>() + n, 0.1f);
+  const double expected = static_cast<double>(0.1f) * n;
+  EXPECT_NEAR(sum(tenths).data_ptr<float>()[0], expected, expected * 1e-6);
+
+  // same along an outer dimension
+  const Tensor rows = ones.as_strided({n / 8, 8}, {8, 1});
+  for (double v : values(sum(rows, {0}))) {
+    EXPECT_EQ(v, n / 8);
+  }
+}
+
+// Few outputs of many elements take the two-pass parallel path
+TEST(ReduceOpsTest, SplitReductionsMatchReference) {
+  const Tensor x =
+      make({3, 200003}, ScalarType::Float, [](int64_t i) { return std::cos(i * 0.001); });
+  // the rows sum to ~20 but their absolute values to ~1e5, hence the tolerance
+  expect_close(sum(x, {1}), reference(x, {false, true}, Op::Sum), 1e-4, "inner sum");
+  expect_close(amax(x, {1}), reference(x, {false, true}, Op::Max), 0, "inner amax");
+  expect_close(argmax(x, 1), reference(x, {false, true}, Op::ArgMax), 0, "inner argmax");
+  const Tensor t = transposed(x);
+  expect_close(sum(t, {0}), reference(t, {true, false}, Op::Sum), 1e-4, "outer sum");
+  expect_close(amin(t, {0}), reference(t, {true, false}, Op::Min), 0, "outer amin");
+  expect_close(argmax(t, 0), reference(t, {true, false}, Op::ArgMax), 0, "outer argmax");
+  const Tensor y =
+      make({200003, 5}, ScalarType::Double, [](int64_t i) { return std::sin(i * 0.01); });
+  expect_close(sum(y, {0}), reference(y, {true, false}, Op::Sum), 1e-10, "outer double sum");
+  expect_close(
+      norm(y, 2, {0}), reference(y, {true, false}, Op::Norm, 2), 1e-10, "outer double norm");
+}
+
+TEST(ReduceOpsTest, ResultsDoNotDependOnTheThreadCount) {
+  c10::test::NumThreadsGuard num_threads(1);
+  const Tensor x = make({4, 300001}, ScalarType::Float, [](int64_t i) {
+    return 1.0 / (i % 1000 + 1) + (i % 7) * 1e3;
+  });
+  const Tensor t = transposed(x);
+  // many outputs, split across the threads by output
+  const Tensor many =
+      make({600, 2000}, ScalarType::Float, [](int64_t i) { return 0.1 * (i % 13); });
+  auto run = [&] {
+    std::vector<double> r = values(sum(x, {1}));
+    for (double v : values(sum(t, {0}))) {
+      r.push_back(v);
+    }
+    for (double v : values(sum(x))) {
+      r.push_back(v);
+    }
+    for (double v : values(sum(many, {1}))) {
+      r.push_back(v);
+    }
+    return r;
+  };
+  const auto expected = run();
+  for (int nthreads : {2, 3, 4}) {
+    set_num_threads(nthreads);
+    EXPECT_EQ(run(), expected) << nthreads << " threads";
+  }
+}
+
+TEST(ReduceOpsTest, NaNPropagates) {
+  const double nan = std::numeric_limits<double>::quiet_NaN();
+  for (ScalarType dtype :
+       {ScalarType::Float, ScalarType::Double, ScalarType::Half, ScalarType::BFloat16}) {
+    // rows of 40 with a NaN at column 3 of row 1 and at columns 20 and 30 of
+    // row 2, long enough for the vector paths
+    const Tensor x = make({3, 40}, dtype, [&](int64_t i) {
+      return i == 43 || i == 100 || i == 110 ? nan : static_cast<double>(i % 40);
+    });
+    for (const Tensor& y : {x, transposed(transposed(x))}) {
+      const auto max = values(amax(y, {1}));
+      EXPECT_EQ(max[0], 39);
+      EXPECT_TRUE(std::isnan(max[1]));
+      EXPECT_TRUE(std::isnan(max[2]));
+      const auto min = values(amin(y, {1}));
+      EXPECT_EQ(min[0], 0);
+      EXPECT_TRUE(std::isnan(min[1]));
+      EXPECT_EQ(values(argmax(y, 1)), (std::vector<double>{39, 3, 20}));
+    }
+    // outer reductions
+    const auto max = values(amax(transposed(x), {0}));
+    EXPECT_EQ(max[0], 39);
+    EXPECT_TRUE(std::isnan(max[1]));
+    EXPECT_EQ(values(argmax(transposed(x), 0)), (std::vector<double>{39, 3, 20}));
+    EXPECT_TRUE(std::isnan(values(sum(x))[0]));
+  }
+}
+
+TEST(ReduceOpsTest, EmptyReductions) {
+  const Tensor x = empty({0, 3}, ScalarType::Float);
+  EXPECT_EQ(values(sum(x, {0})), (std::vector<double>{0, 0, 0}));
+  EXPECT_EQ(values(prod(x, {0})), (std::vector<double>{1, 1, 1}));
+  for (double v : values(mean(x, {0}))) {
+    EXPECT_TRUE(std::isnan(v));
+  }
+  EXPECT_EQ(values(norm(x, 2, {0})), (std::vector<double>{0, 0, 0}));
+  EXPECT_THROW(amax(x, {0}), c10::Error);
+  EXPECT_THROW(amin(x), c10::Error);
+  EXPECT_THROW(argmax(x, 0), c10::Error);
+  EXPECT_THROW(norm(x, std::numeric_limits<double>::infinity(), {0}), c10::Error);
+  // no outputs, nothing to reduce
+  EXPECT_EQ(amax(x, {1}).sizes(), IntArrayRef({0}));
+  EXPECT_EQ(argmax(x, 1, true).sizes(), IntArrayRef({0, 1}));
+}
+
+TEST(ReduceOpsTest, ScalarsAndSizeOneDims) {
+  const Tensor s = make({}, ScalarType::Float, [](int64_t) { return 2.5; });
+  EXPECT_EQ(sum(s).dim(), 0);
+  EXPECT_EQ(values(sum(s)), (std::vector<double>{2.5}));
+  EXPECT_EQ(values(amax(s, {-1})), (std::vector<double>{2.5}));
+  EXPECT_EQ(values(argmax(s)), (std::vector<double>{0}));
+  const Tensor x = make({1, 5, 1}, ScalarType::Int, [](int64_t i) { return i; });
+  EXPECT_EQ(sum(x, {0, 2}).sizes(), IntArrayRef({5}));
+  EXPECT_EQ(values(sum(x, {0, 2})), (std::vector<double>{0, 1, 2, 3, 4}));
+  EXPECT_EQ(sum(x, {1}, true).sizes(), IntArrayRef({1, 1, 1}));
+  EXPECT_EQ(values(sum(x, {1})), (std::vector<double>{10}));
+}
+
+TEST(ReduceOpsTest, InvalidArguments) {
+  const Tensor x = empty({2, 3}, ScalarType::Float);
+  EXPECT_THROW(sum(x, {0, -2}), c10::Error);
+  EXPECT_THROW(sum(x, {2}), c10::Error);
+  EXPECT_THROW(argmax(x, -3), c10::Error);
+  EXPECT_THROW(norm(x, -1), c10::Error);
+  EXPECT_THROW(sum(Tensor()), c10::Error);
+  EXPECT_THROW(sum(empty({2}, ScalarType::Bool)), c10::Error);
+}
+
+} // namespace
@@ -0,0 +1,204 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/CPUAllocator.h>
+#include <c10/core/MetaAllocator.h>
+#include <c10/core/Tensor.h>
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <limits>
+#include <numeric>
+#include <vector>
+
+using namespace c10;
+
+namespace {
+
+bool pointsInto(const void* p, const TensorImpl* impl) {
+  auto* begin = reinterpret_cast<const char*>(impl);
+  auto* q = static_cast<const char*>(p);
+  return q >= begin && q < begin + sizeof(TensorImpl);
+}
+
+// Forwards to the CPU allocator and counts the calls
+struct CountingAllocator final : public Allocator {
+  DataPtr allocate(size_t nbytes) const override {
+    allocations++;
+    return GetDefaultCPUAllocator()->allocate(nbytes);
+  }
+  DeleterFnPtr raw_deleter() const override {
+    return GetDefaultCPUAllocator()->raw_deleter();
+  }
+  mutable std::atomic<int64_t> allocations{0};
+};
+
+// Makes `allocator` the CPU allocator for its scope
+struct CPUAllocatorGuard {
+  explicit CPUAllocatorGuard(Allocator* allocator) {
+    SetAllocator(DeviceType::CPU, allocator, std::numeric_limits<uint8_t>::max());
+  }
+  ~CPUAllocatorGuard() {
+    SetAllocator(DeviceType::CPU, GetDefaultCPUAllocator(), std::numeric_limits<uint8_t>::max());
+  }
+};
+
+} // namespace
+
+TEST(TensorImplTest, EmptyContiguous) {
+  Tensor t = empty({2, 3, 4}, ScalarType::Float);
+  ASSERT_TRUE(t.defined());
+  EXPECT_EQ(t.sizes(), IntArrayRef({2, 3, 4}));
+  EXPECT_EQ(t.strides(), IntArrayRef({12, 4, 1}));
+  EXPECT_EQ(t.numel(), 24);
+  EXPECT_EQ(t.nbytes(), 24 * sizeof(float));
+  EXPECT_EQ(t.size(-1), 4);
+  EXPECT_EQ(t.stride(0), 12);
+  EXPECT_THROW(t.size(3), c10::Error);
+  EXPECT_TRUE(t.is_contiguous());
+  EXPECT_FALSE(t.is_contiguous(MemoryFormat::ChannelsLast));
+  EXPECT_TRUE(t.key_set().has(DispatchKey::CPU));
+  EXPECT_EQ(t.device().type(), DeviceType::CPU);
+  ASSERT_NE(t.data_ptr(), nullptr);
+  EXPECT_EQ(reinterpret_cast<uintptr_t>(t.data_ptr()) % gAlignment, 0);
+  EXPECT_EQ(t.unsafeGetTensorImpl()->storage()->nbytes(), t.nbytes());
+  // scribble over the data to let sanitizers check the size
+  std::fill(t.data_ptr<float>(), t.data_ptr<float>() + t.numel(), 1.f);
+}
+
+TEST(TensorImplTest, SizesAndStridesAreInline) {
+  for (size_t rank = 0; rank <= kDimVectorStaticSize; rank++) {
+    const std::vector<int64_t> sizes(rank, 2);
+    Tensor t = empty(sizes, ScalarType::Double);
+    const TensorImpl* impl = t.unsafeGetTensorImpl();
+    EXPECT_EQ(t.dim(), static_cast<int64_t>(rank));
+    if (rank > 0) {
+      EXPECT_TRUE(pointsInto(t.sizes().data(), impl)) << rank;
+      EXPECT_TRUE(pointsInto(t.strides().data(), impl)) << rank;
+    }
+  }
+  // larger ranks spill to the heap but work the same
+  Tensor t = empty({1, 2, 1, 2, 1, 2, 3}, ScalarType::Float);
+  EXPECT_EQ(t.numel(), 24);
+  EXPECT_EQ(t.stride(0), 24);
+  EXPECT_TRUE(t.is_contiguous());
+}
+
+TEST(TensorImplTest, ChannelsLast) {
+  Tensor t = empty({2, 3, 4, 5}, ScalarType::Float, MemoryFormat::ChannelsLast);
+  EXPECT_EQ(t.strides(), IntArrayRef({60, 1, 15, 3}));
+  EXPECT_TRUE(t.is_contiguous(MemoryFormat::ChannelsLast));
+  EXPECT_FALSE(t.is_contiguous());
+  EXPECT_EQ(t.suggest_memory_format(), MemoryFormat::ChannelsLast);
+
+  Tensor t3 = empty({2, 3, 4, 5, 6}, ScalarType::Float, MemoryFormat::ChannelsLast3d);
+  EXPECT_TRUE(t3.is_contiguous(MemoryFormat::ChannelsLast3d));
+  EXPECT_FALSE(t3.is_contiguous());
+  EXPECT_EQ(t3.suggest_memory_format(), MemoryFormat::ChannelsLast3d);
+
+  // contiguous NCHW with C == 1 is also dense in NHWC order, but keeps its
+  // NCHW memory format
+  Tensor c1 = empty({2, 1, 4, 5}, ScalarType::Float);
+  EXPECT_TRUE(c1.is_contiguous());
+  EXPECT_TRUE(c1.is_contiguous(MemoryFormat::ChannelsLast));
+  EXPECT_EQ(c1.suggest_memory_format(), MemoryFormat::Contiguous);
+}
+
+TEST(TensorImplTest, FlagsFollowShapeChanges) {
+  Tensor t = empty({4, 6}, ScalarType::Float);
+  // the transpose is a view of the same storage
+  Tensor tt = t.as_strided({6, 4}, {1, 6});
+  EXPECT_TRUE(tt.is_alias_of(t));
+  EXPECT_FALSE(tt.is_contiguous());
+  EXPECT_EQ(tt.data_ptr(), t.data_ptr());
+
+  TensorImpl* impl = tt.unsafeGetTensorImpl();
+  impl->set_sizes_contiguous({24});
+  EXPECT_TRUE(tt.is_contiguous());
+  impl->set_sizes_and_strides({2, 3}, {6, 2});
+  EXPECT_FALSE(tt.is_contiguous());
+  // size-1 dims and empty tensors ignore their strides
+  impl->set_sizes_and_strides({1, 4}, {100, 1});
+  EXPECT_TRUE(tt.is_contiguous());
+  impl->set_sizes_and_strides({0, 4}, {7, 3});
+  EXPECT_TRUE(tt.is_contiguous());
+  EXPECT_EQ(tt.numel(), 0);
+
+  Tensor row = t.as_strided({6}, {1}, 6);
+  EXPECT_EQ(row.data_ptr<float>(), t.data_ptr<float>() + 6);
+  EXPECT_THROW(t.as_strided({6}, {1}, 19), c10::Error);
+  EXPECT_THROW(t.as_strided({2}, {-1}), c10::Error);
+  EXPECT_THROW(empty({2, -1}, ScalarType::Float), c10::Error);
+}
+
+TEST(TensorImplTest, EmptyStrided) {
+  Tensor t = empty_strided({3, 4}, {1, 3}, ScalarType::Int);
+  EXPECT_FALSE(t.is_contiguous());
+  EXPECT_EQ(t.unsafeGetTensorImpl()->storage()->nbytes(), 12 * sizeof(int32_t));
+  // a broadcast (zero stride) tensor needs a single element
+  Tensor b = empty_strided({3, 4}, {0, 0}, ScalarType::Int);
+  EXPECT_EQ(b.unsafeGetTensorImpl()->storage()->nbytes(), sizeof(int32_t));
+}
+
+TEST(TensorImplTest, StorageSizeOverflowThrows) {
+  const int64_t big = std::numeric_limits<int64_t>::max() / 2;
+  // the element extent fits in size_t but the byte count doesn't
+  EXPECT_THROW(empty_strided({2, 2}, {big, 1}, ScalarType::Float), c10::Error);
+  // the element extent itself overflows
+  EXPECT_THROW(empty_strided({3, 3}, {big, big}, ScalarType::Byte), c10::Error);
+  Tensor t = empty({4}, ScalarType::Float);
+  EXPECT_THROW(t.as_strided({3}, {std::numeric_limits<int64_t>::max()}), c10::Error);
+  EXPECT_THROW(t.as_strided({2}, {1}, std::numeric_limits<int64_t>::max()), c10::Error);
+}
+
+TEST(TensorImplTest, MetaTensorAllocatesOnce) {
+  resetPeakMetaMemoryStats();
+  {
+    Tensor t = empty({8, 16}, ScalarType::Half, MemoryFormat::Contiguous, Device(kMeta));
+    EXPECT_EQ(t.data_ptr(), nullptr);
+    EXPECT_TRUE(t.key_set().has(DispatchKey::Meta));
+    EXPECT_EQ(getMetaMemoryStats().allocated_bytes, 8 * 16 * 2);
+    Tensor empty_meta = empty({0, 3}, ScalarType::Float, MemoryFormat::Contiguous, Device(kMeta));
+    EXPECT_EQ(empty_meta.numel(), 0);
+  }
+  EXPECT_EQ(getMetaMemoryStats().num_allocs, 1);
+  EXPECT_EQ(getMetaMemoryStats().allocated_bytes, 0);
+}
+
+TEST(TensorImplTest, CreationMakesOneHeapAllocationBesidesData) {
+  CountingAllocator counting;
+  CPUAllocatorGuard guard(&counting);
+  Tensor t = empty({2, 3, 4, 5, 6}, ScalarType::Float);
+  EXPECT_EQ(counting.allocations, 1);
+  EXPECT_EQ(t.unsafeGetTensorImpl()->storage()->allocator(), &counting);
+  // sizes and strides are inline (see SizesAndStridesAreInline), and the
+  // storage sits in the TensorImpl's block, right before it
+  auto* impl = reinterpret_cast<const char*>(t.unsafeGetTensorImpl());
+  auto* storage = reinterpret_cast<const char*>(t.unsafeGetTensorImpl()->storage().get());
+  EXPECT_GT(impl - storage, static_cast<std::ptrdiff_t>(sizeof(StorageImpl)));
+  EXPECT_LE(
+      impl - storage,
+      static_cast<std::ptrdiff_t>(sizeof(StorageImpl) + 2 * alignof(std::max_align_t)));
+}
+
+TEST(TensorImplTest, ViewOutlivesBase) {
+  Tensor view;
+  {
+    Tensor base = empty({4, 6}, ScalarType::Int);
+    std::iota(base.data_ptr<int32_t>(), base.data_ptr<int32_t>() + base.numel(), 0);
+    view = base.as_strided({6}, {1}, 6);
+  }
+  EXPECT_EQ(view.unsafeGetTensorImpl()->storage().use_count(), 1);
+  for (int32_t i = 0; i < 6; i++) {
+    EXPECT_EQ(view.data_ptr<int32_t>()[i], 6 + i);
+  }
+}
+
+TEST(TensorImplTest, HandleSharesImpl) {
+  Tensor a = empty({5}, ScalarType::Long);
+  Tensor b = a;
+  EXPECT_TRUE(a.is_same(b));
+  EXPECT_EQ(a.use_count(), 2);
+  Tensor undefined;
+  EXPECT_FALSE(undefined.defined());
+}
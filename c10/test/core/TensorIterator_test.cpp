@@ -0,0 +1,223 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/TensorIterator.h>
+
+#include <numeric>
+#include <vector>
+
+using namespace c10;
+
+namespace {
+
+struct Chunk {
+  std::vector<char*> data;
+  std::vector<int64_t> strides;
+  int64_t n;
+};
+
+std::vector<Chunk> chunks(const TensorIterator& iter, int64_t begin, int64_t end) {
+  std::vector<Chunk> result;
+  iter.serial_for_each(
+      [&](char** data, const int64_t* strides, int64_t n) {
+        result.push_back(
+            {std::vector<char*>(data, data + iter.ntensors()),
+             std::vector<int64_t>(strides, strides + iter.ntensors()), n});
+      },
+      begin, end);
+  return result;
+}
+
+std::vector<int64_t> iota(int64_t n) {
+  std::vector<int64_t> v(n);
+  std::iota(v.begin(), v.end(), 0);
+  return v;
+}
+
+// out[i, j] = a[i, j] + b[i, j] with the iterator, for any strides
+void add(TensorIterator& iter) {
+  iter.for_each([](char** data, const int64_t* strides, int64_t n) {
+    for (int64_t i = 0; i < n; i++) {
+      *reinterpret_cast<int64_t*>(data[0] + i * strides[0]) =
+          *reinterpret_cast<int64_t*>(data[1] + i * strides[1]) +
+          *reinterpret_cast<int64_t*>(data[2] + i * strides[2]);
+    }
+  });
+}
+
+} // namespace
+
+TEST(TensorIteratorTest, ContiguousCoalescesToOneChunk) {
+  std::vector<int64_t> out(24), a = iota(24), b = iota(24);
+  TensorIterator iter;
+  iter.add_output(out.data(), {2, 3, 4}, {12, 4, 1}, sizeof(int64_t))
+      .add_input(a.data(), {2, 3, 4}, {12, 4, 1}, sizeof(int64_t))
+      .add_input(b.data(), {2, 3, 4}, {12, 4, 1}, sizeof(int64_t))
+      .build();
+  EXPECT_EQ(iter.ndim(), 1);
+  EXPECT_EQ(iter.numel(), 24);
+  EXPECT_TRUE(iter.is_contiguous());
+  const auto c = chunks(iter, 0, iter.numel());
+  ASSERT_EQ(c.size(), 1u);
+  EXPECT_EQ(c[0].n, 24);
+  EXPECT_EQ(c[0].strides, std::vector<int64_t>(3, sizeof(int64_t)));
+  add(iter);
+  for (int64_t i = 0; i < 24; i++) {
+    EXPECT_EQ(out[i], 2 * i);
+  }
+}
+
+TEST(TensorIteratorTest, Broadcasting) {
+  // out[2, 3] = a[2, 1] + b[3]
+  std::vector<int64_t> out(6), a = {10, 20}, b = {1, 2, 3};
+  TensorIterator iter;
+  iter.add_output(out.data(), {2, 3}, {3, 1}, sizeof(int64_t))
+      .add_input(a.data(), {2, 1}, {1, 1}, sizeof(int64_t))
+      .add_input(b.data(), {3}, {1}, sizeof(int64_t))
+      .build();
+  EXPECT_EQ(iter.ndim(), 2);
+  EXPECT_EQ(iter.shape(), IntArrayRef({3, 2}));
+  EXPECT_EQ(iter.strides(1), IntArrayRef({0, 8}));
+  EXPECT_EQ(iter.strides(2), IntArrayRef({8, 0}));
+  EXPECT_FALSE(iter.is_contiguous());
+  add(iter);
+  EXPECT_EQ(out, std::vector<int64_t>({11, 12, 13, 21, 22, 23}));
+}
+
+TEST(TensorIteratorTest, ShapeErrors) {
+  std::vector<int64_t> out(6), a(6);
+  {
+    TensorIterator iter;
+    iter.add_output(out.data(), {2, 3}, {3, 1}, 8).add_input(a.data(), {3, 2}, {2, 1}, 8);
+    EXPECT_THROW(iter.build(), c10::Error);
+  }
+  {
+    // outputs are not broadcast
+    TensorIterator iter;
+    iter.add_output(out.data(), {3}, {1}, 8).add_input(a.data(), {2, 3}, {3, 1}, 8);
+    EXPECT_THROW(iter.build(), c10::Error);
+  }
+  {
+    TensorIterator iter;
+    iter.add_output(out.data(), {2, 3}, {0, 1}, 8).add_input(a.data(), {2, 3}, {3, 1}, 8);
+    EXPECT_THROW(iter.build(), c10::Error);
+  }
+  {
+    TensorIterator iter;
+    iter.add_input(a.data(), {6}, {1}, 8);
+    EXPECT_THROW(iter.add_output(out.data(), {6}, {1}, 8), c10::Error);
+  }
+}
+
+TEST(TensorIteratorTest, ReordersByStride) {
+  // a transposed input and output: the iterator walks memory order and
+  // coalesces back to one dimension
+  std::vector<int64_t> out(12), a = iota(12), b(12, 1);
+  TensorIterator iter;
+  iter.add_output(out.data(), {4, 3}, {1, 4}, 8)
+      .add_input(a.data(), {4, 3}, {1, 4}, 8)
+      .add_input(b.data(), {4, 3}, {1, 4}, 8)
+      .build();
+  EXPECT_EQ(iter.ndim(), 1);
+  EXPECT_TRUE(iter.is_contiguous());
+  add(iter);
+  for (int64_t i = 0; i < 12; i++) {
+    EXPECT_EQ(out[i], i + 1);
+  }
+
+  // only the output is transposed: the output's order wins
+  std::vector<int64_t> out2(12);
+  TensorIterator iter2;
+  iter2.add_output(out2.data(), {4, 3}, {1, 4}, 8)
+      .add_input(a.data(), {4, 3}, {3, 1}, 8)
+      .add_input(b.data(), {4, 3}, {3, 1}, 8)
+      .build();
+  EXPECT_EQ(iter2.shape(), IntArrayRef({4, 3}));
+  EXPECT_EQ(iter2.strides(0), IntArrayRef({8, 32}));
+  add(iter2);
+  for (int64_t i = 0; i < 4; i++) {
+    for (int64_t j = 0; j < 3; j++) {
+      EXPECT_EQ(out2[i + 4 * j], a[3 * i + j] + 1);
+    }
+  }
+}
+
+TEST(TensorIteratorTest, PartialCoalescing) {
+  // a slice [:, :, :2] of a [2, 3, 4] tensor: the two outer dimensions
+  // merge, the sliced inner one can't
+  std::vector<int64_t> src = iota(24), out(12);
+  TensorIterator iter;
+  iter.add_output(out.data(), {2, 3, 2}, {6, 2, 1}, 8)
+      .add_input(src.data(), {2, 3, 2}, {12, 4, 1}, 8)
+      .build();
+  EXPECT_EQ(iter.shape(), IntArrayRef({2, 6}));
+  EXPECT_EQ(iter.strides(1), IntArrayRef({8, 32}));
+  iter.for_each([](char** data, const int64_t* strides, int64_t n) {
+    for (int64_t i = 0; i < n; i++) {
+      *reinterpret_cast<int64_t*>(data[0] + i * strides[0]) =
+          *reinterpret_cast<int64_t*>(data[1] + i * strides[1]);
+    }
+  });
+  for (int64_t r = 0; r < 6; r++) {
+    EXPECT_EQ(out[2 * r], 4 * r);
+    EXPECT_EQ(out[2 * r + 1], 4 * r + 1);
+  }
+}
+
+TEST(TensorIteratorTest, SerialForEachRanges) {
+  std::vector<int64_t> src = iota(60), out(60);
+  TensorIterator iter;
+  // non-coalescable: the input is transposed
+  iter.add_output(out.data(), {3, 4, 5}, {20, 5, 1}, 8)
+      .add_input(src.data(), {3, 4, 5}, {1, 3, 12}, 8)
+      .build();
+  ASSERT_GT(iter.ndim(), 1);
+  // every split of the range visits every element exactly once
+  for (int64_t split : {0, 1, 7, 13, 59, 60}) {
+    std::vector<int> visits(60, 0);
+    auto count = [&](char** data, const int64_t* strides, int64_t n) {
+      for (int64_t i = 0; i < n; i++) {
+        visits[(reinterpret_cast<int64_t*>(data[0] + i * strides[0]) - out.data())]++;
+      }
+    };
+    iter.serial_for_each(count, 0, split);
+    iter.serial_for_each(count, split, 60);
+    EXPECT_EQ(visits, std::vector<int>(60, 1)) << split;
+  }
+}
+
+TEST(TensorIteratorTest, ScalarsAndEmpty) {
+  int64_t out = 0, a = 5;
+  TensorIterator iter;
+  iter.add_output(&out, {}, {}, 8).add_input(&a, {}, {}, 8).build();
+  EXPECT_EQ(iter.ndim(), 1);
+  EXPECT_EQ(iter.numel(), 1);
+  const auto c = chunks(iter, 0, 1);
+  ASSERT_EQ(c.size(), 1u);
+  EXPECT_EQ(c[0].n, 1);
+
+  std::vector<int64_t> empty_out;
+  TensorIterator empty_iter;
+  empty_iter.add_output(empty_out.data(), {0, 3}, {3, 1}, 8)
+      .add_input(&a, {1}, {1}, 8)
+      .build();
+  EXPECT_EQ(empty_iter.numel(), 0);
+  EXPECT_TRUE(chunks(empty_iter, 0, 0).empty());
+}
+
+TEST(TensorIteratorTest, Tensors) {
+  Tensor out = empty({2, 3}, ScalarType::Long);
+  Tensor a = empty({2, 3}, ScalarType::Long);
+  Tensor b = empty({3}, ScalarType::Long);
+  for (int64_t i = 0; i < 6; i++) {
+    a.data_ptr<int64_t>()[i] = i;
+  }
+  for (int64_t i = 0; i < 3; i++) {
+    b.data_ptr<int64_t>()[i] = 100 * i;
+  }
+  TensorIterator iter;
+  iter.add_output(out).add_input(a).add_input(b).build();
+  add(iter);
+  for (int64_t i = 0; i < 6; i++) {
+    EXPECT_EQ(out.data_ptr<int64_t>()[i], i + 100 * (i % 3));
+  }
+}
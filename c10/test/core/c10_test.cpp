@@ -1,6 +1,10 @@
 #include <gtest/gtest.h>
 
 #include <c10/core/DispatchKeySet.h>
+#include <c10/core/MetaAllocator.h>
+#include <c10/core/Storage.h>
+
+#include <vector>
 
 using namespace c10;
 
@@ -53,3 +57,52 @@ TEST(DispatchKeySet, Full) {
     ASSERT_TRUE(full.has(tid));
   }
 }
+
+TEST(DispatchKeySet, IteratorOrder) {
+  DispatchKeySet full(DispatchKeySet::FULL);
+  auto expected = static_cast<uint8_t>(64);
+  for (DispatchKey tid : full) {
+    ASSERT_EQ(static_cast<uint8_t>(tid), expected--);
+  }
+  ASSERT_EQ(expected, 0);
+  ASSERT_EQ(DispatchKeySet().begin(), DispatchKeySet().end());
+
+  auto ks = DispatchKeySet({DispatchKey::CPU, DispatchKey::Autograd, DispatchKey::Meta});
+  std::vector<DispatchKey> keys(ks.begin(), ks.end());
+  ASSERT_EQ(keys, (std::vector<DispatchKey>{DispatchKey::Autograd, DispatchKey::Meta, DispatchKey::CPU}));
+}
+
+TEST(DispatchKeySet, FullAfter) {
+  static_assert(DispatchKeySet(DispatchKeySet::FULL_AFTER, DispatchKey::Undefined).raw_repr() == 0, "");
+  static_assert(DispatchKeySet(DispatchKeySet::FULL_AFTER, DispatchKey::CPU).raw_repr() == 0, "");
+  for (uint8_t i = 1; i < static_cast<uint8_t>(DispatchKey::NumDispatchKeys); i++) {
+    auto tid = static_cast<DispatchKey>(i);
+    DispatchKeySet after(DispatchKeySet::FULL_AFTER, tid);
+    ASSERT_FALSE(after.has_unchecked(tid));
+    for (uint8_t j = 1; j < static_cast<uint8_t>(DispatchKey::NumDispatchKeys); j++) {
+      ASSERT_EQ(after.has(static_cast<DispatchKey>(j)), j < i);
+    }
+  }
+}
+
+TEST(MetaAllocator, StorageHasSizeButNoData) {
+  resetPeakMetaMemoryStats();
+  auto before = getMetaMemoryStats();
+  {
+    Storage a(Storage::use_byte_size_t(), 1024, GetAllocator(kMeta), false);
+    ASSERT_EQ(a.nbytes(), 1024);
+    ASSERT_EQ(a.data(), nullptr);
+    ASSERT_TRUE(a.device().is_meta());
+    {
+      Storage b(Storage::use_byte_size_t(), 4096, GetAllocator(kMeta), false);
+      ASSERT_EQ(getMetaMemoryStats().allocated_bytes,
+                before.allocated_bytes + 1024 + 4096);
+    }
+    ASSERT_EQ(getMetaMemoryStats().allocated_bytes,
+              before.allocated_bytes + 1024);
+  }
+  auto after = getMetaMemoryStats();
+  ASSERT_EQ(after.allocated_bytes, before.allocated_bytes);
+  ASSERT_EQ(after.peak_bytes, before.allocated_bytes + 1024 + 4096);
+  ASSERT_EQ(after.num_allocs, 2);
+}
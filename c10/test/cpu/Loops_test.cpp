@@ -0,0 +1,115 @@
+#include <gtest/gtest.h>
+
+#include <c10/cpu/Loops.h>
+#include <c10/test/cpu/cpu_test_util.h>
+
+#include <vector>
+
+using namespace c10;
+using c10::vec::Vectorized;
+
+namespace {
+
+// Counts how the kernels were called
+struct Calls {
+  int scalar = 0;
+  int vec = 0;
+};
+
+void mul_add(const TensorIterator& iter, Calls& calls) {
+  cpu_kernel_vec(
+      iter,
+      [&](float a, float b, float c) -> float {
+        calls.scalar++;
+        return a * b + c;
+      },
+      [&](Vectorized<float> a, Vectorized<float> b, Vectorized<float> c) {
+        calls.vec++;
+        return a * b + c;
+      });
+}
+
+} // namespace
+
+TEST(LoopsTest, ContiguousRunsVectorized) {
+  SKIP_IF_UNSUPPORTED();
+  const int64_t n = 1000;
+  std::vector<float> out(n), a(n), b(n), c(n);
+  for (int64_t i = 0; i < n; i++) {
+    a[i] = static_cast<float>(i);
+    b[i] = 0.5f;
+    c[i] = 1.f;
+  }
+  TensorIterator iter;
+  iter.add_output(out.data(), {10, 100}, {100, 1}, 4)
+      .add_input(a.data(), {10, 100}, {100, 1}, 4)
+      .add_input(b.data(), {10, 100}, {100, 1}, 4)
+      .add_input(c.data(), {10, 100}, {100, 1}, 4)
+      .build();
+  Calls calls;
+  mul_add(iter, calls);
+  const int64_t lanes = Vectorized<float>::size();
+  EXPECT_EQ(calls.vec, n / (2 * lanes) * 2);
+  EXPECT_EQ(calls.scalar, n % (2 * lanes));
+  for (int64_t i = 0; i < n; i++) {
+    ASSERT_EQ(out[i], a[i] * 0.5f + 1.f) << i;
+  }
+}
+
+TEST(LoopsTest, BroadcastScalarRunsVectorized) {
+  SKIP_IF_UNSUPPORTED();
+  const int64_t n = 256;
+  std::vector<float> out(n), a(n), c(n, 2.f);
+  for (int64_t i = 0; i < n; i++) {
+    a[i] = static_cast<float>(i);
+  }
+  float b = 3.f;
+  TensorIterator iter;
+  iter.add_output(out.data(), {n}, {1}, 4)
+      .add_input(a.data(), {n}, {1}, 4)
+      .add_input(&b, {}, {}, 4)
+      .add_input(c.data(), {n}, {1}, 4)
+      .build();
+  Calls calls;
+  mul_add(iter, calls);
+  EXPECT_EQ(calls.scalar, 0);
+  for (int64_t i = 0; i < n; i++) {
+    ASSERT_EQ(out[i], a[i] * 3.f + 2.f) << i;
+  }
+}
+
+TEST(LoopsTest, StridedFallsBackToScalar) {
+  SKIP_IF_UNSUPPORTED();
+  // a is read transposed
+  std::vector<float> out(12), a(12), b(12, 2.f), c(12, 0.f);
+  for (int64_t i = 0; i < 12; i++) {
+    a[i] = static_cast<float>(i);
+  }
+  TensorIterator iter;
+  iter.add_output(out.data(), {3, 4}, {4, 1}, 4)
+      .add_input(a.data(), {3, 4}, {1, 3}, 4)
+      .add_input(b.data(), {3, 4}, {4, 1}, 4)
+      .add_input(c.data(), {3, 4}, {4, 1}, 4)
+      .build();
+  Calls calls;
+  mul_add(iter, calls);
+  EXPECT_EQ(calls.vec, 0);
+  for (int64_t i = 0; i < 3; i++) {
+    for (int64_t j = 0; j < 4; j++) {
+      EXPECT_EQ(out[4 * i + j], 2.f * a[i + 3 * j]);
+    }
+  }
+}
+
+TEST(LoopsTest, CpuKernelMixedTypesInPlace) {
+  SKIP_IF_UNSUPPORTED();
+  std::vector<double> x = {1.0, 2.0, 3.0, 4.0, 5.0};
+  std::vector<int32_t> k = {1, 2, 3, 4, 5};
+  TensorIterator iter;
+  iter.add_output(x.data(), {5}, {1}, sizeof(double))
+      .add_input(x.data(), {5}, {1}, sizeof(double))
+      .add_input(k.data(), {5}, {1}, sizeof(int32_t))
+      .build();
+  cpu_kernel(iter, [](double v, int32_t m) -> double { return v * m; });
+  EXPECT_EQ(x, std::vector<double>({1.0, 4.0, 9.0, 16.0, 25.0}));
+}
@@ -0,0 +1,31 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <c10/util/CPUCapability.h>
+
+// The tests in this directory are built once per CPU capability, see
+// c10/test/CMakeLists.txt.  Builds the CPU can't run skip their tests.
+
+namespace c10 {
+namespace test {
+
+inline bool cpuSupportsBuild() {
+  const auto& f = c10::cpu::cpuFeatures();
+#if defined(CPU_CAPABILITY_AVX512)
+  return f.avx512f && f.avx512bw && f.avx512vl && f.avx2 && f.fma && f.f16c;
+#elif defined(CPU_CAPABILITY_AVX2)
+  return f.avx2 && f.fma && f.f16c;
+#else
+  (void)f;
+  return true;
+#endif
+}
+
+} // namespace test
+} // namespace c10
+
+#define SKIP_IF_UNSUPPORTED()                                              \
+  if (!c10::test::cpuSupportsBuild()) {                                    \
+    GTEST_SKIP() << "CPU does not support " C10_STRINGIZE(CPU_CAPABILITY); \
+  }
@@ -0,0 +1,597 @@
+#include <gtest/gtest.h>
+
+#include <c10/cpu/vec/vec.h>
+#include <c10/test/cpu/cpu_test_util.h>
+
+#include <cmath>
+#include <cstring>
+#include <initializer_list>
+#include <limits>
+#include <vector>
+
+using namespace c10::vec;
+
+namespace {
+
+uint32_t bits(float f) {
+  uint32_t b;
+  std::memcpy(&b, &f, sizeof(b));
+  return b;
+}
+
+float from_bits(uint32_t b) {
+  float f;
+  std::memcpy(&f, &b, sizeof(f));
+  return f;
+}
+
+// The first elements of a Vectorized<float>, whatever its width.
+Vectorized<float> floats(std::initializer_list<float> vals) {
+  return Vectorized<float>::loadu(vals.begin(), vals.size());
+}
+
+// A spread of values of T, no zeros for the divisions.
+template <typename T>
+T value(int i) {
+  return static_cast<T>((i * 7) % 23 - 11 == 0 ? 5 : (i * 7) % 23 - 11);
+}
+
+template <>
+float value<float>(int i) {
+  return (i % 2 ? -1.f : 1.f) * (0.375f + 1.3f * i);
+}
+
+template <>
+double value<double>(int i) {
+  return (i % 2 ? -1. : 1.) * (0.375 + 1.3 * i);
+}
+
+template <>
+c10::BFloat16 value<c10::BFloat16>(int i) {
+  return c10::BFloat16(value<float>(i));
+}
+
+template <>
+c10::Half value<c10::Half>(int i) {
+  return c10::Half(value<float>(i));
+}
+
+template <>
+c10::complex<float> value<c10::complex<float>>(int i) {
+  return c10::complex<float>(value<float>(i), value<float>(i + 3));
+}
+
+template <>
+c10::complex<double> value<c10::complex<double>>(int i) {
+  return c10::complex<double>(value<double>(i), value<double>(i + 3));
+}
+
+template <typename T>
+bool same(const T& a, const T& b) {
+  return std::memcmp(&a, &b, sizeof(T)) == 0;
+}
+
+template <typename T>
+std::vector<T> values(int n, int seed = 0) {
+  std::vector<T> v(n);
+  for (int i = 0; i < n; i++) {
+    v[i] = value<T>(i + seed);
+  }
+  return v;
+}
+
+template <typename T>
+class VecTypedTest : public ::testing::Test {};
+
+using VecTypes = ::testing::Types<
+    float,
+    double,
+    int64_t,
+    int32_t,
+    int16_t,
+    int8_t,
+    uint8_t,
+    c10::BFloat16,
+    c10::Half,
+    c10::complex<float>,
+    c10::complex<double>>;
+TYPED_TEST_SUITE(VecTypedTest, VecTypes);
+
+TYPED_TEST(VecTypedTest, LoadStore) {
+  SKIP_IF_UNSUPPORTED();
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  EXPECT_EQ(Vec::size() * sizeof(T), C10_VECTOR_WIDTH);
+  const auto src = values<T>(Vec::size());
+  for (int count = 0; count <= Vec::size(); count++) {
+    std::vector<T> dst(Vec::size() + 1, value<T>(100));
+    Vec::loadu(src.data(), count).store(dst.data(), count);
+    for (int i = 0; i < count; i++) {
+      EXPECT_TRUE(same(dst[i], src[i])) << "count " << count << " i " << i;
+    }
+    for (int i = count; i <= Vec::size(); i++) {
+      EXPECT_TRUE(same(dst[i], value<T>(100))) << "wrote past count " << count;
+    }
+    // the elements past count are zero
+    std::vector<T> full(Vec::size());
+    Vec::loadu(src.data(), count).store(full.data());
+    for (int i = count; i < Vec::size(); i++) {
+      EXPECT_TRUE(same(full[i], T(0)));
+    }
+  }
+  Vec broadcast(value<T>(3));
+  for (int i = 0; i < Vec::size(); i++) {
+    EXPECT_TRUE(same(broadcast[i], value<T>(3)));
+  }
+}
+
+TYPED_TEST(VecTypedTest, Arithmetic) {
+  SKIP_IF_UNSUPPORTED();
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  const auto a = values<T>(Vec::size());
+  const auto b = values<T>(Vec::size(), 5);
+  const Vec va = Vec::loadu(a.data());
+  const Vec vb = Vec::loadu(b.data());
+  const Vec sum = va + vb;
+  const Vec diff = va - vb;
+  const Vec prod = va * vb;
+  const Vec neg = va.neg();
+  for (int i = 0; i < Vec::size(); i++) {
+    // Scalar BFloat16 / Half compute in float and round, like the vectors.
+    EXPECT_TRUE(same(sum[i], static_cast<T>(a[i] + b[i]))) << i;
+    EXPECT_TRUE(same(diff[i], static_cast<T>(a[i] - b[i]))) << i;
+    EXPECT_TRUE(same(neg[i], static_cast<T>(-a[i]))) << i;
+    if (c10::is_complex_t<T>::value) {
+      const auto expected = static_cast<T>(a[i] * b[i]);
+      EXPECT_NEAR(std::abs(prod[i] - expected), 0, 1e-5 * std::abs(expected)) << i;
+    } else {
+      EXPECT_TRUE(same(prod[i], static_cast<T>(a[i] * b[i]))) << i;
+    }
+  }
+}
+
+TYPED_TEST(VecTypedTest, BlendAndSet) {
+  SKIP_IF_UNSUPPORTED();
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  const auto a = values<T>(Vec::size());
+  const auto b = values<T>(Vec::size(), 9);
+  const Vec va = Vec::loadu(a.data());
+  const Vec vb = Vec::loadu(b.data());
+  const Vec blended = Vec::template blend<0x5>(va, vb);
+  for (int i = 0; i < Vec::size(); i++) {
+    EXPECT_TRUE(same(blended[i], (i == 0 || i == 2) ? b[i] : a[i])) << i;
+  }
+  for (int count = 0; count <= Vec::size(); count++) {
+    const Vec set = Vec::set(va, vb, count);
+    for (int i = 0; i < Vec::size(); i++) {
+      EXPECT_TRUE(same(set[i], i < count ? b[i] : a[i])) << count << " " << i;
+    }
+  }
+  const Vec selected = Vec::blendv(va, vb, va == vb.neg().neg());
+  for (int i = 0; i < Vec::size(); i++) {
+    EXPECT_TRUE(same(selected[i], same(a[i], b[i]) ? b[i] : a[i])) << i;
+  }
+}
+
+template <typename T>
+class VecRealTest : public ::testing::Test {};
+
+using VecRealTypes = ::testing::Types<
+    float,
+    double,
+    int64_t,
+    int32_t,
+    int16_t,
+    int8_t,
+    uint8_t,
+    c10::BFloat16,
+    c10::Half>;
+TYPED_TEST_SUITE(VecRealTest, VecRealTypes);
+
+TYPED_TEST(VecRealTest, CompareMinMax) {
+  SKIP_IF_UNSUPPORTED();
+  using T = TypeParam;
+  using Vec = Vectorized<T>;
+  auto a = values<T>(Vec::size());
+  auto b = values<T>(Vec::size(), 4);
+  b[1] = a[1];
+  const Vec va = Vec::loadu(a.data());
+  const Vec vb = Vec::loadu(b.data());
+  const Vec lt = va.lt(vb), le = va.le(vb), gt = va.gt(vb), ge = va.ge(vb), eq = va.eq(vb), ne = va.ne(vb);
+  const Vec lt_mask = va < vb;
+  const Vec max = maximum(va, vb), min = minimum(va, vb);
+  const Vec clamped = clamp(va, Vec(T(-3)), Vec(T(4)));
+  for (int i = 0; i < Vec::size(); i++) {
+    EXPECT_TRUE(same(lt[i], T(a[i] < b[i]))) << i;
+    EXPECT_TRUE(same(le[i], T(a[i] <= b[i]))) << i;
+    EXPECT_TRUE(same(gt[i], T(a[i] > b[i]))) << i;
+    EXPECT_TRUE(same(ge[i], T(a[i] >= b[i]))) << i;
+    EXPECT_TRUE(same(eq[i], T(a[i] == b[i]))) << i;
+    EXPECT_TRUE(same(ne[i], T(a[i] != b[i]))) << i;
+    EXPECT_TRUE(same(max[i], a[i] > b[i] ? a[i] : b[i])) << i;
+    EXPECT_TRUE(same(min[i], a[i] < b[i] ? a[i] : b[i])) << i;
+    EXPECT_TRUE(same(clamped[i], std::min(std::max(a[i], T(-3)), T(4)))) << i;
+  }
+  int64_t expected_zero_mask = 0;
+  for (int i = 0; i < Vec::size(); i++) {
+    if (!(a[i] < b[i])) {
+      expected_zero_mask |= int64_t(1) << i;
+    }
+  }
+  EXPECT_EQ(lt.zero_mask(), expected_zero_mask);
+  // masks select like the 1 / 0 results
+  const Vec selected = Vec::blendv(vb, va, lt_mask);
+  for (int i = 0; i < Vec::size(); i++) {
+    EXPECT_TRUE(same(selected[i], a[i] < b[i] ? a[i] : b[i])) << i;
+  }
+  T sum = 0, mx = a[0], mn = a[0];
+  for (int i = 0; i < Vec::size(); i++) {
+    sum = sum + a[i];
+    mx = std::max(mx, a[i]);
+    mn = std::min(mn, a[i]);
+  }
+  if (std::is_integral<T>::value) {
+    EXPECT_TRUE(same(vec_reduce_add(va), sum));
+  } else {
+    EXPECT_NEAR(static_cast<double>(vec_reduce_add(va)), static_cast<double>(sum), 1e-2);
+  }
+  EXPECT_TRUE(same(vec_reduce_max(va), mx));
+  EXPECT_TRUE(same(vec_reduce_min(va), mn));
+}
+
+TEST(VecTest, ZeroMask) {
+  SKIP_IF_UNSUPPORTED();
+  using Vec = Vectorized<float>;
+  auto a = values<float>(Vec::size());
+  a[0] = 0.f;
+  a[3] = -0.f;
+  EXPECT_EQ(Vec::loadu(a.data()).zero_mask(), 0x9);
+  using IVec = Vectorized<int8_t>;
+  std::vector<int8_t> b(IVec::size(), 1);
+  b[IVec::size() - 1] = 0;
+  EXPECT_EQ(IVec::loadu(b.data()).zero_mask(), int64_t(1) << (IVec::size() - 1));
+}
+
+TEST(VecTest, MaximumMinimumPropagateNaN) {
+  SKIP_IF_UNSUPPORTED();
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  for (bool nan_first : {true, false}) {
+    Vectorized<float> a(nan_first ? nan : 1.f);
+    Vectorized<float> b(nan_first ? 1.f : nan);
+    EXPECT_TRUE(std::isnan(maximum(a, b)[0]));
+    EXPECT_TRUE(std::isnan(minimum(a, b)[0]));
+    Vectorized<double> c(nan_first ? nan : 1.);
+    Vectorized<double> d(nan_first ? 1. : nan);
+    EXPECT_TRUE(std::isnan(maximum(c, d)[0]));
+    EXPECT_TRUE(std::isnan(minimum(c, d)[0]));
+  }
+}
+
+TEST(VecTest, IntegerOps) {
+  SKIP_IF_UNSUPPORTED();
+  using Vec = Vectorized<int32_t>;
+  const auto a = values<int32_t>(Vec::size());
+  const Vec va = Vec::loadu(a.data());
+  const Vec shl = va << 3, shr = va >> 2, abs = va.abs();
+  const Vectorized<float> f = convert_to_fp_of_same_size(va);
+  for (int i = 0; i < Vec::size(); i++) {
+    EXPECT_EQ(shl[i], a[i] * 8);
+    EXPECT_EQ(shr[i], a[i] >> 2);
+    EXPECT_EQ(abs[i], std::abs(a[i]));
+    EXPECT_EQ(f[i], static_cast<float>(a[i]));
+  }
+  const Vectorized<float> g(-2.75f);
+  EXPECT_EQ(convert_to_int_of_same_size(g)[0], -2);
+  EXPECT_EQ(g.round()[0], -3.f);
+  EXPECT_EQ(Vectorized<float>(2.5f).round()[0], 2.f);
+  EXPECT_EQ(bits(cast<float>(cast<int32_t>(g))[0]), bits(-2.75f));
+  using BVec = Vectorized<uint8_t>;
+  const BVec x(static_cast<uint8_t>(200)), y(static_cast<uint8_t>(3));
+  EXPECT_EQ((x * y)[0], static_cast<uint8_t>(600 & 0xFF));
+  EXPECT_EQ(maximum(x, y)[0], 200);
+  EXPECT_EQ((x > y)[0], 0xFF);
+}
+
+// Checks the approximations in vec_math.h (or libm, for DEFAULT) against
+// double precision libm, over a strided sweep of all floats.
+float max_ulp_error(
+    Vectorized<float> (Vectorized<float>::*vec_fn)() const,
+    double (*ref_fn)(double),
+    float lo,
+    float hi) {
+  std::vector<float> in;
+  for (uint64_t b = 0; b < (1ull << 32); b += 4099) {
+    const float f = from_bits(static_cast<uint32_t>(b));
+    if (f >= lo && f <= hi) {
+      in.push_back(f);
+    }
+  }
+  std::vector<float> out(in.size());
+  using Vec = Vectorized<float>;
+  size_t i = 0;
+  for (; i + Vec::size() <= in.size(); i += Vec::size()) {
+    (Vec::loadu(&in[i]).*vec_fn)().store(&out[i]);
+  }
+  (Vec::loadu(&in[i], in.size() - i).*vec_fn)().store(&out[i], in.size() - i);
+  double max_err = 0;
+  for (size_t j = 0; j < in.size(); j++) {
+    const double expected = ref_fn(in[j]);
+    const float expected_f = static_cast<float>(expected);
+    if (std::isinf(expected_f) || expected_f == 0.f) {
+      EXPECT_EQ(out[j], expected_f) << "input " << in[j];
+      continue;
+    }
+    // ulp of the float result
+    const double ulp = std::nextafter(std::fabs(expected_f), INFINITY) - std::fabs(expected_f);
+    max_err = std::max(max_err, std::fabs(out[j] - expected) / ulp);
+  }
+  return static_cast<float>(max_err);
+}
+
+TEST(VecTest, Exp) {
+  SKIP_IF_UNSUPPORTED();
+  EXPECT_LE(max_ulp_error(&Vectorized<float>::exp, std::exp, -88.f, 88.f), 2.f);
+  // denormal results
+  EXPECT_LE(max_ulp_error(&Vectorized<float>::exp, std::exp, -103.f, -88.f), 2.f);
+  const float inf = std::numeric_limits<float>::infinity();
+  const Vectorized<float> v = floats({-inf, -200.f, 200.f, inf, 0.f, -0.f, std::nanf(""), 1.f});
+  const Vectorized<float> e = v.exp();
+  EXPECT_EQ(e[0], 0.f);
+  EXPECT_EQ(e[1], 0.f);
+  EXPECT_EQ(e[2], inf);
+  EXPECT_EQ(e[3], inf);
+  EXPECT_EQ(e[4], 1.f);
+  EXPECT_EQ(e[5], 1.f);
+  EXPECT_TRUE(std::isnan(e[6]));
+}
+
+TEST(VecTest, Log) {
+  SKIP_IF_UNSUPPORTED();
+  const float inf = std::numeric_limits<float>::infinity();
+  EXPECT_LE(max_ulp_error(&Vectorized<float>::log, std::log, 0.f, inf), 2.f);
+  const Vectorized<float> v = floats({0.f, -0.f, -1.f, inf, std::nanf(""), 1.f, 1e-45f, 2.f});
+  const Vectorized<float> l = v.log();
+  EXPECT_EQ(l[0], -inf);
+  EXPECT_EQ(l[1], -inf);
+  EXPECT_TRUE(std::isnan(l[2]));
+  EXPECT_EQ(l[3], inf);
+  EXPECT_TRUE(std::isnan(l[4]));
+  EXPECT_EQ(l[5], 0.f);
+}
+
+TEST(VecTest, Tanh) {
+  SKIP_IF_UNSUPPORTED();
+  const float inf = std::numeric_limits<float>::infinity();
+  EXPECT_LE(max_ulp_error(&Vectorized<float>::tanh, std::tanh, -inf, inf), 3.f);
+  const Vectorized<float> t = floats({-inf, inf, -0.f, 0.f, 1e-30f, -20.f, 20.f, std::nanf("")}).tanh();
+  EXPECT_EQ(t[0], -1.f);
+  EXPECT_EQ(t[1], 1.f);
+  EXPECT_EQ(bits(t[2]), bits(-0.f));
+  EXPECT_EQ(bits(t[3]), bits(0.f));
+  EXPECT_EQ(t[4], 1e-30f);
+  EXPECT_TRUE(std::isnan(t[7]));
+}
+
+TEST(VecTest, Erf) {
+  SKIP_IF_UNSUPPORTED();
+  const float inf = std::numeric_limits<float>::infinity();
+  // The Taylor series region; A&S takes over at 0.5.
+  EXPECT_LE(max_ulp_error(&Vectorized<float>::erf, std::erf, -0.4999f, 0.4999f), 3.f);
+  std::vector<float> in;
+  for (float x = -6.f; x <= 6.f; x += 1.f / 1024) {
+    in.push_back(x);
+  }
+  using Vec = Vectorized<float>;
+  in.resize(in.size() / Vec::size() * Vec::size());
+  for (size_t i = 0; i < in.size(); i += Vec::size()) {
+    const Vec e = Vec::loadu(&in[i]).erf();
+    for (int j = 0; j < Vec::size(); j++) {
+      EXPECT_NEAR(e[j], std::erf(in[i + j]), 4e-7) << in[i + j];
+    }
+  }
+  const Vectorized<float> e = floats({-inf, inf, 0.f, std::nanf("")}).erf();
+  EXPECT_EQ(e[0], -1.f);
+  EXPECT_EQ(e[1], 1.f);
+  EXPECT_EQ(e[2], 0.f);
+  EXPECT_TRUE(std::isnan(e[3]));
+}
+
+TEST(VecTest, SinCos) {
+  SKIP_IF_UNSUPPORTED();
+  using Vec = Vectorized<float>;
+  // past 8192 the vector code hands the lanes to libm
+  std::vector<float> in;
+  for (float x = -10000.f; x <= 10000.f; x += 0.37f) {
+    in.push_back(x);
+  }
+  in.resize(in.size() / Vec::size() * Vec::size());
+  for (size_t i = 0; i < in.size(); i += Vec::size()) {
+    const Vec v = Vec::loadu(&in[i]);
+    const Vec s = v.sin(), c = v.cos();
+    for (int j = 0; j < Vec::size(); j++) {
+      ASSERT_NEAR(s[j], std::sin(static_cast<double>(in[i + j])), 1e-7) << in[i + j];
+      ASSERT_NEAR(c[j], std::cos(static_cast<double>(in[i + j])), 1e-7) << in[i + j];
+    }
+  }
+  const float inf = std::numeric_limits<float>::infinity();
+  const Vec s = floats({-0.f, 0.f, inf, std::nanf("")}).sin();
+  EXPECT_EQ(bits(s[0]), bits(-0.f));
+  EXPECT_EQ(bits(s[1]), bits(0.f));
+  EXPECT_TRUE(std::isnan(s[2]));
+  EXPECT_TRUE(std::isnan(s[3]));
+}
+
+TEST(VecTest, Atan2) {
+  SKIP_IF_UNSUPPORTED();
+  using Vec = Vectorized<float>;
+  std::vector<float> ys, xs;
+  for (int i = 0; i < 4096; i++) {
+    const double t = i * 0.01;
+    ys.push_back(static_cast<float>(std::sin(t * 1.7) * std::ldexp(1.0, i % 40 - 20)));
+    xs.push_back(static_cast<float>(std::cos(t) * std::ldexp(1.0, i % 37 - 18)));
+  }
+  for (size_t i = 0; i < ys.size(); i += Vec::size()) {
+    const Vec r = Vec::loadu(&ys[i]).atan2(Vec::loadu(&xs[i]));
+    for (int j = 0; j < Vec::size(); j++) {
+      const double expected = std::atan2(static_cast<double>(ys[i + j]), static_cast<double>(xs[i + j]));
+      ASSERT_LE(std::fabs(r[j] - expected), 4e-7 * std::fabs(expected)) << ys[i + j] << " " << xs[i + j];
+    }
+  }
+  const float inf = std::numeric_limits<float>::infinity();
+  const std::vector<float> y = {0.f, 0.f, -0.f, -0.f, inf, -inf, 1.f, std::nanf("")};
+  const std::vector<float> x = {0.f, -0.f, 0.f, -0.f, inf, -inf, -inf, 1.f};
+  const Vec r = Vec::loadu(y.data(), y.size()).atan2(Vec::loadu(x.data(), x.size()));
+  for (size_t j = 0; j < y.size(); j++) {
+    const float expected = std::atan2(y[j], x[j]);
+    if (std::isnan(expected)) {
+      EXPECT_TRUE(std::isnan(r[j])) << j;
+    } else {
+      EXPECT_FLOAT_EQ(r[j], expected) << j;
+      EXPECT_EQ(std::signbit(r[j]), std::signbit(expected)) << j;
+    }
+  }
+}
+
+TEST(VecTest, ReducedFloatRoundsLikeScalar) {
+  SKIP_IF_UNSUPPORTED();
+  using BVec = Vectorized<c10::BFloat16>;
+  using HVec = Vectorized<c10::Half>;
+  // values with more precision than BFloat16 / Half, including the rounding
+  // midpoints and NaNs
+  std::vector<float> f;
+  for (uint64_t b = 0; b < (1ull << 32); b += 32749) {
+    f.push_back(from_bits(static_cast<uint32_t>(b)));
+  }
+  for (uint32_t b : {0x3F808000u, 0x3F818000u, 0x7FC00001u, 0xFF800001u}) {
+    f.push_back(from_bits(b));
+  }
+  f.resize(f.size() / BVec::size() * BVec::size());
+  std::vector<c10::BFloat16> b(BVec::size());
+  std::vector<c10::Half> h(HVec::size());
+  const int half = Vectorized<float>::size();
+  for (size_t i = 0; i < f.size(); i += BVec::size()) {
+    const auto lo = Vectorized<float>::loadu(&f[i]);
+    const auto hi = Vectorized<float>::loadu(&f[i + half]);
+    BVec::from_float(lo, hi).store(b.data());
+    HVec::from_float(lo, hi).store(h.data());
+    for (int j = 0; j < BVec::size(); j++) {
+      EXPECT_EQ(b[j].x, c10::BFloat16(f[i + j]).x) << f[i + j];
+      EXPECT_EQ(h[j].x, c10::Half(f[i + j]).x) << f[i + j];
+    }
+    // loads are exact
+    const BVec vb = BVec::loadu(b.data());
+    for (int j = 0; j < BVec::size(); j++) {
+      EXPECT_EQ(bits(static_cast<float>(vb[j])), bits(static_cast<float>(b[j])));
+    }
+  }
+  // exp in float, then rounded
+  const BVec x(c10::BFloat16(1.7f));
+  EXPECT_EQ(x.exp()[0].x, c10::BFloat16(Vectorized<float>(static_cast<float>(x[0])).exp()[0]).x);
+}
+
+TEST(VecTest, ComplexOps) {
+  SKIP_IF_UNSUPPORTED();
+  using T = c10::complex<float>;
+  using Vec = Vectorized<T>;
+  const auto a = values<T>(Vec::size());
+  const auto b = values<T>(Vec::size(), 2);
+  const Vec va = Vec::loadu(a.data());
+  const Vec vb = Vec::loadu(b.data());
+  const Vec quot = va / vb, abs = va.abs(), conj = va.conj(), re = va.real(), im = va.imag();
+  const Vec recip = va.reciprocal(), exp = va.exp();
+  for (int i = 0; i < Vec::size(); i++) {
+    const T expected = a[i] / b[i];
+    EXPECT_NEAR(std::abs(quot[i] - expected), 0, 1e-5 * std::abs(expected));
+    EXPECT_NEAR(abs[i].real(), std::abs(a[i]), 1e-5 * std::abs(a[i]));
+    EXPECT_EQ(abs[i].imag(), 0.f);
+    EXPECT_TRUE(same(conj[i], T(a[i].real(), -a[i].imag())));
+    EXPECT_TRUE(same(re[i], T(a[i].real(), 0.f)));
+    EXPECT_TRUE(same(im[i], T(a[i].imag(), 0.f)));
+    EXPECT_NEAR(std::abs(recip[i] - T(1) / a[i]), 0, 1e-5 * std::abs(T(1) / a[i]));
+    EXPECT_NEAR(std::abs(exp[i] - std::exp(a[i])), 0, 1e-6 * std::abs(std::exp(a[i])));
+  }
+  auto c = a;
+  c[1] = T(c[1].real(), c[1].imag() + 1);
+  const Vec eq = va.eq(Vec::loadu(c.data()));
+  for (int i = 0; i < Vec::size(); i++) {
+    EXPECT_TRUE(same(eq[i], T(i == 1 ? 0.f : 1.f, 0.f))) << i;
+  }
+  EXPECT_EQ((va == Vec::loadu(c.data())).zero_mask(), 0x2);
+}
+
+template <typename T>
+class VecQuantizedTest : public ::testing::Test {};
+
+using VecQuantizedTypes = ::testing::Types<c10::qint8, c10::quint8, c10::qint32>;
+TYPED_TEST_SUITE(VecQuantizedTest, VecQuantizedTypes);
+
+template <typename T>
+int32_t quantize_ref(float x, float inverse_scale, int32_t zero_point) {
+  using U = typename T::underlying;
+  const double q = std::nearbyint(static_cast<double>(x * inverse_scale)) + zero_point;
+  return static_cast<int32_t>(std::min<double>(
+      std::max<double>(q, std::numeric_limits<U>::min()), std::numeric_limits<U>::max()));
+}
+
+TYPED_TEST(VecQuantizedTest, QuantizeDequantize) {
+  SKIP_IF_UNSUPPORTED();
+  using T = TypeParam;
+  using U = typename T::underlying;
+  using Vec = Vectorized<T>;
+  const float scale = 0.37f;
+  const float inverse_scale = 1.f / scale;
+  const int32_t zero_point = std::is_same<U, uint8_t>::value ? 100 : -3;
+
+  std::vector<float> in(Vec::size());
+  for (int i = 0; i < Vec::size(); i++) {
+    // hits the clamping for 8 bits, and the half way cases
+    in[i] = (i - Vec::size() / 2) * 0.37f * 4.5f;
+  }
+  in[0] = std::numeric_limits<float>::quiet_NaN();
+  in[1] = 1e20f;
+  in[2] = -1e20f;
+  typename Vec::float_vec_return_type f;
+  for (int i = 0; i < Vec::float_num_vecs(); i++) {
+    f[i] = Vectorized<float>::loadu(&in[i * Vectorized<float>::size()]);
+  }
+  const Vec q = Vec::quantize(f, scale, zero_point, inverse_scale);
+  EXPECT_EQ(static_cast<int32_t>(q[0].val_), zero_point) << "NaN";
+  for (int i = 1; i < Vec::size(); i++) {
+    EXPECT_EQ(static_cast<int32_t>(q[i].val_), quantize_ref<T>(in[i], inverse_scale, zero_point)) << in[i];
+  }
+
+  const auto deq = q.dequantize(Vectorized<float>(scale), Vectorized<float>(zero_point));
+  const auto deq_premul = q.dequantize(
+      Vectorized<float>(scale), Vectorized<float>(zero_point), Vectorized<float>(-zero_point * scale));
+  std::vector<U> qv(Vec::size());
+  q.store(qv.data());
+  for (int i = 0; i < Vec::size(); i++) {
+    const int v = i / Vectorized<float>::size(), j = i % Vectorized<float>::size();
+    const float expected = (static_cast<float>(qv[i]) - zero_point) * scale;
+    EXPECT_EQ(deq[v][j], expected);
+    EXPECT_NEAR(deq_premul[v][j], expected, 1e-6 * std::fabs(expected) + 1e-6);
+  }
+
+  const Vec zp(T(static_cast<U>(zero_point)));
+  const Vec six(T(static_cast<U>(zero_point + 16)));
+  const Vec relu = q.relu(zp), relu6 = q.relu6(zp, six);
+  for (int i = 0; i < Vec::size(); i++) {
+    EXPECT_EQ(relu[i].val_, std::max<U>(qv[i], zero_point));
+    EXPECT_EQ(relu6[i].val_, std::min<U>(std::max<U>(qv[i], zero_point), zero_point + 16));
+  }
+
+  const auto diff = q.widening_subtract(zp);
+  const Vec requantized = Vec::requantize_from_int(diff, 0.5f, zero_point);
+  for (int i = 0; i < Vec::size(); i++) {
+    const int v = i / Vectorized<int32_t>::size(), j = i % Vectorized<int32_t>::size();
+    const int32_t d = static_cast<int32_t>(qv[i]) - zero_point;
+    EXPECT_EQ(diff[v][j], d);
+    EXPECT_EQ(
+        static_cast<int32_t>(requantized[i].val_),
+        quantize_ref<T>(static_cast<float>(d), 0.5f, zero_point));
+  }
+}
+
+} // namespace
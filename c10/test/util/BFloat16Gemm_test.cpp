@@ -0,0 +1,189 @@
+#include <gtest/gtest.h>
+
+#include <c10/test/util/parallel_test_util.h>
+#include <c10/util/BFloat16Gemm.h>
+#include <c10/util/Exception.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using namespace c10;
+
+namespace {
+
+// BFloat16 values in [-1, 1)
+std::vector<BFloat16> random_matrix(int64_t n, uint32_t seed) {
+  std::vector<BFloat16> v(n);
+  for (auto& x : v) {
+    seed = seed * 1664525u + 1013904223u;
+    x = BFloat16(static_cast<float>(seed >> 8) / (1 << 23) - 1.f);
+  }
+  return v;
+}
+
+struct Problem {
+  Transpose trans_a;
+  Transpose trans_b;
+  int64_t m;
+  int64_t n;
+  int64_t k;
+  std::vector<BFloat16> a;
+  std::vector<BFloat16> b;
+
+  Problem(Transpose trans_a, Transpose trans_b, int64_t m, int64_t n, int64_t k)
+      : trans_a(trans_a),
+        trans_b(trans_b),
+        m(m),
+        n(n),
+        k(k),
+        a(random_matrix(m * k, 1)),
+        b(random_matrix(k * n, 2)) {}
+
+  int64_t lda() const {
+    return trans_a == Transpose::NoTrans ? k : m;
+  }
+  int64_t ldb() const {
+    return trans_b == Transpose::NoTrans ? n : k;
+  }
+  float a_at(int64_t i, int64_t p) const {
+    return trans_a == Transpose::NoTrans ? a[i * k + p] : a[p * m + i];
+  }
+  float b_at(int64_t p, int64_t j) const {
+    return trans_b == Transpose::NoTrans ? b[p * n + j] : b[j * k + p];
+  }
+
+  // Checks c against alpha * op(A) * op(B) + beta * c0, in double
+  void expect_close(
+      float alpha,
+      float beta,
+      const std::vector<float>& c0,
+      const std::vector<float>& c,
+      int64_t ldc) const {
+    for (int64_t i = 0; i < m; i++) {
+      for (int64_t j = 0; j < n; j++) {
+        double sum = 0;
+        double abs_sum = 0;
+        for (int64_t p = 0; p < k; p++) {
+          sum += static_cast<double>(a_at(i, p)) * b_at(p, j);
+          abs_sum += std::abs(static_cast<double>(a_at(i, p)) * b_at(p, j));
+        }
+        double expected = alpha * sum;
+        double tolerance = (k + 2) * 1.2e-7 * std::abs(alpha) * abs_sum + 1e-6;
+        if (beta != 0) {
+          expected += beta * c0[i * ldc + j];
+          tolerance += 1e-6 * std::abs(beta * c0[i * ldc + j]);
+        }
+        ASSERT_NEAR(c[i * ldc + j], expected, tolerance)
+            << "m " << m << " n " << n << " k " << k << " at " << i << ", " << j;
+      }
+    }
+  }
+};
+
+class BFloat16GemmTest : public c10::test::ParallelFixture {};
+
+// Sizes around the register tiles (4 x 16 and 6 x 32), the pairs of values
+// of k and the 96 x 128 blocks of the threads
+TEST_F(BFloat16GemmTest, AllTransposesAndEdgeSizes) {
+  const std::vector<std::vector<int64_t>> sizes = {
+      {1, 1, 1},    {4, 16, 2},     {6, 32, 8},    {5, 17, 3},   {7, 33, 5},
+      {13, 100, 64}, {100, 130, 257}, {200, 40, 31}, {1, 300, 1000}};
+  for (Transpose trans_a : {Transpose::NoTrans, Transpose::Trans}) {
+    for (Transpose trans_b : {Transpose::NoTrans, Transpose::Trans}) {
+      for (const auto& size : sizes) {
+        const Problem problem(trans_a, trans_b, size[0], size[1], size[2]);
+        const int64_t ldc = problem.n + 3;
+        std::vector<float> c0(problem.m * ldc);
+        for (size_t i = 0; i < c0.size(); i++) {
+          c0[i] = static_cast<float>(i % 7) - 3.f;
+        }
+        std::vector<float> c = c0;
+        gemm(
+            trans_a, trans_b, problem.m, problem.n, problem.k, 0.5f, problem.a.data(),
+            problem.lda(), problem.b.data(), problem.ldb(), -2.f, c.data(), ldc);
+        problem.expect_close(0.5f, -2.f, c0, c, ldc);
+        // the padding of C is left alone
+        for (int64_t i = 0; i < problem.m; i++) {
+          for (int64_t j = problem.n; j < ldc; j++) {
+            ASSERT_EQ(c[i * ldc + j], c0[i * ldc + j]);
+          }
+        }
+      }
+    }
+  }
+}
+
+TEST_F(BFloat16GemmTest, BetaZeroDoesNotReadC) {
+  const Problem problem(Transpose::NoTrans, Transpose::Trans, 20, 50, 40);
+  std::vector<float> c(problem.m * problem.n, std::numeric_limits<float>::quiet_NaN());
+  gemm(
+      Transpose::NoTrans, Transpose::Trans, problem.m, problem.n, problem.k, 1.f,
+      problem.a.data(), problem.lda(), problem.b.data(), problem.ldb(), 0.f, c.data(),
+      problem.n);
+  problem.expect_close(1.f, 0.f, c, c, problem.n);
+}
+
+TEST_F(BFloat16GemmTest, AlphaZeroOrEmptyKScalesC) {
+  const std::vector<BFloat16> a(12, BFloat16(std::numeric_limits<float>::infinity()));
+  const std::vector<BFloat16> b(12, BFloat16(1.f));
+  std::vector<float> c(12, 2.f);
+  gemm(
+      Transpose::NoTrans, Transpose::NoTrans, 3, 4, 3, 0.f, a.data(), 3, b.data(), 4, 3.f,
+      c.data(), 4);
+  for (float x : c) {
+    EXPECT_EQ(x, 6.f);
+  }
+  gemm(
+      Transpose::NoTrans, Transpose::NoTrans, 3, 4, 0, 1.f, a.data(), 1, b.data(), 4, 0.f,
+      c.data(), 4);
+  for (float x : c) {
+    EXPECT_EQ(x, 0.f);
+  }
+}
+
+TEST_F(BFloat16GemmTest, PackedMatrixIsReusable) {
+  const Problem problem(Transpose::NoTrans, Transpose::Trans, 30, 70, 45);
+  const PackedBFloat16Matrix packed(
+      Transpose::Trans, problem.k, problem.n, problem.b.data(), problem.ldb());
+  EXPECT_EQ(packed.k(), 45);
+  EXPECT_EQ(packed.n(), 70);
+  std::vector<float> first(problem.m * problem.n);
+  gemm(
+      Transpose::NoTrans, problem.m, 1.f, problem.a.data(), problem.lda(), packed, 0.f,
+      first.data(), problem.n);
+  problem.expect_close(1.f, 0.f, first, first, problem.n);
+  // a single row, as in a decoding step
+  std::vector<float> second(problem.n);
+  gemm(
+      Transpose::NoTrans, 1, 1.f, problem.a.data(), problem.lda(), packed, 0.f, second.data(),
+      problem.n);
+  for (int64_t j = 0; j < problem.n; j++) {
+    ASSERT_EQ(first[j], second[j]);
+  }
+}
+
+TEST_F(BFloat16GemmTest, InvalidArguments) {
+  const std::vector<BFloat16> a(16);
+  const std::vector<BFloat16> b(16);
+  std::vector<float> c(16);
+  EXPECT_THROW(PackedBFloat16Matrix(Transpose::NoTrans, -1, 2, b.data(), 2), c10::Error);
+  EXPECT_THROW(PackedBFloat16Matrix(Transpose::NoTrans, 2, 4, b.data(), 2), c10::Error);
+  const PackedBFloat16Matrix packed(Transpose::Trans, 4, 2, b.data(), 4);
+  EXPECT_THROW(
+      gemm(Transpose::NoTrans, -1, 1.f, a.data(), 4, packed, 0.f, c.data(), 2), c10::Error);
+  EXPECT_THROW(
+      gemm(Transpose::NoTrans, 2, 1.f, a.data(), 3, packed, 0.f, c.data(), 2), c10::Error);
+  EXPECT_THROW(
+      gemm(Transpose::Trans, 3, 1.f, a.data(), 2, packed, 0.f, c.data(), 2), c10::Error);
+  EXPECT_THROW(
+      gemm(Transpose::NoTrans, 2, 1.f, a.data(), 4, packed, 0.f, c.data(), 1), c10::Error);
+  EXPECT_THROW(
+      gemm(
+          Transpose::NoTrans, Transpose::NoTrans, 2, 2, -1, 1.f, a.data(), 2, b.data(), 2, 0.f,
+          c.data(), 2),
+      c10::Error);
+}
+
+} // namespace
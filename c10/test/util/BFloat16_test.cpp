@@ -0,0 +1,85 @@
+#include <gtest/gtest.h>
+
+#include <c10/util/BFloat16.h>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+uint32_t bits(float f) {
+  uint32_t b;
+  std::memcpy(&b, &f, sizeof(b));
+  return b;
+}
+
+float from_bits(uint32_t b) {
+  float f;
+  std::memcpy(&f, &b, sizeof(f));
+  return f;
+}
+
+// Floats that exercise float -> BFloat16 rounding: every BFloat16 value with
+// the dropped half at, just below and just above the tie, NaNs with all
+// kinds of payloads, plus a strided sweep over all bit patterns.
+std::vector<float> interestingFloats() {
+  std::vector<float> result;
+  for (uint32_t b = 0; b < 0x10000; ++b) {
+    for (uint32_t low : {0x0u, 0x1u, 0x7FFFu, 0x8000u, 0x8001u, 0xFFFFu}) {
+      result.push_back(from_bits((b << 16) | low));
+    }
+  }
+  for (uint64_t b = 0; b < (1ull << 32); b += 65521) {
+    result.push_back(from_bits(static_cast<uint32_t>(b)));
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(BFloat16Test, BulkBFloat16ToFloatIsBitExact) {
+  std::vector<c10::BFloat16> src(0x10000);
+  for (uint32_t b = 0; b < 0x10000; ++b) {
+    src[b].x = static_cast<uint16_t>(b);
+  }
+  // odd offsets and lengths to hit unaligned heads and tails
+  for (size_t offset : {0, 1, 7}) {
+    std::vector<float> dst(src.size() - offset);
+    c10::convert_bfloat16_to_float(src.data() + offset, dst.data(), dst.size());
+    for (size_t i = 0; i < dst.size(); ++i) {
+      ASSERT_EQ(bits(dst[i]), bits(c10::detail::f32_from_bits(src[i + offset].x)))
+          << "bfloat16 bits " << src[i + offset].x;
+    }
+  }
+}
+
+TEST(BFloat16Test, BulkFloatToBFloat16RoundsToNearestEven) {
+  const auto src = interestingFloats();
+  for (size_t offset : {0, 1, 7}) {
+    std::vector<c10::BFloat16> dst(src.size() - offset);
+    c10::convert_float_to_bfloat16(src.data() + offset, dst.data(), dst.size());
+    for (size_t i = 0; i < dst.size(); ++i) {
+      ASSERT_EQ(dst[i].x, c10::detail::round_to_nearest_even(src[i + offset]))
+          << "float bits " << bits(src[i + offset]);
+    }
+  }
+}
+
+TEST(BFloat16Test, BulkConvertShortLengths) {
+  for (size_t n = 0; n < 40; ++n) {
+    std::vector<float> f(n + 1, -1.0f);
+    std::vector<c10::BFloat16> b(n + 1, c10::BFloat16(-2.0f));
+    for (size_t i = 0; i < n; ++i) {
+      f[i] = static_cast<float>(i) + 0.5f;
+    }
+    c10::convert_float_to_bfloat16(f.data(), b.data(), n);
+    // nothing past n is written
+    EXPECT_EQ(static_cast<float>(b[n]), -2.0f);
+    std::vector<float> back(n + 1, -3.0f);
+    c10::convert_bfloat16_to_float(b.data(), back.data(), n);
+    EXPECT_EQ(back[n], -3.0f);
+    for (size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(back[i], f[i]);
+    }
+  }
+}
@@ -0,0 +1,41 @@
+#include <gtest/gtest.h>
+
+#include <c10/util/CPUCapability.h>
+
+#include <cstdlib>
+#include <cstring>
+
+using c10::cpu::CPUCapability;
+
+TEST(CPUCapabilityTest, FeaturesMatchCompilerBuiltins) {
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+  const auto& f = c10::cpu::cpuFeatures();
+  EXPECT_EQ(f.avx2, static_cast<bool>(__builtin_cpu_supports("avx2")));
+  EXPECT_EQ(f.fma, static_cast<bool>(__builtin_cpu_supports("fma")));
+  EXPECT_EQ(f.avx512f, static_cast<bool>(__builtin_cpu_supports("avx512f")));
+  EXPECT_EQ(f.avx512bw, static_cast<bool>(__builtin_cpu_supports("avx512bw")));
+  EXPECT_EQ(f.avx512vl, static_cast<bool>(__builtin_cpu_supports("avx512vl")));
+#endif
+}
+
+TEST(CPUCapabilityTest, CapabilityIsSupported) {
+  const auto& f = c10::cpu::cpuFeatures();
+  const auto capability = c10::cpu::getCPUCapability();
+  if (capability >= CPUCapability::AVX2) {
+    EXPECT_TRUE(f.avx2 && f.fma && f.f16c);
+  }
+  if (capability >= CPUCapability::AVX512) {
+    EXPECT_TRUE(f.avx512f && f.avx512bw && f.avx512vl);
+  }
+  // the override can only lower the level
+  const char* env = std::getenv("C10_CPU_CAPABILITY");
+  if (env != nullptr && std::strcmp(env, "default") == 0) {
+    EXPECT_EQ(capability, CPUCapability::DEFAULT);
+  }
+}
+
+TEST(CPUCapabilityTest, Names) {
+  EXPECT_STREQ(c10::cpu::toString(CPUCapability::DEFAULT), "default");
+  EXPECT_STREQ(c10::cpu::toString(CPUCapability::AVX2), "avx2");
+  EXPECT_STREQ(c10::cpu::toString(CPUCapability::AVX512), "avx512");
+}
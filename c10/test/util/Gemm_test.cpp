@@ -0,0 +1,264 @@
+#include <gtest/gtest.h>
+
+#include <c10/test/util/parallel_test_util.h>
+#include <c10/util/Exception.h>
+#include <c10/util/Gemm.h>
+#include <c10/util/Parallel.h>
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+using namespace c10;
+
+namespace {
+
+// Values in [-1, 1) from a fixed seed
+template <typename T>
+std::vector<T> random_values(int64_t n, uint32_t seed) {
+  std::vector<T> v(n);
+  uint32_t state = seed;
+  for (auto& x : v) {
+    state = state * 1664525u + 1013904223u;
+    x = static_cast<T>(static_cast<int32_t>(state >> 8) - (1 << 23)) / static_cast<T>(1 << 23);
+  }
+  return v;
+}
+
+struct Shape {
+  Transpose trans_a;
+  Transpose trans_b;
+  int64_t m;
+  int64_t n;
+  int64_t k;
+  // padding of the leading dimensions
+  int64_t pad;
+};
+
+// Storage of op(X), rows x cols, with ld = stored columns + pad
+struct Stored {
+  int64_t rows;
+  int64_t cols;
+  int64_t ld;
+};
+
+Stored stored(Transpose trans, int64_t rows, int64_t cols, int64_t pad) {
+  return trans == Transpose::NoTrans ? Stored{rows, cols, cols + pad}
+                                      : Stored{cols, rows, rows + pad};
+}
+
+template <typename T>
+T element(const std::vector<T>& x, Transpose trans, int64_t ld, int64_t i, int64_t j) {
+  return trans == Transpose::NoTrans ? x[i * ld + j] : x[j * ld + i];
+}
+
+// Runs gemm on random matrices and checks C against a double precision
+// product, within the error bound of a k-term dot product.
+template <typename T>
+void check_gemm(const Shape& s, T alpha, T beta) {
+  const Stored sa = stored(s.trans_a, s.m, s.k, s.pad);
+  const Stored sb = stored(s.trans_b, s.k, s.n, s.pad);
+  const int64_t ldc = s.n + s.pad;
+  const auto a = random_values<T>(sa.rows * sa.ld, 1);
+  const auto b = random_values<T>(sb.rows * sb.ld, 2);
+  const auto c0 = random_values<T>(s.m * ldc, 3);
+  auto c = c0;
+  gemm(
+      s.trans_a, s.trans_b, s.m, s.n, s.k, alpha, a.data(), sa.ld, b.data(), sb.ld, beta, c.data(),
+      ldc);
+  const double eps = std::numeric_limits<T>::epsilon();
+  for (int64_t i = 0; i < s.m; i++) {
+    for (int64_t j = 0; j < s.n; j++) {
+      double expected = 0;
+      double magnitude = 0;
+      for (int64_t p = 0; p < s.k; p++) {
+        const double product = static_cast<double>(element(a, s.trans_a, sa.ld, i, p)) *
+            element(b, s.trans_b, sb.ld, p, j);
+        expected += product;
+        magnitude += std::abs(product);
+      }
+      expected = alpha * expected + beta * c0[i * ldc + j];
+      magnitude = std::abs(alpha) * magnitude + std::abs(beta * c0[i * ldc + j]);
+      ASSERT_NEAR(c[i * ldc + j], expected, (s.k + 2) * eps * magnitude)
+          << "m " << s.m << " n " << s.n << " k " << s.k << " at " << i << ", " << j;
+    }
+    // the padding is left alone
+    for (int64_t j = s.n; j < ldc; j++) {
+      ASSERT_EQ(c[i * ldc + j], c0[i * ldc + j]);
+    }
+  }
+}
+
+// Sizes around the register tiles (6 x 16 to 6 x 32), the 96-row blocks, the
+// 256-deep panels and the 2048 or 4096-column panels
+const std::vector<std::vector<int64_t>> kSizes = {
+    {1, 1, 1},    {6, 16, 8},   {6, 32, 4},  {7, 33, 5},   {13, 17, 300},
+    {100, 70, 257}, {97, 130, 64}, {3, 4200, 20}, {250, 9, 513}};
+
+class GemmTest : public c10::test::ParallelFixture {};
+
+TEST_F(GemmTest, AllTransposesAndEdgeSizes) {
+  for (Transpose ta : {Transpose::NoTrans, Transpose::Trans}) {
+    for (Transpose tb : {Transpose::NoTrans, Transpose::Trans}) {
+      for (const auto& size : kSizes) {
+        const Shape shape{ta, tb, size[0], size[1], size[2], 3};
+        check_gemm<float>(shape, 1.5f, 0.5f);
+        check_gemm<double>(shape, -0.75, 1.0);
+      }
+    }
+  }
+}
+
+TEST_F(GemmTest, DenseMatrices) {
+  check_gemm<float>({Transpose::NoTrans, Transpose::NoTrans, 150, 200, 300, 0}, 1.0f, 0.0f);
+  check_gemm<double>({Transpose::Trans, Transpose::NoTrans, 64, 64, 64, 0}, 2.0, 0.0);
+}
+
+TEST_F(GemmTest, BetaZeroDoesNotReadC) {
+  const int64_t m = 20;
+  const int64_t n = 37;
+  const int64_t k = 11;
+  const auto a = random_values<float>(m * k, 4);
+  const auto b = random_values<float>(k * n, 5);
+  std::vector<float> c(m * n, std::numeric_limits<float>::quiet_NaN());
+  gemm(Transpose::NoTrans, Transpose::NoTrans, m, n, k, 1.0f, a.data(), k, b.data(), n, 0.0f,
+       c.data(), n);
+  for (float x : c) {
+    ASSERT_FALSE(std::isnan(x));
+  }
+}
+
+TEST_F(GemmTest, AlphaZeroOrEmptyKScalesC) {
+  const int64_t m = 5;
+  const int64_t n = 9;
+  std::vector<double> a(m * 4, std::numeric_limits<double>::quiet_NaN());
+  std::vector<double> b(4 * n, std::numeric_limits<double>::quiet_NaN());
+  std::vector<double> c(m * n, 2.0);
+  gemm(Transpose::NoTrans, Transpose::NoTrans, m, n, 4, 0.0, a.data(), 4, b.data(), n, 3.0,
+       c.data(), n);
+  for (double x : c) {
+    ASSERT_EQ(x, 6.0);
+  }
+  gemm(Transpose::NoTrans, Transpose::NoTrans, m, n, 0, 1.0, a.data(), 1, b.data(), n, 0.0,
+       c.data(), n);
+  for (double x : c) {
+    ASSERT_EQ(x, 0.0);
+  }
+}
+
+// Each product of a batch equals the same product made alone, for small
+// products (one per thread) and large ones (each split over the threads)
+TEST_F(GemmTest, BatchedMatchesSingleProducts) {
+  for (const auto& size : std::vector<std::vector<int64_t>>{{7, 9, 13}, {130, 140, 150}}) {
+    const int64_t batch = 5;
+    const int64_t m = size[0];
+    const int64_t n = size[1];
+    const int64_t k = size[2];
+    // A is shared by the products, B transposed and padded
+    const int64_t ldb = k + 2;
+    const int64_t stride_b = n * ldb;
+    const int64_t stride_c = m * n + 7;
+    const auto a = random_values<float>(m * k, 6);
+    const auto b = random_values<float>(batch * stride_b, 7);
+    const auto c0 = random_values<float>(batch * stride_c, 8);
+    auto c = c0;
+    gemm_batched(
+        Transpose::NoTrans, Transpose::Trans, batch, m, n, k, 0.5f, a.data(), k, 0, b.data(), ldb,
+        stride_b, 2.0f, c.data(), n, stride_c);
+    for (int64_t i = 0; i < batch; i++) {
+      std::vector<float> expected(c0.begin() + i * stride_c, c0.begin() + i * stride_c + m * n);
+      gemm(Transpose::NoTrans, Transpose::Trans, m, n, k, 0.5f, a.data(), k,
+           b.data() + i * stride_b, ldb, 2.0f, expected.data(), n);
+      for (int64_t j = 0; j < m * n; j++) {
+        ASSERT_EQ(c[i * stride_c + j], expected[j]) << "product " << i << " element " << j;
+      }
+      for (int64_t j = m * n; j < stride_c; j++) {
+        ASSERT_EQ(c[i * stride_c + j], c0[i * stride_c + j]);
+      }
+    }
+  }
+}
+
+// C matrices whose rows interleave, with ldc 4 and stride_c 2: the second
+// matrix fills the columns the first one skips
+TEST_F(GemmTest, BatchedInterleavedC) {
+  const int64_t m = 2;
+  const int64_t n = 2;
+  const int64_t k = 3;
+  const auto a = random_values<float>(2 * m * k, 11);
+  const auto b = random_values<float>(k * n, 12);
+  std::vector<float> c(m * 4);
+  gemm_batched(
+      Transpose::NoTrans, Transpose::NoTrans, 2, m, n, k, 1.0f, a.data(), k, m * k, b.data(), n, 0,
+      0.0f, c.data(), 4, 2);
+  for (int64_t i = 0; i < 2; i++) {
+    std::vector<float> expected(m * n);
+    gemm(Transpose::NoTrans, Transpose::NoTrans, m, n, k, 1.0f, a.data() + i * m * k, k,
+         b.data(), n, 0.0f, expected.data(), n);
+    for (int64_t r = 0; r < m; r++) {
+      for (int64_t j = 0; j < n; j++) {
+        ASSERT_EQ(c[i * 2 + r * 4 + j], expected[r * n + j]) << "product " << i;
+      }
+    }
+  }
+  // a third matrix would start on the second row of the first one
+  std::vector<float> a3(3 * m * k);
+  std::vector<float> c3(m * 4 + 4);
+  EXPECT_THROW(
+      gemm_batched(
+          Transpose::NoTrans, Transpose::NoTrans, 3, m, n, k, 1.0f, a3.data(), k, m * k, b.data(),
+          n, 0, 0.0f, c3.data(), 4, 2),
+      c10::Error);
+}
+
+TEST_F(GemmTest, ResultsDoNotDependOnThreadCount) {
+  const int64_t m = 300;
+  const int64_t n = 500;
+  const int64_t k = 600;
+  const auto a = random_values<float>(m * k, 9);
+  const auto b = random_values<float>(k * n, 10);
+  std::vector<float> c4(m * n);
+  gemm(Transpose::NoTrans, Transpose::NoTrans, m, n, k, 1.0f, a.data(), k, b.data(), n, 0.0f,
+       c4.data(), n);
+  set_num_threads(1);
+  std::vector<float> c1(m * n);
+  gemm(Transpose::NoTrans, Transpose::NoTrans, m, n, k, 1.0f, a.data(), k, b.data(), n, 0.0f,
+       c1.data(), n);
+  EXPECT_EQ(c1, c4);
+}
+
+TEST_F(GemmTest, InvalidArguments) {
+  float x[64] = {};
+  EXPECT_THROW(
+      gemm(Transpose::NoTrans, Transpose::NoTrans, -1, 2, 2, 1.0f, x, 2, x, 2, 0.0f, x, 2),
+      c10::Error);
+  // lda is less than k
+  EXPECT_THROW(
+      gemm(Transpose::NoTrans, Transpose::NoTrans, 2, 2, 3, 1.0f, x, 2, x, 2, 0.0f, x, 2),
+      c10::Error);
+  // lda is less than m for a transposed A
+  EXPECT_THROW(
+      gemm(Transpose::Trans, Transpose::NoTrans, 4, 2, 3, 1.0f, x, 3, x, 2, 0.0f, x, 2),
+      c10::Error);
+  EXPECT_THROW(
+      gemm(Transpose::NoTrans, Transpose::NoTrans, 2, 4, 2, 1.0f, x, 2, x, 4, 0.0f, x, 3),
+      c10::Error);
+  EXPECT_THROW(
+      gemm_batched(
+          Transpose::NoTrans, Transpose::NoTrans, 2, 2, 2, 2, 1.0f, x, 2, 4, x, 2, 4, 0.0f, x, 2,
+          3),
+      c10::Error);
+  // every product writes the same C
+  EXPECT_THROW(
+      gemm_batched(
+          Transpose::NoTrans, Transpose::NoTrans, 2, 2, 2, 2, 1.0f, x, 2, 4, x, 2, 4, 0.0f, x, 2,
+          0),
+      c10::Error);
+  // one element apart, but a single row each
+  gemm_batched(
+      Transpose::NoTrans, Transpose::NoTrans, 4, 1, 1, 2, 1.0f, x, 2, 2, x, 1, 2, 0.0f, x + 32, 1,
+      1);
+}
+
+} // namespace
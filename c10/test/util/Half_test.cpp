@@ -0,0 +1,95 @@
+#include <gtest/gtest.h>
+
+#include <c10/util/Half.h>
+
+#include <cstring>
+#include <vector>
+
+namespace {
+
+uint32_t bits(float f) {
+  uint32_t b;
+  std::memcpy(&b, &f, sizeof(b));
+  return b;
+}
+
+float from_bits(uint32_t b) {
+  float f;
+  std::memcpy(&f, &b, sizeof(f));
+  return f;
+}
+
+// Floats that exercise float -> Half rounding: every Half value, the
+// midpoints between neighbouring Halfs and their float neighbours, NaNs and
+// Infs of both signs, plus a strided sweep over all bit patterns.
+std::vector<float> interestingFloats() {
+  std::vector<float> result;
+  for (uint32_t h = 0; h < 0x10000; ++h) {
+    const uint32_t f = bits(c10::detail::fp16_ieee_to_fp32_value(h));
+    const uint32_t mid = f + (1u << 12);
+    for (uint32_t b : {f, f - 1, f + 1, mid, mid - 1, mid + 1}) {
+      result.push_back(from_bits(b));
+    }
+  }
+  for (uint32_t sign : {0u, 0x80000000u}) {
+    for (uint32_t payload : {0x1u, 0x2000u, 0x400000u, 0x7FFFFFu}) {
+      result.push_back(from_bits(sign | 0x7F800000u | payload));
+    }
+  }
+  for (uint64_t b = 0; b < (1ull << 32); b += 65521) {
+    result.push_back(from_bits(static_cast<uint32_t>(b)));
+  }
+  return result;
+}
+
+} // namespace
+
+TEST(HalfTest, BulkHalfToFloatIsBitExact) {
+  std::vector<c10::Half> src(0x10000);
+  for (uint32_t h = 0; h < 0x10000; ++h) {
+    src[h].x = static_cast<uint16_t>(h);
+  }
+  // odd offsets and lengths to hit unaligned heads and tails
+  for (size_t offset : {0, 1, 7}) {
+    std::vector<float> dst(src.size() - offset);
+    c10::convert_half_to_float(src.data() + offset, dst.data(), dst.size());
+    for (size_t i = 0; i < dst.size(); ++i) {
+      ASSERT_EQ(
+          bits(dst[i]),
+          bits(c10::detail::fp16_ieee_to_fp32_value(src[i + offset].x)))
+          << "half bits " << src[i + offset].x;
+    }
+  }
+}
+
+TEST(HalfTest, BulkFloatToHalfIsBitExact) {
+  const auto src = interestingFloats();
+  for (size_t offset : {0, 1, 7}) {
+    std::vector<c10::Half> dst(src.size() - offset);
+    c10::convert_float_to_half(src.data() + offset, dst.data(), dst.size());
+    for (size_t i = 0; i < dst.size(); ++i) {
+      ASSERT_EQ(
+          dst[i].x, c10::detail::fp16_ieee_from_fp32_value(src[i + offset]))
+          << "float bits " << bits(src[i + offset]);
+    }
+  }
+}
+
+TEST(HalfTest, BulkConvertShortLengths) {
+  for (size_t n = 0; n < 40; ++n) {
+    std::vector<float> f(n + 1, -1.0f);
+    std::vector<c10::Half> h(n + 1, c10::Half(-2.0f));
+    for (size_t i = 0; i < n; ++i) {
+      f[i] = static_cast<float>(i) + 0.5f;
+    }
+    c10::convert_float_to_half(f.data(), h.data(), n);
+    // nothing past n is written
+    EXPECT_EQ(static_cast<float>(h[n]), -2.0f);
+    std::vector<float> back(n + 1, -3.0f);
+    c10::convert_half_to_float(h.data(), back.data(), n);
+    EXPECT_EQ(back[n], -3.0f);
+    for (size_t i = 0; i < n; ++i) {
+      EXPECT_EQ(back[i], f[i]);
+    }
+  }
+}
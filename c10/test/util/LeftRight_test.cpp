@@ -0,0 +1,112 @@
+#include <gtest/gtest.h>
+
+#include <c10/util/LeftRight.h>
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+
+using c10::ShardedLeftRight;
+
+TEST(ShardedLeftRightTest, givenInt_whenWritingAndReading_thenChangesArePresent) {
+  ShardedLeftRight<int> obj;
+
+  obj.write([](int& obj) { obj = 5; });
+  int read = obj.read([](const int& obj) { return obj; });
+  EXPECT_EQ(5, read);
+
+  // check changes are also present in background copy
+  obj.write([](int&) {}); // this switches to the background copy
+  read = obj.read([](const int& obj) { return obj; });
+  EXPECT_EQ(5, read);
+}
+
+TEST(ShardedLeftRightTest, givenConcurrentReaders_whenWriting_thenReadersSeeConsistentState) {
+  // Both entries are always written together, so a reader must never see them differ.
+  ShardedLeftRight<std::array<int, 2>> obj;
+  std::atomic<bool> done{false};
+  std::atomic<int> mismatches{0};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 8; ++i) {
+    readers.emplace_back([&] {
+      while (!done.load()) {
+        obj.read([&](const std::array<int, 2>& v) {
+          if (v[0] != v[1]) {
+            ++mismatches;
+          }
+        });
+      }
+    });
+  }
+
+  for (int i = 1; i <= 1000; ++i) {
+    obj.write([i](std::array<int, 2>& v) {
+      v[0] = i;
+      v[1] = i;
+    });
+  }
+  done = true;
+  for (auto& t : readers) {
+    t.join();
+  }
+
+  EXPECT_EQ(0, mismatches.load());
+  EXPECT_EQ(1000, obj.read([](const std::array<int, 2>& v) { return v[0]; }));
+}
+
+TEST(ShardedLeftRightTest, givenWriter_whenReaderIsBlocked_thenWriterWaitsForIt) {
+  ShardedLeftRight<int> obj;
+  std::atomic<bool> reading{false};
+  std::atomic<bool> release{false};
+  std::atomic<bool> written{false};
+
+  std::thread reader([&] {
+    obj.read([&](const int&) {
+      reading = true;
+      while (!release.load()) {
+        std::this_thread::yield();
+      }
+    });
+  });
+  while (!reading.load()) {
+    std::this_thread::yield();
+  }
+
+  std::thread writer([&] {
+    obj.write([](int& v) { v = 1; });
+    written = true;
+  });
+
+  std::this_thread::sleep_for(std::chrono::milliseconds(50));
+  EXPECT_FALSE(written.load());
+  release = true;
+  reader.join();
+  writer.join();
+  EXPECT_TRUE(written.load());
+}
+
+TEST(ShardedLeftRightTest, givenCounterShards_whenAllocated_thenEachShardStartsACacheLine) {
+  auto* shards = c10::detail::allocateCounterShards();
+  for (size_t i = 0; i < c10::detail::kLeftRightNumShards; i++) {
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(&shards[i]) % C10_CACHE_LINE_SIZE);
+    EXPECT_EQ(0, shards[i].counters[0].load());
+    EXPECT_EQ(0, shards[i].counters[1].load());
+  }
+  c10::detail::freeCounterShards(shards);
+}
+
+TEST(ShardedLeftRightTest, givenHeapAllocatedInstance_whenReadingFromManyThreads_thenChangesArePresent) {
+  auto obj = std::make_unique<ShardedLeftRight<int>>();
+  obj->write([](int& obj) { obj = 5; });
+
+  // threads get shards round-robin, so as many threads cover all of them
+  for (size_t i = 0; i < c10::detail::kLeftRightNumShards; i++) {
+    std::thread reader([&] {
+      EXPECT_EQ(5, obj->read([](const int& obj) { return obj; }));
+    });
+    reader.join();
+  }
+}
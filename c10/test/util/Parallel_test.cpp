@@ -0,0 +1,312 @@
+#include <gtest/gtest.h>
+
+#include <c10/test/util/parallel_test_util.h>
+#include <c10/util/Parallel.h>
+
+#include <atomic>
+#include <chrono>
+#include <functional>
+#include <mutex>
+#include <set>
+#include <stdexcept>
+#include <thread>
+#include <vector>
+
+#ifndef _WIN32
+#include <pthread.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+namespace {
+
+class ParallelTest : public c10::test::ParallelFixture {};
+
+TEST_F(ParallelTest, ChunksCoverTheRangeOnce) {
+  for (int64_t n : {1, 7, 100, 1000, 12345}) {
+    for (int64_t grain : {0, 1, 3, 64, 5000}) {
+      std::vector<std::atomic<int>> hits(n);
+      for (auto& h : hits) {
+        h = 0;
+      }
+      c10::parallel_for(10, 10 + n, grain, [&](int64_t begin, int64_t end) {
+        EXPECT_LT(begin, end);
+        for (int64_t i = begin; i < end; i++) {
+          hits[i - 10]++;
+        }
+      });
+      for (int64_t i = 0; i < n; i++) {
+        ASSERT_EQ(hits[i], 1) << "n=" << n << " grain=" << grain << " i=" << i;
+      }
+    }
+  }
+}
+
+TEST_F(ParallelTest, EmptyRangeDoesNotCallFn) {
+  bool called = false;
+  c10::parallel_for(5, 5, 1, [&](int64_t, int64_t) { called = true; });
+  c10::parallel_for(5, 2, 1, [&](int64_t, int64_t) { called = true; });
+  EXPECT_FALSE(called);
+}
+
+TEST_F(ParallelTest, ChunksAreAtLeastGrainSize) {
+  std::mutex mutex;
+  std::vector<std::pair<int64_t, int64_t>> chunks;
+  c10::parallel_for(0, 1000, 100, [&](int64_t begin, int64_t end) {
+    std::lock_guard<std::mutex> guard(mutex);
+    chunks.emplace_back(begin, end);
+  });
+  for (const auto& chunk : chunks) {
+    if (chunk.second != 1000) {
+      EXPECT_GE(chunk.second - chunk.first, 100);
+    }
+  }
+}
+
+TEST_F(ParallelTest, SmallRangeRunsInline) {
+  const auto caller = std::this_thread::get_id();
+  int calls = 0;
+  c10::parallel_for(0, 100, 100, [&](int64_t begin, int64_t end) {
+    calls++;
+    EXPECT_EQ(std::this_thread::get_id(), caller);
+    EXPECT_EQ(begin, 0);
+    EXPECT_EQ(end, 100);
+    EXPECT_FALSE(c10::in_parallel_region());
+  });
+  EXPECT_EQ(calls, 1);
+}
+
+TEST_F(ParallelTest, UsesThePoolsThreads) {
+  EXPECT_EQ(c10::get_num_threads(), 4);
+  std::mutex mutex;
+  std::set<int> thread_nums;
+  std::set<std::thread::id> threads;
+  // Every chunk waits until every participant has one, so that they can't
+  // all go to the same thread.
+  std::atomic<int> started{0};
+  c10::parallel_for(0, 4, 1, [&](int64_t begin, int64_t end) {
+    EXPECT_TRUE(c10::in_parallel_region());
+    {
+      std::lock_guard<std::mutex> guard(mutex);
+      thread_nums.insert(c10::get_thread_num());
+      threads.insert(std::this_thread::get_id());
+    }
+    started += static_cast<int>(end - begin);
+    while (started < 4) {
+      std::this_thread::yield();
+    }
+  });
+  EXPECT_EQ(thread_nums, (std::set<int>{0, 1, 2, 3}));
+  EXPECT_EQ(threads.size(), 4);
+  EXPECT_FALSE(c10::in_parallel_region());
+  EXPECT_EQ(c10::get_thread_num(), 0);
+}
+
+#ifdef __GLIBC__
+TEST_F(ParallelTest, WorkersAreNamed) {
+  std::mutex mutex;
+  std::set<std::string> names;
+  std::atomic<int> started{0};
+  c10::parallel_for(0, 4, 1, [&](int64_t begin, int64_t end) {
+    if (c10::get_thread_num() != 0) {
+      char name[16] = {};
+      pthread_getname_np(pthread_self(), name, sizeof(name));
+      std::lock_guard<std::mutex> guard(mutex);
+      names.insert(name);
+    }
+    started += static_cast<int>(end - begin);
+    while (started < 4) {
+      std::this_thread::yield();
+    }
+  });
+  EXPECT_EQ(names, (std::set<std::string>{"c10_intraop"}));
+}
+#endif
+
+TEST_F(ParallelTest, NestedCallsRunInline) {
+  std::atomic<int64_t> total{0};
+  c10::parallel_for(0, 8, 1, [&](int64_t begin, int64_t end) {
+    const auto outer_thread = std::this_thread::get_id();
+    const int outer_num = c10::get_thread_num();
+    for (int64_t i = begin; i < end; i++) {
+      int calls = 0;
+      c10::parallel_for(0, 1000, 1, [&](int64_t b, int64_t e) {
+        calls++;
+        EXPECT_EQ(std::this_thread::get_id(), outer_thread);
+        EXPECT_EQ(c10::get_thread_num(), outer_num);
+        total += e - b;
+      });
+      EXPECT_EQ(calls, 1);
+    }
+  });
+  EXPECT_EQ(total, 8000);
+}
+
+TEST_F(ParallelTest, UnevenWorkIsStolen) {
+  // The first chunks are much slower than the rest; everything still runs
+  // exactly once.
+  std::vector<std::atomic<int>> hits(256);
+  for (auto& h : hits) {
+    h = 0;
+  }
+  c10::parallel_for(0, 256, 1, [&](int64_t begin, int64_t end) {
+    for (int64_t i = begin; i < end; i++) {
+      if (i < 8) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(2));
+      }
+      hits[i]++;
+    }
+  });
+  for (const auto& h : hits) {
+    EXPECT_EQ(h, 1);
+  }
+}
+
+TEST_F(ParallelTest, ExceptionIsRethrown) {
+  EXPECT_THROW(
+      c10::parallel_for(0, 1000, 1, [](int64_t begin, int64_t end) {
+        if (begin <= 500 && 500 < end) {
+          throw std::runtime_error("chunk failed");
+        }
+      }),
+      std::runtime_error);
+  // the pool is still usable
+  std::atomic<int64_t> total{0};
+  c10::parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) { total += end - begin; });
+  EXPECT_EQ(total, 1000);
+}
+
+TEST_F(ParallelTest, NegativeGrainSizeIsRejected) {
+  EXPECT_ANY_THROW(c10::parallel_for(0, 10, -1, [](int64_t, int64_t) {}));
+  EXPECT_ANY_THROW(c10::set_num_threads(0));
+}
+
+TEST_F(ParallelTest, SetNumThreads) {
+  for (int nthreads : {1, 3, 8}) {
+    c10::set_num_threads(nthreads);
+    EXPECT_EQ(c10::get_num_threads(), nthreads);
+    std::mutex mutex;
+    std::set<int> thread_nums;
+    std::atomic<int64_t> total{0};
+    c10::parallel_for(0, 10000, 1, [&](int64_t begin, int64_t end) {
+      std::lock_guard<std::mutex> guard(mutex);
+      thread_nums.insert(c10::get_thread_num());
+      total += end - begin;
+    });
+    EXPECT_EQ(total, 10000);
+    for (int num : thread_nums) {
+      EXPECT_GE(num, 0);
+      EXPECT_LT(num, nthreads);
+    }
+  }
+}
+
+TEST_F(ParallelTest, ConcurrentCallers) {
+  std::vector<std::thread> callers;
+  std::atomic<int64_t> total{0};
+  for (int t = 0; t < 4; t++) {
+    callers.emplace_back([&] {
+      for (int k = 0; k < 50; k++) {
+        c10::parallel_for(0, 1000, 10, [&](int64_t begin, int64_t end) { total += end - begin; });
+      }
+    });
+  }
+  for (auto& caller : callers) {
+    caller.join();
+  }
+  EXPECT_EQ(total, 4 * 50 * 1000);
+}
+
+TEST_F(ParallelTest, ReduceSums) {
+  std::vector<int64_t> x(100000);
+  for (size_t i = 0; i < x.size(); i++) {
+    x[i] = static_cast<int64_t>(i);
+  }
+  const int64_t n = static_cast<int64_t>(x.size());
+  for (int64_t grain : {0, 1, 1000, 200000}) {
+    const int64_t sum = c10::parallel_reduce(
+        0, n, grain, int64_t(0),
+        [&](int64_t begin, int64_t end, int64_t ident) {
+          int64_t partial = ident;
+          for (int64_t i = begin; i < end; i++) {
+            partial += x[i];
+          }
+          return partial;
+        },
+        std::plus<int64_t>());
+    EXPECT_EQ(sum, n * (n - 1) / 2);
+  }
+  EXPECT_EQ(
+      c10::parallel_reduce(
+          3, 3, 1, int64_t(42), [](int64_t, int64_t, int64_t) { return int64_t(0); },
+          std::plus<int64_t>()),
+      42);
+}
+
+TEST_F(ParallelTest, ReduceIsIndependentOfThreadCount) {
+  // float addition is not associative, so this only holds if the chunks and
+  // the combining order don't depend on the threads.
+  std::vector<float> x(1 << 18);
+  for (size_t i = 0; i < x.size(); i++) {
+    x[i] = 1.0f / static_cast<float>(i % 1000 + 1) + static_cast<float>(i % 7) * 1e3f;
+  }
+  auto sum = [&] {
+    return c10::parallel_reduce(
+        0, static_cast<int64_t>(x.size()), 100, 0.0f,
+        [&](int64_t begin, int64_t end, float ident) {
+          float partial = ident;
+          for (int64_t i = begin; i < end; i++) {
+            partial += x[i];
+          }
+          return partial;
+        },
+        std::plus<float>());
+  };
+  c10::set_num_threads(1);
+  const float expected = sum();
+  for (int nthreads : {2, 3, 4, 7}) {
+    c10::set_num_threads(nthreads);
+    for (int k = 0; k < 5; k++) {
+      EXPECT_EQ(sum(), expected) << nthreads << " threads";
+    }
+  }
+}
+
+#ifndef _WIN32
+TEST_F(ParallelTest, WorksAfterFork) {
+  // start the parent's pool first
+  std::atomic<int64_t> total{0};
+  c10::parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) { total += end - begin; });
+  ASSERT_EQ(total, 1000);
+
+  const pid_t pid = fork();
+  ASSERT_GE(pid, 0);
+  if (pid == 0) {
+    std::atomic<int64_t> child_total{0};
+    std::atomic<bool> used_worker{false};
+    std::atomic<int> started{0};
+    c10::parallel_for(0, 4, 1, [&](int64_t begin, int64_t end) {
+      if (c10::get_thread_num() != 0) {
+        used_worker = true;
+      }
+      child_total += end - begin;
+      started += static_cast<int>(end - begin);
+      while (started < 4) {
+        std::this_thread::yield();
+      }
+    });
+    _exit(child_total == 4 && used_worker ? 0 : 1);
+  }
+  int status = 0;
+  ASSERT_EQ(waitpid(pid, &status, 0), pid);
+  ASSERT_TRUE(WIFEXITED(status));
+  EXPECT_EQ(WEXITSTATUS(status), 0);
+
+  // and the parent's pool still works
+  total = 0;
+  c10::parallel_for(0, 1000, 1, [&](int64_t begin, int64_t end) { total += end - begin; });
+  EXPECT_EQ(total, 1000);
+}
+#endif
+
+} // namespace
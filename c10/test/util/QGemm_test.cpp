@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <c10/test/util/parallel_test_util.h>
+#include <c10/util/Exception.h>
+#include <c10/util/QGemm.h>
+
+#include <cstdint>
+#include <vector>
+
+using namespace c10;
+
+namespace {
+
+uint32_t next(uint32_t& state) {
+  state = state * 1664525u + 1013904223u;
+  return state >> 8;
+}
+
+// Activations in [0, max_value]
+std::vector<quint8> random_activations(int64_t n, uint32_t seed, int max_value) {
+  std::vector<quint8> v(n);
+  for (auto& x : v) {
+    x = quint8(static_cast<uint8_t>(next(seed) % (max_value + 1)));
+  }
+  return v;
+}
+
+std::vector<qint8> random_weights(int64_t n, uint32_t seed) {
+  std::vector<qint8> v(n);
+  for (auto& x : v) {
+    x = qint8(static_cast<int8_t>(static_cast<int>(next(seed) % 256) - 128));
+  }
+  return v;
+}
+
+struct Problem {
+  int64_t m;
+  int64_t n;
+  int64_t k;
+  Transpose trans;
+  int32_t a_zero_point;
+  int32_t b_zero_point;
+  std::vector<quint8> a;
+  std::vector<qint8> b;
+
+  Problem(int64_t m, int64_t n, int64_t k, Transpose trans, int max_activation)
+      : m(m),
+        n(n),
+        k(k),
+        trans(trans),
+        a_zero_point(max_activation / 3),
+        b_zero_point(-5),
+        a(random_activations(m * k, 1, max_activation)),
+        b(random_weights(k * n, 2)) {}
+
+  int64_t ldb() const {
+    return trans == Transpose::NoTrans ? n : k;
+  }
+
+  PackedQInt8Matrix pack() const {
+    return PackedQInt8Matrix(trans, k, n, b.data(), ldb(), b_zero_point);
+  }
+
+  int32_t expected(int64_t i, int64_t j) const {
+    int64_t sum = 0;
+    for (int64_t p = 0; p < k; p++) {
+      const int64_t bv = trans == Transpose::NoTrans ? b[p * n + j].val_ : b[j * k + p].val_;
+      sum += (a[i * k + p].val_ - a_zero_point) * (bv - b_zero_point);
+    }
+    return static_cast<int32_t>(sum);
+  }
+};
+
+void expect_exact(const Problem& problem) {
+  const PackedQInt8Matrix packed = problem.pack();
+  const int64_t ldc = problem.n + 3;
+  std::vector<qint32> c(problem.m * ldc, qint32(12345));
+  qgemm(problem.m, problem.a.data(), problem.k, problem.a_zero_point, packed, c.data(), ldc);
+  for (int64_t i = 0; i < problem.m; i++) {
+    for (int64_t j = 0; j < problem.n; j++) {
+      ASSERT_EQ(c[i * ldc + j].val_, problem.expected(i, j))
+          << "m " << problem.m << " n " << problem.n << " k " << problem.k << " at " << i << ", "
+          << j;
+    }
+    for (int64_t j = problem.n; j < ldc; j++) {
+      ASSERT_EQ(c[i * ldc + j].val_, 12345);
+    }
+  }
+}
+
+class QGemmTest : public c10::test::ParallelFixture {};
+
+// Sizes around the register tiles (4 x 16 and 6 x 32), the groups of 4
+// values of k and the 96 x 128 blocks of the threads.  Activations stay in
+// [0, 127], where vpmaddubsw does not saturate.
+TEST_F(QGemmTest, MatchesReference) {
+  const std::vector<std::vector<int64_t>> sizes = {
+      {1, 1, 1},   {4, 16, 4},  {6, 32, 8},    {5, 17, 3},  {7, 33, 5},
+      {13, 100, 64}, {100, 130, 257}, {200, 40, 31}, {3, 300, 1000}};
+  for (Transpose trans : {Transpose::NoTrans, Transpose::Trans}) {
+    for (const auto& size : sizes) {
+      expect_exact(Problem(size[0], size[1], size[2], trans, 127));
+    }
+  }
+}
+
+// Activations above 127 take the split path of the vpmaddubsw kernels
+TEST_F(QGemmTest, FullRangeActivations) {
+  for (Transpose trans : {Transpose::NoTrans, Transpose::Trans}) {
+    expect_exact(Problem(37, 70, 129, trans, 255));
+    expect_exact(Problem(6, 32, 8, trans, 255));
+  }
+}
+
+TEST_F(QGemmTest, FusedRequantization) {
+  const Problem problem(50, 45, 77, Transpose::Trans, 127);
+  const PackedQInt8Matrix packed = problem.pack();
+  std::vector<int32_t> bias(problem.n);
+  for (int64_t j = 0; j < problem.n; j++) {
+    bias[j] = static_cast<int32_t>(j * 397 - 9000);
+  }
+  const RequantizationParams params = choose_requantization_params(0.0007, 120);
+  std::vector<quint8> c(problem.m * problem.n);
+  qgemm_requantize(
+      problem.m, problem.a.data(), problem.k, problem.a_zero_point, packed, bias.data(), params,
+      c.data(), problem.n);
+  int saturated = 0;
+  for (int64_t i = 0; i < problem.m; i++) {
+    for (int64_t j = 0; j < problem.n; j++) {
+      const quint8 expected = requantize_val(params, qint32(problem.expected(i, j) + bias[j]));
+      ASSERT_EQ(c[i * problem.n + j].val_, expected.val_) << "at " << i << ", " << j;
+      saturated += expected.val_ == 0 || expected.val_ == 255;
+    }
+  }
+  // the scale keeps most values off the bounds
+  EXPECT_LT(saturated, problem.m * problem.n / 4);
+}
+
+TEST_F(QGemmTest, PackedMatrixIsReusable) {
+  const Problem problem(20, 24, 36, Transpose::NoTrans, 100);
+  const PackedQInt8Matrix packed = problem.pack();
+  EXPECT_EQ(packed.k(), 36);
+  EXPECT_EQ(packed.n(), 24);
+  EXPECT_EQ(packed.zero_point(), -5);
+  std::vector<qint32> first(problem.m * problem.n);
+  std::vector<qint32> second(problem.m * problem.n);
+  qgemm(
+      problem.m, problem.a.data(), problem.k, problem.a_zero_point, packed, first.data(),
+      problem.n);
+  // a smaller batch of the same activations
+  qgemm(3, problem.a.data(), problem.k, problem.a_zero_point, packed, second.data(), problem.n);
+  for (int64_t i = 0; i < 3 * problem.n; i++) {
+    ASSERT_EQ(first[i].val_, second[i].val_);
+  }
+}
+
+TEST_F(QGemmTest, InvalidArguments) {
+  const std::vector<qint8> b(16);
+  const std::vector<quint8> a(16);
+  std::vector<qint32> c(16);
+  EXPECT_THROW(PackedQInt8Matrix(Transpose::NoTrans, -1, 2, b.data(), 2, 0), c10::Error);
+  EXPECT_THROW(PackedQInt8Matrix(Transpose::NoTrans, 2, 4, b.data(), 2, 0), c10::Error);
+  EXPECT_THROW(PackedQInt8Matrix(Transpose::Trans, 2, 2, b.data(), 2, 200), c10::Error);
+  const PackedQInt8Matrix packed(Transpose::Trans, 4, 2, b.data(), 4, 0);
+  EXPECT_THROW(qgemm(2, a.data(), 3, 0, packed, c.data(), 2), c10::Error);
+  EXPECT_THROW(qgemm(2, a.data(), 4, 0, packed, c.data(), 1), c10::Error);
+  EXPECT_THROW(qgemm(2, a.data(), 4, 256, packed, c.data(), 2), c10::Error);
+  std::vector<quint8> c8(4);
+  const RequantizationParams bad{1, 0, 0};
+  EXPECT_THROW(
+      qgemm_requantize(2, a.data(), 4, 0, packed, nullptr, bad, c8.data(), 2), c10::Error);
+}
+
+} // namespace
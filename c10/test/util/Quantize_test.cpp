@@ -0,0 +1,221 @@
+#include <gtest/gtest.h>
+
+#include <c10/test/util/parallel_test_util.h>
+#include <c10/util/Parallel.h>
+#include <c10/util/Quantize.h>
+
+#include <cmath>
+#include <limits>
+#include <vector>
+
+using c10::ScalarType;
+
+namespace {
+
+// Values around the rounding and saturation boundaries of scale and
+// zero_point, plus NaN and +-inf, in an order that spreads them over vector
+// lanes and the scalar tail.
+std::vector<float> interestingFloats(float scale, int32_t zero_point, size_t n) {
+  const float inf = std::numeric_limits<float>::infinity();
+  std::vector<float> special = {
+      0.f, -0.f, std::nanf(""), inf, -inf, 1e30f, -1e30f, 2.1e9f, -2.1e9f,
+      0.5f * scale, -0.5f * scale, 1.5f * scale, -2.5f * scale,
+      (127.5f - zero_point) * scale, (-128.5f - zero_point) * scale,
+      (255.5f - zero_point) * scale, (-0.5f - zero_point) * scale};
+  std::vector<float> result;
+  for (size_t i = 0; i < n; ++i) {
+    if (i % 3 == 0) {
+      result.push_back(special[(i / 3) % special.size()]);
+    } else {
+      result.push_back(std::sin(static_cast<float>(i)) * 300.f * scale);
+    }
+  }
+  return result;
+}
+
+template <typename T>
+void checkPerTensor(ScalarType dtype, float scale, int32_t zero_point) {
+  // enough elements for the vector loops of every capability, and a tail
+  const size_t n = 5 * 64 + 13;
+  const std::vector<float> src = interestingFloats(scale, zero_point, n);
+  std::vector<T> q(n);
+  c10::quantize_per_tensor(src.data(), q.data(), dtype, n, scale, zero_point);
+  const float inverse_scale = 1.0f / scale;
+  for (size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(q[i].val_, c10::quantize_val<T>(inverse_scale, zero_point, src[i]).val_)
+        << "input " << src[i] << " at " << i;
+  }
+  std::vector<float> deq(n);
+  c10::dequantize_per_tensor(q.data(), dtype, deq.data(), n, scale, zero_point);
+  for (size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(deq[i], c10::dequantize_val(scale, zero_point, q[i])) << "at " << i;
+  }
+}
+
+} // namespace
+
+TEST(QuantizeTest, QuantizeMatchesScalar) {
+  for (float scale : {0.02f, 1.f, 3.7f}) {
+    checkPerTensor<c10::qint8>(ScalarType::QInt8, scale, 3);
+    checkPerTensor<c10::quint8>(ScalarType::QUInt8, scale, 128);
+    checkPerTensor<c10::qint32>(ScalarType::QInt32, scale, -17);
+    checkPerTensor<c10::qint32>(ScalarType::QInt32, scale, 100);
+  }
+}
+
+TEST(QuantizeTest, QuantizeVal) {
+  const float inf = std::numeric_limits<float>::infinity();
+  // half to even
+  EXPECT_EQ(c10::quantize_val<c10::qint8>(1.f, 0, 2.5f).val_, 2);
+  EXPECT_EQ(c10::quantize_val<c10::qint8>(1.f, 0, -3.5f).val_, -4);
+  EXPECT_EQ(c10::quantize_val<c10::quint8>(1.f, 10, 300.f).val_, 255);
+  EXPECT_EQ(c10::quantize_val<c10::quint8>(1.f, 10, -300.f).val_, 0);
+  EXPECT_EQ(c10::quantize_val<c10::quint8>(1.f, 10, std::nanf("")).val_, 10);
+  EXPECT_EQ(c10::quantize_val<c10::qint32>(1.f, 0, inf).val_, std::numeric_limits<int32_t>::max());
+  EXPECT_EQ(c10::quantize_val<c10::qint32>(1.f, 0, -inf).val_, std::numeric_limits<int32_t>::min());
+  // qmax - zero_point is not a float, the largest float below it still is
+  // in range
+  EXPECT_EQ(c10::quantize_val<c10::qint32>(1.f, 100, 2147483520.f).val_, 2147483620);
+}
+
+TEST(QuantizeTest, PerChannel) {
+  const int64_t outer = 3;
+  const int64_t channels = 4;
+  for (int64_t inner : {1, 37, 130}) {
+    const size_t n = outer * channels * inner;
+    const std::vector<float> src = interestingFloats(0.1f, 0, n);
+    const std::vector<float> scales = {0.1f, 0.05f, 1.f, 0.3f};
+    const std::vector<int32_t> zero_points = {0, 5, -20, 127};
+    std::vector<c10::qint8> q(n);
+    c10::quantize_per_channel(
+        src.data(), q.data(), ScalarType::QInt8, outer, channels, inner,
+        scales.data(), zero_points.data());
+    std::vector<float> deq(n);
+    c10::dequantize_per_channel(
+        q.data(), ScalarType::QInt8, deq.data(), outer, channels, inner,
+        scales.data(), zero_points.data());
+    for (size_t i = 0; i < n; ++i) {
+      const int64_t c = (i / inner) % channels;
+      const c10::qint8 expected =
+          c10::quantize_val<c10::qint8>(1.0f / scales[c], zero_points[c], src[i]);
+      ASSERT_EQ(q[i].val_, expected.val_) << "at " << i;
+      ASSERT_EQ(deq[i], c10::dequantize_val(scales[c], zero_points[c], expected)) << "at " << i;
+    }
+  }
+}
+
+TEST(QuantizeTest, LargeArraysMatchScalar) {
+  // large enough to be split across threads, with chunks that start in the
+  // middle of a channel
+  c10::test::NumThreadsGuard num_threads(4);
+  const size_t n = 3 * c10::internal::GRAIN_SIZE + 13;
+  const std::vector<float> src = interestingFloats(0.5f, 3, n);
+  std::vector<c10::qint8> q(n);
+  c10::quantize_per_tensor(src.data(), q.data(), ScalarType::QInt8, n, 0.5f, 3);
+  std::vector<float> deq(n);
+  c10::dequantize_per_tensor(q.data(), ScalarType::QInt8, deq.data(), n, 0.5f, 3);
+  for (size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(q[i].val_, c10::quantize_val<c10::qint8>(2.f, 3, src[i]).val_) << "at " << i;
+    ASSERT_EQ(deq[i], c10::dequantize_val(0.5f, 3, q[i])) << "at " << i;
+  }
+
+  const int64_t outer = 2;
+  const int64_t channels = 300;
+  const int64_t inner = 257;
+  std::vector<float> scales(channels);
+  std::vector<int32_t> zero_points(channels);
+  for (int64_t c = 0; c < channels; c++) {
+    scales[c] = 0.1f + 0.01f * static_cast<float>(c);
+    zero_points[c] = static_cast<int32_t>(c % 50) - 25;
+  }
+  const std::vector<float> channel_src = interestingFloats(0.1f, 0, outer * channels * inner);
+  std::vector<c10::qint8> channel_q(channel_src.size());
+  c10::quantize_per_channel(
+      channel_src.data(), channel_q.data(), ScalarType::QInt8, outer, channels, inner,
+      scales.data(), zero_points.data());
+  std::vector<float> channel_deq(channel_src.size());
+  c10::dequantize_per_channel(
+      channel_q.data(), ScalarType::QInt8, channel_deq.data(), outer, channels, inner,
+      scales.data(), zero_points.data());
+  for (size_t i = 0; i < channel_src.size(); ++i) {
+    const int64_t c = (i / inner) % channels;
+    const c10::qint8 expected =
+        c10::quantize_val<c10::qint8>(1.0f / scales[c], zero_points[c], channel_src[i]);
+    ASSERT_EQ(channel_q[i].val_, expected.val_) << "at " << i;
+    ASSERT_EQ(channel_deq[i], c10::dequantize_val(scales[c], zero_points[c], expected)) << "at " << i;
+  }
+
+  const auto params = c10::choose_requantization_params(0.0123, 7);
+  std::vector<c10::qint32> acc(n);
+  for (size_t i = 0; i < n; ++i) {
+    acc[i] = c10::qint32(static_cast<int32_t>(i * 7919 % 40001) - 20000);
+  }
+  std::vector<c10::quint8> requantized(n);
+  c10::requantize(acc.data(), requantized.data(), n, params);
+  for (size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(requantized[i].val_, c10::requantize_val(params, acc[i]).val_) << "at " << i;
+  }
+}
+
+TEST(QuantizeTest, InvalidParameters) {
+  float src = 1.f;
+  c10::qint8 dst;
+  EXPECT_THROW(
+      c10::quantize_per_tensor(&src, &dst, ScalarType::QInt8, 1, 0.f, 0), c10::Error);
+  EXPECT_THROW(
+      c10::quantize_per_tensor(&src, &dst, ScalarType::QInt8, 1, 1.f, 128), c10::Error);
+  EXPECT_THROW(
+      c10::quantize_per_tensor(&src, &dst, ScalarType::Float, 1, 1.f, 0), c10::Error);
+  EXPECT_THROW(c10::choose_requantization_params(1.5, 0), c10::Error);
+  EXPECT_THROW(c10::choose_requantization_params(0.5, 256), c10::Error);
+}
+
+TEST(QuantizeTest, RequantizationParams) {
+  for (double m : {0.5, 0.75, 1e-3, 0.999999, 1.0 - 1e-12, std::ldexp(1.0, -31)}) {
+    const auto params = c10::choose_requantization_params(m, 0);
+    EXPECT_GE(params.multiplier, 1 << 30);
+    EXPECT_GE(params.shift, 31);
+    EXPECT_LE(params.shift, 61);
+    EXPECT_NEAR(std::ldexp(static_cast<double>(params.multiplier), -params.shift), m, m * 1e-9);
+  }
+}
+
+TEST(QuantizeTest, RequantizeMatchesScalar) {
+  const size_t n = 5 * 16 + 11;
+  std::vector<c10::qint32> src(n);
+  for (size_t i = 0; i < n; ++i) {
+    const int64_t v = static_cast<int64_t>(std::sin(static_cast<double>(i)) * 5000.0);
+    src[i] = c10::qint32(static_cast<int32_t>(v));
+  }
+  src[0] = c10::qint32(std::numeric_limits<int32_t>::max());
+  src[1] = c10::qint32(std::numeric_limits<int32_t>::min());
+  src[2] = c10::qint32(0);
+  for (double m : {0.0123, 0.5, 0.999, 1e-9}) {
+    for (int32_t zero_point : {0, 3, 128, 255}) {
+      const auto params = c10::choose_requantization_params(m, zero_point);
+      std::vector<c10::quint8> dst(n);
+      c10::requantize(src.data(), dst.data(), n, params);
+      for (size_t i = 0; i < n; ++i) {
+        ASSERT_EQ(dst[i].val_, c10::requantize_val(params, src[i]).val_)
+            << "input " << src[i].val_ << " multiplier " << m;
+      }
+    }
+  }
+}
+
+TEST(QuantizeTest, RequantizeRoundsHalfToEven) {
+  // 0.5 is exact in fixed point, so x * 0.5 has exact ties for odd x
+  const auto params = c10::choose_requantization_params(0.5, 100);
+  const std::vector<int32_t> in = {1, 3, 5, -1, -3, -5, 2, 7, 400, -400};
+  const std::vector<uint8_t> expected = {100, 102, 102, 100, 98, 98, 101, 104, 255, 0};
+  for (size_t i = 0; i < in.size(); ++i) {
+    EXPECT_EQ(c10::requantize_val(params, c10::qint32(in[i])).val_, expected[i]) << in[i];
+  }
+  // the exact result against double arithmetic, away from ties
+  const auto p = c10::choose_requantization_params(0.0123, 7);
+  for (int32_t x = -30000; x <= 30000; x += 37) {
+    const double exact = std::nearbyint(x * std::ldexp(static_cast<double>(p.multiplier), -p.shift));
+    const double clamped = std::min(std::max(exact + 7, 0.0), 255.0);
+    EXPECT_EQ(c10::requantize_val(p, c10::qint32(x)).val_, clamped) << x;
+  }
+}
@@ -0,0 +1,94 @@
+#include <gtest/gtest.h>
+
+#include <c10/util/RcuSnapshot.h>
+
+#include <array>
+#include <thread>
+#include <vector>
+
+using c10::RcuSnapshot;
+
+namespace {
+// Counts live instances so the tests can check old versions are reclaimed.
+struct Tracked {
+  static std::atomic<int> alive;
+  std::array<int, 2> v{{0, 0}};
+  Tracked() { ++alive; }
+  Tracked(const Tracked& rhs) : v(rhs.v) { ++alive; }
+  ~Tracked() { --alive; }
+};
+std::atomic<int> Tracked::alive{0};
+}
+
+TEST(RcuSnapshotTest, givenInt_whenWritingAndReading_thenChangesArePresent) {
+  RcuSnapshot<int> obj(3);
+  EXPECT_EQ(3, obj.read([](const int& v) { return v; }));
+
+  obj.write([](int& v) { v += 2; });
+  EXPECT_EQ(5, obj.read([](const int& v) { return v; }));
+
+  obj.publish(std::unique_ptr<int>(new int(7)));
+  EXPECT_EQ(7, *obj.snapshot());
+}
+
+TEST(RcuSnapshotTest, givenThrowingWrite_thenOldVersionIsKept) {
+  RcuSnapshot<int> obj(3);
+  EXPECT_THROW(obj.write([](int& v) { v = 4; throw std::runtime_error("fail"); }), std::runtime_error);
+  EXPECT_EQ(3, obj.read([](const int& v) { return v; }));
+}
+
+TEST(RcuSnapshotTest, givenSnapshot_whenWriting_thenSnapshotIsUnchangedAndOldVersionIsReclaimedAfterwards) {
+  {
+    RcuSnapshot<Tracked> obj;
+    std::atomic<bool> written{false};
+    std::thread writer;
+    {
+      auto snap = obj.snapshot();
+      writer = std::thread([&] {
+        obj.write([](Tracked& t) { t.v[0] = 1; });
+        written = true;
+      });
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      // the writer must wait for us before freeing the version we look at
+      EXPECT_FALSE(written.load());
+      EXPECT_EQ(0, snap->v[0]);
+      EXPECT_EQ(2, Tracked::alive.load());
+    }
+    writer.join();
+    EXPECT_EQ(1, Tracked::alive.load());
+    EXPECT_EQ(1, obj.snapshot()->v[0]);
+  }
+  EXPECT_EQ(0, Tracked::alive.load());
+}
+
+TEST(RcuSnapshotTest, givenConcurrentReaders_whenWriting_thenReadersSeeConsistentState) {
+  RcuSnapshot<std::array<int, 2>> obj;
+  std::atomic<bool> done{false};
+  std::atomic<int> mismatches{0};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 8; ++i) {
+    readers.emplace_back([&] {
+      while (!done.load()) {
+        auto snap = obj.snapshot();
+        if ((*snap)[0] != (*snap)[1]) {
+          ++mismatches;
+        }
+      }
+    });
+  }
+
+  for (int i = 1; i <= 1000; ++i) {
+    obj.write([i](std::array<int, 2>& v) {
+      v[0] = i;
+      v[1] = i;
+    });
+  }
+  done = true;
+  for (auto& t : readers) {
+    t.join();
+  }
+
+  EXPECT_EQ(0, mismatches.load());
+  EXPECT_EQ(1000, obj.read([](const std::array<int, 2>& v) { return v[0]; }));
+}
@@ -0,0 +1,132 @@
+#include <gtest/gtest.h>
+
+#include <c10/util/Registry.h>
+
+#include <atomic>
+#include <thread>
+#include <vector>
+
+// Note: we use a different namespace to test if the macros defined in
+// Registry.h actually works with a different namespace from c10.
+namespace c10_test {
+
+class Foo {
+ public:
+  explicit Foo(int x) : x_(x) {}
+  virtual ~Foo() {}
+  virtual int bar() const { return x_; }
+ protected:
+  int x_;
+};
+
+C10_DECLARE_REGISTRY(FooRegistry, Foo, int);
+C10_DEFINE_REGISTRY(FooRegistry, Foo, int);
+#define REGISTER_FOO(clsname) C10_REGISTER_CLASS(FooRegistry, clsname, clsname)
+
+class Bar : public Foo {
+ public:
+  explicit Bar(int x) : Foo(x) {}
+};
+REGISTER_FOO(Bar);
+
+class AnotherBar : public Foo {
+ public:
+  explicit AnotherBar(int x) : Foo(x + 1) {}
+};
+C10_REGISTER_CLASS_WITH_PRIORITY(FooRegistry, Bar2, c10::REGISTRY_FALLBACK, Bar);
+C10_REGISTER_CLASS_WITH_PRIORITY(FooRegistry, Bar2, c10::REGISTRY_PREFERRED, AnotherBar);
+
+TEST(RegistryTest, CanRunCreator) {
+  std::unique_ptr<Foo> bar(FooRegistry()->Create("Bar", 1));
+  ASSERT_TRUE(bar != nullptr) << "Cannot create bar.";
+  EXPECT_EQ(bar->bar(), 1);
+  EXPECT_TRUE(FooRegistry()->Has("Bar"));
+  EXPECT_TRUE(FooRegistry()->Has(std::string("Bar")));
+}
+
+TEST(RegistryTest, ReturnNullOnNonExistingCreator) {
+  EXPECT_EQ(FooRegistry()->Create("Non-existing bar", 1), nullptr);
+  EXPECT_FALSE(FooRegistry()->Has("Non-existing bar"));
+}
+
+TEST(RegistryTest, LooksUpStringView) {
+  const char buf[] = "BarBaz";
+  std::unique_ptr<Foo> bar(FooRegistry()->Create(c10::string_view(buf, 3), 2));
+  ASSERT_TRUE(bar != nullptr);
+  EXPECT_EQ(bar->bar(), 2);
+}
+
+TEST(RegistryTest, LooksUpCompileTimeHashedKey) {
+  constexpr c10::RegistryKey key = C10_REGISTRY_KEY("Bar");
+  static_assert(key.hash() == c10::util::crc64("Bar", 3).checksum(), "");
+  EXPECT_EQ(key.hash(), c10::RegistryKey(std::string("Bar")).hash());
+  std::unique_ptr<Foo> bar(FooRegistry()->Create(key, 4));
+  ASSERT_TRUE(bar != nullptr);
+  EXPECT_EQ(bar->bar(), 4);
+  EXPECT_FALSE(FooRegistry()->Has(C10_REGISTRY_KEY("Baz")));
+}
+
+TEST(RegistryTest, HashCollisionsAreResolvedByName) {
+  c10::Registry<std::string, std::unique_ptr<Foo>, int> registry;
+  registry.Register("Bar", [](int x) { return std::unique_ptr<Foo>(new Bar(x)); });
+  registry.Register("AnotherBar", [](int x) { return std::unique_ptr<Foo>(new AnotherBar(x)); });
+  // Pretend "AnotherBar" has the hash of "Bar"
+  c10::RegistryKey fake(
+      "AnotherBar", c10::RegistryKey("Bar").hash());
+  EXPECT_EQ(registry.Create(fake, 1), nullptr);
+  EXPECT_EQ(registry.Create("AnotherBar", 1)->bar(), 2);
+}
+
+TEST(RegistryTest, RegistryPriorities) {
+  std::unique_ptr<Foo> bar(FooRegistry()->Create("Bar2", 1));
+  ASSERT_TRUE(bar != nullptr);
+  EXPECT_EQ(bar->bar(), 2);
+}
+
+TEST(RegistryTest, LookupsSeeRegistrationsMadeBetweenThem) {
+  c10::Registry<std::string, std::unique_ptr<Foo>, int> registry;
+  for (int i = 0; i < 100; ++i) {
+    registry.Register("Key" + std::to_string(i), [](int x) { return std::unique_ptr<Foo>(new Bar(x)); });
+    if (i % 10 == 0) {
+      EXPECT_TRUE(registry.Has("Key" + std::to_string(i)));
+    }
+  }
+  EXPECT_EQ(registry.Keys().size(), 100);
+  EXPECT_FALSE(registry.Has("Key100"));
+  registry.Register(
+      "Key0", [](int x) { return std::unique_ptr<Foo>(new AnotherBar(x)); },
+      c10::REGISTRY_PREFERRED);
+  EXPECT_EQ(registry.Create("Key0", 1)->bar(), 2);
+}
+
+TEST(RegistryTest, ConcurrentRegisterAndCreate) {
+  c10::Registry<std::string, std::unique_ptr<Foo>, int> registry;
+  registry.Register("Bar", [](int x) { return std::unique_ptr<Foo>(new Bar(x)); });
+  std::atomic<bool> done{false};
+  std::atomic<int> failures{0};
+
+  std::vector<std::thread> readers;
+  for (int i = 0; i < 4; ++i) {
+    readers.emplace_back([&] {
+      while (!done.load()) {
+        auto foo = registry.Create("Bar", 3);
+        if (foo == nullptr || foo->bar() != 3) {
+          ++failures;
+        }
+      }
+    });
+  }
+  for (int i = 0; i < 200; ++i) {
+    registry.Register("Key" + std::to_string(i), [](int x) { return std::unique_ptr<Foo>(new Bar(x)); });
+  }
+  done = true;
+  for (auto& t : readers) {
+    t.join();
+  }
+
+  EXPECT_EQ(failures.load(), 0);
+  EXPECT_EQ(registry.Keys().size(), 201);
+  EXPECT_TRUE(registry.Has("Key199"));
+}
+
+} // namespace c10_test
@@ -0,0 +1,93 @@
+#include <gtest/gtest.h>
+
+#include <c10/test/util/parallel_test_util.h>
+#include <c10/util/Parallel.h>
+#include <c10/util/TypeCast.h>
+
+#include <cstring>
+#include <memory>
+
+using c10::ScalarType;
+
+namespace {
+
+// In range for every castable type, so that no cast is undefined behavior;
+// the negative values exercise the uint8 special case.
+const double kValues[] = {0, 1, -1, 2.5, -2.7, 3.5, 100, -100, 0.25, 42.75,
+                          -7.5, 127, 5, -3, 64, 9.5, 11, -12.25, 13, 0.5};
+constexpr size_t kNumValues = sizeof(kValues) / sizeof(kValues[0]);
+
+template <typename dest_t, typename src_t>
+void checkCast(ScalarType src_dtype, ScalarType dst_dtype) {
+  // enough elements to run through the vectorized main loops and the tails
+  const size_t n = 3 * 64 + 7;
+  // not std::vector, which has no data() for bool
+  std::unique_ptr<src_t[]> src(new src_t[n]);
+  for (size_t i = 0; i < n; ++i) {
+    src[i] = c10::static_cast_with_inter_type<src_t, double>::apply(
+        kValues[i % kNumValues] * (i % 3 == 2 ? 0.5 : 1.0));
+  }
+  std::unique_ptr<dest_t[]> dst(new dest_t[n]);
+  std::unique_ptr<dest_t[]> expected(new dest_t[n]);
+  for (size_t i = 0; i < n; ++i) {
+    expected[i] = c10::static_cast_with_inter_type<dest_t, src_t>::apply(src[i]);
+  }
+  c10::cast_buffer(src.get(), src_dtype, dst.get(), dst_dtype, n);
+  EXPECT_EQ(std::memcmp(dst.get(), expected.get(), n * sizeof(dest_t)), 0)
+      << "cast from " << src_dtype << " to " << dst_dtype;
+}
+
+template <typename dest_t>
+void checkCastsTo(ScalarType dst_dtype) {
+#define CHECK_CAST(src_t, name) checkCast<dest_t, src_t>(ScalarType::name, dst_dtype);
+  AT_FORALL_SCALAR_TYPES_WITH_COMPLEX_EXCEPT_COMPLEX_HALF(CHECK_CAST)
+#undef CHECK_CAST
+}
+
+} // namespace
+
+TEST(TypeCastTest, CastBufferMatchesStaticCast) {
+#define CHECK_CASTS_TO(dest_t, name) checkCastsTo<dest_t>(ScalarType::name);
+  AT_FORALL_SCALAR_TYPES_WITH_COMPLEX_EXCEPT_COMPLEX_HALF(CHECK_CASTS_TO)
+#undef CHECK_CASTS_TO
+}
+
+TEST(TypeCastTest, CastBufferUint8GoesThroughInt64) {
+  const float src[] = {-1.0f, -2.5f, 255.0f, -128.0f};
+  uint8_t dst[4];
+  c10::cast_buffer(src, ScalarType::Float, dst, ScalarType::Byte, 4);
+  EXPECT_EQ(dst[0], 255);
+  EXPECT_EQ(dst[1], 254);
+  EXPECT_EQ(dst[2], 255);
+  EXPECT_EQ(dst[3], 128);
+}
+
+TEST(TypeCastTest, CastBufferLargeBuffer) {
+  // large enough to be split across threads
+  c10::test::NumThreadsGuard num_threads(4);
+  const size_t n = 3 * c10::internal::GRAIN_SIZE + 5;
+  std::unique_ptr<float[]> src(new float[n]);
+  for (size_t i = 0; i < n; ++i) {
+    src[i] = static_cast<float>(kValues[i % kNumValues]) + static_cast<float>(i % 101);
+  }
+  std::unique_ptr<c10::BFloat16[]> dst(new c10::BFloat16[n]);
+  c10::cast_buffer(src.get(), ScalarType::Float, dst.get(), ScalarType::BFloat16, n);
+  for (size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(dst[i].x, c10::BFloat16(src[i]).x) << "at " << i;
+  }
+}
+
+TEST(TypeCastTest, CastBufferQuantizedTypesAreOnlyCopied) {
+  const c10::qint8 src[] = {c10::qint8(1), c10::qint8(-2), c10::qint8(3)};
+  c10::qint8 dst[3];
+  c10::cast_buffer(src, ScalarType::QInt8, dst, ScalarType::QInt8, 3);
+  EXPECT_EQ(dst[1].val_, -2);
+
+  EXPECT_EQ(c10::cast_buffer_kernel(ScalarType::QInt8, ScalarType::Float), nullptr);
+  EXPECT_EQ(c10::cast_buffer_kernel(ScalarType::Float, ScalarType::QUInt8), nullptr);
+  EXPECT_EQ(c10::cast_buffer_kernel(ScalarType::Float, ScalarType::ComplexHalf), nullptr);
+  EXPECT_NE(c10::cast_buffer_kernel(ScalarType::ComplexHalf, ScalarType::ComplexHalf), nullptr);
+  EXPECT_EQ(c10::cast_buffer_kernel(ScalarType::Undefined, ScalarType::Float), nullptr);
+  float f[3];
+  EXPECT_ANY_THROW(c10::cast_buffer(src, ScalarType::QInt8, f, ScalarType::Float, 3));
+}
@@ -0,0 +1,35 @@
+#pragma once
+
+#include <gtest/gtest.h>
+
+#include <c10/util/Parallel.h>
+
+namespace c10 {
+namespace test {
+
+// Sets the size of the intra-op pool for its scope, and restores the old
+// size on the way out, test failures included.
+class NumThreadsGuard {
+ public:
+  explicit NumThreadsGuard(int nthreads) : old_num_threads_(c10::get_num_threads()) {
+    c10::set_num_threads(nthreads);
+  }
+  ~NumThreadsGuard() {
+    c10::set_num_threads(old_num_threads_);
+  }
+  NumThreadsGuard(const NumThreadsGuard&) = delete;
+  NumThreadsGuard& operator=(const NumThreadsGuard&) = delete;
+
+ private:
+  int old_num_threads_;
+};
+
+// Fixture for tests of parallel code: each test runs with a pool of 4
+// threads, so that the work is split the same way on any machine.
+class ParallelFixture : public ::testing::Test {
+ private:
+  NumThreadsGuard num_threads_{4};
+};
+
+} // namespace test
+} // namespace c10
@@ -0,0 +1,110 @@
+#include <gtest/gtest.h>
+
+#include <c10/core/ScalarTypeToTypeMeta.h>
+#include <c10/test/util/parallel_test_util.h>
+#include <c10/util/typeid.h>
+
+#include <string>
+#include <vector>
+
+using caffe2::TypeMeta;
+
+TEST(TypeMetaTest, TrivialityFlags) {
+  EXPECT_TRUE(TypeMeta::Make<float>().isTriviallyCopyable());
+  EXPECT_TRUE(TypeMeta::Make<float>().isTriviallyDestructible());
+  EXPECT_TRUE(TypeMeta::Make<at::Half>().isTriviallyCopyable());
+  EXPECT_TRUE(TypeMeta::Make<c10::qint8>().isTriviallyCopyable());
+  EXPECT_TRUE(TypeMeta::Make<c10::complex<float>>().isTriviallyCopyable());
+  EXPECT_FALSE(TypeMeta::Make<std::string>().isTriviallyCopyable());
+  EXPECT_FALSE(TypeMeta::Make<std::string>().isTriviallyDestructible());
+
+  // trivial types take the memcpy / no-op paths
+  EXPECT_EQ(TypeMeta::Make<c10::qint8>().copy(), nullptr);
+  EXPECT_EQ(TypeMeta::Make<c10::qint8>().placementDelete(), nullptr);
+  EXPECT_NE(TypeMeta::Make<std::string>().copy(), nullptr);
+}
+
+TEST(TypeMetaTest, BulkCopyTrivial) {
+  std::vector<c10::qint8> src, dst(100, c10::qint8(0));
+  for (int i = 0; i < 100; ++i) {
+    src.emplace_back(static_cast<int8_t>(i));
+  }
+  TypeMeta::Make<c10::qint8>().copyItems(src.data(), dst.data(), src.size());
+  for (int i = 0; i < 100; ++i) {
+    EXPECT_EQ(dst[i].val_, i);
+  }
+}
+
+TEST(TypeMetaTest, BulkConstructCopyDestructNonTrivial) {
+  auto meta = TypeMeta::Make<std::string>();
+  constexpr size_t n = 10;
+  std::aligned_storage<sizeof(std::string), alignof(std::string)>::type src[n], dst[n];
+  meta.constructItems(src, n);
+  meta.constructItems(dst, n);
+  auto* typed_src = reinterpret_cast<std::string*>(src);
+  for (size_t i = 0; i < n; ++i) {
+    typed_src[i] = std::string(40, static_cast<char>('a' + i));
+  }
+  meta.copyItems(src, dst, n);
+  auto* typed_dst = reinterpret_cast<std::string*>(dst);
+  for (size_t i = 0; i < n; ++i) {
+    EXPECT_EQ(typed_dst[i], typed_src[i]);
+  }
+  meta.destructItems(src, n);
+  meta.destructItems(dst, n);
+}
+
+TEST(TypeMetaTest, BulkNonTrivialInParallelChunks) {
+  c10::test::NumThreadsGuard num_threads(4);
+  auto meta = TypeMeta::Make<std::string>();
+  constexpr size_t n = 5000;
+  using Storage = std::aligned_storage<sizeof(std::string), alignof(std::string)>::type;
+  std::vector<Storage> src(n), dst(n);
+  meta.constructItems(src.data(), n);
+  meta.constructItems(dst.data(), n);
+  auto* typed_src = reinterpret_cast<std::string*>(src.data());
+  auto* typed_dst = reinterpret_cast<std::string*>(dst.data());
+  for (size_t i = 0; i < n; ++i) {
+    EXPECT_TRUE(typed_dst[i].empty());
+    typed_src[i] = std::to_string(i) + std::string(32, 'x');
+  }
+  meta.copyItems(src.data(), dst.data(), n);
+  for (size_t i = 0; i < n; ++i) {
+    ASSERT_EQ(typed_dst[i], typed_src[i]);
+  }
+  meta.destructItems(src.data(), n);
+  meta.destructItems(dst.data(), n);
+}
+
+TEST(TypeMetaTest, ScalarTypeIndex) {
+#define CHECK_SCALAR_TYPE(T, name)                                       \
+  {                                                                      \
+    auto meta = TypeMeta::Make<T>();                                     \
+    EXPECT_TRUE(meta.isScalarType());                                    \
+    EXPECT_TRUE(meta.isScalarType(c10::ScalarType::name));               \
+    EXPECT_EQ(meta.toScalarType(), c10::ScalarType::name);               \
+    EXPECT_EQ(TypeMeta::fromScalarType(c10::ScalarType::name), meta);    \
+    EXPECT_EQ(meta.itemsize(), sizeof(T));                               \
+    EXPECT_EQ(meta.id(), TypeMeta::Id<T>());                             \
+  }
+  AT_FORALL_SCALAR_TYPES_WITH_COMPLEX_AND_QINTS(CHECK_SCALAR_TYPE)
+#undef CHECK_SCALAR_TYPE
+
+  EXPECT_FALSE(TypeMeta().isScalarType());
+  EXPECT_EQ(TypeMeta().toScalarType(), c10::ScalarType::Undefined);
+  EXPECT_EQ(TypeMeta::fromScalarType(c10::ScalarType::Undefined), TypeMeta());
+  EXPECT_EQ(TypeMeta().itemsize(), 0);
+}
+
+TEST(TypeMetaTest, NonScalarTypes) {
+  auto meta = TypeMeta::Make<std::string>();
+  EXPECT_FALSE(meta.isScalarType());
+  EXPECT_ANY_THROW(meta.toScalarType());
+  EXPECT_FALSE(c10::tryTypeMetaToScalarType(meta).has_value());
+  EXPECT_EQ(meta, TypeMeta::Make<std::string>());
+  EXPECT_NE(meta, TypeMeta::Make<std::vector<int64_t>>());
+  EXPECT_EQ(meta.itemsize(), sizeof(std::string));
+  EXPECT_EQ(meta.id(), TypeMeta::Id<std::string>());
+  EXPECT_TRUE(c10::ScalarType::Float == TypeMeta::Make<float>());
+  EXPECT_TRUE(c10::ScalarType::Float != meta);
+}
@@ -0,0 +1,319 @@
+#include <gtest/gtest.h>
+
+#include <c10/util/vmath.h>
+
+#include <cmath>
+#include <complex>
+#include <cstring>
+#include <limits>
+#include <vector>
+
+namespace {
+
+float from_bits(uint32_t b) {
+  float f;
+  std::memcpy(&f, &b, sizeof(f));
+  return f;
+}
+
+double sigmoid_ref(double x) {
+  return 1 / (1 + std::exp(-x));
+}
+
+double gelu_ref(double x) {
+  return x / 2 * (1 + std::erf(x / std::sqrt(2.0)));
+}
+
+// Distance in units of the last place of float, denormals included.
+double ulps(float actual, double expected) {
+  const float expected_f = static_cast<float>(expected);
+  if (std::isinf(expected_f)) {
+    return actual == expected_f ? 0 : std::numeric_limits<double>::infinity();
+  }
+  int exponent = 0;
+  std::frexp(expected_f, &exponent);
+  const double ulp = std::max(std::ldexp(1.0, exponent - 24), std::ldexp(1.0, -149));
+  return std::fabs(actual - expected) / ulp;
+}
+
+// Finite floats from a strided sweep over all bit patterns
+std::vector<float> sweep(float lo, float hi) {
+  std::vector<float> result;
+  for (uint64_t b = 0; b < (1ull << 32); b += 40009) {
+    const float f = from_bits(static_cast<uint32_t>(b));
+    if (f >= lo && f <= hi) {
+      result.push_back(f);
+    }
+  }
+  return result;
+}
+
+using FloatFn = void (*)(const float*, float*, size_t);
+
+void expectMaxUlps(FloatFn fn, double (*ref)(double), float lo, float hi, double max_ulps) {
+  const std::vector<float> in = sweep(lo, hi);
+  std::vector<float> out(in.size());
+  fn(in.data(), out.data(), in.size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    ASSERT_LE(ulps(out[i], ref(in[i])), max_ulps) << "input " << in[i];
+  }
+}
+
+// BFloat16 and Half values in order, so that neighbours differ by 1
+int32_t ordered(uint16_t bits) {
+  return bits & 0x8000 ? -static_cast<int32_t>(bits & 0x7FFF) : bits;
+}
+
+// Every finite value of T against the float reference rounded to T
+template <typename T>
+void expectWithinOneUlp(
+    void (*fn)(const T*, T*, size_t),
+    double (*ref)(double),
+    float lo) {
+  std::vector<T> in;
+  for (uint32_t b = 0; b < 0x10000; ++b) {
+    T t;
+    t.x = static_cast<uint16_t>(b);
+    const float f = static_cast<float>(t);
+    if (std::isfinite(f) && f >= lo) {
+      in.push_back(t);
+    }
+  }
+  std::vector<T> out(in.size());
+  fn(in.data(), out.data(), in.size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    const T expected = static_cast<T>(static_cast<float>(ref(static_cast<float>(in[i]))));
+    if (std::isnan(static_cast<float>(expected))) {
+      ASSERT_TRUE(std::isnan(static_cast<float>(out[i]))) << static_cast<float>(in[i]);
+    } else {
+      ASSERT_LE(std::abs(ordered(out[i].x) - ordered(expected.x)), 1)
+          << "input " << static_cast<float>(in[i]) << " result " << static_cast<float>(out[i])
+          << " expected " << static_cast<float>(expected);
+    }
+  }
+}
+
+double exp_ref(double x) {
+  return std::exp(x);
+}
+double log_ref(double x) {
+  return std::log(x);
+}
+double tanh_ref(double x) {
+  return std::tanh(x);
+}
+double erf_ref(double x) {
+  return std::erf(x);
+}
+
+// Complex values over many magnitudes and all quadrants, small enough that
+// the exps stay normal floats
+template <typename T>
+std::vector<c10::complex<T>> complexInputs(size_t n) {
+  std::vector<c10::complex<T>> result(n);
+  for (size_t i = 0; i < n; ++i) {
+    const double t = static_cast<double>(i);
+    const double scale = std::ldexp(1.0, static_cast<int>(i % 17) - 10);
+    result[i] = c10::complex<T>(
+        static_cast<T>(std::sin(t * 1.3) * scale), static_cast<T>(std::cos(t * 0.7) * scale));
+  }
+  return result;
+}
+
+std::complex<double> to_std(c10::complex<float> z) {
+  return {z.real(), z.imag()};
+}
+std::complex<double> to_std(c10::complex<double> z) {
+  return {z.real(), z.imag()};
+}
+
+template <typename T>
+void checkComplexMatchesScalar(double arg_eps, double exp_eps) {
+  const double eps = std::numeric_limits<T>::epsilon();
+  for (size_t n : {0, 1, 3, 7, 8, 9, 31, 67, 1000}) {
+    const std::vector<c10::complex<T>> a = complexInputs<T>(n);
+    std::vector<c10::complex<T>> b = complexInputs<T>(n + 5);
+    b.erase(b.begin(), b.begin() + 5);
+    std::vector<c10::complex<T>> out(n);
+    std::vector<T> real_out(n);
+
+    c10::vmath::mul(a.data(), b.data(), out.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      const std::complex<double> expected = to_std(a[i]) * to_std(b[i]);
+      ASSERT_LE(std::abs(to_std(out[i]) - expected), 4 * eps * std::abs(to_std(a[i])) * std::abs(to_std(b[i])))
+          << "n " << n << " at " << i;
+    }
+    std::vector<c10::complex<T>> acc = b;
+    c10::vmath::mul_add(a.data(), b.data(), acc.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      const std::complex<double> expected = to_std(b[i]) + to_std(a[i]) * to_std(b[i]);
+      ASSERT_LE(
+          std::abs(to_std(acc[i]) - expected),
+          4 * eps * (std::abs(to_std(b[i])) + std::abs(to_std(a[i])) * std::abs(to_std(b[i]))))
+          << "n " << n << " at " << i;
+    }
+
+    c10::vmath::conj(a.data(), out.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      ASSERT_EQ(out[i], std::conj(a[i])) << "n " << n << " at " << i;
+    }
+
+    c10::vmath::abs(a.data(), real_out.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      const double expected = std::abs(to_std(a[i]));
+      ASSERT_LE(std::fabs(real_out[i] - expected), 2 * eps * expected) << "n " << n << " at " << i;
+    }
+
+    c10::vmath::arg(a.data(), real_out.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      const double expected = std::arg(to_std(a[i]));
+      ASSERT_LE(std::fabs(real_out[i] - expected), arg_eps * std::fabs(expected))
+          << "n " << n << " at " << i;
+    }
+
+    c10::vmath::exp(a.data(), out.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      const std::complex<double> expected = std::exp(to_std(a[i]));
+      const double bound = exp_eps * std::abs(expected);
+      ASSERT_LE(std::fabs(out[i].real() - expected.real()), bound) << "n " << n << " at " << i;
+      ASSERT_LE(std::fabs(out[i].imag() - expected.imag()), bound) << "n " << n << " at " << i;
+    }
+
+    std::complex<double> expected_dot = 0;
+    double magnitude = 0;
+    for (size_t i = 0; i < n; ++i) {
+      expected_dot += std::conj(to_std(a[i])) * to_std(b[i]);
+      magnitude += std::abs(to_std(a[i])) * std::abs(to_std(b[i]));
+    }
+    const c10::complex<T> dot = c10::vmath::vdot(a.data(), b.data(), n);
+    ASSERT_LE(std::abs(to_std(dot) - expected_dot), 2 * eps * static_cast<double>(n) * magnitude)
+        << "n " << n;
+  }
+}
+
+} // namespace
+
+TEST(VmathTest, FloatErrorBounds) {
+  const float inf = std::numeric_limits<float>::infinity();
+  expectMaxUlps(c10::vmath::exp, exp_ref, -103.f, 88.f, 2);
+  expectMaxUlps(c10::vmath::log, log_ref, 0.f, inf, 2);
+  expectMaxUlps(c10::vmath::tanh, tanh_ref, -inf, inf, 2);
+  expectMaxUlps(c10::vmath::sigmoid, sigmoid_ref, -103.f, inf, 3);
+  expectMaxUlps(c10::vmath::erf, erf_ref, -0.49f, 0.49f, 3);
+  expectMaxUlps(c10::vmath::gelu, gelu_ref, 0.f, inf, 3);
+  expectMaxUlps(c10::vmath::gelu, gelu_ref, -1.f, 0.f, 10);
+
+  const std::vector<float> in = sweep(-inf, inf);
+  std::vector<float> out(in.size());
+  c10::vmath::erf(in.data(), out.data(), in.size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    ASSERT_NEAR(out[i], std::erf(static_cast<double>(in[i])), 4e-7) << in[i];
+  }
+  c10::vmath::gelu(in.data(), out.data(), in.size());
+  for (size_t i = 0; i < in.size(); ++i) {
+    if (in[i] < -1.f) {
+      ASSERT_NEAR(out[i], gelu_ref(in[i]), 2e-7 * std::fabs(in[i])) << in[i];
+    }
+  }
+}
+
+TEST(VmathTest, SpecialValues) {
+  const float inf = std::numeric_limits<float>::infinity();
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const std::vector<float> in = {-inf, inf, nan, 0.f, -200.f, 200.f};
+  std::vector<float> out(in.size());
+  c10::vmath::sigmoid(in.data(), out.data(), in.size());
+  EXPECT_EQ(out[0], 0.f);
+  EXPECT_EQ(out[1], 1.f);
+  EXPECT_TRUE(std::isnan(out[2]));
+  EXPECT_EQ(out[3], 0.5f);
+  EXPECT_EQ(out[4], 0.f);
+  EXPECT_EQ(out[5], 1.f);
+  c10::vmath::gelu(in.data(), out.data(), in.size());
+  EXPECT_TRUE(std::isnan(out[0])); // -inf * 0
+  EXPECT_EQ(out[1], inf);
+  EXPECT_TRUE(std::isnan(out[2]));
+  EXPECT_EQ(out[3], 0.f);
+  EXPECT_EQ(out[5], 200.f);
+}
+
+TEST(VmathTest, TailsAndInPlace) {
+  // every length up to a few vectors, in place
+  for (size_t n = 0; n < 70; ++n) {
+    std::vector<float> data(n);
+    std::vector<float> expected(n);
+    for (size_t i = 0; i < n; ++i) {
+      data[i] = 0.1f * static_cast<float>(i) - 3.f;
+      expected[i] = static_cast<float>(std::tanh(static_cast<double>(data[i])));
+    }
+    c10::vmath::tanh(data.data(), data.data(), n);
+    for (size_t i = 0; i < n; ++i) {
+      ASSERT_LE(ulps(data[i], expected[i]), 2) << "n " << n << " at " << i;
+    }
+  }
+}
+
+TEST(VmathTest, BFloat16WithinOneUlp) {
+  const float inf = std::numeric_limits<float>::infinity();
+  expectWithinOneUlp<c10::BFloat16>(c10::vmath::exp, exp_ref, -inf);
+  expectWithinOneUlp<c10::BFloat16>(c10::vmath::log, log_ref, -inf);
+  expectWithinOneUlp<c10::BFloat16>(c10::vmath::tanh, tanh_ref, -inf);
+  expectWithinOneUlp<c10::BFloat16>(c10::vmath::sigmoid, sigmoid_ref, -inf);
+  expectWithinOneUlp<c10::BFloat16>(c10::vmath::erf, erf_ref, -inf);
+  expectWithinOneUlp<c10::BFloat16>(c10::vmath::gelu, gelu_ref, -1.f);
+}
+
+TEST(VmathTest, HalfWithinOneUlp) {
+  const float inf = std::numeric_limits<float>::infinity();
+  expectWithinOneUlp<c10::Half>(c10::vmath::exp, exp_ref, -inf);
+  expectWithinOneUlp<c10::Half>(c10::vmath::log, log_ref, -inf);
+  expectWithinOneUlp<c10::Half>(c10::vmath::tanh, tanh_ref, -inf);
+  expectWithinOneUlp<c10::Half>(c10::vmath::sigmoid, sigmoid_ref, -inf);
+  expectWithinOneUlp<c10::Half>(c10::vmath::erf, erf_ref, -inf);
+  expectWithinOneUlp<c10::Half>(c10::vmath::gelu, gelu_ref, -1.f);
+}
+
+TEST(VmathTest, ComplexMatchesScalar) {
+  const double float_eps = std::numeric_limits<float>::epsilon();
+  checkComplexMatchesScalar<float>(3.2 * float_eps, 2e-7);
+  const double double_eps = std::numeric_limits<double>::epsilon();
+  checkComplexMatchesScalar<double>(2 * double_eps, 4 * double_eps);
+}
+
+TEST(VmathTest, ComplexSpecialValues) {
+  using c10::complex;
+  const float inf = std::numeric_limits<float>::infinity();
+  const float nan = std::numeric_limits<float>::quiet_NaN();
+  const std::vector<complex<float>> in = {
+      {inf, nan}, {1e30f, 1e30f}, {1e-30f, -1e-30f}, {0.f, 0.f},
+      {-0.f, 0.f}, {-1.f, -0.f}, {-inf, 2.f}, {nan, 0.f}, {3.f, 4.f}};
+  std::vector<float> real_out(in.size());
+  c10::vmath::abs(in.data(), real_out.data(), in.size());
+  EXPECT_EQ(real_out[0], inf);
+  EXPECT_FLOAT_EQ(real_out[1], 1.41421356e30f);
+  EXPECT_FLOAT_EQ(real_out[2], 1.41421356e-30f);
+  EXPECT_EQ(real_out[3], 0.f);
+  EXPECT_EQ(real_out[6], inf);
+  EXPECT_TRUE(std::isnan(real_out[7]));
+  EXPECT_EQ(real_out[8], 5.f);
+
+  c10::vmath::arg(in.data(), real_out.data(), in.size());
+  for (size_t i = 1; i < in.size(); ++i) {
+    const float expected = std::atan2(in[i].imag(), in[i].real());
+    if (std::isnan(expected)) {
+      EXPECT_TRUE(std::isnan(real_out[i])) << i;
+    } else {
+      EXPECT_FLOAT_EQ(real_out[i], expected) << i;
+      EXPECT_EQ(std::signbit(real_out[i]), std::signbit(expected)) << i;
+    }
+  }
+
+  std::vector<complex<float>> out(in.size());
+  c10::vmath::exp(in.data(), out.data(), in.size());
+  for (size_t i : {3, 5, 6, 8}) {
+    const std::complex<float> expected = std::exp(std::complex<float>(in[i].real(), in[i].imag()));
+    EXPECT_NEAR(out[i].real(), expected.real(), 1e-5f * std::abs(expected)) << i;
+    EXPECT_NEAR(out[i].imag(), expected.imag(), 1e-5f * std::abs(expected)) << i;
+  }
+  EXPECT_TRUE(std::isnan(out[7].real()));
+}
@@ -0,0 +1,23 @@
+#include <c10/util/BFloat16.h>
+#include <c10/cpu/ConvertKernel.h>
+
+#include <type_traits>
+
+namespace c10 {
+
+static_assert(
+    std::is_standard_layout<BFloat16>::value,
+    "c10::BFloat16 must be standard layout.");
+
+DEFINE_DISPATCH(bfloat16_to_float_stub);
+DEFINE_DISPATCH(float_to_bfloat16_stub);
+
+void convert_bfloat16_to_float(const BFloat16* src, float* dst, size_t n) {
+  bfloat16_to_float_stub(src, dst, n);
+}
+
+void convert_float_to_bfloat16(const float* src, BFloat16* dst, size_t n) {
+  float_to_bfloat16_stub(src, dst, n);
+}
+
+} // namespace c10
@@ -86,6 +86,13 @@ struct alignas(2) BFloat16 {
   inline C10_HOST_DEVICE operator float() const;
 };
 
+// Bulk conversions between n BFloat16s and floats.  They use AVX2 or AVX-512
+// (and vcvtneps2bf16 on CPUs with AVX512_BF16) when the CPU supports it,
+// checked once at the first call, and round exactly like
+// round_to_nearest_even on every path.
+C10_API void convert_bfloat16_to_float(const BFloat16* src, float* dst, size_t n);
+C10_API void convert_float_to_bfloat16(const float* src, BFloat16* dst, size_t n);
+
 } // namespace c10
 
 
@@ -0,0 +1,104 @@
+#include <c10/util/BFloat16Gemm.h>
+#include <c10/core/CPUAllocator.h>
+#include <c10/cpu/BFloat16GemmKernel.h>
+#include <c10/util/Exception.h>
+#include <c10/util/Parallel.h>
+
+#include <algorithm>
+
+namespace c10 {
+
+DEFINE_DISPATCH(bfloat16_gemm_stub);
+
+PackedBFloat16Matrix::PackedBFloat16Matrix(
+    Transpose trans,
+    int64_t k,
+    int64_t n,
+    const BFloat16* b,
+    int64_t ldb)
+    : k_(k), n_(n) {
+  TORCH_CHECK(
+      k >= 0 && n >= 0, "PackedBFloat16Matrix: sizes must be non-negative, got k ", k, ", n ",
+      n);
+  const int64_t stored_cols = std::max<int64_t>(trans == Transpose::NoTrans ? n : k, 1);
+  TORCH_CHECK(
+      ldb >= stored_cols, "PackedBFloat16Matrix: ldb must be at least ", stored_cols, ", got ",
+      ldb);
+  const int64_t groups = padded_k(k) / 2;
+  const int64_t blocks = padded_n(n) / 16;
+  data_ = GetDefaultCPUAllocator()->allocate(padded_k(k) * padded_n(n) * sizeof(BFloat16));
+  auto* packed = static_cast<BFloat16*>(data_.get());
+  auto value = [&](int64_t p, int64_t j) -> BFloat16 {
+    if (p >= k || j >= n) {
+      return BFloat16(0, BFloat16::from_bits());
+    }
+    return trans == Transpose::NoTrans ? b[p * ldb + j] : b[j * ldb + p];
+  };
+  const int64_t grain_size =
+      internal::divup(internal::GRAIN_SIZE, std::max<int64_t>(32 * groups, 1));
+  parallel_for(0, blocks, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t block = begin; block < end; block++) {
+      BFloat16* dst = packed + block * groups * 32;
+      for (int64_t g = 0; g < groups; g++) {
+        for (int64_t c = 0; c < 16; c++) {
+          dst[(g * 16 + c) * 2] = value(2 * g, block * 16 + c);
+          dst[(g * 16 + c) * 2 + 1] = value(2 * g + 1, block * 16 + c);
+        }
+      }
+    }
+  });
+}
+
+void gemm(
+    Transpose trans_a,
+    int64_t m,
+    float alpha,
+    const BFloat16* a,
+    int64_t lda,
+    const PackedBFloat16Matrix& b,
+    float beta,
+    float* c,
+    int64_t ldc) {
+  TORCH_CHECK(m >= 0, "gemm: m must be non-negative, got ", m);
+  const int64_t a_cols = std::max<int64_t>(trans_a == Transpose::NoTrans ? b.k() : m, 1);
+  TORCH_CHECK(lda >= a_cols, "gemm: lda must be at least ", a_cols, ", got ", lda);
+  TORCH_CHECK(
+      ldc >= std::max<int64_t>(b.n(), 1), "gemm: ldc must be at least ",
+      std::max<int64_t>(b.n(), 1), ", got ", ldc);
+  if (m == 0 || b.n() == 0) {
+    return;
+  }
+  BFloat16GemmParams p;
+  p.trans_a = trans_a;
+  p.m = m;
+  p.alpha = alpha;
+  p.a = a;
+  p.lda = lda;
+  p.b = &b;
+  p.beta = beta;
+  p.c = c;
+  p.ldc = ldc;
+  bfloat16_gemm_stub(p);
+}
+
+void gemm(
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    float alpha,
+    const BFloat16* a,
+    int64_t lda,
+    const BFloat16* b,
+    int64_t ldb,
+    float beta,
+    float* c,
+    int64_t ldc) {
+  TORCH_CHECK(
+      m >= 0 && n >= 0 && k >= 0, "gemm: sizes must be non-negative, got m ", m, ", n ", n,
+      ", k ", k);
+  gemm(trans_a, m, alpha, a, lda, PackedBFloat16Matrix(trans_b, k, n, b, ldb), beta, c, ldc);
+}
+
+} // namespace c10
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <c10/core/Allocator.h>
+#include <c10/macros/Macros.h>
+#include <c10/util/BFloat16.h>
+#include <c10/util/Gemm.h>
+
+#include <cstdint>
+
+// Matrix products of BFloat16 matrices with float accumulation, row-major:
+//
+//   C = alpha * op(A) * op(B) + beta * C
+//
+// with A and B BFloat16 and C float, and the same conventions as the float
+// gemm in Gemm.h.  The weights of an inference run are packed once into a
+// PackedBFloat16Matrix and reused from call to call; the overload taking B
+// as is packs it on every call.
+//
+// The kernel (c10/cpu/BFloat16GemmKernel.cpp) multiplies pairs of
+// consecutive values of k: a pair of a row of A, broadcast, against 16
+// columns of packed B per 512-bit vector.  AVX-512 CPUs with AVX512_BF16 sum
+// both products into the float accumulators with vdpbf16ps, which flushes
+// denormal inputs and results to zero.  Other AVX-512 and AVX2 CPUs widen B
+// to float in registers (a shift and a mask) and use FMAs.  The products of
+// two BFloat16 values are exact in float, so all paths differ only in the
+// order of the sums.  Tiles of C are spread over the intra-op thread pool.
+//
+// Products with few rows of A are bound by the reads of B: prepacked
+// BFloat16 weights take half the bytes of float ones, and no packing per call.
+
+namespace c10 {
+
+// op(B), k x n BFloat16, in the layout of the kernel: columns in blocks of
+// 16, and each block as k / 2 groups of 16 x 2 values, the 2 values of k of
+// each column being adjacent.  k is padded to a multiple of 2 and n to a
+// multiple of 32 with zeros.
+class C10_API PackedBFloat16Matrix {
+ public:
+  // B is stored k x n (NoTrans) or n x k (Trans, the usual layout of the
+  // weights of a linear layer), ldb elements between rows.
+  PackedBFloat16Matrix(Transpose trans, int64_t k, int64_t n, const BFloat16* b, int64_t ldb);
+
+  int64_t k() const {
+    return k_;
+  }
+  int64_t n() const {
+    return n_;
+  }
+  const BFloat16* data() const {
+    return static_cast<const BFloat16*>(data_.get());
+  }
+
+  // The padded sizes
+  static int64_t padded_k(int64_t k) {
+    return (k + 1) / 2 * 2;
+  }
+  static int64_t padded_n(int64_t n) {
+    return (n + 31) / 32 * 32;
+  }
+
+ private:
+  int64_t k_;
+  int64_t n_;
+  DataPtr data_;
+};
+
+// C = alpha * op(A) * B + beta * C, with B packed; op(A) is m x b.k().
+C10_API void gemm(
+    Transpose trans_a,
+    int64_t m,
+    float alpha,
+    const BFloat16* a,
+    int64_t lda,
+    const PackedBFloat16Matrix& b,
+    float beta,
+    float* c,
+    int64_t ldc);
+
+C10_API void gemm(
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    float alpha,
+    const BFloat16* a,
+    int64_t lda,
+    const BFloat16* b,
+    int64_t ldb,
+    float beta,
+    float* c,
+    int64_t ldc);
+
+} // namespace c10
@@ -0,0 +1,181 @@
+#include <c10/util/CPUCapability.h>
+#include <c10/util/Exception.h>
+
+#include <cctype>
+#include <cstdlib>
+
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64) || \
+    defined(_M_IX86)
+#define C10_CPU_X86 1
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else
+#include <cpuid.h>
+#endif
+#else
+#define C10_CPU_X86 0
+#endif
+
+namespace c10 {
+namespace cpu {
+
+namespace {
+
+#if C10_CPU_X86
+
+struct CPUIDRegisters {
+  uint32_t eax = 0;
+  uint32_t ebx = 0;
+  uint32_t ecx = 0;
+  uint32_t edx = 0;
+};
+
+CPUIDRegisters cpuid(uint32_t leaf, uint32_t subleaf) {
+  CPUIDRegisters r;
+#if defined(_MSC_VER)
+  int regs[4];
+  __cpuidex(regs, static_cast<int>(leaf), static_cast<int>(subleaf));
+  r.eax = regs[0];
+  r.ebx = regs[1];
+  r.ecx = regs[2];
+  r.edx = regs[3];
+#else
+  __cpuid_count(leaf, subleaf, r.eax, r.ebx, r.ecx, r.edx);
+#endif
+  return r;
+}
+
+// The register state the OS saves on context switches, see XSAVE.
+uint64_t xgetbv0() {
+#if defined(_MSC_VER)
+  return _xgetbv(0);
+#else
+  uint32_t eax, edx;
+  __asm__ volatile("xgetbv" : "=a"(eax), "=d"(edx) : "c"(0));
+  return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+bool bit(uint32_t reg, int n) {
+  return (reg >> n) & 1;
+}
+
+CPUFeatures probeCPUFeatures() {
+  CPUFeatures f;
+  const uint32_t max_leaf = cpuid(0, 0).eax;
+  if (max_leaf < 1) {
+    return f;
+  }
+  const CPUIDRegisters leaf1 = cpuid(1, 0);
+  const bool osxsave = bit(leaf1.ecx, 27);
+  const bool avx = bit(leaf1.ecx, 28);
+  if (!osxsave || !avx) {
+    return f;
+  }
+  const uint64_t xcr0 = xgetbv0();
+  // XMM and YMM state
+  if ((xcr0 & 0x6) != 0x6) {
+    return f;
+  }
+  f.fma = bit(leaf1.ecx, 12);
+  f.f16c = bit(leaf1.ecx, 29);
+  if (max_leaf < 7) {
+    return f;
+  }
+  const CPUIDRegisters leaf7 = cpuid(7, 0);
+  f.avx2 = bit(leaf7.ebx, 5);
+  // opmask, upper halves of ZMM0-15 and ZMM16-31 state
+  if ((xcr0 & 0xE0) != 0xE0) {
+    return f;
+  }
+  f.avx512f = bit(leaf7.ebx, 16);
+  f.avx512bw = bit(leaf7.ebx, 30);
+  f.avx512vl = bit(leaf7.ebx, 31);
+  f.avx512vnni = bit(leaf7.ecx, 11);
+  if (leaf7.eax >= 1) {
+    f.avx512bf16 = bit(cpuid(7, 1).eax, 5);
+  }
+  return f;
+}
+
+#else
+
+CPUFeatures probeCPUFeatures() {
+  return CPUFeatures();
+}
+
+#endif // C10_CPU_X86
+
+CPUCapability supportedCPUCapability() {
+  const CPUFeatures& f = cpuFeatures();
+  if (!(f.avx2 && f.fma && f.f16c)) {
+    return CPUCapability::DEFAULT;
+  }
+  if (!(f.avx512f && f.avx512bw && f.avx512vl)) {
+    return CPUCapability::AVX2;
+  }
+  return CPUCapability::AVX512;
+}
+
+bool equalsIgnoreCase(const char* a, const char* b) {
+  for (; *a != '\0' && *b != '\0'; ++a, ++b) {
+    if (std::tolower(static_cast<unsigned char>(*a)) !=
+        std::tolower(static_cast<unsigned char>(*b))) {
+      return false;
+    }
+  }
+  return *a == *b;
+}
+
+CPUCapability computeCPUCapability() {
+  const CPUCapability supported = supportedCPUCapability();
+  const char* env = std::getenv("C10_CPU_CAPABILITY");
+  if (env == nullptr || *env == '\0') {
+    return supported;
+  }
+  for (uint8_t i = 0; i < static_cast<uint8_t>(CPUCapability::NUM_OPTIONS);
+       ++i) {
+    const auto requested = static_cast<CPUCapability>(i);
+    if (equalsIgnoreCase(env, toString(requested))) {
+      if (requested > supported) {
+        TORCH_WARN(
+            "C10_CPU_CAPABILITY=", env, " is not supported by this CPU, using ",
+            toString(supported));
+        return supported;
+      }
+      return requested;
+    }
+  }
+  TORCH_WARN(
+      "Ignoring unknown C10_CPU_CAPABILITY=", env,
+      ", expected default, avx2 or avx512");
+  return supported;
+}
+
+} // namespace
+
+const CPUFeatures& cpuFeatures() {
+  static const CPUFeatures features = probeCPUFeatures();
+  return features;
+}
+
+CPUCapability getCPUCapability() {
+  static const CPUCapability capability = computeCPUCapability();
+  return capability;
+}
+
+const char* toString(CPUCapability capability) {
+  switch (capability) {
+    case CPUCapability::DEFAULT:
+      return "default";
+    case CPUCapability::AVX2:
+      return "avx2";
+    case CPUCapability::AVX512:
+      return "avx512";
+    default:
+      return "unknown";
+  }
+}
+
+} // namespace cpu
+} // namespace c10
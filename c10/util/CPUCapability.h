@@ -0,0 +1,46 @@
+#pragma once
+
+#include <cstdint>
+
+#include <c10/macros/Macros.h>
+
+namespace c10 {
+namespace cpu {
+
+// What the CPU (and the OS, for the AVX register state) supports, from a
+// single cpuid probe at the first call.  All false on non-x86 platforms.
+struct CPUFeatures {
+  bool avx2 = false;
+  bool fma = false;
+  bool f16c = false;
+  bool avx512f = false;
+  bool avx512bw = false;
+  bool avx512vl = false;
+  bool avx512bf16 = false;
+  bool avx512vnni = false;
+};
+
+C10_API const CPUFeatures& cpuFeatures();
+
+// The instruction set levels kernels are compiled for, see DispatchStub.h.
+//  - AVX2 means AVX2, FMA and F16C.
+//  - AVX512 means AVX2 plus AVX512F, AVX512BW and AVX512VL.
+// Extensions on top of a level (e.g. AVX512_BF16) are checked by the kernels
+// themselves, through cpuFeatures().
+enum class CPUCapability : uint8_t {
+  DEFAULT = 0,
+  AVX2 = 1,
+  AVX512 = 2,
+  NUM_OPTIONS
+};
+
+// The highest level the CPU supports, computed once.  The environment
+// variable C10_CPU_CAPABILITY (default, avx2 or avx512) lowers it, e.g. to
+// compare the kernels of different levels on the same machine; asking for a
+// level the CPU does not support leaves it as is.
+C10_API CPUCapability getCPUCapability();
+
+C10_API const char* toString(CPUCapability capability);
+
+} // namespace cpu
+} // namespace c10
@@ -0,0 +1,117 @@
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+#include <c10/macros/Macros.h>
+#include <c10/util/CPUCapability.h>
+#include <c10/util/Exception.h>
+
+// Implements instruction set specific function dispatch.
+//
+// Kernels that are compiled multiple times, with different instruction sets,
+// live in c10/cpu.  CMake compiles each file in c10/cpu once per
+// CPUCapability the compiler supports, with the matching -m flags and
+// CPU_CAPABILITY / CPU_CAPABILITY_<level> defined.  The first call of a stub
+// picks the kernel of the highest level getCPUCapability() allows.
+//
+// Example:
+//
+// In Foo.h:
+//   using fn_type = void(*)(const float*, float*, size_t);
+//   DECLARE_DISPATCH(fn_type, foo_stub);
+//
+// In Foo.cpp:
+//   DEFINE_DISPATCH(foo_stub);
+//   void foo(const float* src, float* dst, size_t n) {
+//     foo_stub(src, dst, n);
+//   }
+//
+// In c10/cpu/FooKernel.cpp:
+//   namespace {
+//     // use anonymous namespace so that different cpu versions won't conflict
+//     void foo_kernel(const float* src, float* dst, size_t n) { ... }
+//   }
+//   REGISTER_DISPATCH(foo_stub, &foo_kernel);
+//
+// NB: the compiler may emit inline functions from headers out of line in any
+// of the copies, and the linker keeps one of them.  CMake links the DEFAULT
+// copies first so that the baseline code wins, but keep the code in c10/cpu
+// in anonymous namespaces anyway.
+
+namespace c10 {
+
+template <typename FnPtr, typename T>
+struct DispatchStub;
+
+template <typename rT, typename T, typename... Args>
+struct DispatchStub<rT (*)(Args...), T> {
+  using FnPtr = rT (*)(Args...);
+
+  DispatchStub() = default;
+  DispatchStub(const DispatchStub&) = delete;
+  DispatchStub& operator=(const DispatchStub&) = delete;
+
+  template <typename... ArgTypes>
+  rT operator()(ArgTypes&&... args) {
+    FnPtr fn = cpu_dispatch_ptr.load(std::memory_order_relaxed);
+    if (C10_UNLIKELY(fn == nullptr)) {
+      // racing first calls all pick the same kernel
+      fn = choose_cpu_impl();
+      cpu_dispatch_ptr.store(fn, std::memory_order_relaxed);
+    }
+    return (*fn)(std::forward<ArgTypes>(args)...);
+  }
+
+  FnPtr choose_cpu_impl() {
+    const auto capability = cpu::getCPUCapability();
+    (void)capability;
+#ifdef C10_HAVE_AVX512_CPU_DEFINITION
+    if (capability >= cpu::CPUCapability::AVX512) {
+      TORCH_INTERNAL_ASSERT(AVX512, "DispatchStub: missing AVX512 kernel");
+      return AVX512;
+    }
+#endif
+#ifdef C10_HAVE_AVX2_CPU_DEFINITION
+    if (capability >= cpu::CPUCapability::AVX2) {
+      TORCH_INTERNAL_ASSERT(AVX2, "DispatchStub: missing AVX2 kernel");
+      return AVX2;
+    }
+#endif
+    TORCH_INTERNAL_ASSERT(DEFAULT, "DispatchStub: missing default kernel");
+    return DEFAULT;
+  }
+
+  std::atomic<FnPtr> cpu_dispatch_ptr{nullptr};
+
+  static FnPtr DEFAULT;
+#ifdef C10_HAVE_AVX2_CPU_DEFINITION
+  static FnPtr AVX2;
+#endif
+#ifdef C10_HAVE_AVX512_CPU_DEFINITION
+  static FnPtr AVX512;
+#endif
+};
+
+} // namespace c10
+
+// `fn` must be a single token sequence without top-level commas; do a `using`
+// declaration for function types that have them.
+#define DECLARE_DISPATCH(fn, name)              \
+  struct name : ::c10::DispatchStub<fn, name> { \
+    name() = default;                           \
+    name(const name&) = delete;                 \
+    name& operator=(const name&) = delete;      \
+  };                                            \
+  extern C10_API struct name name
+
+#define DEFINE_DISPATCH(name) struct name name
+
+#define REGISTER_ARCH_DISPATCH(name, arch, fn) \
+  template <>                                  \
+  decltype(fn) c10::DispatchStub<decltype(fn), struct name>::arch = fn;
+
+// Only for use in c10/cpu, where CPU_CAPABILITY names the level the file is
+// being compiled for.
+#define REGISTER_DISPATCH(name, fn) \
+  REGISTER_ARCH_DISPATCH(name, CPU_CAPABILITY, fn)
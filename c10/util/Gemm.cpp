@@ -0,0 +1,289 @@
+#include <c10/util/Gemm.h>
+#include <c10/cpu/GemmKernel.h>
+#include <c10/util/Exception.h>
+
+#include <algorithm>
+#include <cstdlib>
+#include <limits>
+#include <type_traits>
+
+#ifdef C10_USE_BLAS
+#ifdef C10_USE_MKL
+#include <mkl_cblas.h>
+#else
+#include <cblas.h>
+#endif
+#endif
+
+namespace c10 {
+
+DEFINE_DISPATCH(gemm_stub);
+
+namespace {
+
+void check_gemm(
+    const char* fn,
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t batch,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    int64_t lda,
+    int64_t ldb,
+    int64_t ldc) {
+  TORCH_CHECK(
+      batch >= 0 && m >= 0 && n >= 0 && k >= 0, fn, ": sizes must be non-negative, got batch ",
+      batch, ", m ", m, ", n ", n, ", k ", k);
+  // the stored matrices are rows x lda and so on
+  const int64_t a_cols = trans_a == Transpose::NoTrans ? k : m;
+  const int64_t b_cols = trans_b == Transpose::NoTrans ? n : k;
+  TORCH_CHECK(
+      lda >= std::max<int64_t>(a_cols, 1), fn, ": lda must be at least ",
+      std::max<int64_t>(a_cols, 1), ", got ", lda);
+  TORCH_CHECK(
+      ldb >= std::max<int64_t>(b_cols, 1), fn, ": ldb must be at least ",
+      std::max<int64_t>(b_cols, 1), ", got ", ldb);
+  TORCH_CHECK(
+      ldc >= std::max<int64_t>(n, 1), fn, ": ldc must be at least ", std::max<int64_t>(n, 1),
+      ", got ", ldc);
+}
+
+#ifdef C10_USE_BLAS
+
+CBLAS_TRANSPOSE to_cblas(Transpose trans) {
+  return trans == Transpose::NoTrans ? CblasNoTrans : CblasTrans;
+}
+
+// CBLAS takes int sizes
+bool fits_cblas(const GemmParams& p) {
+  const int64_t limit = std::numeric_limits<int>::max();
+  return p.m <= limit && p.n <= limit && p.k <= limit && p.lda <= limit && p.ldb <= limit &&
+      p.ldc <= limit;
+}
+
+void cblas_gemm(const GemmParams& p, int64_t i) {
+  if (p.dtype == ScalarType::Float) {
+    cblas_sgemm(
+        CblasRowMajor, to_cblas(p.trans_a), to_cblas(p.trans_b), p.m, p.n, p.k, p.alpha,
+        static_cast<const float*>(p.a) + i * p.stride_a, p.lda,
+        static_cast<const float*>(p.b) + i * p.stride_b, p.ldb, p.beta,
+        static_cast<float*>(p.c) + i * p.stride_c, p.ldc);
+  } else {
+    cblas_dgemm(
+        CblasRowMajor, to_cblas(p.trans_a), to_cblas(p.trans_b), p.m, p.n, p.k, p.alpha,
+        static_cast<const double*>(p.a) + i * p.stride_a, p.lda,
+        static_cast<const double*>(p.b) + i * p.stride_b, p.ldb, p.beta,
+        static_cast<double*>(p.c) + i * p.stride_c, p.ldc);
+  }
+}
+
+#endif // C10_USE_BLAS
+
+void run_gemm(const GemmParams& p) {
+  if (p.batch == 0 || p.m == 0 || p.n == 0) {
+    return;
+  }
+#ifdef C10_USE_BLAS
+  if (fits_cblas(p)) {
+    for (int64_t i = 0; i < p.batch; i++) {
+      cblas_gemm(p, i);
+    }
+    return;
+  }
+#endif
+  gemm_stub(p);
+}
+
+template <typename T>
+GemmParams make_params(
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t batch,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    T alpha,
+    const T* a,
+    int64_t lda,
+    int64_t stride_a,
+    const T* b,
+    int64_t ldb,
+    int64_t stride_b,
+    T beta,
+    T* c,
+    int64_t ldc,
+    int64_t stride_c) {
+  GemmParams p;
+  p.dtype = std::is_same<T, float>::value ? ScalarType::Float : ScalarType::Double;
+  p.trans_a = trans_a;
+  p.trans_b = trans_b;
+  p.batch = batch;
+  p.m = m;
+  p.n = n;
+  p.k = k;
+  p.alpha = alpha;
+  p.beta = beta;
+  p.a = a;
+  p.lda = lda;
+  p.stride_a = stride_a;
+  p.b = b;
+  p.ldb = ldb;
+  p.stride_b = stride_b;
+  p.c = c;
+  p.ldc = ldc;
+  p.stride_c = stride_c;
+  return p;
+}
+
+template <typename T>
+void gemm_impl(
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    T alpha,
+    const T* a,
+    int64_t lda,
+    const T* b,
+    int64_t ldb,
+    T beta,
+    T* c,
+    int64_t ldc) {
+  check_gemm("gemm", trans_a, trans_b, 1, m, n, k, lda, ldb, ldc);
+  run_gemm(make_params(trans_a, trans_b, 1, m, n, k, alpha, a, lda, 0, b, ldb, 0, beta, c, ldc, 0));
+}
+
+// Whether two C matrices of a batch share an element.  Matrices i apart
+// start d = i * stride_c elements apart, and share an element if and only if
+// d = dr * ldc + dj for some |dr| < m and |dj| < n.  As ldc >= n, only the
+// values of dr within one of d / ldc can leave |dj| < n.  Matrices may
+// interleave, e.g. two 2 x 2 ones with ldc 4 and stride_c 2.
+bool c_matrices_overlap(int64_t batch, int64_t m, int64_t n, int64_t ldc, int64_t stride_c) {
+  if (m == 0 || n == 0) {
+    return false;
+  }
+  for (int64_t i = 1; i < batch; i++) {
+    const int64_t d = i * stride_c;
+    const int64_t q = d / ldc;
+    for (int64_t dr = q - 1; dr <= q + 1; dr++) {
+      if (std::abs(dr) < m && std::abs(d - dr * ldc) < n) {
+        return true;
+      }
+    }
+  }
+  return false;
+}
+
+template <typename T>
+void gemm_batched_impl(
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t batch,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    T alpha,
+    const T* a,
+    int64_t lda,
+    int64_t stride_a,
+    const T* b,
+    int64_t ldb,
+    int64_t stride_b,
+    T beta,
+    T* c,
+    int64_t ldc,
+    int64_t stride_c) {
+  check_gemm("gemm_batched", trans_a, trans_b, batch, m, n, k, lda, ldb, ldc);
+  TORCH_CHECK(
+      !c_matrices_overlap(batch, m, n, ldc, stride_c), "gemm_batched: the C matrices overlap, m ",
+      m, ", n ", n, ", ldc ", ldc, " and stride_c ", stride_c);
+  run_gemm(make_params(
+      trans_a, trans_b, batch, m, n, k, alpha, a, lda, stride_a, b, ldb, stride_b, beta, c, ldc,
+      stride_c));
+}
+
+} // namespace
+
+void gemm(
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    float alpha,
+    const float* a,
+    int64_t lda,
+    const float* b,
+    int64_t ldb,
+    float beta,
+    float* c,
+    int64_t ldc) {
+  gemm_impl(trans_a, trans_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+void gemm(
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    double alpha,
+    const double* a,
+    int64_t lda,
+    const double* b,
+    int64_t ldb,
+    double beta,
+    double* c,
+    int64_t ldc) {
+  gemm_impl(trans_a, trans_b, m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+void gemm_batched(
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t batch,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    float alpha,
+    const float* a,
+    int64_t lda,
+    int64_t stride_a,
+    const float* b,
+    int64_t ldb,
+    int64_t stride_b,
+    float beta,
+    float* c,
+    int64_t ldc,
+    int64_t stride_c) {
+  gemm_batched_impl(
+      trans_a, trans_b, batch, m, n, k, alpha, a, lda, stride_a, b, ldb, stride_b, beta, c, ldc,
+      stride_c);
+}
+
+void gemm_batched(
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t batch,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    double alpha,
+    const double* a,
+    int64_t lda,
+    int64_t stride_a,
+    const double* b,
+    int64_t ldb,
+    int64_t stride_b,
+    double beta,
+    double* c,
+    int64_t ldc,
+    int64_t stride_c) {
+  gemm_batched_impl(
+      trans_a, trans_b, batch, m, n, k, alpha, a, lda, stride_a, b, ldb, stride_b, beta, c, ldc,
+      stride_c);
+}
+
+} // namespace c10
@@ -0,0 +1,110 @@
+#pragma once
+
+#include <c10/macros/Macros.h>
+
+#include <cstdint>
+
+// Dense matrix products, row-major:
+//
+//   C = alpha * op(A) * op(B) + beta * C
+//
+// op(A) is m x k, op(B) is k x n and C is m x n.  op(X) is X for NoTrans and
+// its transpose for Trans; lda, ldb and ldc are the distances between the
+// rows of A, B and C as stored, in elements.  As in BLAS, beta == 0 writes C
+// without reading it, so C may hold NaN or garbage, and alpha == 0 or k == 0
+// only scales C.
+//
+// The products run in c10/cpu/GemmKernel.cpp, after GotoBLAS: op(B) is
+// packed in KC x NC panels shared by the threads, and each thread packs the
+// MC x KC blocks of op(A) it multiplies them with, so that the scratch memory
+// doesn't grow with m.  Both are laid out so that an MR x NR register tile of
+// C is updated by a micro-kernel that streams them with unit stride.  MR x NR is 6 x 2 vectors, 6 x 16 floats on AVX2 and
+// 6 x 32 on AVX-512; each step of the micro-kernel is 12 FMAs on 2 loads and
+// 6 broadcasts.  The tiles of each panel are spread over the intra-op thread
+// pool (c10/util/Parallel.h).  Results do not depend on the thread count.
+//
+// With -DUSE_BLAS=ON and a CBLAS found at configure time (see
+// c10/CMakeLists.txt), the products go to cblas_sgemm / cblas_dgemm instead.
+
+namespace c10 {
+
+enum class Transpose : uint8_t {
+  NoTrans,
+  Trans,
+};
+
+C10_API void gemm(
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    float alpha,
+    const float* a,
+    int64_t lda,
+    const float* b,
+    int64_t ldb,
+    float beta,
+    float* c,
+    int64_t ldc);
+
+C10_API void gemm(
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    double alpha,
+    const double* a,
+    int64_t lda,
+    const double* b,
+    int64_t ldb,
+    double beta,
+    double* c,
+    int64_t ldc);
+
+// batch products of the same shape, the i-th one on a + i * stride_a,
+// b + i * stride_b and c + i * stride_c.  The C matrices must not share an
+// element, but may interleave: the rows of one may sit in the padding
+// between the rows of another.
+// Small products run one per thread, large ones one after the other, each
+// spread over the threads.
+C10_API void gemm_batched(
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t batch,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    float alpha,
+    const float* a,
+    int64_t lda,
+    int64_t stride_a,
+    const float* b,
+    int64_t ldb,
+    int64_t stride_b,
+    float beta,
+    float* c,
+    int64_t ldc,
+    int64_t stride_c);
+
+C10_API void gemm_batched(
+    Transpose trans_a,
+    Transpose trans_b,
+    int64_t batch,
+    int64_t m,
+    int64_t n,
+    int64_t k,
+    double alpha,
+    const double* a,
+    int64_t lda,
+    int64_t stride_a,
+    const double* b,
+    int64_t ldb,
+    int64_t stride_b,
+    double beta,
+    double* c,
+    int64_t ldc,
+    int64_t stride_c);
+
+} // namespace c10
@@ -1,4 +1,5 @@
 #include <c10/util/Half.h>
+#include <c10/cpu/ConvertKernel.h>
 #include <iostream>
 
 namespace c10 {
@@ -11,4 +12,16 @@ std::ostream& operator<<(std::ostream& out, const Half& value) {
   out << (float)value;
   return out;
 }
+
+DEFINE_DISPATCH(half_to_float_stub);
+DEFINE_DISPATCH(float_to_half_stub);
+
+void convert_half_to_float(const Half* src, float* dst, size_t n) {
+  half_to_float_stub(src, dst, n);
+}
+
+void convert_float_to_half(const float* src, Half* dst, size_t n) {
+  float_to_half_stub(src, dst, n);
+}
+
 } // namespace c10
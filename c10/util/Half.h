@@ -468,6 +468,13 @@ typename std::enable_if<is_complex_t<From>::value, bool>::type overflows(
 
 C10_API std::ostream& operator<<(std::ostream& out, const Half& value);
 
+// Bulk conversions between n Halfs and floats.  They use F16C or AVX-512
+// when the CPU supports it (checked once, at the first call) and an unrolled
+// scalar loop otherwise, and are bit-exact with fp16_ieee_to_fp32_value /
+// fp16_ieee_from_fp32_value on every path, including NaN, Inf and denormals.
+C10_API void convert_half_to_float(const Half* src, float* dst, size_t n);
+C10_API void convert_float_to_half(const float* src, Half* dst, size_t n);
+
 } // namespace c10
 
 #include <c10/util/Half-inl.h>
@@ -1 +1,50 @@
 #include <c10/util/LeftRight.h>
+
+#include <cstdlib>
+#include <new>
+#if defined(_MSC_VER)
+#include <malloc.h>
+#endif
+
+namespace c10 {
+namespace detail {
+
+size_t leftRightReaderShard() {
+    static std::atomic<size_t> nextShard{0};
+    thread_local size_t shard = nextShard.fetch_add(1) % kLeftRightNumShards;
+    return shard;
+}
+
+LeftRightCounterShard* allocateCounterShards() {
+    constexpr size_t nbytes = kLeftRightNumShards * sizeof(LeftRightCounterShard);
+    void* memory = nullptr;
+#if defined(_MSC_VER)
+    memory = _aligned_malloc(nbytes, alignof(LeftRightCounterShard));
+#else
+    if (posix_memalign(&memory, alignof(LeftRightCounterShard), nbytes) != 0) {
+        memory = nullptr;
+    }
+#endif
+    if (memory == nullptr) {
+        throw std::bad_alloc();
+    }
+    auto* shards = static_cast<LeftRightCounterShard*>(memory);
+    for (size_t i = 0; i < kLeftRightNumShards; i++) {
+        new (&shards[i]) LeftRightCounterShard();
+    }
+    return shards;
+}
+
+void freeCounterShards(LeftRightCounterShard* shards) {
+    for (size_t i = 0; i < kLeftRightNumShards; i++) {
+        shards[i].~LeftRightCounterShard();
+    }
+#if defined(_MSC_VER)
+    _aligned_free(shards);
+#else
+    free(shards);
+#endif
+}
+
+}
+}
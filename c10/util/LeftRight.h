@@ -1,5 +1,9 @@
+#pragma once
+
 #include <atomic>
+#include <condition_variable>
 #include <functional>
+#include <memory>
 #include <mutex>
 #include <thread>
 #include <array>
@@ -161,4 +165,209 @@ private:
     std::mutex _writeMutex;
 };
 
+namespace detail {
+
+// Number of reader counter shards used by ShardedReaderCounters.  Threads are
+// spread over the shards round-robin, so up to this many concurrent readers
+// never share a cache line.
+constexpr size_t kLeftRightNumShards = 64;
+
+// Shard assigned to the calling thread; assigned once per thread, on first use.
+C10_API size_t leftRightReaderShard();
+
+// The left and right counters of one shard share a line: a reader only ever
+// touches the line of its own shard.
+struct alignas(C10_CACHE_LINE_SIZE) LeftRightCounterShard final {
+    std::array<std::atomic<int32_t>, 2> counters{{{0}, {0}}};
+};
+
+// kLeftRightNumShards zeroed shards, aligned to C10_CACHE_LINE_SIZE.  Shards
+// must come from here rather than be members of a heap object: before C++17,
+// new does not honor alignments above that of max_align_t.
+C10_API LeftRightCounterShard* allocateCounterShards();
+C10_API void freeCounterShards(LeftRightCounterShard* shards);
+
+struct CounterShardsDeleter final {
+    void operator()(LeftRightCounterShard* shards) const {
+        freeCounterShards(shards);
+    }
+};
+
+// A pair of reader counters (index 0 and 1, like LeftRight::_counters), sharded
+// per thread slot.  Writers sleep on a condition variable while waiting for a
+// counter to drain; the last reader leaving a shard wakes them up.
+class ShardedReaderCounters final {
+public:
+    ShardedReaderCounters()
+    : _shards(allocateCounterShards())
+    , _writerWaiting(false)
+    , _drainMutex()
+    , _drainCondition()
+    {}
+
+    std::atomic<int32_t>* enter(uint8_t counterIndex) {
+        auto* counter = &_shards[leftRightReaderShard()].counters[counterIndex];
+        counter->fetch_add(1);
+        return counter;
+    }
+
+    void leave(std::atomic<int32_t>* counter) {
+        /*
+         * Both the decrement here and the _writerWaiting store in the writer are sequentially consistent.
+         * Either the writer's scan sees our decrement, or we see _writerWaiting == true and notify it.
+         * The notify takes _drainMutex, which the writer holds from its scan until it is asleep, so the
+         * wakeup can't get lost.
+         */
+        if (counter->fetch_sub(1) == 1 && C10_UNLIKELY(_writerWaiting.load())) {
+            std::lock_guard<std::mutex> lock(_drainMutex);
+            _drainCondition.notify_all();
+        }
+    }
+
+    // Must only be called by one thread at a time (i.e. under the writer's lock).
+    void waitForZero(uint8_t counterIndex) {
+        // Fast path: readers are short, usually they are gone already.
+        if (isZero(counterIndex)) {
+            return;
+        }
+        std::unique_lock<std::mutex> lock(_drainMutex);
+        _writerWaiting = true;
+        _drainCondition.wait(lock, [&] { return isZero(counterIndex); });
+        _writerWaiting = false;
+    }
+
+private:
+    bool isZero(uint8_t counterIndex) const {
+        for (size_t i = 0; i < kLeftRightNumShards; i++) {
+            if (_shards[i].counters[counterIndex].load() != 0) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    std::unique_ptr<LeftRightCounterShard[], CounterShardsDeleter> _shards;
+    std::atomic<bool> _writerWaiting;
+    std::mutex _drainMutex;
+    std::condition_variable _drainCondition;
+
+    C10_DISABLE_COPY_AND_ASSIGN(ShardedReaderCounters);
+};
+
+struct ShardedDecrementRAII final {
+public:
+    ShardedDecrementRAII(ShardedReaderCounters* counters, uint8_t counterIndex)
+    : _counters(counters), _counter(counters->enter(counterIndex)) {}
+
+    ~ShardedDecrementRAII() {
+        _counters->leave(_counter);
+    }
+private:
+    ShardedReaderCounters* _counters;
+    std::atomic<int32_t>* _counter;
+
+    C10_DISABLE_COPY_AND_ASSIGN(ShardedDecrementRAII);
+};
+
+}
+
+// Same wait-free readers algorithm as LeftRight, tuned for many reader cores:
+//  - Reader counters are sharded per thread slot, each shard on its own cache
+//    line, so concurrent read() calls on different cores don't contend on the
+//    counter's cache line.
+//  - Writers sleep on a condition variable while draining readers instead of
+//    spinning with std::this_thread::yield(); the last reader leaving a
+//    counter wakes them up.
+// The price is a write that scans all shards, and kLeftRightNumShards cache
+// lines of counters, so prefer plain LeftRight for objects that are not read
+// from many threads at once.
+template <class T>
+class ShardedLeftRight final {
+public:
+    template<class... Args>
+    explicit ShardedLeftRight(const Args& ...args)
+    : _counters()
+    , _foregroundCounterIndex(0)
+    , _foregroundDataIndex(0)
+    , _data{{T{args...}, T{args...}}}
+    , _writeMutex()
+    {}
+
+    // Copying and moving would not be threadsafe, see LeftRight.
+    ShardedLeftRight(const ShardedLeftRight&) = delete;
+    ShardedLeftRight(ShardedLeftRight&&) noexcept = delete;
+    ShardedLeftRight& operator=(const ShardedLeftRight&) = delete;
+    ShardedLeftRight& operator=(ShardedLeftRight&&) noexcept = delete;
+
+    ~ShardedLeftRight() {
+        // wait until any potentially running writers are finished
+        std::unique_lock<std::mutex> lock(_writeMutex);
+
+        // wait until any potentially running readers are finished
+        _counters.waitForZero(0);
+        _counters.waitForZero(1);
+    }
+
+    template <typename F>
+    auto read(F&& readFunc) const -> typename std::result_of<F(const T&)>::type {
+        detail::ShardedDecrementRAII _increment_counter(&_counters, _foregroundCounterIndex.load());
+
+        return readFunc(_data[_foregroundDataIndex.load()]);
+    }
+
+    // Same exception guarantee as LeftRight::write.
+    template <typename F>
+    auto write(F&& writeFunc) -> typename std::result_of<F(T&)>::type {
+        std::unique_lock<std::mutex> lock(_writeMutex);
+
+        return _write(writeFunc);
+    }
+
+private:
+    template <class F>
+    auto _write(const F& writeFunc) -> typename std::result_of<F(T&)>::type {
+        // See LeftRight::_write for the explanation of the individual steps.
+        auto localDataIndex = _foregroundDataIndex.load();
+
+        // 1. Write to A
+        _callWriteFuncOnBackgroundInstance(writeFunc, localDataIndex);
+
+        // 2. Switch A/B data pointers
+        localDataIndex = localDataIndex ^ 1;
+        _foregroundDataIndex = localDataIndex;
+
+        // 3. Wait until A counter is zero
+        auto localCounterIndex = _foregroundCounterIndex.load();
+        _counters.waitForZero(localCounterIndex ^ 1);
+
+        // 4. Switch A/B counters
+        localCounterIndex = localCounterIndex ^ 1;
+        _foregroundCounterIndex = localCounterIndex;
+
+        // 5. Wait until B counter is zero
+        _counters.waitForZero(localCounterIndex ^ 1);
+
+        // 6. Write to B
+        return _callWriteFuncOnBackgroundInstance(writeFunc, localDataIndex);
+    }
+
+    template<class F>
+    auto _callWriteFuncOnBackgroundInstance(const F& writeFunc, uint8_t localDataIndex) -> typename std::result_of<F(T&)>::type {
+        try {
+            return writeFunc(_data[localDataIndex ^ 1]);
+        } catch (...) {
+            // recover invariant by copying from the foreground instance
+            _data[localDataIndex ^ 1] = _data[localDataIndex];
+            // rethrow
+            throw;
+        }
+    }
+
+    mutable detail::ShardedReaderCounters _counters;
+    std::atomic<uint8_t> _foregroundCounterIndex;
+    std::atomic<uint8_t> _foregroundDataIndex;
+    std::array<T, 2> _data;
+    std::mutex _writeMutex;
+};
+
 }
@@ -0,0 +1,357 @@
+#include <c10/util/Parallel.h>
+
+#include <c10/util/Flags.h>
+#include <c10/util/thread_name.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <exception>
+#include <memory>
+#include <mutex>
+#include <thread>
+
+#ifndef _WIN32
+#include <pthread.h>
+#endif
+
+C10_DEFINE_int(
+    c10_num_threads,
+    0,
+    "Number of threads of the intra-op pool of c10::parallel_for, counting "
+    "the calling thread; 0 means one per hardware thread");
+
+namespace c10 {
+
+namespace {
+
+thread_local bool in_parallel_region_ = false;
+thread_local int thread_num_ = 0;
+
+// Marks the current thread as participant id of a parallel region, and
+// restores its state on exit.
+class ParallelRegionGuard {
+ public:
+  explicit ParallelRegionGuard(int id)
+      : old_in_region_(in_parallel_region_), old_thread_num_(thread_num_) {
+    in_parallel_region_ = true;
+    thread_num_ = id;
+  }
+  ~ParallelRegionGuard() {
+    in_parallel_region_ = old_in_region_;
+    thread_num_ = old_thread_num_;
+  }
+
+ private:
+  bool old_in_region_;
+  int old_thread_num_;
+};
+
+// num_threads - 1 workers, the caller of run() being participant 0.
+//
+// A job is cut into chunks, numbered from 0, and each participant owns a
+// range [lo, hi) of chunk numbers, packed in one 64-bit word so that it is
+// updated with a single CAS.  The owner takes chunks from the front; a
+// participant whose range is empty steals the back half of another's.  A
+// participant leaves the job when every range is empty, and run() returns
+// once all of them have left.
+class ThreadPool {
+ public:
+  explicit ThreadPool(int num_threads) : ranges_(num_threads) {
+    workers_.reserve(num_threads - 1);
+    for (int id = 1; id < num_threads; id++) {
+      workers_.emplace_back([this, id] { worker_loop(id); });
+    }
+  }
+
+  ~ThreadPool() {
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      stop_ = true;
+    }
+    wake_cv_.notify_all();
+    for (auto& worker : workers_) {
+      worker.join();
+    }
+  }
+
+  int size() const {
+    return static_cast<int>(ranges_.size());
+  }
+
+  // Whether the job ran here; false if the pool is busy with another caller's.
+  bool run(
+      int64_t begin,
+      int64_t end,
+      int64_t grain_size,
+      c10::function_ref<void(int64_t, int64_t)> fn) {
+    std::unique_lock<std::mutex> job_lock(job_mutex_, std::try_to_lock);
+    if (!job_lock.owns_lock()) {
+      return false;
+    }
+    // A few chunks per participant leave something to steal when the work
+    // is uneven.
+    constexpr int64_t kChunksPerThread = 4;
+    const int64_t range = end - begin;
+    chunk_size_ = std::max<int64_t>(
+        {grain_size, internal::divup(range, size() * kChunksPerThread), 1});
+    const int64_t num_chunks = internal::divup(range, chunk_size_);
+    const int participants = static_cast<int>(std::min<int64_t>(size(), num_chunks));
+    begin_ = begin;
+    end_ = end;
+    fn_ = fn;
+    failed_.store(false);
+    exception_ = nullptr;
+    for (int id = 0; id < size(); id++) {
+      const int64_t lo = id < participants ? num_chunks * id / participants : 0;
+      const int64_t hi = id < participants ? num_chunks * (id + 1) / participants : 0;
+      ranges_[id].bounds.store(pack(lo, hi));
+    }
+    {
+      std::lock_guard<std::mutex> guard(mutex_);
+      participants_ = participants;
+      left_ = 0;
+      generation_++;
+    }
+    wake_cv_.notify_all();
+
+    participate(0);
+
+    std::unique_lock<std::mutex> lock(mutex_);
+    done_cv_.wait(lock, [&] { return left_ == participants_ - 1; });
+    if (exception_) {
+      std::rethrow_exception(exception_);
+    }
+    return true;
+  }
+
+ private:
+  // Padded so that two participants' ranges never share a cache line
+  struct Range {
+    std::atomic<uint64_t> bounds{0};
+    char padding[64 - sizeof(std::atomic<uint64_t>)];
+  };
+
+  static uint64_t pack(int64_t lo, int64_t hi) {
+    return (static_cast<uint64_t>(lo) << 32) | static_cast<uint64_t>(hi);
+  }
+  static int64_t lo_of(uint64_t bounds) {
+    return static_cast<int64_t>(bounds >> 32);
+  }
+  static int64_t hi_of(uint64_t bounds) {
+    return static_cast<int64_t>(bounds & 0xffffffffu);
+  }
+
+  void worker_loop(int id) {
+    setThreadName("c10_intraop");
+    uint64_t seen = 0;
+    for (;;) {
+      {
+        std::unique_lock<std::mutex> lock(mutex_);
+        wake_cv_.wait(lock, [&] { return stop_ || generation_ != seen; });
+        if (stop_) {
+          return;
+        }
+        seen = generation_;
+        if (id >= participants_) {
+          continue;
+        }
+      }
+      participate(id);
+      {
+        std::lock_guard<std::mutex> guard(mutex_);
+        left_++;
+      }
+      done_cv_.notify_one();
+    }
+  }
+
+  void participate(int id) {
+    ParallelRegionGuard region(id);
+    int64_t chunk = 0;
+    while (pop(id, &chunk) || steal(id, &chunk)) {
+      if (failed_.load(std::memory_order_relaxed)) {
+        continue; // drain the ranges without running the chunks
+      }
+      const int64_t chunk_begin = begin_ + chunk * chunk_size_;
+      try {
+        fn_(chunk_begin, std::min(end_, chunk_begin + chunk_size_));
+      } catch (...) {
+        std::lock_guard<std::mutex> guard(mutex_);
+        if (!failed_.exchange(true)) {
+          exception_ = std::current_exception();
+        }
+      }
+    }
+  }
+
+  // Takes the first chunk of the participant's own range.
+  bool pop(int id, int64_t* chunk) {
+    auto& bounds = ranges_[id].bounds;
+    uint64_t current = bounds.load();
+    for (;;) {
+      const int64_t lo = lo_of(current);
+      const int64_t hi = hi_of(current);
+      if (lo >= hi) {
+        return false;
+      }
+      if (bounds.compare_exchange_weak(current, pack(lo + 1, hi))) {
+        *chunk = lo;
+        return true;
+      }
+    }
+  }
+
+  // Moves the back half of another participant's range to the thief's own
+  // (empty) range, and takes its first chunk.
+  bool steal(int thief, int64_t* chunk) {
+    for (int k = 1; k < size(); k++) {
+      auto& bounds = ranges_[(thief + k) % size()].bounds;
+      uint64_t current = bounds.load();
+      for (;;) {
+        const int64_t lo = lo_of(current);
+        const int64_t hi = hi_of(current);
+        if (lo >= hi) {
+          break;
+        }
+        const int64_t mid = hi - (hi - lo + 1) / 2;
+        if (bounds.compare_exchange_weak(current, pack(lo, mid))) {
+          ranges_[thief].bounds.store(pack(mid + 1, hi));
+          *chunk = mid;
+          return true;
+        }
+      }
+    }
+    return false;
+  }
+
+  std::vector<Range> ranges_;
+  std::vector<std::thread> workers_;
+
+  // Serializes jobs
+  std::mutex job_mutex_;
+
+  // The job, written by run() before the workers are woken
+  int64_t begin_ = 0;
+  int64_t end_ = 0;
+  int64_t chunk_size_ = 1;
+  c10::function_ref<void(int64_t, int64_t)> fn_;
+  std::atomic<bool> failed_{false};
+  std::exception_ptr exception_;
+
+  // Guards the fields below and exception_
+  std::mutex mutex_;
+  std::condition_variable wake_cv_;
+  std::condition_variable done_cv_;
+  uint64_t generation_ = 0;
+  int participants_ = 0;
+  // Workers that have left the current job
+  int left_ = 0;
+  bool stop_ = false;
+};
+
+std::mutex pool_mutex_;
+std::shared_ptr<ThreadPool> pool_;
+// Set by set_num_threads(), 0 until then
+int num_threads_ = 0;
+// What get_num_threads() returns, 0 until first computed.  Written under
+// pool_mutex_, read without it on every parallel_for.
+std::atomic<int> cached_num_threads_{0};
+
+int configured_num_threads() {
+  if (num_threads_ > 0) {
+    return num_threads_;
+  }
+  if (FLAGS_c10_num_threads > 0) {
+    return FLAGS_c10_num_threads;
+  }
+  return std::max(1, static_cast<int>(std::thread::hardware_concurrency()));
+}
+
+#ifndef _WIN32
+// The child of a fork() has only the forking thread, so the pool's workers
+// are gone.  pool_mutex_ is held across the fork so that the child doesn't
+// inherit it locked by a thread that no longer exists; the child then drops
+// the parent's pool without destroying it (its threads can't be joined) and
+// makes a new one on first use.
+void prepare_fork() {
+  pool_mutex_.lock();
+}
+
+void parent_after_fork() {
+  pool_mutex_.unlock();
+}
+
+void child_after_fork() {
+  new std::shared_ptr<ThreadPool>(std::move(pool_)); // leaked on purpose
+  cached_num_threads_.store(configured_num_threads(), std::memory_order_relaxed);
+  pool_mutex_.unlock();
+}
+#endif
+
+std::shared_ptr<ThreadPool> get_pool() {
+#ifndef _WIN32
+  static const int registered =
+      pthread_atfork(prepare_fork, parent_after_fork, child_after_fork);
+  (void)registered;
+#endif
+  std::lock_guard<std::mutex> guard(pool_mutex_);
+  if (!pool_) {
+    pool_ = std::make_shared<ThreadPool>(configured_num_threads());
+    cached_num_threads_.store(pool_->size(), std::memory_order_relaxed);
+  }
+  return pool_;
+}
+
+} // namespace
+
+namespace internal {
+
+void invoke_parallel(
+    int64_t begin,
+    int64_t end,
+    int64_t grain_size,
+    c10::function_ref<void(int64_t, int64_t)> fn) {
+  const auto pool = get_pool();
+  if (!pool->run(begin, end, grain_size, fn)) {
+    fn(begin, end);
+  }
+}
+
+} // namespace internal
+
+int get_num_threads() {
+  const int cached = cached_num_threads_.load(std::memory_order_relaxed);
+  if (cached > 0) {
+    return cached;
+  }
+  std::lock_guard<std::mutex> guard(pool_mutex_);
+  const int num_threads = pool_ ? pool_->size() : configured_num_threads();
+  cached_num_threads_.store(num_threads, std::memory_order_relaxed);
+  return num_threads;
+}
+
+void set_num_threads(int nthreads) {
+  TORCH_CHECK(nthreads > 0, "set_num_threads: expected a positive number of threads, got ", nthreads);
+  std::shared_ptr<ThreadPool> old_pool;
+  {
+    std::lock_guard<std::mutex> guard(pool_mutex_);
+    num_threads_ = nthreads;
+    cached_num_threads_.store(nthreads, std::memory_order_relaxed);
+    if (pool_ && pool_->size() != nthreads) {
+      old_pool = std::move(pool_);
+    }
+  }
+  // joins the old workers, outside of the lock, unless a parallel region
+  // still holds the old pool
+  old_pool.reset();
+}
+
+int get_thread_num() {
+  return thread_num_;
+}
+
+bool in_parallel_region() {
+  return in_parallel_region_;
+}
+
+} // namespace c10
@@ -0,0 +1,137 @@
+#pragma once
+
+#include <c10/macros/Macros.h>
+#include <c10/util/Exception.h>
+#include <c10/util/FunctionRef.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+// Intra-op parallelism on a process-wide thread pool:
+//
+//   parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+//     for (int64_t i = begin; i < end; i++) {
+//       y[i] = f(x[i]);
+//     }
+//   });
+//
+// The range is cut into chunks of at least grain_size elements (the last one
+// may be shorter), and the calling thread and the pool's workers run them.
+// Each participant starts on its own share of the chunks and, when that runs
+// out, steals half of what is left of another one's share, so uneven chunks
+// don't leave threads idle.  Ranges of grain_size elements or fewer run
+// inline on the calling thread, as does every call made from inside a
+// parallel region, so nested parallel_for never oversubscribes the machine.
+//
+// The pool has get_num_threads() participants counting the calling thread.
+// It is created on first use with --c10_num_threads threads (0, the default,
+// means one per hardware thread), or with the count of the last
+// set_num_threads().  Only one parallel region runs on the pool at a time:
+// a parallel_for from another thread while the pool is busy runs inline.
+//
+// A child process made with fork() gets a fresh pool on its first
+// parallel_for; the parent's workers don't exist in the child.
+//
+// If fn throws, the remaining chunks are skipped and the first exception is
+// rethrown on the calling thread.
+
+namespace c10 {
+
+namespace internal {
+
+// Elements per chunk below which splitting a cheap elementwise loop costs
+// more than it saves
+constexpr int64_t GRAIN_SIZE = 32768;
+
+C10_API void invoke_parallel(
+    int64_t begin,
+    int64_t end,
+    int64_t grain_size,
+    c10::function_ref<void(int64_t, int64_t)> fn);
+
+inline int64_t divup(int64_t x, int64_t y) {
+  return (x + y - 1) / y;
+}
+
+} // namespace internal
+
+// Number of threads a parallel region may use, counting the caller
+C10_API int get_num_threads();
+
+// Resizes the pool.  Parallel regions running on the old pool finish on it.
+C10_API void set_num_threads(int nthreads);
+
+// Index of the current thread in the running parallel region, in
+// [0, get_num_threads()); 0 outside of one.
+C10_API int get_thread_num();
+
+C10_API bool in_parallel_region();
+
+// Calls fn(chunk_begin, chunk_end) on disjoint chunks covering [begin, end).
+template <typename F>
+inline void parallel_for(int64_t begin, int64_t end, int64_t grain_size, const F& fn) {
+  TORCH_CHECK(grain_size >= 0, "parallel_for: grain_size must be non-negative, got ", grain_size);
+  if (begin >= end) {
+    return;
+  }
+  if (end - begin <= grain_size || in_parallel_region() || get_num_threads() == 1) {
+    fn(begin, end);
+    return;
+  }
+  internal::invoke_parallel(begin, end, grain_size, fn);
+}
+
+// Reduces [begin, end) to a scalar_t:
+//
+//   float sum = parallel_reduce(0, n, internal::GRAIN_SIZE, 0.f,
+//       [&](int64_t begin, int64_t end, float ident) {
+//         float partial = ident;
+//         for (int64_t i = begin; i < end; i++) {
+//           partial += x[i];
+//         }
+//         return partial;
+//       },
+//       std::plus<float>());
+//
+// fn reduces one chunk, starting from ident, and combine merges two partial
+// results.  The chunks depend only on the range and grain_size, and their
+// results are combined left to right, so the result is the same whatever the
+// number of threads, even for operations like floating point addition that
+// are not associative.
+template <typename scalar_t, typename F, typename SF>
+inline scalar_t parallel_reduce(
+    int64_t begin,
+    int64_t end,
+    int64_t grain_size,
+    const scalar_t ident,
+    const F& fn,
+    const SF& combine) {
+  // Caps the number of partial results, independently of the thread count
+  constexpr int64_t kMaxChunks = 256;
+  TORCH_CHECK(grain_size >= 0, "parallel_reduce: grain_size must be non-negative, got ", grain_size);
+  if (begin >= end) {
+    return ident;
+  }
+  const int64_t range = end - begin;
+  if (range <= grain_size) {
+    return fn(begin, end, ident);
+  }
+  const int64_t chunk_size =
+      std::max<int64_t>({grain_size, internal::divup(range, kMaxChunks), 1});
+  const int64_t num_chunks = internal::divup(range, chunk_size);
+  std::vector<scalar_t> results(num_chunks, ident);
+  parallel_for(0, num_chunks, 1, [&](int64_t first, int64_t last) {
+    for (int64_t c = first; c < last; c++) {
+      const int64_t chunk_begin = begin + c * chunk_size;
+      results[c] = fn(chunk_begin, std::min(end, chunk_begin + chunk_size), ident);
+    }
+  });
+  scalar_t result = results[0];
+  for (int64_t c = 1; c < num_chunks; c++) {
+    result = combine(result, results[c]);
+  }
+  return result;
+}
+
+} // namespace c10
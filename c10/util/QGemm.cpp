@@ -0,0 +1,142 @@
+#include <c10/util/QGemm.h>
+#include <c10/core/CPUAllocator.h>
+#include <c10/cpu/QGemmKernel.h>
+#include <c10/util/Exception.h>
+#include <c10/util/Parallel.h>
+
+#include <algorithm>
+
+namespace c10 {
+
+DEFINE_DISPATCH(qgemm_stub);
+
+PackedQInt8Matrix::PackedQInt8Matrix(
+    Transpose trans,
+    int64_t k,
+    int64_t n,
+    const qint8* b,
+    int64_t ldb,
+    int32_t zero_point)
+    : k_(k), n_(n), zero_point_(zero_point) {
+  TORCH_CHECK(
+      k >= 0 && n >= 0, "PackedQInt8Matrix: sizes must be non-negative, got k ", k, ", n ", n);
+  const int64_t stored_cols = std::max<int64_t>(trans == Transpose::NoTrans ? n : k, 1);
+  TORCH_CHECK(
+      ldb >= stored_cols, "PackedQInt8Matrix: ldb must be at least ", stored_cols, ", got ", ldb);
+  TORCH_CHECK(
+      zero_point >= -128 && zero_point <= 127,
+      "PackedQInt8Matrix: zero_point must be in [-128, 127], got ", zero_point);
+  const int64_t groups = padded_k(k) / 4;
+  const int64_t blocks = padded_n(n) / 16;
+  data_ = GetDefaultCPUAllocator()->allocate(packed_size() + padded_n(n) * sizeof(int32_t));
+  auto* packed = static_cast<int8_t*>(data_.get());
+  auto* sums = const_cast<int32_t*>(column_sums());
+  auto value = [&](int64_t p, int64_t j) -> int8_t {
+    if (p >= k || j >= n) {
+      return 0;
+    }
+    return trans == Transpose::NoTrans ? b[p * ldb + j].val_ : b[j * ldb + p].val_;
+  };
+  const int64_t grain_size =
+      internal::divup(internal::GRAIN_SIZE, std::max<int64_t>(64 * groups, 1));
+  parallel_for(0, blocks, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t block = begin; block < end; block++) {
+      int8_t* dst = packed + block * groups * 64;
+      for (int64_t g = 0; g < groups; g++) {
+        for (int64_t c = 0; c < 16; c++) {
+          for (int64_t t = 0; t < 4; t++) {
+            dst[(g * 16 + c) * 4 + t] = value(4 * g + t, block * 16 + c);
+          }
+        }
+      }
+      for (int64_t c = 0; c < 16; c++) {
+        int32_t sum = 0;
+        for (int64_t p = 0; p < k; p++) {
+          sum += value(p, block * 16 + c);
+        }
+        sums[block * 16 + c] = sum;
+      }
+    }
+  });
+}
+
+namespace {
+
+void check_qgemm(
+    const char* fn,
+    int64_t m,
+    int64_t lda,
+    int32_t a_zero_point,
+    const PackedQInt8Matrix& b,
+    int64_t ldc) {
+  TORCH_CHECK(m >= 0, fn, ": m must be non-negative, got ", m);
+  TORCH_CHECK(
+      lda >= std::max<int64_t>(b.k(), 1), fn, ": lda must be at least ",
+      std::max<int64_t>(b.k(), 1), ", got ", lda);
+  TORCH_CHECK(
+      ldc >= std::max<int64_t>(b.n(), 1), fn, ": ldc must be at least ",
+      std::max<int64_t>(b.n(), 1), ", got ", ldc);
+  TORCH_CHECK(
+      a_zero_point >= 0 && a_zero_point <= 255,
+      fn, ": a_zero_point must be in [0, 255], got ", a_zero_point);
+}
+
+} // namespace
+
+void qgemm(
+    int64_t m,
+    const quint8* a,
+    int64_t lda,
+    int32_t a_zero_point,
+    const PackedQInt8Matrix& b,
+    qint32* c,
+    int64_t ldc) {
+  check_qgemm("qgemm", m, lda, a_zero_point, b, ldc);
+  if (m == 0 || b.n() == 0) {
+    return;
+  }
+  QGemmParams p;
+  p.m = m;
+  p.a = a;
+  p.lda = lda;
+  p.a_zero_point = a_zero_point;
+  p.b = &b;
+  p.c32 = c;
+  p.ldc = ldc;
+  qgemm_stub(p);
+}
+
+void qgemm_requantize(
+    int64_t m,
+    const quint8* a,
+    int64_t lda,
+    int32_t a_zero_point,
+    const PackedQInt8Matrix& b,
+    const int32_t* bias,
+    const RequantizationParams& params,
+    quint8* c,
+    int64_t ldc) {
+  check_qgemm("qgemm_requantize", m, lda, a_zero_point, b, ldc);
+  TORCH_CHECK(
+      params.multiplier >= (int32_t(1) << 30) && params.shift >= 31 && params.shift <= 61,
+      "qgemm_requantize: invalid RequantizationParams, use choose_requantization_params");
+  TORCH_CHECK(
+      params.zero_point >= 0 && params.zero_point <= 255,
+      "qgemm_requantize: zero_point ", params.zero_point, " is out of range for quint8");
+  if (m == 0 || b.n() == 0) {
+    return;
+  }
+  QGemmParams p;
+  p.m = m;
+  p.a = a;
+  p.lda = lda;
+  p.a_zero_point = a_zero_point;
+  p.b = &b;
+  p.bias = bias;
+  p.c8 = c;
+  p.requantization = &params;
+  p.ldc = ldc;
+  qgemm_stub(p);
+}
+
+} // namespace c10
@@ -0,0 +1,109 @@
+#pragma once
+
+#include <c10/core/Allocator.h>
+#include <c10/macros/Macros.h>
+#include <c10/util/Gemm.h>
+#include <c10/util/Quantize.h>
+
+#include <cstdint>
+
+// u8 x s8 -> s32 matrix products for quantized linear layers, row-major:
+//
+//   C[i][j] = sum_p (A[i][p] - a_zero_point) * (op(B)[p][j] - b_zero_point)
+//
+// A is m x k quint8 activations and op(B) is k x n qint8 weights, packed once
+// into a PackedQInt8Matrix and reused from call to call.  qgemm stores C as
+// qint32; qgemm_requantize adds a per-column int32 bias and requantizes to
+// quint8 (see requantize_val in Quantize.h) before C leaves the cache.  The
+// accumulators are 32 bits, exact for k up to 33025 (2^31 / 255^2).
+//
+// The kernel (c10/cpu/QGemmKernel.cpp) multiplies groups of 4 consecutive
+// values of k: 4 bytes of a row of A, broadcast, against 16 columns of
+// packed B per 512-bit vector.  AVX-512 CPUs with VNNI sum the 4 products
+// into the 32-bit accumulators with vpdpbusd.  Other AVX-512 CPUs, and AVX2
+// ones, use vpmaddubsw and vpmaddwd, as FBGEMM does: vpmaddubsw adds pairs of
+// products in 16 bits, with saturation, which is exact for activations in
+// [0, 127] (what quantizing with a reduced range gives).  Packing A checks
+// its range, and when it has values above 127 these kernels split them into
+// their low 7 bits and their top bit and multiply both, which stays exact at
+// twice the multiplies.  Other CPUs compute exactly in scalar code.  Tiles of
+// C are spread over the intra-op thread pool.
+
+namespace c10 {
+
+// op(B), k x n qint8, in the layout of the kernel: columns in blocks of 16,
+// and each block as k / 4 groups of 16 x 4 bytes, the 4 values of k of each
+// column being adjacent.  k is padded to a multiple of 4 and n to a multiple
+// of 32 with zeros.  Also keeps the column sums for the zero point terms.
+class C10_API PackedQInt8Matrix {
+ public:
+  // B is stored k x n (NoTrans) or n x k (Trans, the usual layout of the
+  // weights of a linear layer), ldb elements between rows.
+  PackedQInt8Matrix(
+      Transpose trans,
+      int64_t k,
+      int64_t n,
+      const qint8* b,
+      int64_t ldb,
+      int32_t zero_point);
+
+  int64_t k() const {
+    return k_;
+  }
+  int64_t n() const {
+    return n_;
+  }
+  int32_t zero_point() const {
+    return zero_point_;
+  }
+  // The packed values, and the sums of the columns of op(B)
+  const int8_t* data() const {
+    return static_cast<const int8_t*>(data_.get());
+  }
+  const int32_t* column_sums() const {
+    return reinterpret_cast<const int32_t*>(data() + packed_size());
+  }
+
+  // The padded sizes
+  static int64_t padded_k(int64_t k) {
+    return (k + 3) / 4 * 4;
+  }
+  static int64_t padded_n(int64_t n) {
+    return (n + 31) / 32 * 32;
+  }
+
+ private:
+  int64_t packed_size() const {
+    return padded_k(k_) * padded_n(n_);
+  }
+
+  int64_t k_;
+  int64_t n_;
+  int32_t zero_point_;
+  DataPtr data_;
+};
+
+// C = (A - a_zero_point) * (op(B) - b_zero_point), m x n qint32.
+C10_API void qgemm(
+    int64_t m,
+    const quint8* a,
+    int64_t lda,
+    int32_t a_zero_point,
+    const PackedQInt8Matrix& b,
+    qint32* c,
+    int64_t ldc);
+
+// C = requantize(A x op(B) as above + bias), m x n quint8.  bias has n
+// values, or is null.
+C10_API void qgemm_requantize(
+    int64_t m,
+    const quint8* a,
+    int64_t lda,
+    int32_t a_zero_point,
+    const PackedQInt8Matrix& b,
+    const int32_t* bias,
+    const RequantizationParams& params,
+    quint8* c,
+    int64_t ldc);
+
+} // namespace c10
@@ -0,0 +1,198 @@
+#include <c10/util/Quantize.h>
+#include <c10/cpu/QuantizeKernel.h>
+#include <c10/util/Exception.h>
+#include <c10/util/Parallel.h>
+
+namespace c10 {
+
+DEFINE_DISPATCH(quantize_stub);
+DEFINE_DISPATCH(dequantize_stub);
+DEFINE_DISPATCH(quantize_per_channel_stub);
+DEFINE_DISPATCH(dequantize_per_channel_stub);
+DEFINE_DISPATCH(requantize_stub);
+
+namespace {
+
+void check_quantization_params(
+    const char* fn,
+    ScalarType dtype,
+    float scale,
+    int32_t zero_point) {
+  TORCH_CHECK(isQIntType(dtype), fn, ": expected a quantized dtype, got ", dtype);
+  TORCH_CHECK(
+      scale > 0 && std::isfinite(scale),
+      fn, ": scale must be positive and finite, got ", scale);
+  int64_t qmin = 0;
+  int64_t qmax = 0;
+  switch (dtype) {
+#define RANGE_CASE(type, name)                                          \
+    case ScalarType::name:                                              \
+      qmin = std::numeric_limits<type::underlying>::min();              \
+      qmax = std::numeric_limits<type::underlying>::max();              \
+      break;
+    AT_FORALL_QINT_TYPES(RANGE_CASE)
+#undef RANGE_CASE
+    default:
+      break;
+  }
+  TORCH_CHECK(
+      zero_point >= qmin && zero_point <= qmax,
+      fn, ": zero_point ", zero_point, " is out of range for ", dtype);
+}
+
+void check_per_channel_params(
+    const char* fn,
+    ScalarType dtype,
+    int64_t outer_size,
+    int64_t channels,
+    int64_t inner_size,
+    const float* scales,
+    const int32_t* zero_points) {
+  TORCH_CHECK(
+      outer_size >= 0 && channels >= 0 && inner_size >= 0,
+      fn, ": sizes must be non-negative");
+  for (int64_t c = 0; c < channels; c++) {
+    check_quantization_params(fn, dtype, scales[c], zero_points[c]);
+  }
+}
+
+// Splits the outer_size * channels rows of inner_size elements across the
+// thread pool.  fn(offset, c, count) handles the count rows of channels c to
+// c + count - 1 that start at element offset, all within one outer index.
+template <typename F>
+void for_each_channel_rows(int64_t outer_size, int64_t channels, int64_t inner_size, const F& fn) {
+  const int64_t grain_size = internal::divup(internal::GRAIN_SIZE, std::max<int64_t>(inner_size, 1));
+  parallel_for(0, outer_size * channels, grain_size, [&](int64_t begin, int64_t end) {
+    for (int64_t row = begin; row < end;) {
+      const int64_t c = row % channels;
+      const int64_t count = std::min(end - row, channels - c);
+      fn(row * inner_size, c, count);
+      row += count;
+    }
+  });
+}
+
+} // namespace
+
+void quantize_per_tensor(
+    const float* src,
+    void* dst,
+    ScalarType dst_dtype,
+    size_t n,
+    float scale,
+    int32_t zero_point) {
+  check_quantization_params("quantize_per_tensor", dst_dtype, scale, zero_point);
+  const size_t itemsize = elementSize(dst_dtype);
+  parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    quantize_stub(
+        src + begin, static_cast<char*>(dst) + begin * itemsize, dst_dtype, end - begin,
+        scale, zero_point);
+  });
+}
+
+void dequantize_per_tensor(
+    const void* src,
+    ScalarType src_dtype,
+    float* dst,
+    size_t n,
+    float scale,
+    int32_t zero_point) {
+  check_quantization_params("dequantize_per_tensor", src_dtype, scale, zero_point);
+  const size_t itemsize = elementSize(src_dtype);
+  parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    dequantize_stub(
+        static_cast<const char*>(src) + begin * itemsize, src_dtype, dst + begin, end - begin,
+        scale, zero_point);
+  });
+}
+
+void quantize_per_channel(
+    const float* src,
+    void* dst,
+    ScalarType dst_dtype,
+    int64_t outer_size,
+    int64_t channels,
+    int64_t inner_size,
+    const float* scales,
+    const int32_t* zero_points) {
+  check_per_channel_params(
+      "quantize_per_channel", dst_dtype, outer_size, channels, inner_size, scales, zero_points);
+  const size_t itemsize = elementSize(dst_dtype);
+  for_each_channel_rows(
+      outer_size, channels, inner_size,
+      [&](int64_t offset, int64_t c, int64_t count) {
+        quantize_per_channel_stub(
+            src + offset, static_cast<char*>(dst) + offset * itemsize, dst_dtype,
+            1, count, inner_size, scales + c, zero_points + c);
+      });
+}
+
+void dequantize_per_channel(
+    const void* src,
+    ScalarType src_dtype,
+    float* dst,
+    int64_t outer_size,
+    int64_t channels,
+    int64_t inner_size,
+    const float* scales,
+    const int32_t* zero_points) {
+  check_per_channel_params(
+      "dequantize_per_channel", src_dtype, outer_size, channels, inner_size, scales, zero_points);
+  const size_t itemsize = elementSize(src_dtype);
+  for_each_channel_rows(
+      outer_size, channels, inner_size,
+      [&](int64_t offset, int64_t c, int64_t count) {
+        dequantize_per_channel_stub(
+            static_cast<const char*>(src) + offset * itemsize, src_dtype, dst + offset,
+            1, count, inner_size, scales + c, zero_points + c);
+      });
+}
+
+RequantizationParams choose_requantization_params(
+    double real_multiplier,
+    int32_t zero_point) {
+  // The kernels need shift <= 61, see c10/cpu/QuantizeKernel.cpp.
+  TORCH_CHECK(
+      real_multiplier >= std::ldexp(1.0, -31) && real_multiplier < 1.0,
+      "choose_requantization_params: real_multiplier must be in [2^-31, 1), got ",
+      real_multiplier);
+  TORCH_CHECK(
+      zero_point >= 0 && zero_point <= 255,
+      "choose_requantization_params: zero_point ", zero_point,
+      " is out of range for quint8");
+  int exponent = 0;
+  const double fraction = std::frexp(real_multiplier, &exponent);
+  int64_t multiplier = static_cast<int64_t>(std::nearbyint(std::ldexp(fraction, 31)));
+  if (multiplier == (int64_t(1) << 31)) {
+    if (exponent < 0) {
+      multiplier >>= 1;
+      exponent++;
+    } else {
+      // real_multiplier is within 2^-32 of 1, keep shift >= 31
+      multiplier--;
+    }
+  }
+  RequantizationParams params;
+  params.multiplier = static_cast<int32_t>(multiplier);
+  params.shift = 31 - exponent;
+  params.zero_point = zero_point;
+  return params;
+}
+
+void requantize(
+    const qint32* src,
+    quint8* dst,
+    size_t n,
+    const RequantizationParams& params) {
+  TORCH_CHECK(
+      params.multiplier >= (int32_t(1) << 30) && params.shift >= 31 && params.shift <= 61,
+      "requantize: invalid RequantizationParams, use choose_requantization_params");
+  TORCH_CHECK(
+      params.zero_point >= 0 && params.zero_point <= 255,
+      "requantize: zero_point ", params.zero_point, " is out of range for quint8");
+  parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    requantize_stub(src + begin, dst + begin, end - begin, params);
+  });
+}
+
+} // namespace c10
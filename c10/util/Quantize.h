@@ -0,0 +1,136 @@
+#pragma once
+
+#include <c10/core/ScalarType.h>
+#include <c10/macros/Macros.h>
+#include <c10/util/qint32.h>
+#include <c10/util/qint8.h>
+#include <c10/util/quint8.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+// Bulk quantization kernels for the quantized dtypes (QInt8, QUInt8, QInt32).
+//
+//   quantize:    q = clamp(nearbyint(x * (1 / scale)) + zero_point, qmin, qmax)
+//   dequantize:  x = (q - zero_point) * scale
+//
+// in float arithmetic.  Rounding is half to even; NaN quantizes to
+// zero_point and +-inf saturates.  The bulk functions use AVX2 / AVX-512 when
+// the CPU supports it and agree bit for bit with quantize_val /
+// dequantize_val below on every path.  Large arrays are split across the
+// intra-op thread pool (c10/util/Parallel.h), by elements for the per-tensor
+// functions and requantize, and by [outer, channel] rows for the per-channel
+// ones.
+//
+// The per-channel variants take src / dst as a contiguous
+// [outer_size, channels, inner_size] array, with one scale and zero_point per
+// channel.  Quantizing along dimension d of a contiguous tensor means
+// outer_size = prod(sizes[:d]), channels = sizes[d] and
+// inner_size = prod(sizes[d + 1:]).  They vectorize along inner_size, so
+// quantizing along the last dimension runs the scalar code.
+//
+// requantize maps the qint32 accumulators of an int8 GEMM or convolution to
+// quint8:
+//
+//   q = clamp(round(x * real_multiplier) + zero_point, 0, 255)
+//
+// with real_multiplier in fixed point (see RequantizationParams), so the
+// result is exact: x * multiplier is computed in 64 bits and rounded half to
+// even.
+
+namespace c10 {
+
+template <typename T>
+inline T quantize_val(float inverse_scale, int32_t zero_point, float value) {
+  using underlying = typename T::underlying;
+  constexpr int64_t qmin = std::numeric_limits<underlying>::min();
+  constexpr int64_t qmax = std::numeric_limits<underlying>::max();
+  const float r = std::nearbyint(value * inverse_scale);
+  if (std::isnan(r)) {
+    return T(static_cast<underlying>(zero_point));
+  }
+  // compare in double, r may not fit in int64_t and qmax - zero_point may
+  // not fit in a float
+  if (static_cast<double>(r) > static_cast<double>(qmax - zero_point)) {
+    return T(static_cast<underlying>(qmax));
+  }
+  if (static_cast<double>(r) < static_cast<double>(qmin - zero_point)) {
+    return T(static_cast<underlying>(qmin));
+  }
+  return T(static_cast<underlying>(static_cast<int64_t>(r) + zero_point));
+}
+
+template <typename T>
+inline float dequantize_val(float scale, int32_t zero_point, T value) {
+  return (static_cast<float>(value.val_) - static_cast<float>(zero_point)) * scale;
+}
+
+// Per tensor quantization parameters are checked: scale must be positive and
+// finite, and zero_point in the range of dtype.
+C10_API void quantize_per_tensor(
+    const float* src,
+    void* dst,
+    ScalarType dst_dtype,
+    size_t n,
+    float scale,
+    int32_t zero_point);
+
+C10_API void dequantize_per_tensor(
+    const void* src,
+    ScalarType src_dtype,
+    float* dst,
+    size_t n,
+    float scale,
+    int32_t zero_point);
+
+C10_API void quantize_per_channel(
+    const float* src,
+    void* dst,
+    ScalarType dst_dtype,
+    int64_t outer_size,
+    int64_t channels,
+    int64_t inner_size,
+    const float* scales,
+    const int32_t* zero_points);
+
+C10_API void dequantize_per_channel(
+    const void* src,
+    ScalarType src_dtype,
+    float* dst,
+    int64_t outer_size,
+    int64_t channels,
+    int64_t inner_size,
+    const float* scales,
+    const int32_t* zero_points);
+
+// real_multiplier = multiplier * 2^-shift, with multiplier in [2^30, 2^31).
+struct RequantizationParams {
+  int32_t multiplier;
+  int32_t shift;
+  int32_t zero_point;
+};
+
+// real_multiplier must be in [2^-31, 1), which covers the usual
+// input_scale * weight_scale / output_scale, and zero_point in [0, 255].
+C10_API RequantizationParams
+choose_requantization_params(double real_multiplier, int32_t zero_point);
+
+inline quint8 requantize_val(const RequantizationParams& params, qint32 value) {
+  const int64_t product = static_cast<int64_t>(value.val_) * params.multiplier;
+  const int64_t half = int64_t(1) << (params.shift - 1);
+  const int64_t floor = product >> params.shift;
+  const int64_t rounded = (product + (half - 1) + (floor & 1)) >> params.shift;
+  const int64_t q = rounded + params.zero_point;
+  return quint8(static_cast<uint8_t>(std::min<int64_t>(std::max<int64_t>(q, 0), 255)));
+}
+
+C10_API void requantize(
+    const qint32* src,
+    quint8* dst,
+    size_t n,
+    const RequantizationParams& params);
+
+} // namespace c10
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <c10/macros/Macros.h>
+#include <c10/util/LeftRight.h>
+
+namespace c10 {
+
+// Read-copy-update container for big, read-mostly state (operator registries,
+// routing tables, ...).
+//
+// Unlike LeftRight, which keeps two full copies of T and applies every write
+// to both, RcuSnapshot keeps a single current version behind an atomic
+// pointer.  A writer copies the current version, modifies the copy and
+// publishes it; the old version is freed as soon as every reader that could
+// still see it is gone.  So T exists twice only for the duration of a write,
+// and each write is done once.
+//
+// Readers pin the current epoch in a per-thread-sharded counter (see
+// ShardedReaderCounters in LeftRight.h) and load the pointer; both are
+// uncontended atomic ops.  A write waits for the grace period, i.e. for all
+// readers pinned to the previous epoch to leave, before it frees the old
+// version.  This means a reader holding a Snapshot blocks writers, so keep
+// snapshots short-lived.
+template <class T>
+class RcuSnapshot final {
+public:
+    // RAII handle to an immutable version of T.  The version stays alive (and
+    // writers wait) until the Snapshot is destroyed.
+    class Snapshot final {
+    public:
+        Snapshot(Snapshot&& other) noexcept
+        : _counters(other._counters), _counter(other._counter), _data(other._data) {
+            other._counter = nullptr;
+        }
+        Snapshot& operator=(Snapshot&&) = delete;
+
+        ~Snapshot() {
+            if (_counter != nullptr) {
+                _counters->leave(_counter);
+            }
+        }
+
+        const T& operator*() const {
+            return *_data;
+        }
+        const T* operator->() const {
+            return _data;
+        }
+        const T* get() const {
+            return _data;
+        }
+
+    private:
+        friend class RcuSnapshot;
+
+        Snapshot(detail::ShardedReaderCounters* counters, uint8_t epoch, const std::atomic<T*>& current)
+        : _counters(counters), _counter(counters->enter(epoch)), _data(current.load()) {}
+
+        detail::ShardedReaderCounters* _counters;
+        std::atomic<int32_t>* _counter;
+        const T* _data;
+
+        C10_DISABLE_COPY_AND_ASSIGN(Snapshot);
+    };
+
+    template<class... Args>
+    explicit RcuSnapshot(const Args& ...args)
+    : _counters()
+    , _epoch(0)
+    , _current(new T{args...})
+    , _writeMutex()
+    {}
+
+    // Copying and moving would not be threadsafe, see LeftRight.
+    RcuSnapshot(const RcuSnapshot&) = delete;
+    RcuSnapshot(RcuSnapshot&&) noexcept = delete;
+    RcuSnapshot& operator=(const RcuSnapshot&) = delete;
+    RcuSnapshot& operator=(RcuSnapshot&&) noexcept = delete;
+
+    ~RcuSnapshot() {
+        // wait until any potentially running writers are finished
+        std::unique_lock<std::mutex> lock(_writeMutex);
+
+        // wait until any potentially running readers are finished
+        _counters.waitForZero(0);
+        _counters.waitForZero(1);
+        delete _current.load();
+    }
+
+    Snapshot snapshot() const {
+        return Snapshot(&_counters, _epoch.load(), _current);
+    }
+
+    template <typename F>
+    auto read(F&& readFunc) const -> typename std::result_of<F(const T&)>::type {
+        detail::ShardedDecrementRAII _increment_counter(&_counters, _epoch.load());
+
+        return readFunc(*_current.load());
+    }
+
+    // Calls writeFunc on a copy of the current version and publishes the copy.
+    // If writeFunc throws, the copy is dropped and the current version stays.
+    template <typename F>
+    void write(F&& writeFunc) {
+        std::unique_lock<std::mutex> lock(_writeMutex);
+
+        std::unique_ptr<T> next(new T(*_current.load()));
+        writeFunc(*next);
+        _publish(std::move(next));
+    }
+
+    // Replaces the current version wholesale, e.g. with a table rebuilt from
+    // scratch.
+    void publish(std::unique_ptr<T> next) {
+        std::unique_lock<std::mutex> lock(_writeMutex);
+
+        _publish(std::move(next));
+    }
+
+private:
+    void _publish(std::unique_ptr<T> next) {
+        /*
+         * 1. Swap in the new version.  Readers that pin an epoch from now on load the new version.
+         * 2. Wait until the background epoch is drained.  A reader may have read the background epoch
+         *    before the previous write switched epochs, and only pinned it now, holding the version we
+         *    just replaced.
+         * 3. Switch epochs.
+         * 4. Wait until the old foreground epoch is drained.
+         * After that, no reader can still hold the old version.
+         */
+        std::unique_ptr<T> old(_current.exchange(next.release()));
+
+        auto localEpoch = _epoch.load();
+        _counters.waitForZero(localEpoch ^ 1);
+        _epoch = localEpoch ^ 1;
+        _counters.waitForZero(localEpoch);
+    }
+
+    mutable detail::ShardedReaderCounters _counters;
+    std::atomic<uint8_t> _epoch;
+    std::atomic<T*> _current;
+    std::mutex _writeMutex;
+};
+
+}
@@ -10,17 +10,23 @@
 // Make all macro invocations from inside the at namespace.
 
 #include <algorithm>
+#include <atomic>
 #include <cstdio>
 #include <cstdlib>
 #include <functional>
 #include <memory>
 #include <mutex>
 #include <string>
+#include <type_traits>
 #include <unordered_map>
 #include <vector>
 
 #include <c10/macros/Macros.h>
+#include <c10/util/ConstexprCrc.h>
+#include <c10/util/RcuSnapshot.h>
 #include <c10/util/Type.h>
+#include <c10/util/flat_hash_map.h>
+#include <c10/util/string_view.h>
 
 namespace c10 {
 
@@ -40,23 +46,128 @@ enum RegistryPriority {
   REGISTRY_PREFERRED = 3,
 };
 
+/**
+ * Lookup key for registries keyed by std::string: the name plus its crc64.
+ *
+ * Only C10_REGISTRY_KEY hashes at compile time, so that
+ *
+ *   FooRegistry()->Create(C10_REGISTRY_KEY("Foo"), ...)
+ *
+ * costs one integer probe into the table plus one compare of the name
+ * against the entry found.  Any other key, including a bare literal as in
+ * Create("Foo"), goes through one of the constructors below and is hashed
+ * when the lookup runs: they are constexpr so that C10_REGISTRY_KEY can use
+ * them, which doesn't make a call with a runtime argument constant.
+ * Register and the C10_REGISTER_* macros hash each key at run time too,
+ * once per registration, usually during static initialization.
+ */
+class RegistryKey final {
+ public:
+  /* implicit */ constexpr RegistryKey(const char* name)
+    : RegistryKey(c10::string_view(name)) {}
+  /* implicit */ constexpr RegistryKey(c10::string_view name)
+    : name_(name), hash_(c10::util::crc64(name).checksum()) {}
+  /* implicit */ RegistryKey(const std::string& name)
+    : RegistryKey(c10::string_view(name)) {}
+  // Trusts that hash is crc64(name); use C10_REGISTRY_KEY instead.
+  constexpr RegistryKey(c10::string_view name, uint64_t hash)
+    : name_(name), hash_(hash) {}
+
+  constexpr c10::string_view name() const {
+    return name_;
+  }
+  constexpr uint64_t hash() const {
+    return hash_;
+  }
+
+ private:
+  c10::string_view name_;
+  uint64_t hash_;
+};
+
+// The integral_constant forces the crc64 to be evaluated at compile time.
+#define C10_REGISTRY_KEY(name)                                     \
+  ::c10::RegistryKey(                                              \
+      name,                                                        \
+      std::integral_constant<                                      \
+          uint64_t,                                                \
+          ::c10::util::crc64(::c10::string_view(name)).checksum()>::value)
+
+namespace detail {
+
+// How a Registry looks up its keys.  By default the table is keyed by the
+// keys themselves.  std::string keys are looked up through RegistryKey, so
+// Create("Foo") doesn't build a std::string, and the table is keyed by their
+// crc64; the name is only compared against the entries sharing that hash.
+template <typename KeyType>
+struct RegistryKeyTraits {
+  using lookup_type = KeyType;
+  using table_key_type = KeyType;
+  using hash = std::hash<KeyType>;
+  static const KeyType& tableKey(const KeyType& key) {
+    return key;
+  }
+  static bool matches(const KeyType& /*entry_key*/, const KeyType& /*key*/) {
+    return true;
+  }
+};
+
+// crc64 is already well mixed, use it as is.
+struct RegistryHashIdentity {
+  typedef ska::power_of_two_hash_policy hash_policy;
+  size_t operator()(uint64_t hash) const {
+    return static_cast<size_t>(hash);
+  }
+};
+
+template <>
+struct RegistryKeyTraits<std::string> {
+  using lookup_type = RegistryKey;
+  using table_key_type = uint64_t;
+  using hash = RegistryHashIdentity;
+  static uint64_t tableKey(const RegistryKey& key) {
+    return key.hash();
+  }
+  static bool matches(const std::string& entry_key, const RegistryKey& key) {
+    return key.name() == c10::string_view(entry_key);
+  }
+};
+
+} // namespace detail
+
 /**
  * @brief A template class that allows one to register classes by keys.
  *
  * The keys are usually a std::string specifying the name, but can be anything
- * that can be used in a std::map.
+ * that can be hashed with std::hash.
  *
  * You should most likely not use the Registry class explicitly, but use the
  * helper macros below to declare specific registries as well as registering
  * objects.
+ *
+ * Lookups (Has, Create, Keys) read the table from an RcuSnapshot, so they
+ * never contend with each other and are safe against a concurrent Register.
+ * Registrations go to a pending copy of the table, made once per burst of
+ * registrations (e.g. all of static initialization), so n registrations cost
+ * O(n), not one table copy each.  The first lookup after a burst publishes
+ * it, and takes the registration lock to do so; once registrations stop,
+ * lookups are lock-free and pay one atomic load on top of the snapshot read.
+ * For std::string keys, see RegistryKey for how lookups are hashed.
  */
 template <class SrcType, class ObjectPtrType, class... Args>
 class Registry {
  public:
   typedef std::function<ObjectPtrType(Args...)> Creator;
+  using KeyTraits = detail::RegistryKeyTraits<SrcType>;
+  using LookupKey = typename KeyTraits::lookup_type;
 
   Registry(bool warning = true)
-    : registry_(), priority_(), terminate_(true), warning_(warning) {}
+    : entries_(),
+      registry_(),
+      pending_(),
+      has_pending_(false),
+      terminate_(true),
+      warning_(warning) {}
 
   void Register(
       const SrcType& key,
@@ -69,16 +180,16 @@ class Registry {
     // However, CHECK_EQ depends on google logging, and since registration is
     // carried out at static initialization time, we do not want to have an
     // explicit dependency on glog's initialization function.
-    if (registry_.count(key) != 0) {
-      auto cur_priority = priority_[key];
+    const Entry* cur = FindIn(Pending(), key);
+    if (cur != nullptr) {
+      auto cur_priority = cur->priority;
       if (priority > cur_priority) {
   #ifdef DEBUG
         std::string warn_msg =
             "Overwriting already registered item for key " + KeyStrRepr(key);
         fprintf(stderr, "%s\n", warn_msg.c_str());
   #endif
-        registry_[key] = creator;
-        priority_[key] = priority;
+        Insert(key, std::move(creator), priority);
       } else if (priority == cur_priority) {
         std::string err_msg =
             "Key already registered with the same priority: " + KeyStrRepr(key);
@@ -95,8 +206,7 @@ class Registry {
         fprintf(stderr, "%s\n", warn_msg.c_str());
       }
     } else {
-      registry_[key] = creator;
-      priority_[key] = priority;
+      Insert(key, std::move(creator), priority);
     }
   }
 
@@ -109,27 +219,35 @@ class Registry {
     help_message_[key] = help_msg;
   }
 
-  inline bool Has(const SrcType& key) {
-    return (registry_.count(key) != 0);
+  inline bool Has(const LookupKey& key) const {
+    return Find(key) != nullptr;
   }
 
-  ObjectPtrType Create(const SrcType& key, Args... args) {
-    if (registry_.count(key) == 0) {
+  ObjectPtrType Create(const LookupKey& key, Args... args) const {
+    const Entry* entry = Find(key);
+    if (entry == nullptr) {
       // Returns nullptr if the key is not registered.
       return nullptr;
     }
-    return registry_[key](args...);
+    return entry->creator(args...);
   }
 
   /**
    * Returns the keys currently registered as a std::vector.
    */
   std::vector<SrcType> Keys() const {
-    std::vector<SrcType> keys;
-    for (const auto& it : registry_) {
-      keys.push_back(it.first);
-    }
-    return keys;
+    PublishPending();
+    return registry_.read([](const Table& table) {
+      std::vector<SrcType> keys;
+      keys.reserve(table.size());
+      for (const auto& it : table) {
+        keys.push_back(it.second.first->key);
+        for (const Entry* entry : it.second.collisions) {
+          keys.push_back(entry->key);
+        }
+      }
+      return keys;
+    });
   }
 
   inline const std::unordered_map<SrcType, std::string>& HelpMessage() const {
@@ -151,12 +269,102 @@ class Registry {
   }
 
  private:
-  std::unordered_map<SrcType, Creator> registry_;
-  std::unordered_map<SrcType, RegistryPriority> priority_;
+  // Entries are never freed before the Registry itself, even when a higher
+  // priority registration replaces them.  That's what lets lookups hand out
+  // a plain Entry* and call the creator after leaving the RcuSnapshot read.
+  struct Entry {
+    SrcType key;
+    Creator creator;
+    RegistryPriority priority;
+  };
+  // Entries whose keys share a table key, i.e. hash collisions of std::string
+  // keys.  There is exactly one entry per bucket in practice, so it is kept
+  // inline and the collisions go to the side.
+  struct Bucket {
+    const Entry* first = nullptr;
+    std::vector<const Entry*> collisions;
+  };
+  using Table = ska::flat_hash_map<
+      typename KeyTraits::table_key_type,
+      Bucket,
+      typename KeyTraits::hash>;
+
+  static const Entry* FindIn(const Table& table, const LookupKey& key) {
+    auto it = table.find(KeyTraits::tableKey(key));
+    if (it == table.end()) {
+      return nullptr;
+    }
+    const Bucket& bucket = it->second;
+    if (C10_LIKELY(KeyTraits::matches(bucket.first->key, key))) {
+      return bucket.first;
+    }
+    for (const Entry* entry : bucket.collisions) {
+      if (KeyTraits::matches(entry->key, key)) {
+        return entry;
+      }
+    }
+    return nullptr;
+  }
+
+  const Entry* Find(const LookupKey& key) const {
+    PublishPending();
+    return registry_.read(
+        [&](const Table& table) { return FindIn(table, key); });
+  }
+
+  // Makes the registrations so far visible to lookups.  Once registrations
+  // stop, this is one atomic load.
+  void PublishPending() const {
+    if (C10_LIKELY(!has_pending_.load(std::memory_order_acquire))) {
+      return;
+    }
+    std::lock_guard<std::mutex> lock(register_mutex_);
+    if (pending_) {
+      registry_.publish(std::move(pending_));
+      has_pending_.store(false, std::memory_order_release);
+    }
+  }
+
+  // Must be called with register_mutex_ held.  The table registrations go to:
+  // the published one plus the registrations not published yet.
+  Table& Pending() {
+    if (!pending_) {
+      pending_ = registry_.read([](const Table& table) {
+        return std::unique_ptr<Table>(new Table(table));
+      });
+      has_pending_.store(true, std::memory_order_release);
+    }
+    return *pending_;
+  }
+
+  // Must be called with register_mutex_ held.
+  void Insert(const SrcType& key, Creator creator, RegistryPriority priority) {
+    entries_.emplace_back(new Entry{key, std::move(creator), priority});
+    const Entry* entry = entries_.back().get();
+    Bucket& bucket = Pending()[KeyTraits::tableKey(entry->key)];
+    if (bucket.first == nullptr ||
+        KeyTraits::matches(bucket.first->key, entry->key)) {
+      bucket.first = entry;
+      return;
+    }
+    for (const Entry*& cur : bucket.collisions) {
+      if (KeyTraits::matches(cur->key, entry->key)) {
+        cur = entry;
+        return;
+      }
+    }
+    bucket.collisions.push_back(entry);
+  }
+
+  std::vector<std::unique_ptr<const Entry>> entries_;
+  // Lookups publish pending_ into registry_, hence mutable.
+  mutable RcuSnapshot<Table> registry_;
+  mutable std::unique_ptr<Table> pending_;
+  mutable std::atomic<bool> has_pending_;
   bool terminate_;
   const bool warning_;
   std::unordered_map<SrcType, std::string> help_message_;
-  std::mutex register_mutex_;
+  mutable std::mutex register_mutex_;
 
   C10_DISABLE_COPY_AND_ASSIGN(Registry);
 };
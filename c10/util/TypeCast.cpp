@@ -0,0 +1,148 @@
+#include <c10/util/TypeCast.h>
+#include <c10/util/Parallel.h>
+
+#include <cstring>
+
+namespace c10 {
+
+namespace {
+
+// fetch_and_cast / cast_and_store only cast between the types below; the
+// quantized types and ComplexHalf can only be copied as they are.
+template <typename T>
+struct is_castable_type {
+  constexpr static bool value =
+#define IS_CASTABLE_TYPE(type, _) std::is_same<T, type>::value ||
+      AT_FORALL_SCALAR_TYPES_WITH_COMPLEX_EXCEPT_COMPLEX_HALF(IS_CASTABLE_TYPE)
+#undef IS_CASTABLE_TYPE
+      false;
+};
+
+template <typename dest_t, typename src_t>
+struct is_supported_cast {
+  constexpr static bool value = std::is_same<dest_t, src_t>::value ||
+      (is_castable_type<dest_t>::value && is_castable_type<src_t>::value);
+};
+
+// The generic kernel is a plain loop over static_cast_with_inter_type, which
+// the compiler vectorizes for the arithmetic types.
+template <typename dest_t, typename src_t>
+struct CastKernel {
+  static void apply(const void* src, void* dst, size_t n) {
+    const src_t* C10_RESTRICT s = static_cast<const src_t*>(src);
+    dest_t* C10_RESTRICT d = static_cast<dest_t*>(dst);
+    for (size_t i = 0; i < n; ++i) {
+      d[i] = static_cast_with_inter_type<dest_t, src_t>::apply(s[i]);
+    }
+  }
+};
+
+template <typename T>
+struct CastKernel<T, T> {
+  static void apply(const void* src, void* dst, size_t n) {
+    if (src != dst && n > 0) {
+      std::memcpy(dst, src, n * sizeof(T));
+    }
+  }
+};
+
+// The reduced float types go through the bulk conversions, which are
+// bit-exact with their scalar constructors and conversion operators.
+template <>
+struct CastKernel<float, Half> {
+  static void apply(const void* src, void* dst, size_t n) {
+    convert_half_to_float(static_cast<const Half*>(src), static_cast<float*>(dst), n);
+  }
+};
+
+template <>
+struct CastKernel<Half, float> {
+  static void apply(const void* src, void* dst, size_t n) {
+    convert_float_to_half(static_cast<const float*>(src), static_cast<Half*>(dst), n);
+  }
+};
+
+template <>
+struct CastKernel<float, BFloat16> {
+  static void apply(const void* src, void* dst, size_t n) {
+    convert_bfloat16_to_float(
+        static_cast<const BFloat16*>(src), static_cast<float*>(dst), n);
+  }
+};
+
+template <>
+struct CastKernel<BFloat16, float> {
+  static void apply(const void* src, void* dst, size_t n) {
+    convert_float_to_bfloat16(
+        static_cast<const float*>(src), static_cast<BFloat16*>(dst), n);
+  }
+};
+
+template <typename dest_t, typename src_t>
+constexpr typename std::enable_if<is_supported_cast<dest_t, src_t>::value, CastBufferFn>::type
+cast_kernel_for() {
+  return &CastKernel<dest_t, src_t>::apply;
+}
+
+template <typename dest_t, typename src_t>
+constexpr typename std::enable_if<!is_supported_cast<dest_t, src_t>::value, CastBufferFn>::type
+cast_kernel_for() {
+  return nullptr;
+}
+
+template <typename dest_t>
+void fill_cast_kernel_row(CastBufferFn* row) {
+#define SET_CAST_KERNEL(src_t, name) \
+  row[static_cast<int>(ScalarType::name)] = cast_kernel_for<dest_t, src_t>();
+  AT_FORALL_SCALAR_TYPES_WITH_COMPLEX_AND_QINTS(SET_CAST_KERNEL)
+#undef SET_CAST_KERNEL
+}
+
+// kernels[dst_dtype][src_dtype]
+struct CastKernelTable {
+  CastBufferFn kernels[NumScalarTypes][NumScalarTypes];
+
+  CastKernelTable() {
+#define FILL_CAST_KERNEL_ROW(dest_t, name) \
+    fill_cast_kernel_row<dest_t>(kernels[static_cast<int>(ScalarType::name)]);
+    AT_FORALL_SCALAR_TYPES_WITH_COMPLEX_AND_QINTS(FILL_CAST_KERNEL_ROW)
+#undef FILL_CAST_KERNEL_ROW
+  }
+};
+
+const CastKernelTable& castKernelTable() {
+  static const CastKernelTable table;
+  return table;
+}
+
+} // namespace
+
+CastBufferFn cast_buffer_kernel(ScalarType src_dtype, ScalarType dst_dtype) {
+  const auto src = static_cast<uint16_t>(src_dtype);
+  const auto dst = static_cast<uint16_t>(dst_dtype);
+  if (src >= NumScalarTypes || dst >= NumScalarTypes) {
+    return nullptr;
+  }
+  return castKernelTable().kernels[dst][src];
+}
+
+void cast_buffer(
+    const void* src,
+    ScalarType src_dtype,
+    void* dst,
+    ScalarType dst_dtype,
+    size_t n) {
+  CastBufferFn kernel = cast_buffer_kernel(src_dtype, dst_dtype);
+  TORCH_CHECK(
+      kernel != nullptr,
+      "cast_buffer: unsupported cast from ", src_dtype, " to ", dst_dtype);
+  const size_t src_size = elementSize(src_dtype);
+  const size_t dst_size = elementSize(dst_dtype);
+  const char* src_base = static_cast<const char*>(src);
+  char* dst_base = static_cast<char*>(dst);
+  parallel_for(0, n, internal::GRAIN_SIZE, [&](int64_t begin, int64_t end) {
+    kernel(src_base + begin * src_size, dst_base + begin * dst_size, end - begin);
+  });
+}
+
+} // namespace c10
@@ -178,4 +178,35 @@ To checked_convert(From f, const char* name) {
   return convert<To, From>(f);
 }
 
+// Whole-buffer casting:
+// - cast_buffer_kernel
+// - cast_buffer
+//
+// cast_buffer casts n elements of dynamic type src_dtype at src into n
+// elements of dynamic type dst_dtype at dst.  Unlike fetch_and_cast /
+// cast_and_store, the switch on the dtypes happens once per buffer: the kernel
+// for each (src_dtype, dst_dtype) pair is specialized at compile time and
+// picked from a table, and then runs a tight loop.  Element-wise it gives
+// exactly what static_cast_with_inter_type gives, uint8 special case
+// included.  Large buffers are cast in chunks on the intra-op thread pool,
+// see c10/util/Parallel.h.
+//
+// The supported casts are the ones fetch_and_cast supports, plus copying any
+// type to itself.  src and dst must not overlap, unless they are the same
+// buffer and the dtypes are the same.
+//
+// cast_buffer_kernel returns the kernel for a pair of dtypes, or nullptr if
+// the cast is not supported, for callers that cast many buffers with the same
+// dtypes.
+using CastBufferFn = void (*)(const void* src, void* dst, size_t n);
+
+C10_API CastBufferFn cast_buffer_kernel(ScalarType src_dtype, ScalarType dst_dtype);
+
+C10_API void cast_buffer(
+    const void* src,
+    ScalarType src_dtype,
+    void* dst,
+    ScalarType dst_dtype,
+    size_t n);
+
 }  // namespace c10
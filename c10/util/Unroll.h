@@ -0,0 +1,34 @@
+#pragma once
+
+#include <c10/macros/Macros.h>
+
+#include <type_traits>
+
+// Utility to guarantee complete unrolling of a loop whose bounds are known at
+// compile time.  Various pragmas achieve similar effects, but are not as
+// portable across compilers.
+//
+// Example: c10::ForcedUnroll<4>{}(f); is equivalent to f(0); f(1); f(2); f(3);
+// where the arguments are std::integral_constant<int, i>, usable as array
+// indices that the compiler sees as constants.
+
+namespace c10 {
+
+template <int n>
+struct ForcedUnroll {
+  template <typename Func>
+  C10_ALWAYS_INLINE void operator()(const Func& f) const {
+    ForcedUnroll<n - 1>{}(f);
+    f(std::integral_constant<int, n - 1>{});
+  }
+};
+
+template <>
+struct ForcedUnroll<1> {
+  template <typename Func>
+  C10_ALWAYS_INLINE void operator()(const Func& f) const {
+    f(std::integral_constant<int, 0>{});
+  }
+};
+
+} // namespace c10
@@ -1 +1,62 @@
 #include <c10/util/intrusive_ptr.h>
+
+#include <cstddef>
+
+namespace c10 {
+
+namespace {
+
+// Precedes each object of a block.  The header of the first object also
+// counts the live objects of the block.
+struct alignas(alignof(std::max_align_t)) CoAllocationHeader {
+  CoAllocationHeader(CoAllocationHeader* first, size_t live) : first(first), live(live) {}
+
+  CoAllocationHeader* first;
+  std::atomic<size_t> live;
+};
+
+constexpr size_t kHeaderSize = sizeof(CoAllocationHeader);
+
+// An object and its header, rounded up to whole headers so that every object
+// of a block is aligned like the block
+size_t slot_size(size_t nbytes) {
+  return kHeaderSize + (nbytes + kHeaderSize - 1) / kHeaderSize * kHeaderSize;
+}
+
+CoAllocationHeader* header_of(void* object) {
+  return reinterpret_cast<CoAllocationHeader*>(static_cast<char*>(object) - kHeaderSize);
+}
+
+} // namespace
+
+void* co_allocate(size_t nbytes) {
+  void* slot = nullptr;
+  co_allocate(&nbytes, &slot, 1);
+  return slot;
+}
+
+void co_allocate(const size_t* nbytes, void** slots, size_t n) {
+  size_t total = 0;
+  for (size_t i = 0; i < n; i++) {
+    total += slot_size(nbytes[i]);
+  }
+  char* p = static_cast<char*>(::operator new(total));
+  auto* first = reinterpret_cast<CoAllocationHeader*>(p);
+  for (size_t i = 0; i < n; i++) {
+    new (p) CoAllocationHeader(first, n);
+    slots[i] = p + kHeaderSize;
+    p += slot_size(nbytes[i]);
+  }
+}
+
+void co_deallocate(void* object) noexcept {
+  if (object == nullptr) {
+    return;
+  }
+  CoAllocationHeader* first = header_of(object)->first;
+  if (first->live.fetch_sub(1, std::memory_order_acq_rel) == 1) {
+    ::operator delete(first);
+  }
+}
+
+} // namespace c10
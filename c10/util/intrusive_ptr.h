@@ -3,6 +3,7 @@
 #include <c10/util/C++17.h>
 #include <c10/util/Exception.h>
 #include <atomic>
+#include <new>
 #include <stdexcept>
 
 namespace c10 {
@@ -133,6 +134,17 @@ class C10_API intrusive_ptr_target {
   virtual void release_resources() {}
 };
 
+// Heap blocks shared by several intrusive_ptr targets, for objects that are
+// nearly always created together (a TensorImpl and its StorageImpl).  A class
+// opts in with an operator new that calls co_allocate(nbytes) and an operator
+// delete that calls co_deallocate(); make_intrusive then gives each object a
+// block of its own.  co_allocate(nbytes, slots, n) makes one block for n such
+// objects, to be constructed with intrusive_ptr::make_in_place().  A block is
+// freed when the last of its objects is deleted.
+C10_API void* co_allocate(size_t nbytes);
+C10_API void co_allocate(const size_t* nbytes, void** slots, size_t n);
+C10_API void co_deallocate(void* object) noexcept;
+
 namespace detail {
 template <class TTarget>
 struct intrusive_target_default_null_type final {
@@ -362,6 +374,19 @@ class intrusive_ptr final {
     return result;
   }
 
+  /**
+   * Like make(), but constructs the target in memory the caller allocated,
+   * e.g. a slot of co_allocate().  The target's operator delete frees that
+   * memory, so it has to match the allocation.
+   */
+  template <class... Args>
+  static intrusive_ptr make_in_place(void* memory, Args&&... args) {
+    auto result = intrusive_ptr(::new (memory) TTarget(std::forward<Args>(args)...));
+    ++result.target_->refcount_;
+    ++result.target_->weakcount_;
+    return result;
+  }
+
   /**
    * Turn a **non-owning raw pointer** to an intrusive_ptr.
    *
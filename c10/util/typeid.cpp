@@ -1,5 +1,6 @@
 #include <c10/util/typeid.h>
 #include <c10/util/Exception.h>
+#include <c10/util/Parallel.h>
 
 #include <atomic>
 
@@ -17,39 +18,103 @@ C10_EXPORT void _ThrowRuntimeTypeLogicError(const string& msg) {
   AT_ERROR(msg);
 }
 
+namespace {
+// Items per chunk: copying a non-trivial item, e.g. a std::string, costs
+// tens of nanoseconds, so chunks are much smaller than for arithmetic loops.
+constexpr int64_t kItemGrainSize = 1024;
+} // namespace
+
+C10_EXPORT void _ParallelPlacementNew(
+    TypeMetaData::PlacementNew* placementNew,
+    size_t itemsize,
+    void* ptr,
+    size_t n) {
+  char* base = static_cast<char*>(ptr);
+  c10::parallel_for(0, n, kItemGrainSize, [&](int64_t begin, int64_t end) {
+    placementNew(base + begin * itemsize, end - begin);
+  });
+}
+
+C10_EXPORT void _ParallelCopy(
+    TypeMetaData::Copy* copy,
+    size_t itemsize,
+    const void* src,
+    void* dst,
+    size_t n) {
+  if (n == 0) {
+    // still call it, so that copying a non-copyable type throws
+    copy(src, dst, 0);
+    return;
+  }
+  const char* src_base = static_cast<const char*>(src);
+  char* dst_base = static_cast<char*>(dst);
+  c10::parallel_for(0, n, kItemGrainSize, [&](int64_t begin, int64_t end) {
+    copy(src_base + begin * itemsize, dst_base + begin * itemsize, end - begin);
+  });
+}
+
+C10_EXPORT void _ParallelPlacementDelete(
+    TypeMetaData::PlacementDelete* placementDelete,
+    size_t itemsize,
+    void* ptr,
+    size_t n) {
+  char* base = static_cast<char*>(ptr);
+  c10::parallel_for(0, n, kItemGrainSize, [&](int64_t begin, int64_t end) {
+    placementDelete(base + begin * itemsize, end - begin);
+  });
+}
+
 
 } // namespace detail
 
-template <>
-EXPORT_IF_NOT_GCC const detail::TypeMetaData* TypeMeta::_typeMetaDataInstance<
-    detail::_Uninitialized>() noexcept {
-  static constexpr detail::TypeMetaData singleton = detail::TypeMetaData(
-      0,
-      nullptr,
-      nullptr,
-      nullptr,
-      nullptr,
-      nullptr,
-      TypeIdentifier::uninitialized(),
-      "nullptr (uninitialized)");
-  return &singleton;
+// The table must be constant initialized: CAFFE_KNOWN_TYPEs Made during the
+// static initialization of other translation units fill their slots, maybe
+// before this one is initialized.
+#if C10_TYPENAME_SUPPORTS_CONSTEXPR
+#define CHECK_SCALAR_TYPE_META(T, name)                               \
+  static_assert(                                                      \
+      detail::_makeTypeMetaDataInstance<T>().itemsize_ == sizeof(T),  \
+      "the TypeMetaData of " #T " must be a constant expression");
+AT_FORALL_SCALAR_TYPES_WITH_COMPLEX_AND_QINTS(CHECK_SCALAR_TYPE_META)
+#undef CHECK_SCALAR_TYPE_META
+
+detail::TypeMetaData TypeMeta::typeMetaDatas_[MaxTypeIndex + 1] = {
+#define SCALAR_TYPE_META(T, name) detail::_makeTypeMetaDataInstance<T>(),
+    AT_FORALL_SCALAR_TYPES_WITH_COMPLEX_AND_QINTS(SCALAR_TYPE_META)
+#undef SCALAR_TYPE_META
+    // The remainder of the array is padded with TypeMetaData blanks, the
+    // first of which is the uninitialized type at index Undefined.
+};
+#else
+// Type names aren't constant expressions on this compiler.  Listing the
+// scalar types above would make the whole table dynamically initialized, so
+// it starts as blanks, and data() fills the ScalarType slots the first time
+// it is called, from whichever translation unit gets there first.
+detail::TypeMetaData TypeMeta::typeMetaDatas_[MaxTypeIndex + 1];
+std::atomic<bool> TypeMeta::scalarTypeMetaDatasFilled_{false};
+
+void TypeMeta::fillScalarTypeMetaDatas() {
+  // Function-local, so concurrent first calls wait for one fill.
+  static const bool filled = [] {
+#define SCALAR_TYPE_META(T, name)                                \
+  typeMetaDatas_[static_cast<uint16_t>(c10::ScalarType::name)] = \
+      detail::_makeTypeMetaDataInstance<T>();
+    AT_FORALL_SCALAR_TYPES_WITH_COMPLEX_AND_QINTS(SCALAR_TYPE_META)
+#undef SCALAR_TYPE_META
+    scalarTypeMetaDatasFilled_.store(true, std::memory_order_release);
+    return true;
+  }();
+  (void)filled;
+}
+#endif
+
+std::atomic<uint16_t>& TypeMeta::nextTypeIndex() {
+  static std::atomic<uint16_t> index{
+      static_cast<uint16_t>(c10::NumScalarTypes + 1)};
+  return index;
 }
 
-CAFFE_KNOWN_TYPE(uint8_t)
-CAFFE_KNOWN_TYPE(int8_t)
-CAFFE_KNOWN_TYPE(int16_t)
-CAFFE_KNOWN_TYPE(int)
-CAFFE_KNOWN_TYPE(int64_t)
-CAFFE_KNOWN_TYPE(at::Half)
-CAFFE_KNOWN_TYPE(float)
-CAFFE_KNOWN_TYPE(double)
-CAFFE_KNOWN_TYPE(c10::complex<c10::Half>)
-CAFFE_KNOWN_TYPE(c10::complex<float>)
-CAFFE_KNOWN_TYPE(c10::complex<double>)
-// 11 = undefined type id
-// 12 = Tensor (defined in tensor.cc)
 CAFFE_KNOWN_TYPE(std::string)
-CAFFE_KNOWN_TYPE(bool)
 CAFFE_KNOWN_TYPE(uint16_t)
 CAFFE_KNOWN_TYPE(char)
 CAFFE_KNOWN_TYPE(std::unique_ptr<std::mutex>)
@@ -84,9 +149,5 @@ CAFFE_KNOWN_TYPE(detail::_guard_long_unique<std::vector<long>>)
 
 CAFFE_KNOWN_TYPE(float*)
 CAFFE_KNOWN_TYPE(at::Half*)
-CAFFE_KNOWN_TYPE(c10::qint8)
-CAFFE_KNOWN_TYPE(c10::quint8)
-CAFFE_KNOWN_TYPE(c10::qint32)
-CAFFE_KNOWN_TYPE(at::BFloat16)
 
 } // namespace caffe2
@@ -4,6 +4,7 @@
 #include <cassert>
 #include <complex>
 #include <cstdlib>
+#include <cstring>
 #include <iostream>
 #include <memory>
 #include <mutex>
@@ -17,6 +18,7 @@
 
 #include <exception>
 
+#include <c10/core/ScalarType.h>
 #include <c10/macros/Macros.h>
 #include <c10/util/Backtrace.h>
 #include <c10/util/C++17.h>
@@ -116,8 +118,9 @@ namespace caffe2 {
 namespace detail {
 
 // This struct holds the actual type information. There will be
-// one allocated per type. TypeMeta objects will then point to the struct
-// instance for the type they're configured for.
+// one allocated per type, in TypeMeta::typeMetaDatas_. TypeMeta objects
+// will then hold the index of the struct instance for the type they're
+// configured for.
 struct TypeMetaData final {
   using New = void*();
   using PlacementNew = void(void*, size_t);
@@ -125,7 +128,20 @@ struct TypeMetaData final {
   using PlacementDelete = void(void*, size_t);
   using Delete = void(void*);
 
-  TypeMetaData() = delete;
+  // Placeholder for the slots of TypeMeta::typeMetaDatas_ that are not
+  // assigned a type yet.
+  constexpr TypeMetaData() noexcept
+      : itemsize_(0),
+        new_(nullptr),
+        placementNew_(nullptr),
+        copy_(nullptr),
+        placementDelete_(nullptr),
+        delete_(nullptr),
+        id_(TypeIdentifier::uninitialized()),
+        name_("nullptr (uninitialized)"),
+        triviallyCopyable_(true),
+        triviallyDestructible_(true) {}
+
   constexpr TypeMetaData(
       size_t itemsize,
       New* newFn,
@@ -134,7 +150,9 @@ struct TypeMetaData final {
       PlacementDelete* placementDelete,
       Delete* deleteFn,
       TypeIdentifier id,
-      c10::string_view name) noexcept
+      c10::string_view name,
+      bool triviallyCopyable,
+      bool triviallyDestructible) noexcept
       : itemsize_(itemsize),
         new_(newFn),
         placementNew_(placementNew),
@@ -142,7 +160,9 @@ struct TypeMetaData final {
         placementDelete_(placementDelete),
         delete_(deleteFn),
         id_(id),
-        name_(name) {}
+        name_(name),
+        triviallyCopyable_(triviallyCopyable),
+        triviallyDestructible_(triviallyDestructible) {}
 
   size_t itemsize_;
   New* new_;
@@ -152,6 +172,8 @@ struct TypeMetaData final {
   Delete* delete_;
   TypeIdentifier id_;
   c10::string_view name_;
+  bool triviallyCopyable_;
+  bool triviallyDestructible_;
 };
 
 // Mechanism for throwing errors which can't be prevented at compile time
@@ -160,6 +182,27 @@ struct TypeMetaData final {
 // in .cpp to manage dependencies
 [[noreturn]] C10_API void _ThrowRuntimeTypeLogicError(const std::string& msg);
 
+// Run the placement new / copy / placement delete function of a non-trivial
+// type over n items of itemsize bytes, in chunks on the intra-op thread pool
+// (c10/util/Parallel.h) when n is large.  Out of line so that this header
+// doesn't depend on the thread pool.
+C10_API void _ParallelPlacementNew(
+    TypeMetaData::PlacementNew* placementNew,
+    size_t itemsize,
+    void* ptr,
+    size_t n);
+C10_API void _ParallelCopy(
+    TypeMetaData::Copy* copy,
+    size_t itemsize,
+    const void* src,
+    void* dst,
+    size_t n);
+C10_API void _ParallelPlacementDelete(
+    TypeMetaData::PlacementDelete* placementDelete,
+    size_t itemsize,
+    void* ptr,
+    size_t n);
+
 /**
  * Placement new function for the type.
  */
@@ -182,7 +225,10 @@ template <
     typename T,
     std::enable_if_t<std::is_default_constructible<T>::value>* = nullptr>
 inline constexpr TypeMetaData::PlacementNew* _PickPlacementNew() {
-  return (c10::guts::is_fundamental<T>::value || std::is_pointer<T>::value)
+  // Default-initializing a trivially default constructible type is a no-op,
+  // so there's nothing to call.
+  return (c10::guts::is_fundamental<T>::value || std::is_pointer<T>::value ||
+          std::is_trivially_default_constructible<T>::value)
       ? nullptr
       : &_PlacementNew<T>;
 }
@@ -249,7 +295,10 @@ template <
     typename T,
     std::enable_if_t<std::is_copy_assignable<T>::value>* = nullptr>
 inline constexpr TypeMetaData::Copy* _PickCopy() {
-  return (c10::guts::is_fundamental<T>::value || std::is_pointer<T>::value)
+  // nullptr means "copy with memcpy", which is what _Copy would boil down to
+  // for trivially copyable types anyway (e.g. qint8, complex<float>).
+  return (c10::guts::is_fundamental<T>::value || std::is_pointer<T>::value ||
+          C10_IS_TRIVIALLY_COPYABLE(T))
       ? nullptr
       : &_Copy<T>;
 }
@@ -277,7 +326,8 @@ inline void _PlacementDelete(void* ptr, size_t n) {
 
 template <typename T>
 inline constexpr TypeMetaData::PlacementDelete* _PickPlacementDelete() {
-  return (c10::guts::is_fundamental<T>::value || std::is_pointer<T>::value)
+  return (c10::guts::is_fundamental<T>::value || std::is_pointer<T>::value ||
+          std::is_trivially_destructible<T>::value)
       ? nullptr
       : &_PlacementDelete<T>;
 }
@@ -305,11 +355,20 @@ inline C10_TYPENAME_CONSTEXPR TypeMetaData _makeTypeMetaDataInstance() {
           _PickPlacementDelete<T>(),
           _PickDelete<T>(),
           typeId,
-          typeName};
+          typeName,
+          C10_IS_TRIVIALLY_COPYABLE(T),
+          std::is_trivially_destructible<T>::value};
 }
 
 class _Uninitialized final {};
 
+// sizeof of each ScalarType type, indexed by ScalarType
+constexpr uint8_t kScalarTypeItemSizes[c10::NumScalarTypes] = {
+#define SCALAR_TYPE_SIZE(T, name) sizeof(T),
+    AT_FORALL_SCALAR_TYPES_WITH_COMPLEX_AND_QINTS(SCALAR_TYPE_SIZE)
+#undef SCALAR_TYPE_SIZE
+};
+
 } // namespace detail
 
 /**
@@ -317,6 +376,13 @@ class _Uninitialized final {};
  * as a blob, or the data type of a tensor, with a unique run-time id. It also
  * stores some additional data such as the item size and the name of the type
  * for run-time inspection.
+ *
+ * A TypeMeta is a 16-bit index into the TypeMetaData table typeMetaDatas_.
+ * The ScalarType types come first, numbered at compile time
+ * in the order of AT_FORALL_SCALAR_TYPES_WITH_COMPLEX_AND_QINTS (so the index
+ * of a scalar type is its ScalarType value), followed by the uninitialized
+ * type at index ScalarType::Undefined.  All other CAFFE_KNOWN_TYPEs get the
+ * following indices, assigned at runtime the first time they are Made.
  */
 class C10_API TypeMeta final {
  public:
@@ -346,8 +412,8 @@ class C10_API TypeMeta final {
  private:
   // TypeMeta can only be created by Make, making sure that we do not
   // create incorrectly mixed up TypeMeta objects.
-  explicit TypeMeta(const detail::TypeMetaData* data) noexcept
-  : data_(data) {
+  explicit constexpr TypeMeta(const uint16_t index) noexcept
+  : index_(index) {
   }
 
  public:
@@ -355,51 +421,117 @@ class C10_API TypeMeta final {
    * Returns the type id.
    */
   TypeIdentifier id() const noexcept {
-    return data_->id_;
+    return data().id_;
+  }
+  /**
+   * true if we represent some ScalarType type
+   */
+  constexpr bool isScalarType() const noexcept {
+    return index_ < c10::NumScalarTypes;
+  }
+  /**
+   * true if we represent ScalarType scalar_type
+   */
+  constexpr bool isScalarType(c10::ScalarType scalar_type) const noexcept {
+    return index_ == static_cast<uint16_t>(scalar_type);
   }
   /**
    * Returns the size of the item.
    */
   size_t itemsize() const noexcept {
-    return data_->itemsize_;
+    if (C10_LIKELY(isScalarType())) {
+      return detail::kScalarTypeItemSizes[index_];
+    }
+    return data().itemsize_;
   }
   New* newFn() const noexcept {
-    return data_->new_;
+    return data().new_;
   }
   /**
    * Returns the placement new function pointer for individual items.
    */
   PlacementNew* placementNew() const noexcept {
-    return data_->placementNew_;
+    return data().placementNew_;
   }
   /**
    * Returns the typed copy function pointer for individual iterms.
    */
   Copy* copy() const noexcept {
-    return data_->copy_;
+    return data().copy_;
   }
   /**
    * Returns the destructor function pointer for individual items.
    */
   PlacementDelete* placementDelete() const noexcept {
-    return data_->placementDelete_;
+    return data().placementDelete_;
   }
   Delete* deleteFn() const noexcept {
-    return data_->delete_;
+    return data().delete_;
   }
   /**
    * Returns a printable name for the type.
    */
   c10::string_view name() const noexcept {
-    return data_->name_;
+    return data().name_;
+  }
+  /**
+   * Whether items can be copied with memcpy.
+   */
+  bool isTriviallyCopyable() const noexcept {
+    return data().triviallyCopyable_;
+  }
+  /**
+   * Whether destroying items is a no-op.
+   */
+  bool isTriviallyDestructible() const noexcept {
+    return data().triviallyDestructible_;
+  }
+
+  // Bulk helpers over n items.  They take the memcpy / no-op fast paths for
+  // trivial types instead of going through the function pointers above, so
+  // callers don't need to check for nullptr themselves.  The loops of
+  // non-trivial types run in parallel chunks for large n.
+
+  /**
+   * Default-constructs n items at ptr.
+   */
+  void constructItems(void* ptr, size_t n) const {
+    const auto& d = data();
+    if (d.placementNew_ != nullptr) {
+      detail::_ParallelPlacementNew(d.placementNew_, d.itemsize_, ptr, n);
+    }
+  }
+  /**
+   * Copy-assigns n items from src to dst.
+   */
+  void copyItems(const void* src, void* dst, size_t n) const {
+    const auto& d = data();
+    if (d.copy_ == nullptr) {
+      if (n > 0) {
+        std::memcpy(dst, src, n * d.itemsize_);
+      }
+    } else {
+      detail::_ParallelCopy(d.copy_, d.itemsize_, src, dst, n);
+    }
+  }
+  /**
+   * Destroys n items at ptr.
+   */
+  void destructItems(void* ptr, size_t n) const {
+    const auto& d = data();
+    if (d.placementDelete_ != nullptr) {
+      detail::_ParallelPlacementDelete(d.placementDelete_, d.itemsize_, ptr, n);
+    }
   }
 
   friend bool operator==(
       const TypeMeta& lhs,
       const TypeMeta& rhs) noexcept;
 
+  // Not noexcept: the first use of a CAFFE_KNOWN_TYPE can throw, see
+  // addTypeMetaData.
   template <typename T>
-  bool Match() const noexcept {
+  bool Match() const {
     return (*this == Make<T>());
   }
 
@@ -424,7 +556,7 @@ class C10_API TypeMeta final {
    * Returns a TypeMeta object that corresponds to the typename T.
    */
   template <typename T>
-  static TypeMeta Make() {
+  static C10_HOST_CONSTEXPR TypeMeta Make() {
     // The instance pointed to is declared here, but defined in a .cpp file.
     // We need to silence the compiler warning about using an undefined
     // variable template. '-Wpragmas' and '-Wunknown-warning-option' has to be
@@ -436,31 +568,103 @@ class C10_API TypeMeta final {
 #pragma GCC diagnostic ignored "-Wunknown-warning-option"
 #pragma GCC diagnostic ignored "-Wundefined-var-template"
 #endif
-    return TypeMeta(_typeMetaDataInstance<T>());
+    return TypeMeta(_typeMetaData<T>());
 #ifndef _MSC_VER
 #pragma GCC diagnostic pop
 #endif
   }
 
+  /**
+   * convert ScalarType enum values to TypeMeta handles
+   */
+  static inline C10_HOST_CONSTEXPR TypeMeta fromScalarType(
+      c10::ScalarType scalar_type) {
+    return TypeMeta(static_cast<uint16_t>(scalar_type));
+  }
+
+  /**
+   * convert TypeMeta handles to ScalarType enum values
+   */
+  inline c10::ScalarType toScalarType() const {
+    // Undefined is numbered like ScalarType::Undefined too
+    if (C10_LIKELY(index_ <= c10::NumScalarTypes)) {
+      return static_cast<c10::ScalarType>(index_);
+    }
+    AT_ERROR(
+        "Unsupported TypeMeta in ATen: ", *this, " (please report this error)");
+  }
+
+  // Size of the typeMetaDatas_ table; the number of types that can be Made.
+  static constexpr uint16_t MaxTypeIndex = 128;
+
  private:
-  const detail::TypeMetaData* data_;
+  uint16_t index_;
+
+  // Indexed by index_.  Constant initialized (see typeid.cpp), so it is valid
+  // during static initialization and data() is a single load.
+  static detail::TypeMetaData typeMetaDatas_[MaxTypeIndex + 1];
+
+  const detail::TypeMetaData& data() const {
+#if !C10_TYPENAME_SUPPORTS_CONSTEXPR
+    if (C10_UNLIKELY(
+            !scalarTypeMetaDatasFilled_.load(std::memory_order_acquire))) {
+      fillScalarTypeMetaDatas();
+    }
+#endif
+    return typeMetaDatas_[index_];
+  }
+
+#if !C10_TYPENAME_SUPPORTS_CONSTEXPR
+  // The TypeMetaData of the ScalarTypes aren't constant expressions when type
+  // names aren't, so their slots are filled on first access instead, whatever
+  // the order of static initialization; see typeid.cpp.
+  static void fillScalarTypeMetaDatas();
+  static std::atomic<bool> scalarTypeMetaDatasFilled_;
+#endif
+
+  // Assigns T the next free index and fills in its TypeMetaData.  Called once
+  // per non-scalar type, by the _typeMetaData specialization CAFFE_KNOWN_TYPE
+  // defines.  Throws c10::Error past MaxTypeIndex types, which is why
+  // _typeMetaData and the functions Making a type aren't noexcept.
+  template <class T>
+  static uint16_t addTypeMetaData() {
+    const uint16_t index = nextTypeIndex().fetch_add(1);
+    TORCH_CHECK(
+        index < MaxTypeIndex,
+        "Maximum number of CAFFE_KNOWN_TYPE declarations has been exceeded. ",
+        "Please report this issue.");
+    typeMetaDatas_[index] = detail::_makeTypeMetaDataInstance<T>();
+    return index;
+  }
+
+  static std::atomic<uint16_t>& nextTypeIndex();
 
   template <class T>
-  C10_API static const detail::TypeMetaData* _typeMetaDataInstance() noexcept;
+  C10_API static uint16_t _typeMetaData();
 };
 
+// The scalar types and the uninitialized type are numbered at compile time.
+#define DEFINE_SCALAR_METADATA_INSTANCE(T, name)                \
+  template <>                                                   \
+  constexpr uint16_t TypeMeta::_typeMetaData<T>() {             \
+    return static_cast<uint16_t>(c10::ScalarType::name);        \
+  }
+AT_FORALL_SCALAR_TYPES_WITH_COMPLEX_AND_QINTS(DEFINE_SCALAR_METADATA_INSTANCE)
+#undef DEFINE_SCALAR_METADATA_INSTANCE
+
 template <>
-C10_EXPORT const detail::TypeMetaData* TypeMeta::_typeMetaDataInstance<
-    detail::_Uninitialized>() noexcept;
+constexpr uint16_t TypeMeta::_typeMetaData<detail::_Uninitialized>() {
+  return static_cast<uint16_t>(c10::ScalarType::Undefined);
+}
 
 inline TypeMeta::TypeMeta() noexcept
-    : data_(_typeMetaDataInstance<detail::_Uninitialized>()) {
+    : index_(_typeMetaData<detail::_Uninitialized>()) {
 }
 
 inline bool operator==(
     const TypeMeta& lhs,
     const TypeMeta& rhs) noexcept {
-  return (lhs.data_ == rhs.data_);
+  return (lhs.index_ == rhs.index_);
 }
 inline bool operator!=(
     const TypeMeta& lhs,
@@ -478,12 +682,13 @@ inline std::ostream& operator<<(
  * Register unique id for a type so it can be used in TypeMeta context, e.g. be
  * used as a type for Blob or for Tensor elements.
  *
- * CAFFE_KNOWN_TYPE does explicit instantiation of TypeIdentifier::Get<T>
- * template function and thus needs to be put in a single translation unit (.cpp
- * file) for a given type T. Other translation units that use type T as a type
- * of the caffe2::Blob or element type of caffe2::Tensor need to depend on the
- * translation unit that contains CAFFE_KNOWN_TYPE declaration via regular
- * linkage dependencies.
+ * CAFFE_KNOWN_TYPE defines the TypeMeta::_typeMetaData<T> specialization,
+ * which assigns T its TypeMeta index on first use, and thus needs to be put in
+ * a single translation unit (.cpp file) for a given type T. The ScalarType
+ * types are numbered in typeid.h and must not be declared with it. Other
+ * translation units that use type T as a type of the caffe2::Blob or element
+ * type of caffe2::Tensor need to depend on the translation unit that contains
+ * CAFFE_KNOWN_TYPE declaration via regular linkage dependencies.
  *
  * NOTE: the macro needs to be invoked in ::caffe2 namespace
  */
@@ -501,11 +706,9 @@ inline std::ostream& operator<<(
 
 #define CAFFE_KNOWN_TYPE(T)                                        \
   template <>                                                      \
-  EXPORT_IF_NOT_GCC const detail::TypeMetaData*                    \
-  TypeMeta::_typeMetaDataInstance<T>() noexcept {                  \
-    static C10_TYPENAME_CONSTEXPR detail::TypeMetaData singleton = \
-        detail::_makeTypeMetaDataInstance<T>();                    \
-    return &singleton;                                             \
+  EXPORT_IF_NOT_GCC uint16_t TypeMeta::_typeMetaData<T>() {      \
+    static const uint16_t index = addTypeMetaData<T>();            \
+    return index;                                                  \
   }
 
 } // namespace caffe2
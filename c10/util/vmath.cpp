@@ -0,0 +1,65 @@
+#include <c10/util/vmath.h>
+#include <c10/cpu/ComplexKernel.h>
+#include <c10/cpu/VmathKernel.h>
+
+namespace c10 {
+
+DEFINE_DISPATCH(vmath_stub);
+DEFINE_DISPATCH(complex_unary_stub);
+DEFINE_DISPATCH(complex_binary_stub);
+DEFINE_DISPATCH(complex_vdot_stub);
+
+namespace vmath {
+
+#define C10_DEFINE_VMATH_FN(name, op)                                  \
+  void name(const float* src, float* dst, size_t n) {                  \
+    vmath_stub(VmathOp::op, ScalarType::Float, src, dst, n);           \
+  }                                                                    \
+  void name(const BFloat16* src, BFloat16* dst, size_t n) {            \
+    vmath_stub(VmathOp::op, ScalarType::BFloat16, src, dst, n);        \
+  }                                                                    \
+  void name(const Half* src, Half* dst, size_t n) {                    \
+    vmath_stub(VmathOp::op, ScalarType::Half, src, dst, n);            \
+  }
+
+C10_DEFINE_VMATH_FN(exp, Exp)
+C10_DEFINE_VMATH_FN(log, Log)
+C10_DEFINE_VMATH_FN(tanh, Tanh)
+C10_DEFINE_VMATH_FN(sigmoid, Sigmoid)
+C10_DEFINE_VMATH_FN(erf, Erf)
+C10_DEFINE_VMATH_FN(gelu, Gelu)
+
+#undef C10_DEFINE_VMATH_FN
+
+#define C10_DEFINE_COMPLEX_VMATH_FNS(T, dtype)                                      \
+  void mul(const complex<T>* a, const complex<T>* b, complex<T>* dst, size_t n) {   \
+    complex_binary_stub(ComplexOp::Mul, ScalarType::dtype, a, b, dst, n);           \
+  }                                                                                 \
+  void mul_add(const complex<T>* a, const complex<T>* b, complex<T>* acc, size_t n) { \
+    complex_binary_stub(ComplexOp::MulAdd, ScalarType::dtype, a, b, acc, n);        \
+  }                                                                                 \
+  void conj(const complex<T>* src, complex<T>* dst, size_t n) {                     \
+    complex_unary_stub(ComplexOp::Conj, ScalarType::dtype, src, dst, n);            \
+  }                                                                                 \
+  void abs(const complex<T>* src, T* dst, size_t n) {                               \
+    complex_unary_stub(ComplexOp::Abs, ScalarType::dtype, src, dst, n);             \
+  }                                                                                 \
+  void arg(const complex<T>* src, T* dst, size_t n) {                               \
+    complex_unary_stub(ComplexOp::Arg, ScalarType::dtype, src, dst, n);             \
+  }                                                                                 \
+  void exp(const complex<T>* src, complex<T>* dst, size_t n) {                      \
+    complex_unary_stub(ComplexOp::Exp, ScalarType::dtype, src, dst, n);             \
+  }                                                                                 \
+  complex<T> vdot(const complex<T>* a, const complex<T>* b, size_t n) {             \
+    complex<T> result;                                                              \
+    complex_vdot_stub(ScalarType::dtype, a, b, n, &result);                         \
+    return result;                                                                  \
+  }
+
+C10_DEFINE_COMPLEX_VMATH_FNS(float, ComplexFloat)
+C10_DEFINE_COMPLEX_VMATH_FNS(double, ComplexDouble)
+
+#undef C10_DEFINE_COMPLEX_VMATH_FNS
+
+} // namespace vmath
+} // namespace c10
@@ -0,0 +1,86 @@
+#pragma once
+
+#include <c10/macros/Macros.h>
+#include <c10/util/BFloat16.h>
+#include <c10/util/Half.h>
+#include <c10/util/complex_type.h>
+
+#include <cstddef>
+
+// Element-wise math over arrays: dst[i] = f(src[i]) for i < n.  src and dst
+// may be the same array, but must not otherwise overlap.
+//
+//   sigmoid(x) = 1 / (1 + exp(-x))
+//   gelu(x)    = x / 2 * (1 + erf(x / sqrt(2)))
+//
+// On AVX2 and AVX-512 CPUs the float versions use the polynomial
+// approximations of c10/cpu/vec/vec_math.h.  Maximum errors against double
+// precision libm, measured over all finite floats:
+//
+//   exp      1.3 ulp
+//   log      0.8 ulp
+//   tanh     1.4 ulp
+//   sigmoid  3 ulp
+//   erf      3.4e-7 absolute, 2.5 ulp for |x| < 0.5
+//   gelu     3 ulp for x >= 0, 10 ulp for -1 < x < 0, and 1.4e-7 * |x|
+//            absolute below -1, where 1 + erf(x / sqrt(2)) cancels
+//
+// Other CPUs use libm.  BFloat16 and Half are computed in float and rounded
+// once, so their results are within 1 ulp of the destination type, except
+// where the float errors above are absolute.
+
+namespace c10 {
+namespace vmath {
+
+#define C10_DECLARE_VMATH_FN(name)                                     \
+  C10_API void name(const float* src, float* dst, size_t n);           \
+  C10_API void name(const BFloat16* src, BFloat16* dst, size_t n);     \
+  C10_API void name(const Half* src, Half* dst, size_t n);
+
+C10_DECLARE_VMATH_FN(exp)
+C10_DECLARE_VMATH_FN(log)
+C10_DECLARE_VMATH_FN(tanh)
+C10_DECLARE_VMATH_FN(sigmoid)
+C10_DECLARE_VMATH_FN(erf)
+C10_DECLARE_VMATH_FN(gelu)
+
+#undef C10_DECLARE_VMATH_FN
+
+// Complex arrays, interleaved like c10::complex:
+//
+//   mul(a, b, dst, n)      dst[i] = a[i] * b[i]
+//   mul_add(a, b, acc, n)  acc[i] += a[i] * b[i]
+//   conj(src, dst, n)      dst[i] = conj(src[i])
+//   abs(src, dst, n)       dst[i] = abs(src[i]), dst is real
+//   arg(src, dst, n)       dst[i] = arg(src[i]), dst is real
+//   exp(src, dst, n)       dst[i] = exp(src[i])
+//   vdot(a, b, n)          the sum of conj(a[i]) * b[i]
+//
+// mul and mul_add use the formula of c10::complex's operator* (up to FMA
+// contraction), and vdot sums in several interleaved partial sums, so its
+// error is that of a blocked summation, not of the scalar loop.  abs is
+// sqrt(re^2 + im^2), within 1 ulp, with std::abs for values whose squares
+// would overflow or underflow.  exp, arg and abs of NaN and inf follow
+// std::exp, std::arg and std::abs.  Against double precision libm, on AVX2
+// and AVX-512 CPUs:
+//
+//   complex<float>   arg  3.2 ulp
+//                    exp  2e-7 * |exp(z)| absolute per component,
+//                         for |im(z)| <= 8192 (libm beyond)
+//   complex<double>  arg, exp go through libm
+#define C10_DECLARE_COMPLEX_VMATH_FNS(T)                                                \
+  C10_API void mul(const complex<T>* a, const complex<T>* b, complex<T>* dst, size_t n); \
+  C10_API void mul_add(const complex<T>* a, const complex<T>* b, complex<T>* acc, size_t n); \
+  C10_API void conj(const complex<T>* src, complex<T>* dst, size_t n);                    \
+  C10_API void abs(const complex<T>* src, T* dst, size_t n);                              \
+  C10_API void arg(const complex<T>* src, T* dst, size_t n);                              \
+  C10_API void exp(const complex<T>* src, complex<T>* dst, size_t n);                     \
+  C10_API complex<T> vdot(const complex<T>* a, const complex<T>* b, size_t n);
+
+C10_DECLARE_COMPLEX_VMATH_FNS(float)
+C10_DECLARE_COMPLEX_VMATH_FNS(double)
+
+#undef C10_DECLARE_COMPLEX_VMATH_FNS
+
+} // namespace vmath
+} // namespace c10